@@ -237,6 +237,196 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
             }
         }
 
+        [Fact]
+        public async Task ReadFramedBreakpointAsync_MultipleReads()
+        {
+            var server = new BreakpointServer(_pipeMock.Object, Constants.LengthPrefixedPipeProtocolVersion);
+            var breakpoint1 = new Breakpoint
+            {
+                Id = "some-id-1"
+            };
+            var breakpoint2 = new Breakpoint
+            {
+                Id = "some-id-2"
+            };
+
+            // Split the frames so neither read is aligned with a frame.
+            var frames = CreateBreakpointFrame(breakpoint1).Concat(CreateBreakpointFrame(breakpoint2)).ToArray();
+            _pipeMock.SetupSequence(p => p.ReadAsync(_cts.Token))
+                .Returns(Task.FromResult(frames.Take(3).ToArray()))
+                .Returns(Task.FromResult(frames.Skip(3).Take(15).ToArray()))
+                .Returns(Task.FromResult(frames.Skip(18).ToArray()));
+
+            Assert.Equal(breakpoint1, await server.ReadBreakpointAsync(_cts.Token));
+            Assert.Equal(breakpoint2, await server.ReadBreakpointAsync(_cts.Token));
+            _pipeMock.Verify(p => p.ReadAsync(_cts.Token), Times.Exactly(3));
+        }
+
+        [Fact]
+        public async Task ReadFramedBreakpointAsync_LongBreakpoint()
+        {
+            var server = new BreakpointServer(_pipeMock.Object, Constants.LengthPrefixedPipeProtocolVersion);
+            var breakpoint = new Breakpoint
+            {
+                Id = "id",
+            };
+            for (int i = 0; i < 100; i += 1)
+            {
+                StackFrame stackFrame = new StackFrame();
+                stackFrame.Locals.Add(new Variable { Name = "TestVariable" });
+                breakpoint.StackFrames.Add(stackFrame);
+            }
+
+            // The frame is larger than the initial frame buffer.
+            var frame = CreateBreakpointFrame(breakpoint);
+            Assert.True(frame.Length > Constants.BufferSize);
+            _pipeMock.SetupSequence(p => p.ReadAsync(_cts.Token))
+                .Returns(Task.FromResult(frame.Take(Constants.BufferSize).ToArray()))
+                .Returns(Task.FromResult(frame.Skip(Constants.BufferSize).ToArray()));
+
+            Assert.Equal(breakpoint, await server.ReadBreakpointAsync(_cts.Token));
+            _pipeMock.Verify(p => p.ReadAsync(_cts.Token), Times.Exactly(2));
+        }
+
+        [Fact]
+        public async Task ReadFramedBreakpointAsync_InvalidFrame()
+        {
+            var server = new BreakpointServer(_pipeMock.Object, Constants.LengthPrefixedPipeProtocolVersion);
+            var breakpoint = new Breakpoint
+            {
+                Id = "some-id"
+            };
+            var breakpointMessage = CreateBreakpointMessage(breakpoint);
+            _pipeMock.Setup(p => p.ReadAsync(_cts.Token)).Returns(Task.FromResult(breakpointMessage));
+
+            await Assert.ThrowsAsync<InvalidOperationException>
+                (async () => await server.ReadBreakpointAsync(_cts.Token));
+        }
+
+        [Fact]
+        public void WriteFramedBreakpointAsync()
+        {
+            var server = new BreakpointServer(_pipeMock.Object, Constants.LengthPrefixedPipeProtocolVersion);
+            var breakpoint = new Breakpoint
+            {
+                Id = "some-id"
+            };
+
+            var frame = CreateBreakpointFrame(breakpoint);
+            _pipeMock.Setup(p => p.WriteAsync(It.Is<byte[]>(bytes => bytes.SequenceEqual(frame)), _cts.Token));
+            server.WriteBreakpointAsync(breakpoint, _cts.Token);
+            _pipeMock.VerifyAll();
+        }
+
+        [Fact]
+        public async Task ReadFramedBreakpointAsync_Batch()
+        {
+            var server = new BreakpointServer(_pipeMock.Object, Constants.LengthPrefixedPipeProtocolVersion);
+            var breakpoint1 = new Breakpoint
+            {
+                Id = "some-id-1"
+            };
+            var breakpoint2 = new Breakpoint
+            {
+                Id = "some-id-2"
+            };
+            var breakpoint3 = new Breakpoint
+            {
+                Id = "some-id-3"
+            };
+
+            // An empty batch is skipped.
+            var frames = CreateBreakpointBatchFrame()
+                .Concat(CreateBreakpointBatchFrame(breakpoint1, breakpoint2))
+                .Concat(CreateBreakpointFrame(breakpoint3)).ToArray();
+            _pipeMock.Setup(p => p.ReadAsync(_cts.Token)).Returns(Task.FromResult(frames));
+
+            Assert.Equal(breakpoint1, await server.ReadBreakpointAsync(_cts.Token));
+            Assert.Equal(breakpoint2, await server.ReadBreakpointAsync(_cts.Token));
+            Assert.Equal(breakpoint3, await server.ReadBreakpointAsync(_cts.Token));
+            _pipeMock.Verify(p => p.ReadAsync(_cts.Token), Times.Once());
+        }
+
+        [Fact]
+        public async Task ReadFramedBreakpointAsync_TruncatedBatch()
+        {
+            var server = new BreakpointServer(_pipeMock.Object, Constants.LengthPrefixedPipeProtocolVersion);
+            var frame = CreateBreakpointBatchFrame(new Breakpoint { Id = "some-id" });
+
+            // Make the breakpoint inside the batch longer than the batch.
+            frame[Constants.BreakpointFrameHeaderSize] += 1;
+            _pipeMock.Setup(p => p.ReadAsync(_cts.Token)).Returns(Task.FromResult(frame));
+
+            await Assert.ThrowsAsync<InvalidOperationException>
+                (async () => await server.ReadBreakpointAsync(_cts.Token));
+        }
+
+        [Fact]
+        public void WriteFramedBreakpointsAsync()
+        {
+            var server = new BreakpointServer(_pipeMock.Object, Constants.LengthPrefixedPipeProtocolVersion);
+            var breakpoint1 = new Breakpoint
+            {
+                Id = "some-id-1"
+            };
+            var breakpoint2 = new Breakpoint
+            {
+                Id = "some-id-2",
+                Activated = true
+            };
+
+            var frame = CreateBreakpointBatchFrame(breakpoint1, breakpoint2);
+            _pipeMock.Setup(p => p.WriteAsync(It.Is<byte[]>(bytes => bytes.SequenceEqual(frame)), _cts.Token));
+            server.WriteBreakpointsAsync(new[] { breakpoint1, breakpoint2 }, _cts.Token);
+            _pipeMock.VerifyAll();
+            _pipeMock.Verify(p => p.WriteAsync(It.IsAny<byte[]>(), _cts.Token), Times.Once());
+        }
+
+        [Fact]
+        public void WriteBreakpointsAsync_MarkerProtocol()
+        {
+            var breakpoints = new[] { new Breakpoint { Id = "some-id-1" }, new Breakpoint { Id = "some-id-2" } };
+            _pipeMock.Setup(p => p.WriteAsync(It.IsAny<byte[]>(), _cts.Token)).Returns(Task.FromResult(true));
+            _server.WriteBreakpointsAsync(breakpoints, _cts.Token).Wait();
+            _pipeMock.Verify(p => p.WriteAsync(It.IsAny<byte[]>(), _cts.Token), Times.Exactly(2));
+        }
+
+        private byte[] CreateBreakpointBatchFrame(params Breakpoint[] breakpoints)
+        {
+            List<byte> message = new List<byte>();
+            foreach (var breakpoint in breakpoints)
+            {
+                var breakpointBytes = breakpoint.ToByteArray();
+                for (int i = 0; i < 4; i++)
+                {
+                    message.Add((byte)(breakpointBytes.Length >> (8 * i)));
+                }
+                message.AddRange(breakpointBytes);
+            }
+
+            List<byte> bytes = new List<byte>();
+            bytes.AddRange(Constants.BreakpointBatchFrameMagic);
+            for (int i = 0; i < 4; i++)
+            {
+                bytes.Add((byte)(message.Count >> (8 * i)));
+            }
+            bytes.AddRange(message);
+            return bytes.ToArray();
+        }
+
+        private byte[] CreateBreakpointFrame(Breakpoint breakpoint)
+        {
+            var message = breakpoint.ToByteArray();
+            List<byte> bytes = new List<byte>();
+            bytes.AddRange(Constants.BreakpointFrameMagic);
+            for (int i = 0; i < 4; i++)
+            {
+                bytes.Add((byte)(message.Length >> (8 * i)));
+            }
+            bytes.AddRange(message);
+            return bytes.ToArray();
+        }
+
         private byte[] CreateBreakpointMessage(Breakpoint breakpoint)
         {
             List<byte> bytes = new List<byte>();
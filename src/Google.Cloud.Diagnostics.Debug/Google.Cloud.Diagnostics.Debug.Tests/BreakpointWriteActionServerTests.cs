@@ -41,8 +41,8 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
             _server = new BreakpointWriteActionServer(_mockBreakpointServer.Object,
                 _cts, _mockDebuggerClient.Object, _breakpointManager);
 
-            _mockBreakpointServer.Setup(s => s.WriteBreakpointAsync(
-                It.IsAny<Breakpoint>(), It.IsAny<CancellationToken>()))
+            _mockBreakpointServer.Setup(s => s.WriteBreakpointsAsync(
+                It.IsAny<IList<Breakpoint>>(), It.IsAny<CancellationToken>()))
                     .Returns(Task.FromResult(true));
         }
 
@@ -55,8 +55,8 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
 
             _mockDebuggerClient.Verify(c => c.ListBreakpoints(), Times.Once);
             _mockDebuggerClient.Verify(c => c.UpdateBreakpoint(It.IsAny<StackdriverBreakpoint>()), Times.Never);
-            _mockBreakpointServer.Verify(s => s.WriteBreakpointAsync(
-                It.IsAny<Breakpoint>(), It.IsAny<CancellationToken>()), Times.Never);
+            _mockBreakpointServer.Verify(s => s.WriteBreakpointsAsync(
+                It.IsAny<IList<Breakpoint>>(), It.IsAny<CancellationToken>()), Times.Never);
         }
 
         [Fact]
@@ -68,8 +68,8 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
 
             _mockDebuggerClient.Verify(c => c.ListBreakpoints(), Times.Once);
             _mockDebuggerClient.Verify(c => c.UpdateBreakpoint(It.IsAny<StackdriverBreakpoint>()), Times.Never);
-            _mockBreakpointServer.Verify(s => s.WriteBreakpointAsync(
-                It.IsAny<Breakpoint>(), It.IsAny<CancellationToken>()), Times.Never);
+            _mockBreakpointServer.Verify(s => s.WriteBreakpointsAsync(
+                It.IsAny<IList<Breakpoint>>(), It.IsAny<CancellationToken>()), Times.Never);
         }
 
         [Fact]
@@ -81,8 +81,8 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
 
             _mockDebuggerClient.Verify(c => c.ListBreakpoints(), Times.Once);
             _mockDebuggerClient.Verify(c => c.UpdateBreakpoint(It.IsAny<StackdriverBreakpoint>()), Times.Never);
-            _mockBreakpointServer.Verify(s => s.WriteBreakpointAsync(
-                breakpoints.Single().Convert(), It.IsAny<CancellationToken>()), Times.Once);
+            _mockBreakpointServer.Verify(s => s.WriteBreakpointsAsync(
+                new[] { breakpoints.Single().Convert() }, It.IsAny<CancellationToken>()), Times.Once);
         }
 
         [Fact]
@@ -95,8 +95,8 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
 
             _mockDebuggerClient.Verify(c => c.ListBreakpoints(), Times.Once);
             _mockDebuggerClient.Verify(c => c.UpdateBreakpoint(It.IsAny<StackdriverBreakpoint>()), Times.Never);
-            _mockBreakpointServer.Verify(s => s.WriteBreakpointAsync(
-                breakpoints.Single().Convert(), It.IsAny<CancellationToken>()), Times.Once);
+            _mockBreakpointServer.Verify(s => s.WriteBreakpointsAsync(
+                new[] { breakpoints.Single().Convert() }, It.IsAny<CancellationToken>()), Times.Once);
         }
 
         [Fact]
@@ -112,8 +112,8 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
             _mockDebuggerClient.Verify(c => c.ListBreakpoints(), Times.Exactly(2));
             _mockDebuggerClient.Verify(c => c.UpdateBreakpoint(It.IsAny<StackdriverBreakpoint>()), Times.Never);
             breakpoints.Single().IsFinalState = true;
-            _mockBreakpointServer.Verify(s => s.WriteBreakpointAsync(
-                breakpoints.Single().Convert(), It.IsAny<CancellationToken>()), Times.Once);
+            _mockBreakpointServer.Verify(s => s.WriteBreakpointsAsync(
+                new[] { breakpoints.Single().Convert() }, It.IsAny<CancellationToken>()), Times.Once);
         }
 
         [Fact]
@@ -124,17 +124,21 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
             _mockDebuggerClient.Setup(c => c.ListBreakpoints()).Returns(breakpoints);
             _server.MainAction();
 
-            _mockBreakpointServer.Verify(s => s.WriteBreakpointAsync(
-                It.IsAny<Breakpoint>(), It.IsAny<CancellationToken>()), Times.Exactly(5));
+            _mockBreakpointServer.Verify(s => s.WriteBreakpointsAsync(
+                Match.Create((IList<Breakpoint> b) => b.Count == 5), It.IsAny<CancellationToken>()), Times.Once);
 
             _mockDebuggerClient.Reset();
             _mockBreakpointServer.Reset();
+            _mockBreakpointServer.Setup(s => s.WriteBreakpointsAsync(
+                It.IsAny<IList<Breakpoint>>(), It.IsAny<CancellationToken>()))
+                    .Returns(Task.FromResult(true));
             _mockDebuggerClient.Setup(c => c.ListBreakpoints()).Returns(breakpoints.GetRange(4, 1));
             _server.MainAction();
 
             _mockDebuggerClient.Verify(c => c.UpdateBreakpoint(It.IsAny<StackdriverBreakpoint>()), Times.Never);
-            _mockBreakpointServer.Verify(s => s.WriteBreakpointAsync(
-                Match.Create((Breakpoint b) => !b.Activated), It.IsAny<CancellationToken>()), Times.Exactly(4));
+            _mockBreakpointServer.Verify(s => s.WriteBreakpointsAsync(
+                Match.Create((IList<Breakpoint> b) => b.Count == 4 && b.All(bp => !bp.Activated)),
+                It.IsAny<CancellationToken>()), Times.Once);
         }
 
         /// <summary>
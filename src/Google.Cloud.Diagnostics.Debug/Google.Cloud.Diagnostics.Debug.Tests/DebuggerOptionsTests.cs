@@ -36,6 +36,7 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
             Assert.Null(options.ApplicationStartCommand);
             Assert.Equal(_processId, options.ApplicationId);
             Assert.StartsWith(Constants.PipeName, options.PipeName);
+            Assert.Equal(Constants.LengthPrefixedPipeProtocolVersion, options.PipeProtocolVersion);
         }
 
         [Fact]
@@ -101,6 +102,9 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
 
             Assert.Contains($"{DebuggerOptions.PipeNameOption}={Constants.PipeName}", optionsString);
             Assert.Contains($"{DebuggerOptions.ApplicationIdOption}={_processId}", optionsString);
+            Assert.Contains(
+                $"{DebuggerOptions.PipeProtocolVersionOption}={Constants.LengthPrefixedPipeProtocolVersion}",
+                optionsString);
             Assert.Contains($"{DebuggerOptions.PropertyEvaluationOption}", optionsString);
             Assert.Contains($"{DebuggerOptions.MethodEvaluationOption}", optionsString);
             Assert.DoesNotContain(DebuggerOptions.ApplicationStartCommandOption, optionsString);
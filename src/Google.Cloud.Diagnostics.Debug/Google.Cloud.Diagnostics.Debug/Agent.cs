@@ -96,7 +96,8 @@ namespace Google.Cloud.Diagnostics.Debug
             TaskCompletionSource<bool> tcs = new TaskCompletionSource<bool>();
             new Thread(() =>
             {
-                var breakpointServer = new BreakpointServer(new NamedPipeServer(_debuggerOptions.PipeName));
+                var breakpointServer = new BreakpointServer(
+                    new NamedPipeServer(_debuggerOptions.PipeName), _debuggerOptions.PipeProtocolVersion);
                 using (var server = new BreakpointWriteActionServer(breakpointServer, _cts, _debuggerClient, _breakpointManager))
                 {
                     TryAction(() =>
@@ -125,7 +126,8 @@ namespace Google.Cloud.Diagnostics.Debug
             TaskCompletionSource<bool> tcs = new TaskCompletionSource<bool>();
             new Thread(() =>
             {
-                var breakpointServer = new BreakpointServer(new NamedPipeServer(_debuggerOptions.PipeName));
+                var breakpointServer = new BreakpointServer(
+                    new NamedPipeServer(_debuggerOptions.PipeName), _debuggerOptions.PipeProtocolVersion);
                 using (var server = new BreakpointReadActionServer(
                     breakpointServer, _cts, _debuggerClient, _loggingClient, _breakpointManager))
                 {
@@ -15,6 +15,7 @@
 using Google.Protobuf;
 using System;
 using System.Collections.Generic;
+using System.IO;
 using System.Linq;
 using System.Threading;
 using System.Threading.Tasks;
@@ -32,14 +33,39 @@ namespace Google.Cloud.Diagnostics.Debug
         /// <summary>A buffer to store partial breakpoint messages.</summary>
         private List<byte> _buffer = new List<byte>();
 
+        /// <summary>
+        /// A buffer to store partial length-prefixed breakpoint frames. The unread
+        /// bytes are between <see cref="_frameStart"/> and <see cref="_frameEnd"/>.
+        /// </summary>
+        private byte[] _frameBuffer = new byte[Constants.BufferSize];
+
+        /// <summary>The index of the first unread byte in <see cref="_frameBuffer"/>.</summary>
+        private int _frameStart;
+
+        /// <summary>The index after the last unread byte in <see cref="_frameBuffer"/>.</summary>
+        private int _frameEnd;
+
+        /// <summary>Breakpoints of a batch frame that have not been returned yet.</summary>
+        private readonly Queue<Breakpoint> _batchBreakpoints = new Queue<Breakpoint>();
+
         /// <summary>The pipe to send and receive breakpoint messages with.</summary>
         private readonly INamedPipeServer _pipe;
 
+        /// <summary>The version of the pipe protocol used to frame breakpoint messages.</summary>
+        private readonly int _protocolVersion;
+
         /// <summary>
         /// Create a <see cref="BreakpointServer"/>.
         /// </summary>
         /// <param name="pipe">The named pipe to send and receive breakpoint messages with.</param>
-        public BreakpointServer(INamedPipeServer pipe) =>_pipe = pipe;
+        /// <param name="protocolVersion">The version of the pipe protocol negotiated with the debugger.
+        /// Either <see cref="Constants.MarkerPipeProtocolVersion"/> or
+        /// <see cref="Constants.LengthPrefixedPipeProtocolVersion"/>.</param>
+        public BreakpointServer(INamedPipeServer pipe, int protocolVersion = Constants.MarkerPipeProtocolVersion)
+        {
+            _pipe = pipe;
+            _protocolVersion = protocolVersion;
+        }
 
         /// <inheritdoc />
         public Task WaitForConnectionAsync() => _pipe.WaitForConnectionAsync();
@@ -50,6 +76,11 @@ namespace Google.Cloud.Diagnostics.Debug
             await _semaphore.WaitAsync(cancellationToken).ConfigureAwait(false);
             try
             {
+                if (_protocolVersion == Constants.LengthPrefixedPipeProtocolVersion)
+                {
+                    return await ReadFramedBreakpointAsync(cancellationToken).ConfigureAwait(false);
+                }
+
                 List<byte> previousBuffer = _buffer;
                 _buffer = new List<byte>();
 
@@ -85,14 +116,197 @@ namespace Google.Cloud.Diagnostics.Debug
             }
         }
 
+        /// <summary>
+        /// Reads a length-prefixed breakpoint frame. The message is parsed directly
+        /// from <see cref="_frameBuffer"/>. The breakpoints of a batch frame are
+        /// returned one by one, and an empty batch frame is skipped.
+        /// </summary>
+        private async Task<Breakpoint> ReadFramedBreakpointAsync(CancellationToken cancellationToken)
+        {
+            while (true)
+            {
+                if (_batchBreakpoints.Count > 0)
+                {
+                    return _batchBreakpoints.Dequeue();
+                }
+
+                int available = _frameEnd - _frameStart;
+                if (available >= Constants.BreakpointFrameHeaderSize)
+                {
+                    bool isBatch = Match(_frameBuffer, _frameStart, Constants.BreakpointBatchFrameMagic);
+                    if (!isBatch && !Match(_frameBuffer, _frameStart, Constants.BreakpointFrameMagic))
+                    {
+                        throw new InvalidOperationException("Invalid breakpoint frame.");
+                    }
+
+                    uint messageSize = ReadUInt32(_frameBuffer, _frameStart + Constants.BreakpointFrameMagic.Length);
+                    if (messageSize > Constants.MaximumBreakpointFrameSize)
+                    {
+                        throw new InvalidOperationException($"Breakpoint frame of {messageSize} bytes is too large.");
+                    }
+
+                    if (available - Constants.BreakpointFrameHeaderSize >= messageSize)
+                    {
+                        int messageStart = _frameStart + Constants.BreakpointFrameHeaderSize;
+                        _frameStart += Constants.BreakpointFrameHeaderSize + (int)messageSize;
+                        if (!isBatch)
+                        {
+                            var breakpoint = Breakpoint.Parser.ParseFrom(
+                                new CodedInputStream(_frameBuffer, messageStart, (int)messageSize));
+                            ResetFrameBufferIfEmpty();
+                            return breakpoint;
+                        }
+
+                        ParseBatchFrame(messageStart, (int)messageSize);
+                        ResetFrameBufferIfEmpty();
+                        continue;
+                    }
+                }
+
+                AppendToFrameBuffer(await _pipe.ReadAsync(cancellationToken).ConfigureAwait(false));
+            }
+        }
+
+        /// <summary>
+        /// Parses the breakpoints of a batch frame message in <see cref="_frameBuffer"/>
+        /// into <see cref="_batchBreakpoints"/>.
+        /// </summary>
+        private void ParseBatchFrame(int messageStart, int messageSize)
+        {
+            int position = messageStart;
+            int end = messageStart + messageSize;
+            while (position != end)
+            {
+                if (end - position < 4)
+                {
+                    throw new InvalidOperationException("Truncated breakpoint batch frame.");
+                }
+
+                uint breakpointSize = ReadUInt32(_frameBuffer, position);
+                position += 4;
+                if (breakpointSize > end - position)
+                {
+                    throw new InvalidOperationException("Truncated breakpoint batch frame.");
+                }
+
+                _batchBreakpoints.Enqueue(Breakpoint.Parser.ParseFrom(
+                    new CodedInputStream(_frameBuffer, position, (int)breakpointSize)));
+                position += (int)breakpointSize;
+            }
+        }
+
+        /// <summary>
+        /// Moves back to the start of <see cref="_frameBuffer"/> once all of it is read.
+        /// </summary>
+        private void ResetFrameBufferIfEmpty()
+        {
+            if (_frameStart == _frameEnd)
+            {
+                _frameStart = 0;
+                _frameEnd = 0;
+            }
+        }
+
+        /// <summary>
+        /// Appends bytes to the unread bytes of <see cref="_frameBuffer"/>, moving the
+        /// unread bytes to the front or growing the buffer if they do not fit.
+        /// </summary>
+        private void AppendToFrameBuffer(byte[] bytes)
+        {
+            if (_frameEnd + bytes.Length > _frameBuffer.Length)
+            {
+                int unread = _frameEnd - _frameStart;
+                byte[] destination = _frameBuffer;
+                if (unread + bytes.Length > _frameBuffer.Length)
+                {
+                    destination = new byte[Math.Max(unread + bytes.Length, _frameBuffer.Length * 2)];
+                }
+                Buffer.BlockCopy(_frameBuffer, _frameStart, destination, 0, unread);
+                _frameBuffer = destination;
+                _frameStart = 0;
+                _frameEnd = unread;
+            }
+            Buffer.BlockCopy(bytes, 0, _frameBuffer, _frameEnd, bytes.Length);
+            _frameEnd += bytes.Length;
+        }
+
         /// <inheritdoc />
         public Task WriteBreakpointAsync(Breakpoint breakpoint, CancellationToken cancellationToken = default(CancellationToken))
         {
-            List<byte> bytes = new List<byte>();
-            bytes.AddRange(Constants.StartBreakpointMessage);
-            bytes.AddRange(breakpoint.ToByteArray());
-            bytes.AddRange(Constants.EndBreakpointMessage);
-            return _pipe.WriteAsync(bytes.ToArray(), cancellationToken);
+            int messageSize = breakpoint.CalculateSize();
+            byte[] bytes;
+            int messageStart;
+            if (_protocolVersion == Constants.LengthPrefixedPipeProtocolVersion)
+            {
+                bytes = new byte[Constants.BreakpointFrameHeaderSize + messageSize];
+                Buffer.BlockCopy(Constants.BreakpointFrameMagic, 0, bytes, 0, Constants.BreakpointFrameMagic.Length);
+                WriteUInt32(bytes, Constants.BreakpointFrameMagic.Length, (uint)messageSize);
+                messageStart = Constants.BreakpointFrameHeaderSize;
+            }
+            else
+            {
+                bytes = new byte[Constants.StartBreakpointMessage.Length + messageSize +
+                    Constants.EndBreakpointMessage.Length];
+                Buffer.BlockCopy(Constants.StartBreakpointMessage, 0, bytes, 0, Constants.StartBreakpointMessage.Length);
+                Buffer.BlockCopy(Constants.EndBreakpointMessage, 0, bytes, bytes.Length - Constants.EndBreakpointMessage.Length,
+                    Constants.EndBreakpointMessage.Length);
+                messageStart = Constants.StartBreakpointMessage.Length;
+            }
+
+            // Serialize the breakpoint in place rather than into a separate array.
+            using (var stream = new MemoryStream(bytes, messageStart, messageSize))
+            {
+                breakpoint.WriteTo(stream);
+            }
+            return _pipe.WriteAsync(bytes, cancellationToken);
+        }
+
+        /// <inheritdoc />
+        public async Task WriteBreakpointsAsync(IList<Breakpoint> breakpoints,
+            CancellationToken cancellationToken = default(CancellationToken))
+        {
+            if (_protocolVersion != Constants.LengthPrefixedPipeProtocolVersion)
+            {
+                // The marker protocol has no batches.
+                foreach (var breakpoint in breakpoints)
+                {
+                    await WriteBreakpointAsync(breakpoint, cancellationToken).ConfigureAwait(false);
+                }
+                return;
+            }
+
+            int[] sizes = breakpoints.Select(b => b.CalculateSize()).ToArray();
+            int messageSize = sizes.Sum(size => 4 + size);
+            byte[] bytes = new byte[Constants.BreakpointFrameHeaderSize + messageSize];
+            Buffer.BlockCopy(Constants.BreakpointBatchFrameMagic, 0, bytes, 0, Constants.BreakpointBatchFrameMagic.Length);
+            WriteUInt32(bytes, Constants.BreakpointBatchFrameMagic.Length, (uint)messageSize);
+
+            // Serialize every breakpoint in place after its size.
+            int position = Constants.BreakpointFrameHeaderSize;
+            for (int i = 0; i < sizes.Length; i++)
+            {
+                WriteUInt32(bytes, position, (uint)sizes[i]);
+                position += 4;
+                using (var stream = new MemoryStream(bytes, position, sizes[i]))
+                {
+                    breakpoints[i].WriteTo(stream);
+                }
+                position += sizes[i];
+            }
+            await _pipe.WriteAsync(bytes, cancellationToken).ConfigureAwait(false);
+        }
+
+        /// <summary>Reads a little-endian 32 bit unsigned integer at index of bytes.</summary>
+        private static uint ReadUInt32(byte[] bytes, int index) =>
+            (uint)(bytes[index] | (bytes[index + 1] << 8) | (bytes[index + 2] << 16) | (bytes[index + 3] << 24));
+
+        /// <summary>Writes value as a little-endian 32 bit unsigned integer at index of bytes.</summary>
+        private static void WriteUInt32(byte[] bytes, int index, uint value)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                bytes[index + i] = (byte)(value >> (8 * i));
+            }
         }
 
         /// <summary>
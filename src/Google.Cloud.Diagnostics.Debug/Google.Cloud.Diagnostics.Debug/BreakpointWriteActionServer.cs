@@ -13,6 +13,7 @@
 // limitations under the License.
 
 using Google.Api.Gax;
+using System.Collections.Generic;
 using System.Threading;
 
 namespace Google.Cloud.Diagnostics.Debug
@@ -45,6 +46,7 @@ namespace Google.Cloud.Diagnostics.Debug
         /// Lists breakpoints from the debugger API.  Stale breakpoints are removed,
         /// new breakpoints are sent to the <see cref="IBreakpointServer"/> and 
         /// breakpoints that cannot be processed are returned with an error.
+        /// The removed and new breakpoints are sent as one batch.
         /// </summary>
         internal override void MainAction()
         {
@@ -55,16 +57,22 @@ namespace Google.Cloud.Diagnostics.Debug
             }
             var bpmResponse = _breakpointManager.UpdateBreakpoints(serverBreakpoints);
 
+            var breakpoints = new List<Breakpoint>();
             foreach (var breakpointToBeRemoved in bpmResponse.Removed)
             {
                 var breakpoint = breakpointToBeRemoved.Convert();
                 breakpoint.Activated = false;
-                _server.WriteBreakpointAsync(breakpoint).Wait();
+                breakpoints.Add(breakpoint);
             }
 
             foreach (var breakpoint in bpmResponse.New)
             {
-                _server.WriteBreakpointAsync(breakpoint.Convert()).Wait();
+                breakpoints.Add(breakpoint.Convert());
+            }
+
+            if (breakpoints.Count > 0)
+            {
+                _server.WriteBreakpointsAsync(breakpoints).Wait();
             }
         }
     }
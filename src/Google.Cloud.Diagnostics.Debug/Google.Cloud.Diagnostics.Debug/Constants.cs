@@ -29,5 +29,34 @@ namespace Google.Cloud.Diagnostics.Debug
 
         /// <summary>The end of a breakpoint message.</summary>
         public static readonly byte[] EndBreakpointMessage = Encoding.ASCII.GetBytes("END_DEBUG_MESSAGE");
+
+        /// <summary>
+        /// Pipe protocol version where a breakpoint message is surrounded by
+        /// <see cref="StartBreakpointMessage"/> and <see cref="EndBreakpointMessage"/>.
+        /// </summary>
+        public const int MarkerPipeProtocolVersion = 1;
+
+        /// <summary>
+        /// Pipe protocol version where a breakpoint message is a frame made of
+        /// <see cref="BreakpointFrameMagic"/>, the size of the message as a
+        /// little-endian 32 bit integer and the message itself.
+        /// </summary>
+        public const int LengthPrefixedPipeProtocolVersion = 2;
+
+        /// <summary>The first bytes of a length-prefixed breakpoint frame.</summary>
+        public static readonly byte[] BreakpointFrameMagic = Encoding.ASCII.GetBytes("GCDF");
+
+        /// <summary>
+        /// The first bytes of a length-prefixed frame that carries a batch of breakpoints
+        /// instead of one. Each breakpoint in the frame is stored as its size as a
+        /// little-endian 32 bit integer followed by the message.
+        /// </summary>
+        public static readonly byte[] BreakpointBatchFrameMagic = Encoding.ASCII.GetBytes("GCDB");
+
+        /// <summary>The size of the header (magic and message size) of a length-prefixed breakpoint frame.</summary>
+        public const int BreakpointFrameHeaderSize = 8;
+
+        /// <summary>Length-prefixed breakpoint frames with a larger message are treated as corrupted (16 MB).</summary>
+        public const int MaximumBreakpointFrameSize = 16 * 1024 * 1024;
     }
 }
@@ -36,6 +36,9 @@ namespace Google.Cloud.Diagnostics.Debug
         // The name of the pipe the debugger will attach to.
         public const string PipeNameOption = "--pipe-name";
 
+        // The version of the protocol the debugger will use to exchange breakpoints over the pipe.
+        public const string PipeProtocolVersionOption = "--pipe-protocol-version";
+
         /// <summary>
         /// If true, the debugger will evaluate properties.
         /// </summary>
@@ -62,6 +65,12 @@ namespace Google.Cloud.Diagnostics.Debug
         /// </summary>
         public string PipeName { get; private set; }
 
+        /// <summary>
+        /// The version of the protocol the debugger and the <see cref="Agent"/>
+        /// will use to exchange breakpoints over the pipe.
+        /// </summary>
+        public int PipeProtocolVersion { get; private set; }
+
         /// <summary>
         /// Create <see cref="DebuggerOptions"/> from <see cref="AgentOptions"/>.
         /// </summary>
@@ -80,7 +89,8 @@ namespace Google.Cloud.Diagnostics.Debug
                 MethodEvaluation = options.MethodEvaluation,
                 ApplicationStartCommand = options.ApplicationStartCommand,
                 ApplicationId = options.ApplicationId,
-                PipeName = CreatePipeName()
+                PipeName = CreatePipeName(),
+                PipeProtocolVersion = Constants.LengthPrefixedPipeProtocolVersion
             };
         }
 
@@ -101,6 +111,12 @@ namespace Google.Cloud.Diagnostics.Debug
                 options += $"{PipeNameOption}={PipeName} ";
             }
 
+            // The debugger uses the marker protocol unless told otherwise.
+            if (PipeProtocolVersion > Constants.MarkerPipeProtocolVersion)
+            {
+                options += $"{PipeProtocolVersionOption}={PipeProtocolVersion} ";
+            }
+
             if (ApplicationId.HasValue)
             {
                 options += $"{ApplicationIdOption}={ApplicationId} ";
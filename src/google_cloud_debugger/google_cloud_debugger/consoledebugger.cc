@@ -4,10 +4,12 @@
 // TODO: Add cleanup to release pointer.
 
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "constants.h"
 #include "debugger.h"
 #include "optionparser.h"
 #include "string_stream_wrapper.h"
@@ -15,6 +17,8 @@
 
 using google_cloud_debugger::ConvertStringToWCharPtr;
 using google_cloud_debugger::Debugger;
+using google_cloud_debugger::kLengthPrefixedPipeProtocolVersion;
+using google_cloud_debugger::kMarkerPipeProtocolVersion;
 using std::cerr;
 using std::cin;
 using std::endl;
@@ -39,13 +43,23 @@ const string kApplicationIDOption = "application-id";
 // The name of the pipe the debugger will use to communicate with the agent.
 const string kPipeNameOption = "pipe-name";
 
+// If given this option, the debugger will cache the indices of PDB files
+// in this directory and reuse them the next time it starts.
+const string kSymbolCacheDirOption = "symbol-cache-dir";
+
+// The version of the protocol the debugger will use to exchange breakpoints
+// with the agent over the pipe.
+const string kPipeProtocolVersionOption = "pipe-protocol-version";
+
 enum optionIndex {
   UNKNOWN,
   APPLICATIONSTARTCOMMAND,
   APPLICATIONID,
   PROPERTYEVALUATION,
   METHODEVALUATION,
-  PIPENAME
+  PIPENAME,
+  SYMBOLCACHEDIR,
+  PIPEPROTOCOLVERSION
 };
 const option::Descriptor usage[] = {
     // The first dummy Descriptor is used for unknown options,
@@ -74,6 +88,16 @@ const option::Descriptor usage[] = {
     {PIPENAME, 0, "", kPipeNameOption.c_str(), option::Arg::Optional,
      "  --pipe-name  \tThe name of the pipe the debugger will use to"
      "communicate with the agent."},
+    {SYMBOLCACHEDIR, 0, "", kSymbolCacheDirOption.c_str(),
+     option::Arg::Optional,
+     "  --symbol-cache-dir  \tAn existing directory the debugger will cache "
+     "the indices of PDB files in. If used, PDB files that did not change "
+     "since the last time the debugger started are not parsed again."},
+    {PIPEPROTOCOLVERSION, 0, "", kPipeProtocolVersionOption.c_str(),
+     option::Arg::Optional,
+     "  --pipe-protocol-version  \tThe version of the protocol used to "
+     "exchange breakpoints with the agent. 1 surrounds each breakpoint with "
+     "start and end markers, 2 prefixes it with its length. Defaults to 1."},
     {0, 0, 0, 0, 0, 0}  // Needs this, otherwise the parser throws error.
 };
 
@@ -125,6 +149,30 @@ int main(int argc, char *argv[]) {
   Debugger debugger(pipe_name);
   HRESULT hr;
 
+  if (options[SYMBOLCACHEDIR].count() && options[SYMBOLCACHEDIR].arg) {
+    debugger.SetSymbolCacheDirectory(string(options[SYMBOLCACHEDIR].arg));
+  }
+
+  if (options[PIPEPROTOCOLVERSION].count() &&
+      options[PIPEPROTOCOLVERSION].arg) {
+    try {
+      int protocol_version = stoi(string(options[PIPEPROTOCOLVERSION].arg));
+      if (protocol_version != kMarkerPipeProtocolVersion &&
+          protocol_version != kLengthPrefixedPipeProtocolVersion) {
+        cerr << "Pipe protocol version " << protocol_version
+             << " is not supported.";
+        return -1;
+      }
+      debugger.SetPipeProtocolVersion(protocol_version);
+    } catch (std::invalid_argument &ex) {
+      cerr << "Pipe protocol version is not a valid number.";
+      return -1;
+    } catch (std::out_of_range &ex) {
+      cerr << "Pipe protocol version is not a valid number.";
+      return -1;
+    }
+  }
+
   if (options[APPLICATIONSTARTCOMMAND].count()) {
     string command_line = string(options[APPLICATIONSTARTCOMMAND].arg);
     std::vector<WCHAR> wchar_command_line =
@@ -14,18 +14,39 @@
 
 #include "breakpoint_client.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "constants.h"
 
 using std::cerr;
 using std::string;
+using std::vector;
 using namespace google::cloud::diagnostics::debug;
 
+namespace {
+
+// Reads a little-endian uint32 from bytes.
+std::uint32_t ReadUint32(const char *bytes) {
+  const unsigned char *data = reinterpret_cast<const unsigned char *>(bytes);
+  return data[0] | (data[1] << 8) | (data[2] << 16) |
+         (static_cast<std::uint32_t>(data[3]) << 24);
+}
+
+// Writes value to bytes as a little-endian uint32.
+void WriteUint32(std::uint32_t value, char *bytes) {
+  for (int i = 0; i < 4; ++i) {
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+  }
+}
+
+}  // namespace
+
 namespace google_cloud_debugger {
 
-BreakpointClient::BreakpointClient(std::unique_ptr<INamedPipe> pipe)
-    : pipe_(std::move(pipe)) {}
+BreakpointClient::BreakpointClient(std::unique_ptr<INamedPipe> pipe,
+                                   int protocol_version)
+    : pipe_(std::move(pipe)), protocol_version_(protocol_version) {}
 
 HRESULT BreakpointClient::Initialize() { return pipe_->Initialize(); }
 
@@ -35,51 +56,259 @@ HRESULT BreakpointClient::WaitForConnection() {
 
 HRESULT BreakpointClient::ReadBreakpoint(Breakpoint *breakpoint) {
   std::lock_guard<std::mutex> lock(mutex_);
-  string buffer;
-  std::swap(buffer, buffer_);
-  string str;
+  // A batch frame can be empty, in which case the next message is read.
+  while (pending_breakpoints_.empty()) {
+    vector<Breakpoint> breakpoints;
+    bool is_batch = false;
+    HRESULT hr = ReadMessage(&breakpoints, &is_batch);
+    if (FAILED(hr)) {
+      return hr;
+    }
 
+    for (Breakpoint &read_breakpoint : breakpoints) {
+      pending_breakpoints_.emplace_back();
+      pending_breakpoints_.back().Swap(&read_breakpoint);
+    }
+  }
+
+  breakpoint->Swap(&pending_breakpoints_.front());
+  pending_breakpoints_.pop_front();
+  return S_OK;
+}
+
+HRESULT BreakpointClient::ReadMarkerBreakpoint(Breakpoint *breakpoint) {
   // Check if we have a full breakpoint message in the buffer.
   // If so just use it and do not try and read another breakpoint.
-  std::size_t found_end = buffer.find(kEndBreakpointMessage);
-  while (found_end == string::npos) {
-    HRESULT result = pipe_->Read(&str);
+  // Only the bytes that were just read are searched for the end marker.
+  std::size_t searched = 0;
+  const char *found_end = nullptr;
+  while (true) {
+    std::size_t search_start = searched < kEndBreakpointMessage.size()
+                                   ? 0
+                                   : searched - kEndBreakpointMessage.size();
+    const char *end = buffer_.Data() + buffer_.Size();
+    found_end = std::search(buffer_.Data() + search_start, end,
+                            kEndBreakpointMessage.begin(),
+                            kEndBreakpointMessage.end());
+    if (found_end != end) {
+      break;
+    }
+
+    searched = buffer_.Size();
+    HRESULT result = pipe_->ReadInto(&buffer_);
     if (FAILED(result)) {
       return result;
     }
-    buffer += str;
-    str.clear();
-    found_end = buffer.find(kEndBreakpointMessage);
   }
 
   // Ensure we have a start to the breakpoint message.
-  std::size_t found_start = buffer.find(kStartBreakpointMessage);
-  if (found_end == string::npos) {
+  const char *found_start =
+      std::search(buffer_.Data(), found_end, kStartBreakpointMessage.begin(),
+                  kStartBreakpointMessage.end());
+  if (found_start == found_end) {
     cerr << "invalid breakpoint message" << std::endl;
     return E_FAIL;
   }
 
-  string newStr =
-      buffer.substr(found_start + kStartBreakpointMessage.size(),
-                    found_end - found_start - kStartBreakpointMessage.size());
-  buffer_.append(buffer, found_end + kEndBreakpointMessage.size(), string::npos);
+  const char *message = found_start + kStartBreakpointMessage.size();
+  bool parsed = breakpoint->ParseFromArray(message, found_end - message);
+  buffer_.Consume(found_end + kEndBreakpointMessage.size() - buffer_.Data());
 
-  if (!breakpoint->ParseFromString(newStr)) {
+  if (!parsed) {
     cerr << "failed to serialize from protobuf" << std::endl;
     return E_FAIL;
   }
   return S_OK;
 }
 
+HRESULT BreakpointClient::ReadBreakpoints(vector<Breakpoint> *breakpoints,
+                                          bool *is_batch) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!pending_breakpoints_.empty()) {
+    breakpoints->clear();
+    for (Breakpoint &pending_breakpoint : pending_breakpoints_) {
+      breakpoints->emplace_back();
+      breakpoints->back().Swap(&pending_breakpoint);
+    }
+    pending_breakpoints_.clear();
+    *is_batch = true;
+    return S_OK;
+  }
+
+  return ReadMessage(breakpoints, is_batch);
+}
+
+HRESULT BreakpointClient::ReadMessage(vector<Breakpoint> *breakpoints,
+                                      bool *is_batch) {
+  breakpoints->clear();
+  *is_batch = false;
+  if (protocol_version_ != kLengthPrefixedPipeProtocolVersion) {
+    breakpoints->emplace_back();
+    return ReadMarkerBreakpoint(&breakpoints->back());
+  }
+
+  std::uint32_t message_size = 0;
+  HRESULT hr = ReadFrame(is_batch, &message_size);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  if (*is_batch) {
+    hr = ParseBatchFrame(message_size, breakpoints);
+  } else {
+    breakpoints->emplace_back();
+    if (!breakpoints->back().ParseFromArray(
+            buffer_.Data() + kBreakpointFrameHeaderSize, message_size)) {
+      cerr << "failed to serialize from protobuf" << std::endl;
+      hr = E_FAIL;
+    }
+  }
+  buffer_.Consume(kBreakpointFrameHeaderSize + message_size);
+  return hr;
+}
+
+HRESULT BreakpointClient::ReadFrame(bool *is_batch,
+                                    std::uint32_t *message_size) {
+  while (true) {
+    if (buffer_.Size() >= kBreakpointFrameHeaderSize) {
+      if (kBreakpointFrameMagic.compare(0, kBreakpointFrameMagic.size(),
+                                        buffer_.Data(),
+                                        kBreakpointFrameMagic.size()) == 0) {
+        *is_batch = false;
+      } else if (kBreakpointBatchFrameMagic.compare(
+                     0, kBreakpointBatchFrameMagic.size(), buffer_.Data(),
+                     kBreakpointBatchFrameMagic.size()) == 0) {
+        *is_batch = true;
+      } else {
+        cerr << "invalid breakpoint frame" << std::endl;
+        return E_FAIL;
+      }
+
+      *message_size = ReadUint32(buffer_.Data() + kBreakpointFrameMagic.size());
+      if (*message_size > kMaximumBreakpointFrameSize) {
+        cerr << "breakpoint frame of " << *message_size
+             << " bytes is too large" << std::endl;
+        return E_FAIL;
+      }
+
+      if (buffer_.Size() - kBreakpointFrameHeaderSize >= *message_size) {
+        return S_OK;
+      }
+
+      // Makes room for the rest of the frame so it is read with as few
+      // reads as possible.
+      buffer_.PrepareWrite(kBreakpointFrameHeaderSize + *message_size -
+                           buffer_.Size());
+    }
+
+    HRESULT hr = pipe_->ReadInto(&buffer_);
+    if (FAILED(hr)) {
+      return hr;
+    }
+  }
+}
+
+HRESULT BreakpointClient::ParseBatchFrame(std::uint32_t message_size,
+                                          vector<Breakpoint> *breakpoints) {
+  const char *position = buffer_.Data() + kBreakpointFrameHeaderSize;
+  const char *end = position + message_size;
+  while (position != end) {
+    if (end - position < 4) {
+      cerr << "truncated breakpoint batch frame" << std::endl;
+      return E_FAIL;
+    }
+
+    std::uint32_t breakpoint_size = ReadUint32(position);
+    position += 4;
+    if (breakpoint_size > static_cast<std::uint32_t>(end - position)) {
+      cerr << "truncated breakpoint batch frame" << std::endl;
+      return E_FAIL;
+    }
+
+    breakpoints->emplace_back();
+    if (!breakpoints->back().ParseFromArray(position, breakpoint_size)) {
+      cerr << "failed to serialize from protobuf" << std::endl;
+      return E_FAIL;
+    }
+    position += breakpoint_size;
+  }
+
+  return S_OK;
+}
+
 HRESULT BreakpointClient::WriteBreakpoint(const Breakpoint &breakpoint) {
-  string bp_str;
-  if (!breakpoint.SerializeToString(&bp_str)) {
-    cerr << "failed to serialize to protobuf" << std::endl;
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  int message_size = breakpoint.ByteSize();
+
+  // Releases the storage of write_buffer_ if it is much larger than
+  // what breakpoints need, so one large snapshot does not pin it.
+  if (write_buffer_.capacity() >
+          static_cast<std::size_t>(kMaximumPipeReadSize) &&
+      write_buffer_.capacity() / 4 > static_cast<std::size_t>(message_size)) {
+    string().swap(write_buffer_);
+  }
+
+  // Serializes the breakpoint in place, using the size computed above.
+  write_buffer_.resize(message_size);
+  breakpoint.SerializeWithCachedSizesToArray(
+      reinterpret_cast<google::protobuf::uint8 *>(&write_buffer_[0]));
+
+  if (protocol_version_ == kLengthPrefixedPipeProtocolVersion) {
+    SetWriteHeader(kBreakpointFrameMagic, message_size);
+    return pipe_->WriteGather({&write_header_, &write_buffer_});
+  }
+
+  return pipe_->WriteGather(
+      {&kStartBreakpointMessage, &write_buffer_, &kEndBreakpointMessage});
+}
+
+HRESULT BreakpointClient::WriteBreakpoints(
+    const vector<Breakpoint> &breakpoints) {
+  if (protocol_version_ != kLengthPrefixedPipeProtocolVersion) {
+    for (const Breakpoint &breakpoint : breakpoints) {
+      HRESULT hr = WriteBreakpoint(breakpoint);
+      if (FAILED(hr)) {
+        return hr;
+      }
+    }
+    return S_OK;
+  }
+
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  std::size_t message_size = 0;
+  write_sizes_.clear();
+  for (const Breakpoint &breakpoint : breakpoints) {
+    write_sizes_.push_back(breakpoint.ByteSize());
+    message_size += 4 + write_sizes_.back();
+  }
+
+  if (message_size > kMaximumBreakpointFrameSize) {
+    cerr << "breakpoint batch of " << message_size << " bytes is too large"
+         << std::endl;
     return E_FAIL;
   }
-  bp_str.insert(0, kStartBreakpointMessage);
-  bp_str.append(kEndBreakpointMessage);
-  return pipe_->Write(bp_str);
+
+  // Serializes every breakpoint after its size, using the sizes
+  // computed above.
+  write_buffer_.resize(message_size);
+  char *position = message_size == 0 ? nullptr : &write_buffer_[0];
+  for (std::size_t i = 0; i < breakpoints.size(); ++i) {
+    WriteUint32(static_cast<std::uint32_t>(write_sizes_[i]), position);
+    position += 4;
+    breakpoints[i].SerializeWithCachedSizesToArray(
+        reinterpret_cast<google::protobuf::uint8 *>(position));
+    position += write_sizes_[i];
+  }
+
+  SetWriteHeader(kBreakpointBatchFrameMagic, message_size);
+  return pipe_->WriteGather({&write_header_, &write_buffer_});
+}
+
+void BreakpointClient::SetWriteHeader(const string &magic,
+                                      std::uint32_t message_size) {
+  write_header_.assign(magic);
+  write_header_.resize(kBreakpointFrameHeaderSize);
+  WriteUint32(message_size, &write_header_[magic.size()]);
 }
 
 HRESULT BreakpointClient::ShutDown() {
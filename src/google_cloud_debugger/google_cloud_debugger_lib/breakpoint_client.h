@@ -17,20 +17,27 @@
 
 #include <cor.h>
 #include <windef.h>
+#include <deque>
 #include <iostream>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "dbg_breakpoint.h"
 #include "constants.h"
 #include "i_named_pipe.h"
+#include "pipe_receive_buffer.h"
 
 namespace google_cloud_debugger {
 
 class BreakpointClient {
  public:
   // Creates a breakpoint client and accepts a NamedPipeClient.
-  BreakpointClient(std::unique_ptr<INamedPipe> pipe);
+  // protocol_version is the version of the pipe protocol negotiated with
+  // the agent (kMarkerPipeProtocolVersion or
+  // kLengthPrefixedPipeProtocolVersion).
+  BreakpointClient(std::unique_ptr<INamedPipe> pipe,
+                   int protocol_version = kMarkerPipeProtocolVersion);
 
   // Initializes the client and returns an HRESULT.
   HRESULT Initialize();
@@ -43,25 +50,92 @@ class BreakpointClient {
   // Reads a breakpoint from a breakpoint server and
   // returns an HRESULT.  This function will
   // block until there is a breakpoint to read.
+  // If a batch frame is read, its breakpoints are returned one by one
+  // by this and the following calls.
   HRESULT ReadBreakpoint(
       google::cloud::diagnostics::debug::Breakpoint *breakpoint);
 
+  // Reads the next message from the breakpoint server into breakpoints.
+  // If the message is a batch frame, all of its breakpoints are returned
+  // and is_batch is set to true. Otherwise, the one breakpoint read is
+  // returned. This function will block until there is a message to read.
+  // Breakpoints of a batch frame that ReadBreakpoint has not returned
+  // yet are returned first, as a batch.
+  HRESULT ReadBreakpoints(
+      std::vector<google::cloud::diagnostics::debug::Breakpoint> *breakpoints,
+      bool *is_batch);
+
   // Writes a breakpoint to a breakpoint server
   // and returns an HRESULT.
   HRESULT WriteBreakpoint(
       const google::cloud::diagnostics::debug::Breakpoint &breakpoint);
 
+  // Writes breakpoints to a breakpoint server as one batch frame. With
+  // the marker protocol, which has no batches, they are written one by one.
+  HRESULT WriteBreakpoints(
+      const std::vector<google::cloud::diagnostics::debug::Breakpoint>
+          &breakpoints);
+
   // Shuts down the pipe.
   HRESULT ShutDown();
 
  private:
+  // Reads a breakpoint message surrounded by kStartBreakpointMessage and
+  // kEndBreakpointMessage.
+  HRESULT ReadMarkerBreakpoint(
+      google::cloud::diagnostics::debug::Breakpoint *breakpoint);
+
+  // Reads the next message from the breakpoint server into breakpoints.
+  // Both ReadBreakpoint and ReadBreakpoints read through this function
+  // with mutex_ held.
+  HRESULT ReadMessage(
+      std::vector<google::cloud::diagnostics::debug::Breakpoint> *breakpoints,
+      bool *is_batch);
+
+  // Waits until buffer_ starts with a complete length-prefixed frame.
+  // Sets is_batch to whether it is a batch frame and message_size to the
+  // size of what follows the header.
+  HRESULT ReadFrame(bool *is_batch, std::uint32_t *message_size);
+
+  // Parses the breakpoints of a batch frame of message_size bytes at the
+  // start of buffer_ into breakpoints.
+  HRESULT ParseBatchFrame(
+      std::uint32_t message_size,
+      std::vector<google::cloud::diagnostics::debug::Breakpoint> *breakpoints);
+
+  // Sets write_header_ to the header of a frame of message_size bytes
+  // that starts with magic.
+  void SetWriteHeader(const std::string &magic, std::uint32_t message_size);
+
   // The pipe client to send messages.
   std::unique_ptr<INamedPipe> pipe_;
 
-  // A buffer to hold partial breakpoint messages.
-  std::string buffer_;
+  // The version of the pipe protocol used to frame breakpoint messages.
+  int protocol_version_;
+
+  // Holds partial breakpoint messages. Messages are parsed from it
+  // in place.
+  PipeReceiveBuffer buffer_;
+
+  // The serialized breakpoint being written. Reused across writes so
+  // its storage is only reallocated when a breakpoint does not fit.
+  std::string write_buffer_;
+
+  // The header of the length-prefixed frame being written.
+  std::string write_header_;
+
+  // The sizes of the breakpoints of the batch frame being written.
+  std::vector<int> write_sizes_;
+
+  // Mutex to protect write_buffer_, write_header_ and write_sizes_.
+  std::mutex write_mutex_;
+
+  // Breakpoints of a batch frame read by ReadBreakpoint that have not
+  // been returned yet.
+  std::deque<google::cloud::diagnostics::debug::Breakpoint>
+      pending_breakpoints_;
 
-  // Mutex to protect the buffer.
+  // Mutex to protect the buffer and pending_breakpoints_.
   std::mutex mutex_;
 };
 
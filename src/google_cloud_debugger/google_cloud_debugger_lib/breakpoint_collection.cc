@@ -18,6 +18,7 @@
 #include <stdlib.h>
 #include <algorithm>
 #include <iostream>
+#include <unordered_set>
 
 #include "breakpoint_location_collection.h"
 #include "dbg_object.h"
@@ -27,6 +28,7 @@
 
 using google::cloud::diagnostics::debug::Breakpoint;
 using google::cloud::diagnostics::debug::SourceLocation;
+using google_cloud_debugger_portable_pdb::IPortablePdbFile;
 using std::cerr;
 using std::cout;
 using std::string;
@@ -35,6 +37,11 @@ using std::vector;
 
 namespace google_cloud_debugger {
 
+BreakpointCollection::BreakpointCollection()
+    : write_queue_([this](const Breakpoint &breakpoint) {
+        return WriteBreakpoint(breakpoint);
+      }) {}
+
 HRESULT BreakpointCollection::SetDebuggerCallback(
     DebuggerCallback *debugger_callback) {
   if (!debugger_callback) {
@@ -47,7 +54,8 @@ HRESULT BreakpointCollection::SetDebuggerCallback(
 }
 
 HRESULT BreakpointCollection::CreateAndInitializeBreakpointClient(
-    unique_ptr<BreakpointClient> *client, std::string pipe_name) {
+    unique_ptr<BreakpointClient> *client, std::string pipe_name,
+    int protocol_version) {
   if (client == nullptr) {
     return E_INVALIDARG;
   }
@@ -60,7 +68,7 @@ HRESULT BreakpointCollection::CreateAndInitializeBreakpointClient(
   }
 
   unique_ptr<BreakpointClient> result = unique_ptr<BreakpointClient>(
-      new (std::nothrow) BreakpointClient(std::move(pipe)));
+      new (std::nothrow) BreakpointClient(std::move(pipe), protocol_version));
   if (!result) {
     cerr << "Cannot create breakpoint client.";
     return E_OUTOFMEMORY;
@@ -83,35 +91,77 @@ HRESULT BreakpointCollection::CreateAndInitializeBreakpointClient(
   return S_OK;
 }
 
+HRESULT BreakpointCollection::EnsureWriteClient() {
+  std::lock_guard<std::mutex> lock(write_client_mutex_);
+  if (breakpoint_client_write_) {
+    return S_OK;
+  }
+
+  HRESULT hr = CreateAndInitializeBreakpointClient(
+      &breakpoint_client_write_, debugger_callback_->GetPipeName(),
+      debugger_callback_->GetPipeProtocolVersion());
+  if (FAILED(hr)) {
+    cerr << "Failed to initialize breakpoint client for writing breakpoints.";
+  }
+  return hr;
+}
+
 HRESULT BreakpointCollection::WriteBreakpoint(const Breakpoint &breakpoint) {
-  if (!breakpoint_client_write_) {
-    HRESULT hr = CreateAndInitializeBreakpointClient(
-        &breakpoint_client_write_, debugger_callback_->GetPipeName());
-    if (FAILED(hr)) {
-      cerr << "Failed to initialize breakpoint client for writing breakpoints.";
-      return hr;
-    }
+  HRESULT hr = EnsureWriteClient();
+  if (FAILED(hr)) {
+    return hr;
   }
 
   return breakpoint_client_write_->WriteBreakpoint(breakpoint);
 }
 
+HRESULT BreakpointCollection::WriteBreakpoints(
+    const vector<Breakpoint> &breakpoints) {
+  HRESULT hr = EnsureWriteClient();
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  return breakpoint_client_write_->WriteBreakpoints(breakpoints);
+}
+
+HRESULT BreakpointCollection::QueueBreakpoint(
+    Breakpoint *breakpoint, std::chrono::steady_clock::time_point hit_time,
+    std::chrono::steady_clock::time_point resume_time) {
+  return write_queue_.Enqueue(breakpoint, hit_time, resume_time);
+}
+
+void BreakpointCollection::ReuseSnapshot(Breakpoint *snapshot) {
+  write_queue_.ReuseBreakpoint(snapshot);
+}
+
+HRESULT BreakpointCollection::EnsureReadClient() {
+  if (breakpoint_client_read_) {
+    return S_OK;
+  }
+
+  HRESULT hr = CreateAndInitializeBreakpointClient(
+      &breakpoint_client_read_, debugger_callback_->GetPipeName(),
+      debugger_callback_->GetPipeProtocolVersion());
+  if (FAILED(hr)) {
+    cerr << "Failed to initialize breakpoint client for reading breakpoints.";
+  }
+  return hr;
+}
+
 HRESULT BreakpointCollection::ReadBreakpoint(Breakpoint *breakpoint) {
-  if (!breakpoint_client_read_) {
-    HRESULT hr = CreateAndInitializeBreakpointClient(
-        &breakpoint_client_read_, debugger_callback_->GetPipeName());
-    if (FAILED(hr)) {
-      cerr << "Failed to initialize breakpoint client for reading breakpoints.";
-      return hr;
-    }
+  HRESULT hr = EnsureReadClient();
+  if (FAILED(hr)) {
+    return hr;
   }
 
   return breakpoint_client_read_->ReadBreakpoint(breakpoint);
 }
 
 HRESULT BreakpointCollection::EvaluateAndPrintBreakpoint(
-    mdMethodDef function_token, ULONG32 il_offset,
-    IEvalCoordinator *eval_coordinator, ICorDebugThread *debug_thread,
+    CORDB_ADDRESS module_base_address, mdMethodDef function_token,
+    ULONG32 il_offset, IEvalCoordinator *eval_coordinator,
+    ICorDebugThread *debug_thread,
     const std::vector<
         std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
         &pdb_files) {
@@ -119,15 +169,14 @@ HRESULT BreakpointCollection::EvaluateAndPrintBreakpoint(
   std::vector<std::shared_ptr<DbgBreakpoint>> matched_breakpoints;
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto &&kvp : location_to_breakpoints_) {
-      // Since the breakpoints are grouped by location, if
-      // one matches, all of them do.
-      if (kvp.second->GetMethodToken() == function_token
-        && kvp.second->GetILOffset() == il_offset) {
-        matched_breakpoints = kvp.second->GetBreakpoints();
-        break;
-      }
+    // Since the breakpoints are grouped by location, all the breakpoints
+    // in the matching collection are hit.
+    BreakpointHitKey hit_key = {module_base_address, function_token,
+                                il_offset};
+    std::lock_guard<std::mutex> lock(hit_key_mutex_);
+    const auto &location = hit_key_to_breakpoints_.find(hit_key);
+    if (location != hit_key_to_breakpoints_.end()) {
+      matched_breakpoints = location->second->GetBreakpoints();
     }
   }
 
@@ -144,34 +193,56 @@ HRESULT BreakpointCollection::EvaluateAndPrintBreakpoint(
   return hr;
 }
 
-HRESULT BreakpointCollection::ReadAndParseBreakpoint(
-    DbgBreakpoint *breakpoint) {
-  assert(breakpoint != nullptr);
+HRESULT BreakpointCollection::ReadAndParseBreakpoints(
+    vector<DbgBreakpoint> *breakpoints, bool *is_batch) {
+  assert(breakpoints != nullptr);
+
+  HRESULT hr = EnsureReadClient();
+  if (FAILED(hr)) {
+    return hr;
+  }
 
-  Breakpoint breakpoint_read;
-  HRESULT hr = ReadBreakpoint(&breakpoint_read);
+  vector<Breakpoint> breakpoints_read;
+  hr = breakpoint_client_read_->ReadBreakpoints(&breakpoints_read, is_batch);
   if (FAILED(hr)) {
     cerr << "Failed to parse breakpoint.";
     return hr;
   }
 
-  SourceLocation location = breakpoint_read.location();
+  breakpoints->clear();
+  breakpoints->resize(breakpoints_read.size());
+  for (size_t i = 0; i < breakpoints_read.size(); ++i) {
+    const Breakpoint &breakpoint_read = breakpoints_read[i];
+    DbgBreakpoint *breakpoint = &(*breakpoints)[i];
+    SourceLocation location = breakpoint_read.location();
 
-  // For now, we don't have a use for column so we just assign it to 0.
-  breakpoint->Initialize(
-      location.path(), breakpoint_read.id(), location.line(), 0,
-      breakpoint_read.log_point(),
-      breakpoint_read.log_message_format(),
-      breakpoint_read.log_level(),
-      breakpoint_read.condition(),
-      std::vector<std::string>(breakpoint_read.expressions().begin(),
-                               breakpoint_read.expressions().end()));
-  breakpoint->SetActivated(breakpoint_read.activated());
-  breakpoint->SetKillServer(breakpoint_read.kill_server());
+    // For now, we don't have a use for column so we just assign it to 0.
+    breakpoint->Initialize(
+        location.path(), breakpoint_read.id(), location.line(), 0,
+        breakpoint_read.log_point(),
+        breakpoint_read.log_message_format(),
+        breakpoint_read.log_level(),
+        breakpoint_read.condition(),
+        std::vector<std::string>(breakpoint_read.expressions().begin(),
+                                 breakpoint_read.expressions().end()));
+    breakpoint->SetActivated(breakpoint_read.activated());
+    breakpoint->SetKillServer(breakpoint_read.kill_server());
+  }
 
   return S_OK;
 }
 
+vector<std::shared_ptr<IPortablePdbFile>>
+BreakpointCollection::GetPdbFilesParsedFirst() {
+  vector<std::shared_ptr<IPortablePdbFile>> pdb_files =
+      debugger_callback_->GetPdbFiles();
+  std::stable_partition(pdb_files.begin(), pdb_files.end(),
+                        [](const std::shared_ptr<IPortablePdbFile> &pdb_file) {
+                          return pdb_file && pdb_file->ParseAttempted();
+                        });
+  return pdb_files;
+}
+
 HRESULT BreakpointCollection::UpdateBreakpoint(
     const DbgBreakpoint &breakpoint) {
   HRESULT hr;
@@ -194,6 +265,11 @@ HRESULT BreakpointCollection::UpdateBreakpoint(
     }
   }
 
+  // A breakpoint that was never set only has to be forgotten.
+  if (!breakpoint.Activated() && pending_breakpoints_.Remove(breakpoint)) {
+    return S_OK;
+  }
+
   // Otherwise, we have to create a new breakpoint from scratch.
   std::shared_ptr<DbgBreakpoint> new_breakpoint(new (std::nothrow)
                                                     DbgBreakpoint);
@@ -207,11 +283,20 @@ HRESULT BreakpointCollection::UpdateBreakpoint(
   // try to set and activate the breakpoint by searching through PDB files
   // for a matching location.
   bool found_bp = false;
-  for (auto pdb_file : debugger_callback_->GetPdbFiles()) {
+  vector<std::shared_ptr<IPortablePdbFile>> pdb_files =
+      GetPdbFilesParsedFirst();
+  for (auto &pdb_file : pdb_files) {
     if (!pdb_file) {
       continue;
     }
 
+    // Only a PDB file that has a document matching the breakpoint's file
+    // is parsed, or waited on if it is being parsed in the background.
+    if (!pdb_file->ReadDocumentPaths() ||
+        new_breakpoint->FindDocument(*pdb_file) < 0) {
+      continue;
+    }
+
     if (!pdb_file->ParsePdbFile()) {
       continue;
     }
@@ -230,41 +315,390 @@ HRESULT BreakpointCollection::UpdateBreakpoint(
   }
 
   if (!found_bp) {
+    if (breakpoint.Activated()) {
+      hr = AddPendingBreakpoint(breakpoint, pdb_files);
+      if (FAILED(hr)) {
+        cerr << "Failed to add pending breakpoint.";
+        return hr;
+      }
+    }
     return S_FALSE;
   }
 
+  return AddBreakpointLocation(breakpoint.GetBreakpointLocation(),
+                               std::move(new_breakpoint));
+}
+
+HRESULT BreakpointCollection::AddBreakpointLocation(
+    const std::string &breakpoint_location,
+    std::shared_ptr<DbgBreakpoint> breakpoint) {
+  BreakpointHitKey hit_key = {breakpoint->GetModuleBaseAddress(),
+                              breakpoint->GetMethodToken(),
+                              breakpoint->GetILOffset()};
+  std::shared_ptr<BreakpointLocationCollection> bp_location;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto &existing = location_to_breakpoints_.find(breakpoint_location);
+  if (existing != location_to_breakpoints_.end()) {
+    // Another thread added this location after the caller looked it up.
+    bp_location = existing->second;
+  } else {
+    // Locations that are set at the same sequence point share a
+    // collection, so each hit key maps to the breakpoints of all of them.
+    std::lock_guard<std::mutex> hit_key_lock(hit_key_mutex_);
+    const auto &hit = hit_key_to_breakpoints_.find(hit_key);
+    if (hit != hit_key_to_breakpoints_.end()) {
+      bp_location = hit->second;
+    }
+  }
+
+  if (bp_location) {
+    // The ICorDebugBreakpoint of breakpoint is deactivated and breakpoint
+    // joins the existing collection, so the collection that may already
+    // be hit is neither replaced nor freed.
+    CComPtr<ICorDebugBreakpoint> debug_breakpoint;
+    HRESULT hr = breakpoint->GetCorDebugBreakpoint(&debug_breakpoint);
+    if (SUCCEEDED(hr)) {
+      hr = debug_breakpoint->Activate(FALSE);
+    }
+    if (FAILED(hr)) {
+      cerr << "Failed to deactivate duplicate breakpoint at "
+           << breakpoint_location;
+      return hr;
+    }
+
+    hr = bp_location->UpdateBreakpoints(*breakpoint);
+    if (FAILED(hr)) {
+      return hr;
+    }
+
+    location_to_breakpoints_[breakpoint_location] = std::move(bp_location);
+    return hr;
+  }
+
   // Create a new location collection.
+  bp_location.reset(new (std::nothrow) BreakpointLocationCollection());
+  if (!bp_location) {
+    return E_OUTOFMEMORY;
+  }
+
+  HRESULT hr = bp_location->AddFirstBreakpoint(std::move(breakpoint));
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  {
+    std::lock_guard<std::mutex> hit_key_lock(hit_key_mutex_);
+    hit_key_to_breakpoints_[hit_key] = bp_location;
+  }
+
+  location_to_breakpoints_[breakpoint_location] = std::move(bp_location);
+  return S_OK;
+}
+
+HRESULT BreakpointCollection::UpdateBreakpoints(
+    const vector<DbgBreakpoint> &breakpoints, vector<Breakpoint> *errors) {
+  // Records that breakpoint failed to update.
+  auto add_error = [errors](const DbgBreakpoint &breakpoint) {
+    errors->emplace_back();
+    Breakpoint *error = &errors->back();
+    error->set_id(breakpoint.GetId());
+    error->mutable_location()->set_path(breakpoint.GetFilePath());
+    error->mutable_location()->set_line(breakpoint.GetLine());
+    error->mutable_status()->set_iserror(true);
+    error->mutable_status()->set_message("Failed to set breakpoint.");
+  };
+
+  // Indices of the breakpoints at new locations, grouped by file path.
+  // Only the first breakpoint of a new location is set here, the others
+  // are deferred until the location exists.
+  std::unordered_map<std::string, vector<size_t>> new_breakpoints_by_file;
+  std::unordered_set<std::string> new_locations;
+  vector<size_t> deferred_breakpoints;
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    std::unique_ptr<BreakpointLocationCollection> bp_location(new BreakpointLocationCollection());
-    hr = bp_location->AddFirstBreakpoint(std::move(new_breakpoint));
+    for (size_t i = 0; i < breakpoints.size(); ++i) {
+      std::string location = breakpoints[i].GetBreakpointLocation();
+      const auto &existing = location_to_breakpoints_.find(location);
+      if (existing != location_to_breakpoints_.end()) {
+        if (FAILED(existing->second->UpdateBreakpoints(breakpoints[i]))) {
+          cerr << "Failed to activate breakpoint.";
+          add_error(breakpoints[i]);
+        }
+      } else if (!breakpoints[i].Activated() &&
+                 pending_breakpoints_.Remove(breakpoints[i])) {
+        continue;
+      } else if (new_locations.insert(location).second) {
+        new_breakpoints_by_file[breakpoints[i].GetFilePath()].push_back(i);
+      } else {
+        deferred_breakpoints.push_back(i);
+      }
+    }
+  }
+
+  // Each PDB file is parsed and searched once for each file path.
+  vector<std::shared_ptr<IPortablePdbFile>> pdb_files =
+      GetPdbFilesParsedFirst();
+  for (auto &pdb_file : pdb_files) {
+    if (new_breakpoints_by_file.empty()) {
+      break;
+    }
+
+    if (!pdb_file || !pdb_file->ReadDocumentPaths()) {
+      continue;
+    }
+
+    // Only a PDB file that has a document matching one of the files
+    // is parsed, or waited on if it is being parsed in the background.
+    bool has_file = std::any_of(
+        new_breakpoints_by_file.begin(), new_breakpoints_by_file.end(),
+        [&breakpoints, &pdb_file](
+            const std::pair<const std::string, vector<size_t>> &file) {
+          return breakpoints[file.second.front()].FindDocument(*pdb_file) >= 0;
+        });
+    if (!has_file || !pdb_file->ParsePdbFile()) {
+      continue;
+    }
+
+    auto file = new_breakpoints_by_file.begin();
+    while (file != new_breakpoints_by_file.end()) {
+      vector<size_t> &indices = file->second;
+      int32_t document_index =
+          breakpoints[indices.front()].FindDocument(*pdb_file);
+      if (document_index < 0) {
+        ++file;
+        continue;
+      }
+
+      vector<size_t> not_found;
+      for (size_t index : indices) {
+        std::shared_ptr<DbgBreakpoint> new_breakpoint(new (std::nothrow)
+                                                          DbgBreakpoint);
+        if (!new_breakpoint) {
+          return E_OUTOFMEMORY;
+        }
+
+        new_breakpoint->Initialize(breakpoints[index]);
+        if (!new_breakpoint->TrySetBreakpointInDocument(*pdb_file,
+                                                        document_index)) {
+          not_found.push_back(index);
+          continue;
+        }
+
+        HRESULT hr =
+            ActivateBreakpointHelper(new_breakpoint.get(), pdb_file.get());
+        if (SUCCEEDED(hr)) {
+          hr = AddBreakpointLocation(
+              breakpoints[index].GetBreakpointLocation(),
+              std::move(new_breakpoint));
+        }
+        if (FAILED(hr)) {
+          cerr << "Failed to activate breakpoint.";
+          add_error(breakpoints[index]);
+        }
+      }
+
+      if (not_found.empty()) {
+        file = new_breakpoints_by_file.erase(file);
+      } else {
+        indices.swap(not_found);
+        ++file;
+      }
+    }
+  }
+
+  // The breakpoints that are not in any loaded module wait for theirs.
+  for (const auto &file : new_breakpoints_by_file) {
+    for (size_t index : file.second) {
+      if (!breakpoints[index].Activated()) {
+        continue;
+      }
+
+      if (FAILED(AddPendingBreakpoint(breakpoints[index], pdb_files))) {
+        cerr << "Failed to add pending breakpoint.";
+        add_error(breakpoints[index]);
+      }
+    }
+  }
+
+  // The rest share their location with an earlier breakpoint of the
+  // batch, so they are applied after it, one by one.
+  for (size_t index : deferred_breakpoints) {
+    if (FAILED(UpdateBreakpoint(breakpoints[index]))) {
+      cerr << "Failed to activate breakpoint.";
+      add_error(breakpoints[index]);
+    }
+  }
+
+  return errors->empty() ? S_OK : E_FAIL;
+}
+
+HRESULT BreakpointCollection::AddPendingBreakpoint(
+    const DbgBreakpoint &breakpoint,
+    const vector<std::shared_ptr<IPortablePdbFile>> &searched_pdb_files) {
+  HRESULT hr = pending_breakpoints_.Add(breakpoint);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  std::unordered_set<IPortablePdbFile *> searched;
+  for (const auto &pdb_file : searched_pdb_files) {
+    searched.insert(pdb_file.get());
+  }
+
+  for (const auto &pdb_file : debugger_callback_->GetPdbFiles()) {
+    if (!pdb_file || searched.find(pdb_file.get()) != searched.end()) {
+      continue;
+    }
+
+    hr = ResolvePendingBreakpoints(pdb_file.get());
     if (FAILED(hr)) {
       return hr;
     }
+  }
+
+  return S_OK;
+}
 
-    location_to_breakpoints_[breakpoint.GetBreakpointLocation()]
-      = std::move(bp_location);
+HRESULT BreakpointCollection::ResolvePendingBreakpoints(
+    IPortablePdbFile *pdb_file) {
+  if (!pdb_file) {
+    return E_INVALIDARG;
+  }
+
+  if (pending_breakpoints_.Empty() || !pdb_file->ParsePdbFile()) {
+    return S_FALSE;
+  }
+
+  vector<ResolvedBreakpoint> resolved =
+      pending_breakpoints_.SetInPdbFile(*pdb_file);
+  if (resolved.empty()) {
+    return S_FALSE;
+  }
+
+  HRESULT result = S_OK;
+  for (auto &resolved_breakpoint : resolved) {
+    HRESULT hr = ActivateResolvedBreakpoint(pdb_file, &resolved_breakpoint);
+    if (FAILED(hr)) {
+      cerr << "Failed to activate pending breakpoint "
+           << resolved_breakpoint.breakpoint->GetId();
+      result = hr;
+    }
+  }
+
+  return result;
+}
+
+HRESULT BreakpointCollection::RemoveModuleBreakpoints(
+    CORDB_ADDRESS module_base_address) {
+  vector<std::shared_ptr<DbgBreakpoint>> active_breakpoints;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_set<BreakpointLocationCollection *> removed;
+    auto location = location_to_breakpoints_.begin();
+    while (location != location_to_breakpoints_.end()) {
+      BreakpointLocationCollection *bp_location = location->second.get();
+      if (bp_location->GetModuleBaseAddress() != module_base_address) {
+        ++location;
+        continue;
+      }
+
+      // A collection shared by several locations is only removed once.
+      if (!removed.insert(bp_location).second) {
+        location = location_to_breakpoints_.erase(location);
+        continue;
+      }
+
+      for (auto &breakpoint : bp_location->GetBreakpoints()) {
+        if (breakpoint->Activated()) {
+          active_breakpoints.push_back(std::move(breakpoint));
+        }
+      }
+
+      BreakpointHitKey hit_key = {bp_location->GetModuleBaseAddress(),
+                                  bp_location->GetMethodToken(),
+                                  bp_location->GetILOffset()};
+      {
+        std::lock_guard<std::mutex> hit_key_lock(hit_key_mutex_);
+        hit_key_to_breakpoints_.erase(hit_key);
+      }
+      location = location_to_breakpoints_.erase(location);
+    }
+  }
+
+  for (const auto &breakpoint : active_breakpoints) {
+    HRESULT hr = pending_breakpoints_.Add(*breakpoint);
+    if (FAILED(hr)) {
+      cerr << "Failed to add pending breakpoint " << breakpoint->GetId();
+      return hr;
+    }
   }
+
   return S_OK;
 }
 
+HRESULT BreakpointCollection::ActivateResolvedBreakpoint(
+    IPortablePdbFile *pdb_file, ResolvedBreakpoint *resolved) {
+  {
+    // Another pending breakpoint at the same location may be set already.
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto &existing =
+        location_to_breakpoints_.find(resolved->requested_location);
+    if (existing != location_to_breakpoints_.end()) {
+      return existing->second->UpdateBreakpoints(*resolved->breakpoint);
+    }
+  }
+
+  HRESULT hr = ActivateBreakpointHelper(resolved->breakpoint.get(), pdb_file);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  return AddBreakpointLocation(resolved->requested_location,
+                               std::move(resolved->breakpoint));
+}
+
 HRESULT BreakpointCollection::SyncBreakpoints() {
-  DbgBreakpoint breakpoint;
+  vector<DbgBreakpoint> breakpoints;
   HRESULT hr = S_OK;
 
   while (true) {
-    hr = ReadAndParseBreakpoint(&breakpoint);
+    bool is_batch = false;
+    hr = ReadAndParseBreakpoints(&breakpoints, &is_batch);
     if (FAILED(hr)) {
       return hr;
     }
 
-    if (breakpoint.GetKillServer()) {
+    bool kill_server = std::any_of(
+        breakpoints.begin(), breakpoints.end(),
+        [](const DbgBreakpoint &breakpoint) {
+          return breakpoint.GetKillServer();
+        });
+    if (kill_server) {
       return S_OK;
     }
 
-    hr = UpdateBreakpoint(breakpoint);
+    if (!is_batch) {
+      for (const DbgBreakpoint &breakpoint : breakpoints) {
+        hr = UpdateBreakpoint(breakpoint);
+        if (FAILED(hr)) {
+          cerr << "Failed to activate breakpoint.";
+        }
+      }
+      continue;
+    }
+
+    // A batch is answered with one batch of the breakpoints that could
+    // not be set, which is empty if they all were.
+    vector<Breakpoint> errors;
+    hr = UpdateBreakpoints(breakpoints, &errors);
     if (FAILED(hr)) {
-      cerr << "Failed to activate breakpoint.";
+      cerr << "Failed to activate " << errors.size() << " breakpoints.";
+    }
+
+    hr = WriteBreakpoints(errors);
+    if (FAILED(hr)) {
+      cerr << "Failed to write breakpoint batch status.";
     }
   }
 
@@ -274,6 +708,18 @@ HRESULT BreakpointCollection::SyncBreakpoints() {
 HRESULT BreakpointCollection::CancelSyncBreakpoints() {
   HRESULT hr = S_OK;
 
+  // Snapshots that are already captured are written before the agent
+  // is told to shut down.
+  write_queue_.Flush();
+  BreakpointWriteStats stats = write_queue_.GetStats();
+  if (stats.written > 0) {
+    cerr << "Wrote " << stats.written << " breakpoint snapshots. Debuggee "
+         << "paused on average " << stats.total_pause_us / stats.written
+         << " us (max " << stats.max_pause_us << " us), snapshot latency on "
+         << "average " << stats.total_latency_us / stats.written << " us (max "
+         << stats.max_latency_us << " us)." << std::endl;
+  }
+
   // We are shutting down the debugger, signal the agent
   // to shutdown as well.
   Breakpoint kill_breakpoint;
@@ -321,6 +767,13 @@ HRESULT BreakpointCollection::ActivateBreakpointHelper(
     return hr;
   }
 
+  CORDB_ADDRESS module_base_address;
+  hr = debug_module->GetBaseAddress(&module_base_address);
+  if (FAILED(hr)) {
+    cerr << "Failed to get base address of ICorDebugModule.";
+    return hr;
+  }
+
   CComPtr<IMetaDataImport> metadata_import;
   hr = portable_pdb->GetMetaDataImport(&metadata_import);
   if (FAILED(hr)) {
@@ -328,125 +781,62 @@ HRESULT BreakpointCollection::ActivateBreakpointHelper(
     return hr;
   }
 
+  // The MethodDebugInformation rows of a portable PDB line up with the
+  // MethodDef rows of its module, so the method token of the breakpoint
+  // is the MethodDef token with the same row.
+  mdMethodDef method_token =
+      TokenFromRid(breakpoint->GetMethodDef(), mdtMethodDef);
+
   mdTypeDef type_def;
   vector<WCHAR> method_name;
   PCCOR_SIGNATURE signature;
   ULONG method_virtual_addr;
-  hr = GetMethodData(metadata_import, breakpoint->GetMethodDef(), &type_def,
-                     &signature, &method_virtual_addr, &method_name);
-
+  hr = GetMethodData(metadata_import, method_token, &type_def, &signature,
+                     &method_virtual_addr, &method_name);
   if (FAILED(hr)) {
     return hr;
   }
 
-  HCORENUM cor_enum = nullptr;
-  bool method_found = false;
-  bool has_error = false;
-
-  while (!method_found && !has_error) {
-    // Enumerate all the methods with the same name as this.
-    // We have to do this because given a method definition (that is parsed
-    // from a PDB file), there seems to be no function to translate
-    // that to a method token (from IMetaDataImport) and we need the
-    // method token to set a breakpoint.
-    // So what we have to do here is search for a method in
-    // IMetaDataImport->EnumMethodsWithName that has the same signature
-    // and use its method token.
-    vector<mdMethodDef> method_tokens(100, 0);
-    ULONG method_defs_returned = 0;
-    hr = metadata_import->EnumMethodsWithName(
-        &cor_enum, type_def, method_name.data(), method_tokens.data(),
-        method_tokens.size(), &method_defs_returned);
-
-    if (FAILED(hr) || method_defs_returned == 0) {
-      cerr << "Failed to get method from IMetadataImport.";
-      has_error = true;
-      break;
-    }
-
-    // For all the methods with the same name, search for the method
-    // that has the same signature and virtual address and uses its method token
-    // to activate the breakpoint.
-    for (size_t i = 0; i < method_defs_returned; ++i) {
-      ULONG temp_method_name_length;
-      DWORD temp_flags1;
-      PCCOR_SIGNATURE temp_signature;
-      ULONG temp_signature_blob;
-      ULONG temp_rva;
-      DWORD temp_flags2;
-
-      hr = metadata_import->GetMethodProps(
-          method_tokens[i], &type_def, nullptr, 0, &temp_method_name_length,
-          &temp_flags1, &temp_signature, &temp_signature_blob, &temp_rva,
-          &temp_flags2);
-
-      if (signature != temp_signature || method_virtual_addr != temp_rva) {
-        continue;
-      }
-
-      // Activates the breakpoint in this method.
-      CComPtr<ICorDebugFunction> debug_function;
-      breakpoint->SetMethodToken(method_tokens[i]);
-      hr =
-          debug_module->GetFunctionFromToken(method_tokens[i], &debug_function);
-      if (FAILED(hr)) {
-        cerr << "Failed to get function from function token "
-             << method_tokens[i] << " with HRESULT " << std::hex << hr;
-        has_error = true;
-        break;
-      }
-
-      CComPtr<ICorDebugCode> debug_code;
-      hr = debug_function->GetILCode(&debug_code);
-      if (FAILED(hr)) {
-        cerr << "Failed to get ICorDebugCode from function with hr " << std::hex
-             << hr;
-        has_error = true;
-        break;
-      }
+  // Activates the breakpoint in this method.
+  breakpoint->SetMethodToken(method_token);
+  breakpoint->SetModuleBaseAddress(module_base_address);
 
-      CComPtr<ICorDebugFunctionBreakpoint> function_breakpoint;
-      hr = debug_code->CreateBreakpoint(breakpoint->GetILOffset(),
-                                        &function_breakpoint);
-
-      if (FAILED(hr)) {
-        cerr << "Failed to set breakpoint in at offset "
-             << breakpoint->GetILOffset() << " in function "
-             << breakpoint->GetMethodToken() << " with HRESULT " << std::hex
-             << hr;
-        has_error = true;
-        break;
-      }
-
-      hr = function_breakpoint->Activate(TRUE);
-      if (FAILED(hr)) {
-        cerr << "Failed to activate breakpoint in at offset "
-             << breakpoint->GetILOffset() << " in function "
-             << breakpoint->GetMethodToken() << " with HRESULT " << std::hex
-             << hr;
-        has_error = true;
-        break;
-      }
-
-      breakpoint->SetMethodName(std::move(method_name));
-      breakpoint->SetCorDebugBreakpoint(function_breakpoint);
-      method_found = true;
-      break;
-    }
+  CComPtr<ICorDebugFunction> debug_function;
+  hr = debug_module->GetFunctionFromToken(method_token, &debug_function);
+  if (FAILED(hr)) {
+    cerr << "Failed to get function from function token " << method_token
+         << " with HRESULT " << std::hex << hr;
+    return hr;
   }
 
-  if (cor_enum) {
-    metadata_import->CloseEnum(cor_enum);
+  CComPtr<ICorDebugCode> debug_code;
+  hr = debug_function->GetILCode(&debug_code);
+  if (FAILED(hr)) {
+    cerr << "Failed to get ICorDebugCode from function with hr " << std::hex
+         << hr;
+    return hr;
   }
 
-  if (has_error) {
+  CComPtr<ICorDebugFunctionBreakpoint> function_breakpoint;
+  hr = debug_code->CreateBreakpoint(breakpoint->GetILOffset(),
+                                    &function_breakpoint);
+  if (FAILED(hr)) {
+    cerr << "Failed to set breakpoint in at offset "
+         << breakpoint->GetILOffset() << " in function "
+         << breakpoint->GetMethodToken() << " with HRESULT " << std::hex << hr;
     return hr;
   }
 
-  if (!method_found) {
-    return E_FAIL;
+  hr = function_breakpoint->Activate(TRUE);
+  if (FAILED(hr)) {
+    cerr << "Failed to activate breakpoint in at offset "
+         << breakpoint->GetILOffset() << " in function "
+         << breakpoint->GetMethodToken() << " with HRESULT " << std::hex << hr;
+    return hr;
   }
 
+  breakpoint->SetMethodName(std::move(method_name));
+  breakpoint->SetCorDebugBreakpoint(function_breakpoint);
   return S_OK;
 }
 
@@ -15,25 +15,54 @@
 #ifndef BREAKPOINT_COLLECTION_H_
 #define BREAKPOINT_COLLECTION_H_
 
-#include <unordered_map>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "breakpoint_client.h"
+#include "breakpoint_write_queue.h"
 #include "ccomptr.h"
 #include "dbg_breakpoint.h"
 #include "i_breakpoint_collection.h"
 #include "breakpoint_location_collection.h"
+#include "pending_breakpoints.h"
 
 namespace google_cloud_debugger {
 
 class DebuggerCallback;
 class IEvalCoordinator;
 
+// Identifies where a breakpoint is hit: the base address of the module,
+// the method token and the IL offset inside the method.
+struct BreakpointHitKey {
+  CORDB_ADDRESS module_base_address;
+  mdMethodDef method_token;
+  ULONG32 il_offset;
+
+  bool operator==(const BreakpointHitKey &other) const {
+    return module_base_address == other.module_base_address &&
+           method_token == other.method_token && il_offset == other.il_offset;
+  }
+};
+
+// Hash function for BreakpointHitKey.
+struct BreakpointHitKeyHash {
+  size_t operator()(const BreakpointHitKey &key) const {
+    size_t hash = std::hash<CORDB_ADDRESS>()(key.module_base_address);
+    hash = hash * 31 + std::hash<mdMethodDef>()(key.method_token);
+    return hash * 31 + std::hash<ULONG32>()(key.il_offset);
+  }
+};
+
 // Class for managing a collection of breakpoints.
 class BreakpointCollection : public IBreakpointCollection {
  public:
+  // Creates a breakpoint collection whose snapshots are written by
+  // write_queue_.
+  BreakpointCollection();
+
   // Sets the Debugger Callback field, which is used to get a list of
   // Portable PDB files applicable to this collection.
   HRESULT SetDebuggerCallback(DebuggerCallback *debugger_callback) override;
@@ -46,11 +75,37 @@ class BreakpointCollection : public IBreakpointCollection {
   // and call the private ActivateBreakpointHelper function to activate it.
   // If it is not and we do not need to activate it, simply don't do anything.
   // This means duplicate breakpoints will be silently rejected.
+  // A breakpoint that has to be activated but is not in any loaded module
+  // is added to pending_breakpoints_ and S_FALSE is returned.
   HRESULT UpdateBreakpoint(const DbgBreakpoint &breakpoint) override;
 
+  // Updates a batch of breakpoints. Breakpoints at locations that already
+  // have breakpoints are updated there. The other breakpoints are grouped
+  // by file path and, for each PDB file, the document of each file path
+  // is looked up once for all the breakpoints in that file.
+  HRESULT UpdateBreakpoints(
+      const std::vector<DbgBreakpoint> &breakpoints,
+      std::vector<google::cloud::diagnostics::debug::Breakpoint> *errors)
+      override;
+
+  // Tries to set the breakpoints in pending_breakpoints_ in pdb_file.
+  // This is called when a module is loaded, so only the pending
+  // breakpoints are searched for and pdb_file is only parsed here if
+  // there are any.
+  HRESULT ResolvePendingBreakpoints(
+      google_cloud_debugger_portable_pdb::IPortablePdbFile *pdb_file) override;
+
+  // Removes the location collections of the module loaded at
+  // module_base_address from location_to_breakpoints_ and
+  // hit_key_to_breakpoints_, and adds their active breakpoints to
+  // pending_breakpoints_.
+  HRESULT RemoveModuleBreakpoints(CORDB_ADDRESS module_base_address) override;
+
   // Using the breakpoint_client_read_ name pipe, try to read and parse
   // any incoming breakpoints that are written to the named pipe.
   // This method will then try to activate or deactivate these breakpoints.
+  // A batch of breakpoints is applied with UpdateBreakpoints and answered
+  // with one batch that holds the errors, if any.
   // This method will block and wait until a breakpoint arrives.
   // It will only terminate if the connection to the named pipe server
   // is cut off.
@@ -63,31 +118,107 @@ class BreakpointCollection : public IBreakpointCollection {
   HRESULT WriteBreakpoint(
       const google::cloud::diagnostics::debug::Breakpoint &breakpoint) override;
 
+  // Queues a breakpoint snapshot in write_queue_.
+  HRESULT QueueBreakpoint(
+      google::cloud::diagnostics::debug::Breakpoint *breakpoint,
+      std::chrono::steady_clock::time_point hit_time,
+      std::chrono::steady_clock::time_point resume_time) override;
+
+  // Swaps snapshot with a written snapshot of the write queue, if any.
+  void ReuseSnapshot(
+      google::cloud::diagnostics::debug::Breakpoint *snapshot) override;
+
   // Reads a breakpoint from the named pipe server.
   HRESULT ReadBreakpoint(
       google::cloud::diagnostics::debug::Breakpoint *breakpoint) override;
 
   // Evaluates and prints out the breakpoint that corresponds to
   // the IL offset il_offset inside the function with token
-  // function_token.
+  // function_token in the module loaded at module_base_address.
   HRESULT EvaluateAndPrintBreakpoint(
-      mdMethodDef function_token, ULONG32 il_offset,
-      IEvalCoordinator *eval_coordinator, ICorDebugThread *debug_thread,
+      CORDB_ADDRESS module_base_address, mdMethodDef function_token,
+      ULONG32 il_offset, IEvalCoordinator *eval_coordinator,
+      ICorDebugThread *debug_thread,
       const std::vector<
           std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
           &pdb_files) override;
 
  private:
-  // Reads an incoming breakpoint from the named pipe and populates
-  // The DbgBreakpoint object based on that.
-  HRESULT ReadAndParseBreakpoint(DbgBreakpoint *breakpoint);
+  // Reads the next message from the named pipe and populates one
+  // DbgBreakpoint per breakpoint in it. is_batch is set to true if the
+  // message is a batch.
+  HRESULT ReadAndParseBreakpoints(std::vector<DbgBreakpoint> *breakpoints,
+                                  bool *is_batch);
+
+  // Writes breakpoints to the named pipe server as one batch.
+  HRESULT WriteBreakpoints(
+      const std::vector<google::cloud::diagnostics::debug::Breakpoint>
+          &breakpoints);
+
+  // Returns the PDB files of debugger_callback_ with the ones that are
+  // already parsed first. Callers read the document paths of a PDB file
+  // and only parse it if one of its documents matches, so PDB files that
+  // are still being parsed in the background are only waited on if they
+  // have the file and none of the parsed ones match.
+  std::vector<
+      std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
+  GetPdbFilesParsedFirst();
+
+  // Adds a new location collection for breakpoint, which is already
+  // activated, under breakpoint_location. This is the location the
+  // breakpoint was requested at, which may differ from the line of the
+  // sequence point it was set at. If the location was added since the
+  // caller looked it up, or another location was set at the same
+  // sequence point, breakpoint is merged into that collection and its
+  // own ICorDebugBreakpoint is deactivated.
+  HRESULT AddBreakpointLocation(const std::string &breakpoint_location,
+                                std::shared_ptr<DbgBreakpoint> breakpoint);
+
+  // Adds breakpoint, which was not found in searched_pdb_files, to
+  // pending_breakpoints_. The PDB files of modules loaded since
+  // searched_pdb_files was taken are searched for it as well, as the
+  // pending breakpoints may have been resolved against them before
+  // breakpoint was added.
+  HRESULT AddPendingBreakpoint(
+      const DbgBreakpoint &breakpoint,
+      const std::vector<std::shared_ptr<
+          google_cloud_debugger_portable_pdb::IPortablePdbFile>>
+          &searched_pdb_files);
+
+  // Activates a breakpoint from pending_breakpoints_ that was set in
+  // pdb_file and adds it to location_to_breakpoints_.
+  HRESULT ActivateResolvedBreakpoint(
+      google_cloud_debugger_portable_pdb::IPortablePdbFile *pdb_file,
+      ResolvedBreakpoint *resolved);
+
+  // Creates breakpoint_client_read_ if it does not exist yet.
+  HRESULT EnsureReadClient();
+
+  // Creates breakpoint_client_write_ if it does not exist yet.
+  HRESULT EnsureWriteClient();
 
   // The underlying list of breakpoints that this collection manages.
   // std::vector<std::shared_ptr<DbgBreakpoint>> breakpoints_;
 
   // A map of location to a collection of breakpoint at that location.
-  std::unordered_map<std::string, std::unique_ptr<BreakpointLocationCollection>>
-    location_to_breakpoints_;
+  // Locations that are set at the same sequence point share a collection.
+  std::unordered_map<std::string,
+                     std::shared_ptr<BreakpointLocationCollection>>
+      location_to_breakpoints_;
+
+  // Secondary index into location_to_breakpoints_ keyed by where the
+  // breakpoints are hit. This is used by EvaluateAndPrintBreakpoint so
+  // the cost of dispatching a hit does not depend on the number of
+  // breakpoints set. Entries are added and removed together with
+  // location_to_breakpoints_, under mutex_, and share the ownership of
+  // the collections so a hit never sees a freed collection.
+  std::unordered_map<BreakpointHitKey,
+                     std::shared_ptr<BreakpointLocationCollection>,
+                     BreakpointHitKeyHash>
+      hit_key_to_breakpoints_;
+
+  // Breakpoints that are active but are not in any loaded module yet.
+  PendingBreakpoints pending_breakpoints_;
 
   // Activate a breakpoint in a portable pdb file.
   // This function should only be used if breakpoint is already set, i.e.
@@ -103,9 +234,11 @@ class BreakpointCollection : public IBreakpointCollection {
                         ULONG *virtual_address,
                         std::vector<WCHAR> *method_name);
 
-  // Helper function to create and initialize a breakpoint client.
+  // Helper function to create and initialize a breakpoint client that
+  // uses version protocol_version of the pipe protocol.
   static HRESULT CreateAndInitializeBreakpointClient(
-      std::unique_ptr<BreakpointClient> *client, std::string pipe_name);
+      std::unique_ptr<BreakpointClient> *client, std::string pipe_name,
+      int protocol_version);
 
   // COM Pointer to the DebuggerCallback that this breakpoint collection
   // is associated with. This is used to get the list of Portable PDB Files
@@ -118,7 +251,23 @@ class BreakpointCollection : public IBreakpointCollection {
   // Named pipe server for writing breakpoints.
   std::unique_ptr<BreakpointClient> breakpoint_client_write_;
 
+  // Protects the creation of breakpoint_client_write_, which is used by
+  // both the write_queue_ thread and the SyncBreakpoints thread.
+  std::mutex write_client_mutex_;
+
+  // Writes breakpoint snapshots with WriteBreakpoint on its own thread.
+  // This is declared after breakpoint_client_write_ so it is destroyed,
+  // and its writer thread stopped, before the client.
+  BreakpointWriteQueue write_queue_;
+
+  // Protects location_to_breakpoints_. This may be held while
+  // ICorDebugBreakpoints are being activated.
   std::mutex mutex_;
+
+  // Protects hit_key_to_breakpoints_. This is only held for the duration
+  // of a hash table lookup or update so a breakpoint hit never waits
+  // behind a breakpoint being set.
+  std::mutex hit_key_mutex_;
 };
 
 // Returns true if the first string and the second string are equal
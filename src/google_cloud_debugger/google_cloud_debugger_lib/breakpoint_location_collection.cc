@@ -31,6 +31,7 @@ HRESULT BreakpointLocationCollection::AddFirstBreakpoint(
   il_offset_ = breakpoint->GetILOffset();
   method_def_ = breakpoint->GetMethodDef();
   method_token_ = breakpoint->GetMethodToken();
+  module_base_address_ = breakpoint->GetModuleBaseAddress();
   method_name_ = breakpoint->GetMethodName();
   location_string_ = breakpoint->GetBreakpointLocation();
   HRESULT hr = breakpoint->GetCorDebugBreakpoint(&debug_breakpoint_);
@@ -77,6 +78,7 @@ HRESULT BreakpointLocationCollection::UpdateBreakpoints(
   new_breakpoint->SetILOffset(il_offset_);
   new_breakpoint->SetMethodDef(method_def_);
   new_breakpoint->SetMethodToken(method_token_);
+  new_breakpoint->SetModuleBaseAddress(module_base_address_);
   new_breakpoint->SetMethodName(method_name_);
   new_breakpoint->SetCorDebugBreakpoint(debug_breakpoint_);
 
@@ -60,6 +60,9 @@ class BreakpointLocationCollection {
   // Returns the method token of breakpoints at this location.
   mdMethodDef GetMethodToken() { return method_token_; }
 
+  // Returns the base address of the module of breakpoints at this location.
+  CORDB_ADDRESS GetModuleBaseAddress() { return module_base_address_; }
+
  private:
   // Mutex to protect breakpoints_ vector from multiple access.
   std::mutex mutex_;
@@ -86,6 +89,9 @@ class BreakpointLocationCollection {
   // The method token of the method of breakpoints at this location.
   mdMethodDef method_token_;
 
+  // The base address of the module of breakpoints at this location.
+  CORDB_ADDRESS module_base_address_ = 0;
+
   // The name of the method of breakpoints at this location.
   std::vector<WCHAR> method_name_;
 
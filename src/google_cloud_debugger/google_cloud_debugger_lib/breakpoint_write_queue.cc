@@ -0,0 +1,154 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "breakpoint_write_queue.h"
+
+#include <algorithm>
+#include <iostream>
+
+using google::cloud::diagnostics::debug::Breakpoint;
+using std::cerr;
+using std::lock_guard;
+using std::mutex;
+using std::unique_lock;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger {
+
+const std::size_t BreakpointWriteQueue::kDefaultCapacity;
+const std::size_t BreakpointWriteQueue::kMaximumReusedBreakpoints;
+
+BreakpointWriteQueue::BreakpointWriteQueue(WriteFunction write_function,
+                                           std::size_t capacity)
+    : write_function_(std::move(write_function)),
+      capacity_(std::max(capacity, static_cast<std::size_t>(1))) {}
+
+BreakpointWriteQueue::~BreakpointWriteQueue() { ShutDown(); }
+
+HRESULT BreakpointWriteQueue::Enqueue(Breakpoint *breakpoint,
+                                      steady_clock::time_point hit_time,
+                                      steady_clock::time_point resume_time) {
+  if (!breakpoint) {
+    return E_INVALIDARG;
+  }
+
+  unique_lock<mutex> lock(mutex_);
+  written_cv_.wait(lock, [this] {
+    return shut_down_ || FAILED(last_error_) || queue_.size() < capacity_;
+  });
+
+  if (shut_down_) {
+    return E_ABORT;
+  }
+
+  if (FAILED(last_error_)) {
+    return last_error_;
+  }
+
+  if (!writer_.joinable()) {
+    writer_ = std::thread(&BreakpointWriteQueue::WriteLoop, this);
+  }
+
+  queue_.emplace_back();
+  queue_.back().breakpoint.Swap(breakpoint);
+  queue_.back().hit_time = hit_time;
+  queue_.back().resume_time = resume_time;
+  queued_cv_.notify_one();
+  return S_OK;
+}
+
+void BreakpointWriteQueue::Flush() {
+  unique_lock<mutex> lock(mutex_);
+  written_cv_.wait(lock, [this] { return queue_.empty() && !writing_; });
+}
+
+void BreakpointWriteQueue::ShutDown() {
+  {
+    lock_guard<mutex> lock(mutex_);
+    shut_down_ = true;
+  }
+  queued_cv_.notify_all();
+  written_cv_.notify_all();
+
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+}
+
+BreakpointWriteStats BreakpointWriteQueue::GetStats() {
+  lock_guard<mutex> lock(mutex_);
+  return stats_;
+}
+
+void BreakpointWriteQueue::ReuseBreakpoint(Breakpoint *breakpoint) {
+  lock_guard<mutex> lock(mutex_);
+  if (written_.empty()) {
+    return;
+  }
+
+  breakpoint->Swap(&written_.back());
+  written_.pop_back();
+}
+
+void BreakpointWriteQueue::WriteLoop() {
+  unique_lock<mutex> lock(mutex_);
+  while (true) {
+    queued_cv_.wait(lock, [this] { return shut_down_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      // Only reached after ShutDown, once everything is written.
+      return;
+    }
+
+    QueuedBreakpoint queued;
+    queued.breakpoint.Swap(&queue_.front().breakpoint);
+    queued.hit_time = queue_.front().hit_time;
+    queued.resume_time = queue_.front().resume_time;
+    queue_.pop_front();
+    writing_ = true;
+
+    lock.unlock();
+    HRESULT hr = write_function_(queued.breakpoint);
+    steady_clock::time_point written_time = steady_clock::now();
+    queued.breakpoint.Clear();
+    lock.lock();
+
+    writing_ = false;
+    if (written_.size() < kMaximumReusedBreakpoints) {
+      written_.emplace_back();
+      written_.back().Swap(&queued.breakpoint);
+    }
+    if (SUCCEEDED(hr)) {
+      std::uint64_t pause_us =
+          duration_cast<microseconds>(queued.resume_time - queued.hit_time)
+              .count();
+      std::uint64_t latency_us =
+          duration_cast<microseconds>(written_time - queued.hit_time).count();
+      stats_.written += 1;
+      stats_.total_pause_us += pause_us;
+      stats_.max_pause_us = std::max(stats_.max_pause_us, pause_us);
+      stats_.total_latency_us += latency_us;
+      stats_.max_latency_us = std::max(stats_.max_latency_us, latency_us);
+    } else {
+      cerr << "Failed to write breakpoint: " << std::hex << hr << std::dec
+           << std::endl;
+      stats_.failed += 1;
+      last_error_ = hr;
+    }
+    written_cv_.notify_all();
+  }
+}
+
+}  // namespace google_cloud_debugger
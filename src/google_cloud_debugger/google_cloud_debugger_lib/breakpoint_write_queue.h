@@ -0,0 +1,159 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BREAKPOINT_WRITE_QUEUE_H_
+#define BREAKPOINT_WRITE_QUEUE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "breakpoint.pb.h"
+#include "cor.h"
+
+namespace google_cloud_debugger {
+
+// Timings of the breakpoint snapshots written by a BreakpointWriteQueue.
+// Pause time is how long the debuggee was stopped at the breakpoint.
+// Latency is the time from the breakpoint hit until the snapshot was
+// written to the agent, which includes the pause.
+struct BreakpointWriteStats {
+  // Number of snapshots written.
+  std::uint64_t written = 0;
+
+  // Number of snapshots that failed to be written.
+  std::uint64_t failed = 0;
+
+  // Sum and maximum of the pause times of the written snapshots,
+  // in microseconds.
+  std::uint64_t total_pause_us = 0;
+  std::uint64_t max_pause_us = 0;
+
+  // Sum and maximum of the latencies of the written snapshots,
+  // in microseconds.
+  std::uint64_t total_latency_us = 0;
+  std::uint64_t max_latency_us = 0;
+};
+
+// A bounded queue of breakpoint snapshots waiting to be written to the
+// agent. A dedicated writer thread drains the queue, so the thread that
+// captured a snapshot does not wait for serialization and pipe I/O.
+// Snapshots are written in the order they are queued.
+//
+// The writer thread is started by the first call to Enqueue and stopped
+// by ShutDown or the destructor, after the queued snapshots are written.
+class BreakpointWriteQueue {
+ public:
+  // Function that writes a snapshot to the agent.
+  typedef std::function<HRESULT(
+      const google::cloud::diagnostics::debug::Breakpoint &)>
+      WriteFunction;
+
+  // Creates a queue that writes snapshots with write_function and holds
+  // at most capacity snapshots that are not written yet.
+  BreakpointWriteQueue(WriteFunction write_function,
+                       std::size_t capacity = kDefaultCapacity);
+
+  // Writes the queued snapshots and stops the writer thread.
+  ~BreakpointWriteQueue();
+
+  // Queues breakpoint to be written. breakpoint is swapped into the queue,
+  // without copying its messages, and is left empty if it is queued.
+  // hit_time is when the debuggee stopped at the breakpoint and
+  // resume_time is when it was allowed to continue. Blocks while the
+  // queue is full. Returns the error of the last failed write, if any,
+  // so callers can stop producing snapshots once the pipe is broken.
+  HRESULT Enqueue(google::cloud::diagnostics::debug::Breakpoint *breakpoint,
+                  std::chrono::steady_clock::time_point hit_time,
+                  std::chrono::steady_clock::time_point resume_time);
+
+  // Blocks until all the queued snapshots are written.
+  void Flush();
+
+  // Writes the queued snapshots and stops the writer thread. Enqueue
+  // fails after this is called.
+  void ShutDown();
+
+  // Returns the timings of the snapshots written so far.
+  BreakpointWriteStats GetStats();
+
+  // If a written snapshot is kept for reuse, swaps it with breakpoint,
+  // which should be empty. The written snapshot is cleared, but its
+  // repeated fields keep their messages, so populating it again does not
+  // allocate them again.
+  void ReuseBreakpoint(
+      google::cloud::diagnostics::debug::Breakpoint *breakpoint);
+
+  // Default number of snapshots that can wait to be written. Snapshots
+  // are at most DbgBreakpoint::kMaximumBreakpointSize bytes.
+  static const std::size_t kDefaultCapacity = 64;
+
+  // Maximum number of written snapshots kept for reuse.
+  static const std::size_t kMaximumReusedBreakpoints = 4;
+
+ private:
+  // A snapshot waiting to be written.
+  struct QueuedBreakpoint {
+    google::cloud::diagnostics::debug::Breakpoint breakpoint;
+    std::chrono::steady_clock::time_point hit_time;
+    std::chrono::steady_clock::time_point resume_time;
+  };
+
+  // Body of the writer thread.
+  void WriteLoop();
+
+  // Writes a snapshot to the agent.
+  WriteFunction write_function_;
+
+  // Maximum number of snapshots in queue_.
+  std::size_t capacity_;
+
+  // Snapshots waiting to be written.
+  std::deque<QueuedBreakpoint> queue_;
+
+  // Cleared snapshots that were written, kept for ReuseBreakpoint.
+  std::deque<google::cloud::diagnostics::debug::Breakpoint> written_;
+
+  // True while the writer thread writes a snapshot it took from queue_.
+  bool writing_ = false;
+
+  // True once ShutDown is called.
+  bool shut_down_ = false;
+
+  // Error of the last failed write.
+  HRESULT last_error_ = S_OK;
+
+  // Timings of the written snapshots.
+  BreakpointWriteStats stats_;
+
+  // The writer thread.
+  std::thread writer_;
+
+  // Protects all the fields above.
+  std::mutex mutex_;
+
+  // Signaled when a snapshot is queued or the queue is shut down.
+  std::condition_variable queued_cv_;
+
+  // Signaled when the writer thread finishes writing a snapshot.
+  std::condition_variable written_cv_;
+};
+
+}  // namespace google_cloud_debugger
+
+#endif  //  BREAKPOINT_WRITE_QUEUE_H_
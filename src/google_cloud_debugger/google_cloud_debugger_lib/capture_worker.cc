@@ -0,0 +1,70 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "capture_worker.h"
+
+namespace google_cloud_debugger {
+
+CaptureWorker::~CaptureWorker() { ShutDown(); }
+
+bool CaptureWorker::Post(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      return false;
+    }
+
+    tasks_.push_back(std::move(task));
+    if (!worker_.joinable()) {
+      worker_ = std::thread(&CaptureWorker::WorkerLoop, this);
+    }
+  }
+  task_available_.notify_one();
+  return true;
+}
+
+void CaptureWorker::ShutDown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  task_available_.notify_all();
+
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+void CaptureWorker::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_available_.wait(lock,
+                           [this] { return stopping_ || !tasks_.empty(); });
+      // Queued tasks still run after ShutDown because the thread that
+      // posted them may be waiting for them.
+      if (tasks_.empty()) {
+        return;
+      }
+
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+
+    task();
+  }
+}
+
+}  // namespace google_cloud_debugger
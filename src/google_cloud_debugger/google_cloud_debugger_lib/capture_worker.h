@@ -0,0 +1,67 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CAPTURE_WORKER_H_
+#define CAPTURE_WORKER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace google_cloud_debugger {
+
+// A long-lived thread that runs tasks one at a time, in the order they
+// are posted. EvalCoordinator uses it to capture breakpoint snapshots off
+// the debugger callback thread without creating a thread per hit.
+//
+// The thread is started by the first call to Post. ShutDown (or the
+// destructor) runs the tasks that are already queued and then stops the
+// thread. ShutDown must not be called from a task.
+class CaptureWorker {
+ public:
+  // Runs the queued tasks and stops the worker thread.
+  ~CaptureWorker();
+
+  // Queues task to run on the worker thread. Returns false and drops the
+  // task if ShutDown has been called.
+  bool Post(std::function<void()> task);
+
+  // Runs the tasks that are already queued, then stops the worker thread.
+  void ShutDown();
+
+ private:
+  // Main loop of the worker thread.
+  void WorkerLoop();
+
+  // The worker thread.
+  std::thread worker_;
+
+  // Tasks waiting to run.
+  std::deque<std::function<void()>> tasks_;
+
+  // True once ShutDown is called.
+  bool stopping_ = false;
+
+  // Mutex protecting tasks_ and stopping_.
+  std::mutex mutex_;
+
+  // Signaled when a task is queued or the worker is stopping.
+  std::condition_variable task_available_;
+};
+
+}  // namespace google_cloud_debugger
+
+#endif  //  CAPTURE_WORKER_H_
@@ -0,0 +1,65 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "class_metadata_cache.h"
+
+using std::lock_guard;
+using std::make_pair;
+using std::mutex;
+using std::shared_ptr;
+
+namespace google_cloud_debugger {
+
+shared_ptr<const ClassMetadata> ClassMetadataCache::Find(
+    CORDB_ADDRESS module_base_address, mdTypeDef class_token) const {
+  lock_guard<mutex> lock(mutex_);
+  auto metadata = metadata_.find(make_pair(module_base_address, class_token));
+  if (metadata == metadata_.end()) {
+    return nullptr;
+  }
+
+  return metadata->second;
+}
+
+shared_ptr<const ClassMetadata> ClassMetadataCache::Add(
+    CORDB_ADDRESS module_base_address, mdTypeDef class_token,
+    shared_ptr<const ClassMetadata> metadata) {
+  lock_guard<mutex> lock(mutex_);
+  auto inserted = metadata_.insert(
+      make_pair(make_pair(module_base_address, class_token), metadata));
+  return inserted.first->second;
+}
+
+void ClassMetadataCache::RemoveModule(CORDB_ADDRESS module_base_address) {
+  lock_guard<mutex> lock(mutex_);
+  auto first =
+      metadata_.lower_bound(make_pair(module_base_address, mdTypeDef(0)));
+  auto last = first;
+  while (last != metadata_.end() && last->first.first == module_base_address) {
+    ++last;
+  }
+  metadata_.erase(first, last);
+}
+
+void ClassMetadataCache::Clear() {
+  lock_guard<mutex> lock(mutex_);
+  metadata_.clear();
+}
+
+size_t ClassMetadataCache::Size() const {
+  lock_guard<mutex> lock(mutex_);
+  return metadata_.size();
+}
+
+}  // namespace google_cloud_debugger
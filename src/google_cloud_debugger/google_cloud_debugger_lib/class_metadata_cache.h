@@ -0,0 +1,169 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CLASS_METADATA_CACHE_H_
+#define CLASS_METADATA_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ccomptr.h"
+#include "cor.h"
+#include "cordebug.h"
+
+namespace google_cloud_debugger {
+
+// Metadata of a field of a class, as returned by GetFieldProps.
+struct ClassFieldMetadata {
+  // Token that represents the field.
+  mdFieldDef field_def = 0;
+
+  // HRESULT of reading the metadata. The other members are only
+  // valid if this succeeded.
+  HRESULT hr = S_OK;
+
+  // Token to the type that implements the field.
+  mdTypeDef parent_token = 0;
+
+  // Name of the field. If the field is the backing field of a property,
+  // this is the name of the property.
+  std::string name;
+
+  // True if the field is the backing field of a property.
+  bool is_backing_field = false;
+
+  // Attribute flags applied to the field.
+  DWORD attributes = 0;
+
+  // Pointer to the metadata signature of the field.
+  PCCOR_SIGNATURE signature = nullptr;
+
+  // The number of bytes in signature.
+  ULONG signature_length = 0;
+
+  // The CorElementType of the default value of the field.
+  DWORD default_value_type_flags = 0;
+
+  // Pointer to the bytes of the default value of the field.
+  UVCP_CONSTANT default_value = nullptr;
+
+  // The size in wide characters of default_value if it is a string.
+  ULONG default_value_len = 0;
+};
+
+// Metadata of a property of a class, as returned by GetPropertyProps.
+struct ClassPropertyMetadata {
+  // Token that represents the property.
+  mdProperty property_def = 0;
+
+  // HRESULT of reading the metadata. The other members are only
+  // valid if this succeeded.
+  HRESULT hr = S_OK;
+
+  // Token to the type that implements the property.
+  mdTypeDef parent_token = 0;
+
+  // Name of the property.
+  std::string name;
+
+  // Attribute flags applied to the property.
+  DWORD attributes = 0;
+
+  // Pointer to the metadata signature of the property.
+  PCCOR_SIGNATURE signature = nullptr;
+
+  // The number of bytes in signature.
+  ULONG signature_length = 0;
+
+  // The CorElementType of the default value of the property.
+  DWORD default_value_type_flags = 0;
+
+  // Pointer to the bytes of the default value of the property.
+  UVCP_CONSTANT default_value = nullptr;
+
+  // The size in wide characters of default_value if it is a string.
+  ULONG default_value_len = 0;
+
+  // Token of the setter of the property.
+  mdMethodDef setter_function = 0;
+
+  // Token of the getter of the property.
+  mdMethodDef getter_function = 0;
+
+  // Tokens of the other methods associated with the property.
+  std::vector<mdMethodDef> other_methods;
+};
+
+// Fields and properties of a class. This cannot change while the module
+// of the class is loaded.
+struct ClassMetadata {
+  // The fields of the class, in metadata order.
+  std::vector<ClassFieldMetadata> fields;
+
+  // The properties of the class that are not backed by one of fields,
+  // in metadata order.
+  std::vector<ClassPropertyMetadata> properties;
+
+  // The IMetaDataImport the signatures and default values point into.
+  // Holding it keeps them valid.
+  CComPtr<IMetaDataImport> metadata_import;
+};
+
+// Cache of ClassMetadata, keyed by the base address of the module and
+// the token of the class. Unlike the values of static members, the
+// metadata is kept across breakpoint hits until the module is unloaded.
+// This class is thread-safe.
+class ClassMetadataCache {
+ public:
+  // Returns the metadata of class class_token in the module at
+  // module_base_address, or null if it is not cached.
+  std::shared_ptr<const ClassMetadata> Find(CORDB_ADDRESS module_base_address,
+                                            mdTypeDef class_token) const;
+
+  // Caches metadata for class class_token in the module at
+  // module_base_address. If another thread cached the metadata first,
+  // metadata is dropped. Returns the cached metadata.
+  std::shared_ptr<const ClassMetadata> Add(
+      CORDB_ADDRESS module_base_address, mdTypeDef class_token,
+      std::shared_ptr<const ClassMetadata> metadata);
+
+  // Removes the metadata of all classes in the module at
+  // module_base_address.
+  void RemoveModule(CORDB_ADDRESS module_base_address);
+
+  // Removes all the metadata.
+  void Clear();
+
+  // Returns the number of cached classes.
+  size_t Size() const;
+
+ private:
+  // Map of the module base address and class token to the metadata. The
+  // map is ordered so that the classes of a module are adjacent.
+  std::map<std::pair<CORDB_ADDRESS, mdTypeDef>,
+           std::shared_ptr<const ClassMetadata>>
+      metadata_;
+
+  // Protects metadata_.
+  mutable std::mutex mutex_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  CLASS_METADATA_CACHE_H_
@@ -15,6 +15,7 @@
 #ifndef CONSTANTS_H_
 #define CONSTANTS_H_
 
+#include <cstdint>
 #include <string>
 
 namespace google_cloud_debugger {
@@ -22,6 +23,11 @@ namespace google_cloud_debugger {
 // The buffer size to read and write pipes.
 static const int kBufferSize = 1024;
 
+// The largest number of bytes a pipe reads with one system call. Pipes start
+// reading kBufferSize bytes at a time and double that up to this size while
+// the reads keep filling the buffer.
+static const int kMaximumPipeReadSize = 65536;
+
 // The maximum amount of time to wait for a pipe connection in milliseconds.
 static const int kConnectionWaitTimeoutMs = 60000;
 
@@ -37,6 +43,32 @@ static const std::string kStartBreakpointMessage = "START_DEBUG_MESSAGE";
 // The end of a breakpoint message.
 static const std::string kEndBreakpointMessage = "END_DEBUG_MESSAGE";
 
+// Pipe protocol version where a breakpoint message is surrounded by
+// kStartBreakpointMessage and kEndBreakpointMessage. This is the version
+// used if the agent does not ask for another one.
+static const int kMarkerPipeProtocolVersion = 1;
+
+// Pipe protocol version where a breakpoint message is a frame made of
+// kBreakpointFrameMagic, the size of the message as a little-endian
+// uint32 and the message itself.
+static const int kLengthPrefixedPipeProtocolVersion = 2;
+
+// The first bytes of a length-prefixed breakpoint frame.
+static const std::string kBreakpointFrameMagic = "GCDF";
+
+// The first bytes of a length-prefixed frame that carries a batch of
+// breakpoints instead of one. Each breakpoint in the frame is stored as
+// its size as a little-endian uint32 followed by the message.
+static const std::string kBreakpointBatchFrameMagic = "GCDB";
+
+// The size of the header of a length-prefixed breakpoint frame
+// (magic and message size).
+static const std::uint32_t kBreakpointFrameHeaderSize = 8;
+
+// Length-prefixed breakpoint frames with a larger message size than this
+// are treated as corrupted (16 MB).
+static const std::uint32_t kMaximumBreakpointFrameSize = 16 * 1024 * 1024;
+
 // File extension for dll file.
 static const std::string kDllExtension = ".dll";
 
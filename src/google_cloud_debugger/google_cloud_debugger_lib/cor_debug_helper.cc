@@ -16,6 +16,7 @@
 
 #include <assert.h>
 #include <iostream>
+#include <limits>
 #include <vector>
 
 #include "ccomptr.h"
@@ -39,6 +40,8 @@ using std::vector;
 
 namespace google_cloud_debugger {
 
+TokenNameCache CorDebugHelper::name_cache_;
+
 HRESULT CorDebugHelper::GetMetadataImportFromICorDebugClass(
     ICorDebugClass *debug_class, IMetaDataImport **metadata_import,
     ostream *err_stream) {
@@ -333,7 +336,19 @@ HRESULT CorDebugHelper::CreateStrongHandle(ICorDebugValue *debug_value,
 HRESULT CorDebugHelper::ExtractStringFromICorDebugStringValue(
     ICorDebugStringValue *debug_string, std::string *returned_string,
     std::ostream *err_stream) {
-  if (!returned_string || !debug_string || !err_stream) {
+  ULONG32 returned_length;
+  ULONG32 string_length;
+  return ExtractStringPrefixFromICorDebugStringValue(
+      debug_string, std::numeric_limits<ULONG32>::max(), returned_string,
+      &returned_length, &string_length, err_stream);
+}
+
+HRESULT CorDebugHelper::ExtractStringPrefixFromICorDebugStringValue(
+    ICorDebugStringValue *debug_string, ULONG32 max_length,
+    std::string *returned_string, ULONG32 *returned_length,
+    ULONG32 *string_length, std::ostream *err_stream) {
+  if (!returned_string || !debug_string || !returned_length ||
+      !string_length || !err_stream) {
     return E_INVALIDARG;
   }
 
@@ -347,21 +362,37 @@ HRESULT CorDebugHelper::ExtractStringFromICorDebugStringValue(
     return hr;
   }
 
-  if (str_len == 0) {
+  *string_length = str_len;
+  if (str_len == 0 || max_length == 0) {
     *returned_string = "";
+    *returned_length = 0;
     return S_OK;
   }
 
+  // Only the prefix is copied out of the debuggee, so a large string does
+  // not have to be read and converted as a whole.
+  bool truncated = str_len > max_length;
+  ULONG32 read_len = truncated ? max_length : str_len + 1;
+
   // Plus 1 for the NULL at the end of the string.
-  str_len += 1;
-  std::vector<WCHAR> string_value(str_len, 0);
+  std::vector<WCHAR> string_value(truncated ? max_length + 1 : read_len, 0);
 
-  hr = debug_string->GetString(str_len, &str_returned_len, string_value.data());
+  hr = debug_string->GetString(read_len, &str_returned_len,
+                               string_value.data());
   if (FAILED(hr)) {
     *err_stream << "Failed to extract the string.";
     return hr;
   }
 
+  *returned_length = truncated ? max_length : str_len;
+
+  // Do not cut a surrogate pair in half.
+  if (truncated && string_value[max_length - 1] >= 0xD800 &&
+      string_value[max_length - 1] <= 0xDBFF) {
+    string_value[max_length - 1] = 0;
+    *returned_length -= 1;
+  }
+
   *returned_string = ConvertWCharPtrToString(string_value);
   return S_OK;
 }
@@ -773,10 +804,20 @@ HRESULT CorDebugHelper::GetTypeNameFromMdTypeDef(
     return E_INVALIDARG;
   }
 
+  TokenInfo type_info;
+  if (name_cache_.Find(metadata_import, type_token, &type_info)) {
+    *type_name = type_info.name;
+    if (base_token) {
+      *base_token = type_info.parent_token;
+    }
+    return S_OK;
+  }
+
   ULONG type_name_len = 0;
   DWORD type_flags = 0;
   HRESULT hr = metadata_import->GetTypeDefProps(
-      type_token, nullptr, 0, &type_name_len, &type_flags, base_token);
+      type_token, nullptr, 0, &type_name_len, &type_flags,
+      &type_info.parent_token);
   if (hr == S_FALSE) {
     hr = E_FAIL;
   }
@@ -789,13 +830,18 @@ HRESULT CorDebugHelper::GetTypeNameFromMdTypeDef(
   vector<WCHAR> wchar_type_name(type_name_len, 0);
   hr = metadata_import->GetTypeDefProps(type_token, wchar_type_name.data(),
                                         wchar_type_name.size(), &type_name_len,
-                                        &type_flags, base_token);
+                                        &type_flags, &type_info.parent_token);
   if (FAILED(hr)) {
     *err_stream << "Failed to get type name.";
     return hr;
   }
 
-  *type_name = ConvertWCharPtrToString(wchar_type_name);
+  type_info.name = ConvertWCharPtrToString(wchar_type_name);
+  name_cache_.Add(metadata_import, type_token, type_info);
+  *type_name = std::move(type_info.name);
+  if (base_token) {
+    *base_token = type_info.parent_token;
+  }
   return hr;
 }
 
@@ -806,6 +852,12 @@ HRESULT CorDebugHelper::GetTypeNameFromMdTypeRef(
     return E_INVALIDARG;
   }
 
+  TokenInfo type_info;
+  if (name_cache_.Find(metadata_import, type_token, &type_info)) {
+    *type_name = type_info.name;
+    return S_OK;
+  }
+
   ULONG type_name_len = 0;
   HRESULT hr = metadata_import->GetTypeRefProps(type_token, nullptr, nullptr, 0,
                                                 &type_name_len);
@@ -827,10 +879,62 @@ HRESULT CorDebugHelper::GetTypeNameFromMdTypeRef(
     return hr;
   }
 
-  *type_name = ConvertWCharPtrToString(wchar_type_name);
+  type_info.name = ConvertWCharPtrToString(wchar_type_name);
+  name_cache_.Add(metadata_import, type_token, type_info);
+  *type_name = std::move(type_info.name);
   return hr;
 }
 
+HRESULT CorDebugHelper::GetMethodNameFromMdMethodDef(
+    mdMethodDef method_token, IMetaDataImport *metadata_import,
+    std::string *method_name, mdTypeDef *class_token, ULONG *code_rva,
+    std::ostream *err_stream) {
+  if (!metadata_import || !method_name || !class_token || !code_rva) {
+    return E_INVALIDARG;
+  }
+
+  TokenInfo method_info;
+  if (name_cache_.Find(metadata_import, method_token, &method_info)) {
+    *method_name = method_info.name;
+    *class_token = method_info.parent_token;
+    *code_rva = method_info.code_rva;
+    return S_OK;
+  }
+
+  ULONG method_name_length = 0;
+  DWORD flags1 = 0;
+  ULONG signature_blob = 0;
+  DWORD flags2 = 0;
+  PCCOR_SIGNATURE method_signature = 0;
+
+  // Retrieves the length of the name of the method.
+  HRESULT hr = metadata_import->GetMethodProps(
+      method_token, &method_info.parent_token, nullptr, 0, &method_name_length,
+      &flags1, &method_signature, &signature_blob, &method_info.code_rva,
+      &flags2);
+  if (FAILED(hr)) {
+    *err_stream << "Failed to get length of name of method.";
+    return hr;
+  }
+
+  vector<WCHAR> wchar_method_name(method_name_length, 0);
+  hr = metadata_import->GetMethodProps(
+      method_token, &method_info.parent_token, wchar_method_name.data(),
+      wchar_method_name.size(), &method_name_length, &flags1,
+      &method_signature, &signature_blob, &method_info.code_rva, &flags2);
+  if (FAILED(hr)) {
+    *err_stream << "Failed to get name of method.";
+    return hr;
+  }
+
+  method_info.name = ConvertWCharPtrToString(wchar_method_name);
+  name_cache_.Add(metadata_import, method_token, method_info);
+  *method_name = std::move(method_info.name);
+  *class_token = method_info.parent_token;
+  *code_rva = method_info.code_rva;
+  return S_OK;
+}
+
 HRESULT CorDebugHelper::GetTypeNameFromMdToken(
     mdToken type_token, IMetaDataImport *metadata_import,
     std::string *type_name, std::ostream *err_stream) {
@@ -856,6 +960,12 @@ HRESULT CorDebugHelper::GetMdTypeDefAndMetaDataFromTypeRef(
     const std::vector<CComPtr<ICorDebugAssembly>> &loaded_assemblies,
     IMetaDataImport *type_ref_token_metadata, mdTypeDef *result_type_def,
     IMetaDataImport **result_type_def_metadata, std::ostream *err_stream) {
+  if (name_cache_.FindResolvedTypeRef(type_ref_token_metadata, type_ref_token,
+                                      result_type_def,
+                                      result_type_def_metadata)) {
+    return S_OK;
+  }
+
   // We cannot use ResolveTypeRef here. It will just return a E_NOTIMPL
   // See
   // https://blogs.msdn.microsoft.com/davbr/2011/10/17/metadata-tokens-run-time-ids-and-type-loading/
@@ -910,6 +1020,10 @@ HRESULT CorDebugHelper::GetMdTypeDefAndMetaDataFromTypeRef(
         continue;
       }
 
+      // Only successful resolutions are cached, since the type may be in
+      // an assembly that is not loaded yet.
+      name_cache_.AddResolvedTypeRef(type_ref_token_metadata, type_ref_token,
+                                     *result_type_def, metadata_import);
       *result_type_def_metadata = metadata_import;
       metadata_import->AddRef();
       return S_OK;
@@ -22,6 +22,7 @@
 #include "cor.h"
 #include "cordebug.h"
 #include "i_cor_debug_helper.h"
+#include "token_name_cache.h"
 
 namespace google_cloud_debugger {
 
@@ -94,6 +95,13 @@ class CorDebugHelper : public ICorDebugHelper {
       ICorDebugStringValue *debug_string, std::string *returned_string,
       std::ostream *err_stream) override;
 
+  // Extracts out at most max_length characters from the start of
+  // ICorDebugStringValue.
+  virtual HRESULT ExtractStringPrefixFromICorDebugStringValue(
+      ICorDebugStringValue *debug_string, ULONG32 max_length,
+      std::string *returned_string, ULONG32 *returned_length,
+      ULONG32 *string_length, std::ostream *err_stream) override;
+
   // Given a metadata token for the parameter param_token,
   // extracts out the parameter name.
   // metadata_import is the MetaDataImport of the module
@@ -184,6 +192,14 @@ class CorDebugHelper : public ICorDebugHelper {
                                          std::string *type_name,
                                          std::ostream *err_stream) override;
 
+  // Gets the name of the method with mdMethodDef token method_token,
+  // the mdTypeDef token of its class and the relative virtual address
+  // of its code.
+  virtual HRESULT GetMethodNameFromMdMethodDef(
+      mdMethodDef method_token, IMetaDataImport *metadata_import,
+      std::string *method_name, mdTypeDef *class_token, ULONG *code_rva,
+      std::ostream *err_stream) override;
+
   // Given a TypeRef token and its MetaDataImport, this function
   // converts it into a TypeDef token. The function will also return
   // the corresponding MetaDataImport for that token.
@@ -252,6 +268,23 @@ class CorDebugHelper : public ICorDebugHelper {
       ULONG *value_len,
       std::vector<uint8_t> *remaining_bytes) override;
 
+  // Starts caching the names of the tokens of metadata_import. This is
+  // called when the module of metadata_import is loaded. The names of
+  // the tokens of other IMetaDataImports are not cached.
+  static void AddMetaDataImportNames(IMetaDataImport *metadata_import) {
+    name_cache_.AddMetaDataImport(metadata_import);
+  }
+
+  // Removes the cached names of the tokens of metadata_import.
+  // This has to be called when the module of metadata_import is unloaded.
+  static void RemoveMetaDataImportNames(IMetaDataImport *metadata_import) {
+    name_cache_.RemoveMetaDataImport(metadata_import);
+  }
+
+  // Returns the cache of the names of tokens, which is shared by all
+  // CorDebugHelpers.
+  static const TokenNameCache &GetNameCache() { return name_cache_; }
+
  private:
   // Given a PCCOR_SIGNATURE signature, parses the next byte A.
   // Then, parses and skips the next A bytes.
@@ -264,6 +297,9 @@ class CorDebugHelper : public ICorDebugHelper {
   // Will modify the signature pointer PCCOR_SIGNATURE.
   HRESULT ParseAndCheckFirstByte(PCCOR_SIGNATURE *signature, ULONG *sig_len,
                                  CorCallingConvention calling_convention);
+
+  // Cache of the names of the tokens looked up by all CorDebugHelpers.
+  static TokenNameCache name_cache_;
 };
 
 }  // namespace google_cloud_debugger
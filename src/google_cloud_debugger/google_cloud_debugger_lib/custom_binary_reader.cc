@@ -16,8 +16,10 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <cstring>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <vector>
 
 #include "metadata_headers.h"
@@ -29,7 +31,6 @@
 using std::cerr;
 using std::ifstream;
 using std::ios;
-using std::min;
 using std::streampos;
 using std::string;
 using std::unique_ptr;
@@ -51,30 +52,51 @@ const std::uint32_t kCompressedSignedIntOneByteUncompressMask = 0xFFFFFFC0;
 const std::uint32_t kCompressedSignedIntTwoByteUncompressMask = 0xFFFFE000;
 const std::uint32_t kCompressedSignedIntFourByteUncompressMask = 0xF0000000;
 
-// Size of the buffer used by GetString to read characters into.
-const std::uint32_t kStringBufferSize = 100;
-
 bool CustomBinaryStream::ConsumeStream(std::istream *stream) {
   assert(stream != nullptr);
 
-  stream_.reset(stream);
+  unique_ptr<std::istream> owned_stream(stream);
+  if (!owned_stream->good()) {
+    cerr << "Invalid stream.";
+    return false;
+  }
 
-  if (stream_->good()) {
-    stream_->unsetf(std::ios::skipws);
-    stream_->seekg(0, stream_->end);
-    absolute_end_ = stream_->tellg();
-    relative_end_ = absolute_end_;
-    stream_->seekg(0, stream_->beg);
-    begin_ = stream_->tellg();
+  owned_stream->unsetf(std::ios::skipws);
+  owned_stream->seekg(0, owned_stream->end);
+  streampos stream_end = owned_stream->tellg();
+  owned_stream->seekg(0, owned_stream->beg);
+  if (owned_stream->fail() || stream_end < 0 ||
+      static_cast<std::uint64_t>(stream_end) >
+          std::numeric_limits<std::uint32_t>::max()) {
+    cerr << "Invalid stream.";
+    return false;
+  }
 
-    return true;
+  vector<uint8_t> buffer(static_cast<size_t>(stream_end));
+  owned_stream->read(reinterpret_cast<char *>(buffer.data()), buffer.size());
+  if (owned_stream->gcount() != static_cast<std::streamsize>(buffer.size())) {
+    cerr << "Failed to read the stream.";
+    return false;
   }
 
-  cerr << "Invalid stream.";
-  return false;
+  mapped_file_.reset();
+  buffer_ = std::move(buffer);
+  SetContent(buffer_.data(), buffer_.size());
+  return true;
 }
 
 bool CustomBinaryStream::ConsumeFile(const string &file) {
+  unique_ptr<MemoryMappedFile> mapped_file(new (std::nothrow)
+                                               MemoryMappedFile());
+  if (mapped_file && mapped_file->Open(file) &&
+      mapped_file->GetSize() <= std::numeric_limits<std::uint32_t>::max()) {
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    mapped_file_ = std::move(mapped_file);
+    SetContent(mapped_file_->GetData(), mapped_file_->GetSize());
+    return true;
+  }
+
   unique_ptr<std::ifstream> file_stream = unique_ptr<std::ifstream>(
       new (std::nothrow) ifstream(file, ios::in | ios::binary | ios::ate));
   // Let the caller throws the error.
@@ -85,180 +107,154 @@ bool CustomBinaryStream::ConsumeFile(const string &file) {
   return ConsumeStream(file_stream.release());
 }
 
+void CustomBinaryStream::SetContent(const std::uint8_t *content,
+                                    std::uint64_t size) {
+  data_ = content;
+  position_ = 0;
+  absolute_end_ = static_cast<uint32_t>(size);
+  relative_end_ = absolute_end_;
+}
+
 bool CustomBinaryStream::ReadBytes(uint8_t *result, uint32_t bytes_to_read,
                                    uint32_t *bytes_read) {
-  assert(stream_ != nullptr);
-  if (relative_end_ - stream_->tellg() < bytes_to_read) {
+  *bytes_read = 0;
+  if (relative_end_ - position_ < bytes_to_read) {
     cerr << "End of stream reached.";
     return false;
   }
 
-  stream_->read(reinterpret_cast<char *>(result), bytes_to_read);
-  *bytes_read = stream_->gcount();
-  return *bytes_read == bytes_to_read;
+  memcpy(result, data_ + position_, bytes_to_read);
+  position_ += bytes_to_read;
+  *bytes_read = bytes_to_read;
+  return true;
 }
 
-bool CustomBinaryStream::HasNext() const {
-  assert(stream_ != nullptr);
-  return stream_->tellg() < relative_end_;
-}
+bool CustomBinaryStream::HasNext() const { return position_ < relative_end_; }
 
 bool CustomBinaryStream::Peek(uint8_t *result) const {
-  assert(stream_ != nullptr);
   if (!HasNext()) {
     cerr << "End of stream reached.";
     return false;
   }
 
-  *result = stream_->peek();
+  *result = data_[position_];
   return true;
 }
 
 bool CustomBinaryStream::SeekFromCurrent(uint32_t index) {
-  assert(stream_ != nullptr);
   // Have to take into account the end_ based on the stream
   // length that we set.
-  if (relative_end_ - stream_->tellg() < index) {
+  if (relative_end_ - position_ < index) {
     cerr << "Seeking to a position out of range of the stream.";
     return false;
   }
 
-  stream_->seekg(index, stream_->cur);
-  if (stream_->fail()) {
-    cerr << "Seek operation failed.";
-    stream_->clear();
-    return false;
-  }
-
+  position_ += index;
   return true;
 }
 
 bool CustomBinaryStream::SeekFromOrigin(uint32_t position) {
-  assert(stream_ != nullptr);
-
-  stream_->seekg(position, stream_->beg);
-  if (stream_->fail()) {
+  if (position > absolute_end_) {
     cerr << "Seek operation failed.";
-    stream_->clear();
     return false;
   }
+
+  position_ = position;
   return true;
 }
 
 bool CustomBinaryStream::SetStreamLength(uint32_t length) {
-  assert(stream_ != nullptr);
-
-  streampos cur_pos = stream_->tellg();
-  stream_->seekg(length, stream_->cur);
-  if (stream_->fail()) {
-    stream_->clear();
-    stream_->seekg(cur_pos);
+  if (absolute_end_ - position_ < length) {
     cerr << "Setting stream length to " << length
          << " will set the relative end of the stream to a position"
          << " outside the absolute end of the stream.";
     return false;
   }
 
-  if (stream_->tellg() > relative_end_) {
-    stream_->seekg(cur_pos);
+  if (position_ + length > relative_end_) {
     cerr << "Setting stream length to " << length
          << " will set the relative end of the stream to a position"
          << " outside the relative end of the stream.";
     return false;
   }
 
-  // Sets the relative end and sets the stream back.
-  relative_end_ = stream_->tellg();
-  stream_->seekg(cur_pos);
+  relative_end_ = position_ + length;
   return true;
 }
 
-void CustomBinaryStream::ResetStreamLength() {
-  assert(stream_ != nullptr);
+void CustomBinaryStream::ResetStreamLength() { relative_end_ = absolute_end_; }
 
-  relative_end_ = absolute_end_;
-}
-
-bool CustomBinaryStream::GetString(std::string *result, std::uint32_t offset) {
-  result->clear();
-  assert(stream_ != nullptr);
-
-  // Makes a copy of the current position so we can restores the stream.
-  streampos previous_pos = stream_->tellg();
-  stream_->seekg(offset, stream_->beg);
-  if (stream_->fail()) {
-    stream_->clear();
-    stream_->seekg(previous_pos);
+bool CustomBinaryStream::GetStringView(std::uint32_t offset,
+                                       const char **result,
+                                       std::uint32_t *length) const {
+  if (offset > relative_end_) {
     cerr << "Failed to seek to the offset point.";
     return false;
   }
 
-  // Read 100 characters at a time or until the end of the stream,
-  // whichever is smaller.
-  uint32_t chars_left = relative_end_ - stream_->tellg();
-  uint32_t char_to_read = min(kStringBufferSize, chars_left);
-  vector<char> buffer(char_to_read, 0);
-
-  while (char_to_read != 0) {
-    // Reads char_to_read bytes from the buffer.
-    stream_->read(buffer.data(), char_to_read);
-    if (stream_->fail()) {
-      stream_->clear();
-      stream_->seekg(previous_pos);
-      cerr << "Failed to read characters from the stream.";
-      return false;
-    }
+  const char *start = reinterpret_cast<const char *>(data_ + offset);
+  const void *null_char_pos = memchr(start, 0, relative_end_ - offset);
+  *result = start;
+  if (null_char_pos != nullptr) {
+    *length = static_cast<const char *>(null_char_pos) - start;
+  } else {
+    // No null character so the string goes to the end of the stream.
+    *length = relative_end_ - offset;
+  }
 
-    // Finds the null character.
-    vector<char>::iterator null_char_pos =
-        std::find(buffer.begin(), buffer.end(), 0);
+  return true;
+}
 
-    result->append(buffer.begin(), null_char_pos);
-    // Stop reading if we found the null character.
-    if (null_char_pos != buffer.end()) {
-      break;
-    }
+bool CustomBinaryStream::GetString(std::string *result,
+                                   std::uint32_t offset) const {
+  result->clear();
 
-    // If we didn't find the null character, continue reading.
-    chars_left = relative_end_ - stream_->tellg();
-    char_to_read = min((uint32_t)buffer.size(), chars_left);
+  const char *view;
+  uint32_t length;
+  if (!GetStringView(offset, &view, &length)) {
+    return false;
   }
 
-  stream_->seekg(previous_pos);
+  result->assign(view, length);
   return true;
 }
 
-bool CustomBinaryStream::GetBlobBytes(
-    std::uint32_t offset, std::vector<uint8_t> *result) {
+bool CustomBinaryStream::GetBlobBytes(std::uint32_t offset,
+                                      std::vector<uint8_t> *result) const {
   result->clear();
-  assert(stream_ != nullptr);
-
-  // Makes a copy of the current position so we can restores the stream.
-  streampos previous_pos = stream_->tellg();
-  stream_->seekg(offset, stream_->beg);
-  if (stream_->fail()) {
-    stream_->clear();
-    stream_->seekg(previous_pos);
+
+  const uint8_t *view;
+  uint32_t length;
+  if (!GetBlobView(offset, &view, &length)) {
+    return false;
+  }
+
+  result->assign(view, view + length);
+  return true;
+}
+
+bool CustomBinaryStream::GetBlobView(std::uint32_t offset,
+                                     const std::uint8_t **result,
+                                     std::uint32_t *length) const {
+  if (offset > relative_end_) {
     cerr << "Failed to seek to the offset point.";
     return false;
   }
 
+  uint32_t position = offset;
   uint32_t const_size = 0;
-  if (!ReadCompressedUInt32(&const_size)) {
-      stream_->clear();
-      stream_->seekg(previous_pos);
-      cerr << "Failed to get length of blob.";
-      return false;
+  if (!DecodeCompressedUInt32(&position, relative_end_, &const_size)) {
+    cerr << "Failed to get length of blob.";
+    return false;
   }
 
-  uint32_t bytes_read;
-  result->resize(const_size);
-  if (!ReadBytes(result->data(), const_size, &bytes_read)) {
-    stream_->seekg(previous_pos);
+  if (relative_end_ - position < const_size) {
+    cerr << "End of stream reached.";
     return false;
   }
 
-  stream_->seekg(previous_pos);
+  *result = data_ + position;
+  *length = const_size;
   return true;
 }
 
@@ -269,40 +265,40 @@ bool CustomBinaryStream::ReadByte(uint8_t *result) {
 
 bool CustomBinaryStream::ReadUInt16(uint16_t *result) {
   uint32_t bytes_read = 0;
-  vector<uint8_t> buffer(2, 0);
-  if (!ReadBytes(buffer.data(), 2, &bytes_read)) {
-    return false;
-  }
-
-  memcpy(result, buffer.data(), 2);
-  return true;
+  return ReadBytes(reinterpret_cast<uint8_t *>(result), 2, &bytes_read);
 }
 
 bool CustomBinaryStream::ReadUInt32(uint32_t *result) {
   uint32_t bytes_read = 0;
-  vector<uint8_t> buffer(4, 0);
-  if (!ReadBytes(buffer.data(), 4, &bytes_read)) {
+  return ReadBytes(reinterpret_cast<uint8_t *>(result), 4, &bytes_read);
+}
+
+bool CustomBinaryStream::ReadCompressedUInt32(uint32_t *uncompress_int) {
+  if (!DecodeCompressedUInt32(&position_, relative_end_, uncompress_int)) {
+    cerr << "Failed to read compressed integer.";
     return false;
   }
 
-  memcpy(result, buffer.data(), 4);
   return true;
 }
 
-bool CustomBinaryStream::ReadCompressedUInt32(uint32_t *uncompress_int) {
-  uint8_t first_byte;
-  if (!ReadByte(&first_byte)) {
+bool CustomBinaryStream::DecodeCompressedUInt32(
+    uint32_t *position, uint32_t end, uint32_t *uncompress_int) const {
+  if (*position >= end) {
     return false;
   }
 
+  const uint8_t *bytes = data_ + *position;
+  uint8_t first_byte = bytes[0];
+
   // If the first bit is a 0, return the value. Range 0 - 0x7F.
   if ((first_byte & kCompressedIntOneByteMask) == 0) {
     *uncompress_int = first_byte;
+    *position += 1;
     return true;
   }
 
-  uint8_t second_byte;
-  if (!ReadByte(&second_byte)) {
+  if (end - *position < 2) {
     return false;
   }
 
@@ -310,14 +306,13 @@ bool CustomBinaryStream::ReadCompressedUInt32(uint32_t *uncompress_int) {
   // Mask it with 0b11000000 (0xC0) and confirm the result is 0b10000000 (0x80).
   // Result should be in the range 0x80 - 0x3FFF.
   if ((first_byte & kCompressedIntTwoByteMask) == kCompressedIntOneByteMask) {
-    *uncompress_int = ((first_byte << 8) | second_byte) &
-                      kCompressedUIntTwoByteUncompressMask;
+    *uncompress_int =
+        ((first_byte << 8) | bytes[1]) & kCompressedUIntTwoByteUncompressMask;
+    *position += 2;
     return true;
   }
 
-  uint8_t third_byte;
-  uint8_t fourth_byte;
-  if (!ReadByte(&third_byte) || !ReadByte(&fourth_byte)) {
+  if (end - *position < 4) {
     return false;
   }
 
@@ -325,9 +320,10 @@ bool CustomBinaryStream::ReadCompressedUInt32(uint32_t *uncompress_int) {
   // Mask it with 0b11100000 (0xE0) and confirm the result is 0b11000000 (0xC0).
   // Result should be in the range 0x4000 - 0x1FFFFFFF.
   if ((first_byte & kCompressedIntFourByteMask) == kCompressedIntTwoByteMask) {
-    *uncompress_int = ((first_byte << 24) | (second_byte << 16) |
-                       (third_byte << 8) | fourth_byte) &
-                      kCompressedUIntFourByteUncompressMask;
+    *uncompress_int =
+        ((first_byte << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3]) &
+        kCompressedUIntFourByteUncompressMask;
+    *position += 4;
     return true;
   }
 
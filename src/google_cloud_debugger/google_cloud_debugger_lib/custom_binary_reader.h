@@ -24,6 +24,7 @@
 
 #include "cor.h"
 
+#include "memory_mapped_file.h"
 #include "metadata_tables.h"
 
 // typedef std::vector<uint8_t>::const_iterator binary_stream_iter;
@@ -37,17 +38,21 @@ enum Heap : std::uint8_t {
   BlobsHeap = 0x04
 };
 
-// Class that consumes a file or a uint8_t vector and produces a
+// Class that consumes a file or a stream and produces a
 // binary stream. This stream is used to read byte, integers,
 // compressed integers and table index.
+// Reads are bounds-checked pointer reads into an in-memory view of
+// the content: a memory mapping of the file for ConsumeFile or an owned
+// buffer for ConsumeStream.
 class CustomBinaryStream {
  public:
-  // Consumes a binary stream pointer, takes ownership
-  // of the underlying stream and makes it the underlying
-  // stream of this class.
+  // Consumes a binary stream pointer, takes ownership of it and
+  // copies its content into a buffer owned by this class.
   bool ConsumeStream(std::istream *stream);
 
   // Consumes a file and exposes the file content as a binary stream.
+  // The file is memory-mapped. If it cannot be mapped, the file is read
+  // through ConsumeStream instead.
   bool ConsumeFile(const std::string &file);
 
   // Returns true if there is a next byte in the stream.
@@ -73,12 +78,27 @@ class CustomBinaryStream {
 
   // Gets a string starting from the offset to a null terminating character or the end of the stream.
   // This function does not change the stream pointer.
-  bool GetString(std::string *result, std::uint32_t offset);
+  bool GetString(std::string *result, std::uint32_t offset) const;
+
+  // Same as GetString but does not copy the string. Sets result to the
+  // start of the string in the underlying content and length to the
+  // number of characters before the null terminating character.
+  // The view is valid until this stream is destroyed or consumes
+  // another file or stream.
+  bool GetStringView(std::uint32_t offset, const char **result,
+                     std::uint32_t *length) const;
 
   // Gets blob bytes starting from offset in the stream.
   // The first byte will tell us the length of the blob.
   // This function does not change the stream pointer.
-  bool GetBlobBytes(std::uint32_t offset, std::vector<uint8_t> *result);
+  bool GetBlobBytes(std::uint32_t offset, std::vector<uint8_t> *result) const;
+
+  // Same as GetBlobBytes but does not copy the blob. Sets result to the
+  // first byte of the blob in the underlying content and length to the
+  // number of bytes in it. The view has the same lifetime as the one of
+  // GetStringView.
+  bool GetBlobView(std::uint32_t offset, const std::uint8_t **result,
+                   std::uint32_t *length) const;
 
   // Reads the next byte in the stream. Returns false if the byte
   // cannot be read.
@@ -124,21 +144,38 @@ class CustomBinaryStream {
                       std::uint32_t *table_index);
 
   // Returns the current position of the stream.
-  std::streampos Current() { return stream_->tellg(); }
+  std::uint32_t Current() const { return position_; }
+
+  // Returns the number of bytes left before the end of the stream.
+  std::uint32_t GetRemainingSize() const { return relative_end_ - position_; }
 
  private:
-  // The underlying binary stream.
-  std::unique_ptr<std::istream> stream_;
+  // Decodes a compressed unsigned integer starting at *position without
+  // reading past end. Advances *position past the integer on success.
+  bool DecodeCompressedUInt32(std::uint32_t *position, std::uint32_t end,
+                              std::uint32_t *result) const;
+
+  // Points data_ at content of the given size and resets the positions.
+  void SetContent(const std::uint8_t *content, std::uint64_t size);
+
+  // The memory mapping of the file if the content comes from ConsumeFile.
+  std::unique_ptr<MemoryMappedFile> mapped_file_;
+
+  // The buffer that holds the content if it comes from ConsumeStream.
+  std::vector<std::uint8_t> buffer_;
+
+  // The content of the stream. Points into either mapped_file_ or buffer_.
+  const std::uint8_t *data_ = nullptr;
 
-  // The begin position of the stream.
-  std::streampos begin_;
+  // The current position of the stream.
+  std::uint32_t position_ = 0;
 
   // The absolute end position of the stream.
-  std::streampos absolute_end_;
+  std::uint32_t absolute_end_ = 0;
 
   // The relative end position of the stream (sets by SetStreamLength), which
   // is as far in a PDB file as we need to read.
-  std::streampos relative_end_;
+  std::uint32_t relative_end_ = 0;
 };
 
 }  // namespace google_cloud_debugger_portable_pdb
@@ -14,12 +14,15 @@
 
 #include "dbg_array.h"
 
+#include <cstring>
 #include <iostream>
 
 #include "class_names.h"
 #include "dbg_breakpoint.h"
+#include "dbg_primitive.h"
 #include "i_dbg_object_factory.h"
 #include "i_cor_debug_helper.h"
+#include "i_eval_coordinator.h"
 #include "type_signature.h"
 #include "variable_wrapper.h"
 
@@ -30,6 +33,93 @@ using std::vector;
 
 namespace google_cloud_debugger {
 
+namespace {
+
+// Creates a DbgPrimitive<T> from the bytes of an array item.
+template <typename T>
+unique_ptr<DbgObject> CreatePrimitiveItem(const BYTE *item_bytes) {
+  T value;
+  memcpy(&value, item_bytes, sizeof(T));
+  return unique_ptr<DbgObject>(new (std::nothrow) DbgPrimitive<T>(value));
+}
+
+// Creates a DbgPrimitive<bool> from the byte of a .NET Boolean array item.
+// The byte is not copied into a bool since a Boolean can hold any nonzero
+// value, which is not a valid bool.
+unique_ptr<DbgObject> CreateBooleanItem(const BYTE *item_bytes) {
+  return unique_ptr<DbgObject>(new (std::nothrow)
+                                   DbgPrimitive<bool>(*item_bytes != 0));
+}
+
+// Sets creator to the function that creates an item of type element_type
+// from its bytes and item_size to the size of the item. Returns false
+// if element_type is not a primitive whose bytes can be copied.
+// Char is not included since DbgPrimitive<char> is narrower than a
+// .NET char.
+bool GetPrimitiveItemCreator(
+    CorElementType element_type,
+    unique_ptr<DbgObject> (**creator)(const BYTE *item_bytes),
+    ULONG32 *item_size) {
+  switch (element_type) {
+    case CorElementType::ELEMENT_TYPE_BOOLEAN:
+      *creator = &CreateBooleanItem;
+      *item_size = sizeof(BYTE);
+      return true;
+    case CorElementType::ELEMENT_TYPE_I:
+      *creator = &CreatePrimitiveItem<intptr_t>;
+      *item_size = sizeof(intptr_t);
+      return true;
+    case CorElementType::ELEMENT_TYPE_U:
+      *creator = &CreatePrimitiveItem<uintptr_t>;
+      *item_size = sizeof(uintptr_t);
+      return true;
+    case CorElementType::ELEMENT_TYPE_I1:
+      *creator = &CreatePrimitiveItem<int8_t>;
+      *item_size = sizeof(int8_t);
+      return true;
+    case CorElementType::ELEMENT_TYPE_U1:
+      *creator = &CreatePrimitiveItem<uint8_t>;
+      *item_size = sizeof(uint8_t);
+      return true;
+    case CorElementType::ELEMENT_TYPE_I2:
+      *creator = &CreatePrimitiveItem<int16_t>;
+      *item_size = sizeof(int16_t);
+      return true;
+    case CorElementType::ELEMENT_TYPE_U2:
+      *creator = &CreatePrimitiveItem<uint16_t>;
+      *item_size = sizeof(uint16_t);
+      return true;
+    case CorElementType::ELEMENT_TYPE_I4:
+      *creator = &CreatePrimitiveItem<int32_t>;
+      *item_size = sizeof(int32_t);
+      return true;
+    case CorElementType::ELEMENT_TYPE_U4:
+      *creator = &CreatePrimitiveItem<uint32_t>;
+      *item_size = sizeof(uint32_t);
+      return true;
+    case CorElementType::ELEMENT_TYPE_I8:
+      *creator = &CreatePrimitiveItem<int64_t>;
+      *item_size = sizeof(int64_t);
+      return true;
+    case CorElementType::ELEMENT_TYPE_U8:
+      *creator = &CreatePrimitiveItem<uint64_t>;
+      *item_size = sizeof(uint64_t);
+      return true;
+    case CorElementType::ELEMENT_TYPE_R4:
+      *creator = &CreatePrimitiveItem<float>;
+      *item_size = sizeof(float);
+      return true;
+    case CorElementType::ELEMENT_TYPE_R8:
+      *creator = &CreatePrimitiveItem<double>;
+      *item_size = sizeof(double);
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
 void DbgArray::Initialize(ICorDebugValue *debug_value, BOOL is_null) {
   SetIsNull(is_null);
   CComPtr<ICorDebugType> debug_type;
@@ -156,26 +246,41 @@ HRESULT DbgArray::PopulateMembers(
     return S_OK;
   }
 
-  int total_items = 1;
-  for (int i = 0; i < dimensions_.size(); ++i) {
-    total_items *= dimensions_[i];
-  }
+  int total_items = GetArraySize();
 
   // We use this dimensions_tracker to help us track which combination
   // of the array dimensions we are currently at (see comments just before the
-  // while loop).
+  // for loop).
   vector<ULONG32> dimensions_tracker(dimensions_.size(), 0);
 
-  int current_index = 0;
   // If this was not set yet, use the current maximum collection size
   // from DbgBreakpoint.
   if (max_items_to_retrieved_ == 0) {
     max_items_to_retrieved_ = DbgBreakpoint::GetMaximumCollectionSize();
   }
 
-  // In this while loop, we visit all possible combinations of the dimensions_
+  int items_to_retrieve = total_items;
+  if (static_cast<std::uint32_t>(items_to_retrieve) > max_items_to_retrieved_) {
+    items_to_retrieve = max_items_to_retrieved_;
+  }
+
+  // Arrays of primitives are read with a single read of the debuggee
+  // memory. Other arrays have their items retrieved one by one.
+  vector<BYTE> item_bytes;
+  ULONG32 item_size = 0;
+  CORDB_ADDRESS item_address = 0;
+  PrimitiveItemCreator creator = nullptr;
+  bool read_in_bulk =
+      ReadPrimitiveItems(items_to_retrieve, eval_coordinator, &item_bytes,
+                         &item_size, &item_address, &creator);
+  CorElementType element_type = CorElementType::ELEMENT_TYPE_END;
+  if (read_in_bulk) {
+    element_type = empty_object_->GetCorElementType();
+  }
+
+  // In this for loop, we visit all possible combinations of the dimensions_
   // array to print out all the items. For example, let's assume that the array
-  // has dimensions 2x3x4, then the while loop will go in this direction:
+  // has dimensions 2x3x4, then the for loop will go in this direction:
   // 0 0 0 -> 0 0 1 -> 0 0 2 -> 0 0 3 ->
   // 0 1 0 -> 0 1 1 -> 0 1 2 -> 0 1 3 ->
   // 0 2 0 -> 0 2 1 -> 0 2 2 -> 0 2 3 ->
@@ -185,34 +290,25 @@ HRESULT DbgArray::PopulateMembers(
   // 2 0 0 -> 2 0 1 -> 2 0 2 -> 2 0 3 ->
   // 2 1 0 -> 2 1 1 -> 2 1 2 -> 2 1 3 ->
   // 2 2 0 -> 2 2 1 -> 2 2 2 -> 2 2 3
-  while (current_index < total_items &&
-         current_index < max_items_to_retrieved_) {
+  string name;
+  for (int current_index = 0; current_index < items_to_retrieve;
+       ++current_index) {
     // Uses the current combination as the name.
-    string name = "[";
-    for (int index = 0; index < dimensions_tracker.size(); ++index) {
-      name += std::to_string(dimensions_tracker[index]);
-      if (index != dimensions_tracker.size() - 1) {
-        name += ", ";
-      }
-    }
-    name += "]";
+    GetItemName(dimensions_tracker, &name);
 
-    ++current_index;
     // Increase the combination by 1. For example: 0 0 0 becomes 0 0 1,
     // 0 1 0 becomes 0 1 1, 0 1 1 becomes 1 0 0.
     // First, we will find an index that we can increase.
-    if (current_index < total_items) {
-      int current_dimension_index = dimensions_.size() - 1;
-      while (current_dimension_index >= 0) {
-        // Spill over the addition until we can't.
-        ++dimensions_tracker[current_dimension_index];
-        if (dimensions_tracker[current_dimension_index] ==
-            dimensions_[current_dimension_index]) {
-          dimensions_tracker[current_dimension_index] = 0;
-          current_dimension_index -= 1;
-        } else {
-          break;
-        }
+    int current_dimension_index = dimensions_.size() - 1;
+    while (current_dimension_index >= 0) {
+      // Spill over the addition until we can't.
+      ++dimensions_tracker[current_dimension_index];
+      if (dimensions_tracker[current_dimension_index] ==
+          dimensions_[current_dimension_index]) {
+        dimensions_tracker[current_dimension_index] = 0;
+        current_dimension_index -= 1;
+      } else {
+        break;
       }
     }
 
@@ -220,9 +316,23 @@ HRESULT DbgArray::PopulateMembers(
     Variable *member = variable_proto->add_members();
     member->set_name(name);
 
+    unique_ptr<DbgObject> result_object;
+    if (read_in_bulk) {
+      result_object = creator(item_bytes.data() + current_index * item_size);
+      if (!result_object) {
+        WriteError("Failed to create array item.");
+        SetErrorStatusMessage(member, this);
+        continue;
+      }
+
+      result_object->SetCorElementType(element_type);
+      result_object->SetAddress(item_address + current_index * item_size);
+      members->push_back(VariableWrapper(member, std::move(result_object)));
+      continue;
+    }
+
     CComPtr<ICorDebugValue> array_item;
-    // Minus one here since we increase it above.
-    HRESULT hr = GetArrayItem(current_index - 1, &array_item);
+    HRESULT hr = GetArrayItem(current_index, &array_item);
 
     if (FAILED(hr)) {
       // Output the error on why we failed to print out.
@@ -230,7 +340,6 @@ HRESULT DbgArray::PopulateMembers(
       continue;
     }
 
-    unique_ptr<DbgObject> result_object;
     hr = object_factory_->CreateDbgObject(
         array_item, GetCreationDepth() - 1,
         &result_object, GetErrorStream());
@@ -249,6 +358,80 @@ HRESULT DbgArray::PopulateMembers(
   return S_OK;
 }
 
+bool DbgArray::ReadPrimitiveItems(int item_count,
+                                  IEvalCoordinator *eval_coordinator,
+                                  vector<BYTE> *item_bytes,
+                                  ULONG32 *item_size,
+                                  CORDB_ADDRESS *item_address,
+                                  PrimitiveItemCreator *creator) {
+  if (item_count <= 0 || !empty_object_ || !object_handle_) {
+    return false;
+  }
+
+  if (!GetPrimitiveItemCreator(empty_object_->GetCorElementType(), creator,
+                               item_size)) {
+    return false;
+  }
+
+  if (static_cast<std::uint64_t>(item_count) * *item_size >
+      kMaximumBulkReadSize) {
+    return false;
+  }
+
+  CComPtr<ICorDebugThread> debug_thread;
+  HRESULT hr = eval_coordinator->GetActiveDebugThread(&debug_thread);
+  if (FAILED(hr) || !debug_thread) {
+    return false;
+  }
+
+  CComPtr<ICorDebugProcess> debug_process;
+  hr = debug_thread->GetProcess(&debug_process);
+  if (FAILED(hr) || !debug_process) {
+    return false;
+  }
+
+  // The items of an array are stored contiguously in the same order
+  // as GetElementAtPosition, so the window starts at the first item.
+  CComPtr<ICorDebugValue> first_item;
+  hr = GetArrayItem(0, &first_item);
+  if (FAILED(hr) || !first_item) {
+    return false;
+  }
+
+  ULONG32 first_item_size = 0;
+  hr = first_item->GetSize(&first_item_size);
+  if (FAILED(hr) || first_item_size != *item_size) {
+    return false;
+  }
+
+  hr = first_item->GetAddress(item_address);
+  if (FAILED(hr) || *item_address == 0) {
+    return false;
+  }
+
+  item_bytes->resize(item_count * *item_size);
+  SIZE_T bytes_read = 0;
+  hr = debug_process->ReadMemory(*item_address, item_bytes->size(),
+                                 item_bytes->data(), &bytes_read);
+  if (FAILED(hr) || bytes_read != item_bytes->size()) {
+    return false;
+  }
+
+  return true;
+}
+
+void DbgArray::GetItemName(const vector<ULONG32> &dimensions_tracker,
+                           string *name) {
+  name->assign(1, '[');
+  for (size_t index = 0; index < dimensions_tracker.size(); ++index) {
+    if (index != 0) {
+      name->append(", ");
+    }
+    name->append(std::to_string(dimensions_tracker[index]));
+  }
+  name->push_back(']');
+}
+
 HRESULT DbgArray::GetTypeString(std::string *type_string) {
   if (FAILED(initialize_hr_)) {
     return initialize_hr_;
@@ -16,6 +16,7 @@
 #define DBG_ARRAY_H_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "dbg_reference_object.h"
@@ -97,6 +98,31 @@ class DbgArray : public DbgReferenceObject {
   HRESULT GetTypeSignature(TypeSignature *type_signature) override;
 
  private:
+  // Creates a DbgObject for an array item from the bytes of its value.
+  typedef std::unique_ptr<DbgObject> (*PrimitiveItemCreator)(
+      const BYTE *item_bytes);
+
+  // If the items of the array are primitives, reads the first item_count
+  // items with a single read of the debuggee memory instead of retrieving
+  // them one by one. On success, sets item_bytes to the values of the
+  // items, item_size to the size of each item, item_address to the address
+  // of the first item and creator to the function that turns the bytes of
+  // an item into a DbgObject. Returns false if the items are not primitives
+  // or cannot be read in bulk.
+  bool ReadPrimitiveItems(int item_count, IEvalCoordinator *eval_coordinator,
+                          std::vector<BYTE> *item_bytes, ULONG32 *item_size,
+                          CORDB_ADDRESS *item_address,
+                          PrimitiveItemCreator *creator);
+
+  // Sets name to the name of the item at the position given by
+  // dimensions_tracker, for example "[1, 2]".
+  static void GetItemName(const std::vector<ULONG32> &dimensions_tracker,
+                          std::string *name);
+
+  // The maximum number of bytes read from the debuggee at once by
+  // ReadPrimitiveItems. Larger arrays are retrieved item by item.
+  static const ULONG32 kMaximumBulkReadSize = 1 << 20;
+
   // The type of the array.
   CComPtr<ICorDebugType> array_type_;
 
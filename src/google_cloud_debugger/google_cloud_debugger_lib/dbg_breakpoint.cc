@@ -19,6 +19,7 @@
 #include <queue>
 
 #include "compiler_helpers.h"
+#include "csharp_expression.h"
 #include "dbg_class_property.h"
 #include "document_index.h"
 #include "expression_evaluator.h"
@@ -47,9 +48,22 @@ std::int32_t DbgBreakpoint::current_max_collection_size_ =
     DbgBreakpoint::kMaximumCollectionSize;
 
 void DbgBreakpoint::Initialize(const DbgBreakpoint &other) {
-  Initialize(other.file_path_, other.id_, other.line_, other.column_,
-             other.log_point_, other.log_message_format_, other.log_level_,
-             other.condition_, other.expressions_);
+  file_path_ = other.file_path_;
+  file_path_segments_ = other.file_path_segments_;
+  id_ = other.id_;
+  log_point_ = other.log_point_;
+  line_ = other.line_;
+  requested_line_ = other.requested_line_;
+  column_ = other.column_;
+  log_message_format_ = other.log_message_format_;
+  log_level_ = other.log_level_;
+
+  // Parsed trees are not modified during evaluation so they can be
+  // shared instead of parsing the condition and expressions again.
+  condition_ = other.condition_;
+  parsed_condition_ = other.parsed_condition_;
+  expressions_ = other.expressions_;
+  parsed_expressions_ = other.parsed_expressions_;
 }
 
 void DbgBreakpoint::Initialize(const string &file_path, const string &id,
@@ -68,11 +82,37 @@ void DbgBreakpoint::Initialize(const string &file_path, const string &id,
   id_ = id;
   log_point_ = log_point;
   line_ = line;
+  requested_line_ = line;
   column_ = column;
-  condition_ = condition;
-  expressions_ = expressions;
   log_message_format_ = log_message_format;
   log_level_ = log_level;
+  SetCondition(condition);
+  SetExpressions(expressions);
+}
+
+void DbgBreakpoint::SetCondition(const std::string &condition) {
+  condition_ = condition;
+  ParseCondition();
+}
+
+void DbgBreakpoint::SetExpressions(const std::vector<std::string> &expressions) {
+  expressions_ = expressions;
+  ParseExpressions();
+}
+
+void DbgBreakpoint::ParseCondition() {
+  parsed_condition_ = nullptr;
+  if (!condition_.empty()) {
+    parsed_condition_ = ParseExpression(condition_);
+  }
+}
+
+void DbgBreakpoint::ParseExpressions() {
+  parsed_expressions_.clear();
+  parsed_expressions_.reserve(expressions_.size());
+  for (const auto &expression : expressions_) {
+    parsed_expressions_.push_back(ParseExpression(expression));
+  }
 }
 
 HRESULT DbgBreakpoint::GetCorDebugBreakpoint(
@@ -96,83 +136,63 @@ bool DbgBreakpoint::TrySetBreakpoint(
     return false;
   }
 
-  int32_t current_doc_index_index = -1;
-  int32_t best_match_doc_index = -1;
-  int32_t longest_match = -1;
-
-  // Loop through all the documents and try to find the one that
-  // best matches the breakpoint's file name.
-  for (auto &&document_index : pdb_file->GetDocumentIndexTable()) {
-    ++current_doc_index_index;
-    string document_name = document_index->GetFilePath();
-    // Normalize path separators. The PDB may use either Unix or Windows-style
-    // paths, but the Cloud Debugger only uses Unix.
-    std::replace(document_name.begin(), document_name.end(), '\\', '/');
-    std::transform(
-        document_name.begin(), document_name.end(), document_name.begin(),
-        [](unsigned char c) -> unsigned char { return std::tolower(c); });
-
-    std::vector<std::string> document_name_segments = SplitFilePath(document_name);
-
-    // Loop and see how many segments matches.
-    int segments_matches = 0;
-    int document_segment_idx = 0;
-    for (auto &&segment : file_path_segments_) {
-      if (document_segment_idx == document_name_segments.size()) {
-        break;
-      }
-
-      if (segment.compare(document_name_segments[document_segment_idx]) == 0) {
-        segments_matches += 1;
-      }
-
-      document_segment_idx += 1;
-    }
+  return TrySetBreakpointInDocument(*pdb_file, FindDocument(*pdb_file));
+}
 
-    if (segments_matches > 0 && segments_matches > longest_match) {
-      best_match_doc_index = current_doc_index_index;
-      longest_match = segments_matches;
-    }
-  }
+int32_t DbgBreakpoint::FindDocument(
+    const google_cloud_debugger_portable_pdb::IPortablePdbFile &pdb_file)
+    const {
+  // Find the document that best matches the breakpoint's file name,
+  // i.e. the one that shares the most trailing path segments with it.
+  return pdb_file.GetDocumentPathTrie().FindBestMatch(file_path_segments_);
+}
 
-  if (best_match_doc_index == -1) {
+bool DbgBreakpoint::TrySetBreakpointInDocument(
+    const google_cloud_debugger_portable_pdb::IPortablePdbFile &pdb_file,
+    int32_t document_index) {
+  const auto &document_indices = pdb_file.GetDocumentIndexTable();
+  if (document_index < 0 || document_index >= document_indices.size()) {
     return false;
   }
 
-  auto &&best_document_index =
-      pdb_file->GetDocumentIndexTable()[best_match_doc_index];
+  auto &&best_document_index = document_indices[document_index];
   // Try to find the best matched method.
   // This is because the breakpoint can be inside method A but if
   // method A is defined inside method B then we should use method A
   // to get the local variables instead of method B. An example is a
   // delegate function that is defined inside a normal function.
-  bool found_breakpoint = false;
-  uint32_t best_matched_method_first_line = 0;
-  for (auto &&method : best_document_index->GetMethods()) {
-    if (method.first_line > line_ || method.last_line < line_) {
-      continue;
-    }
-
-    // If this method's first line is greater than the previous one,
-    // this means that this method is inside it.
-    if (method.first_line > best_matched_method_first_line) {
-      // If this is false, it means no sequence points in the method
-      // corresponds to this breakpoint.
-      if (TrySetBreakpointInMethod(method)) {
-        best_matched_method_first_line = method.first_line;
-        found_breakpoint = true;
-      }
-    }
+  // The line index returns the innermost method that has a sequence point
+  // corresponding to this breakpoint.
+  const auto &methods = best_document_index->GetMethods();
+  uint32_t method_index;
+  uint32_t sequence_point_index;
+  if (!best_document_index->GetMethodLineIndex().FindLocation(
+          methods, line_, &method_index, &sequence_point_index)) {
+    return false;
   }
 
-  return found_breakpoint;
+  const auto &method = methods[method_index];
+  const auto &sequence_point = method.sequence_points[sequence_point_index];
+  il_offset_ = sequence_point.il_offset;
+  line_ = sequence_point.start_line;
+  method_def_ = method.method_def;
+  return true;
 }
 
 HRESULT DbgBreakpoint::EvaluateExpressions(IDbgStackFrame *stack_frame,
                                            IEvalCoordinator *eval_coordinator,
                                            IDbgObjectFactory *obj_factory) {
-  for (auto &expression : expressions_) {
-    CompiledExpression compiled_expression = CompileExpression(expression);
+  for (size_t i = 0; i < expressions_.size(); ++i) {
+    const std::string &expression = expressions_[i];
+    if (!parsed_expressions_[i]) {
+      WriteError("Failed to compile expression: " + expression);
+      return E_FAIL;
+    }
+
+    // A new evaluator is needed for every hit because Compile binds
+    // the evaluator to the values of the current frame.
+    CompiledExpression compiled_expression =
+        parsed_expressions_[i]->CreateEvaluator();
     if (compiled_expression.evaluator == nullptr) {
       WriteError("Failed to compile expression: " + expression);
       return E_FAIL;
@@ -217,9 +237,13 @@ HRESULT DbgBreakpoint::EvaluateCondition(IDbgStackFrame *stack_frame,
     return S_OK;
   }
 
-  CompiledExpression compiled_expression = CompileExpression(condition_);
+  if (!parsed_condition_) {
+    // TODO(quoct): Get the error from ParseExpression.
+    return E_FAIL;
+  }
+
+  CompiledExpression compiled_expression = parsed_condition_->CreateEvaluator();
   if (compiled_expression.evaluator == nullptr) {
-    // TODO(quoct): Get the error from CompileExpression.
     return E_FAIL;
   }
 
@@ -334,12 +358,15 @@ HRESULT DbgBreakpoint::PopulateExpression(Breakpoint *breakpoint,
 
   if (bfs_queue.size() != 0) {
     current_max_collection_size_ = kMaximumCollectionExpressionSize;
+    // The BFS keeps breakpoint_size up to date as it populates the
+    // expressions.
+    std::int64_t breakpoint_size = breakpoint->ByteSizeLong();
     HRESULT hr = VariableWrapper::PerformBFS(
         &bfs_queue,
-        [breakpoint]() {
-          return breakpoint->ByteSize() > DbgBreakpoint::kMaximumBreakpointSize;
+        [&breakpoint_size]() {
+          return breakpoint_size > DbgBreakpoint::kMaximumBreakpointSize;
         },
-        eval_coordinator);
+        eval_coordinator, &breakpoint_size);
     current_max_collection_size_ = kMaximumCollectionSize;
     return hr;
   }
@@ -347,24 +374,6 @@ HRESULT DbgBreakpoint::PopulateExpression(Breakpoint *breakpoint,
   return S_OK;
 }
 
-bool DbgBreakpoint::TrySetBreakpointInMethod(
-    const google_cloud_debugger_portable_pdb::MethodInfo &method) {
-  const auto &find_seq = std::find_if(
-      method.sequence_points.begin(), method.sequence_points.end(),
-      [&](const google_cloud_debugger_portable_pdb::SequencePoint &seq) {
-        return !seq.is_hidden && seq.start_line >= line_;
-      });
-
-  if (find_seq == method.sequence_points.end()) {
-    return false;
-  }
-
-  il_offset_ = find_seq->il_offset;
-  line_ = find_seq->start_line;
-  method_def_ = method.method_def;
-  return true;
-}
-
 std::vector<std::string> DbgBreakpoint::SplitFilePath(const std::string &path) {
   std::vector<std::string> result;
 
@@ -16,6 +16,7 @@
 #define DBG_BREAKPOINT_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -28,11 +29,11 @@
 
 namespace google_cloud_debugger_portable_pdb {
 class IPortablePdbFile;
-struct MethodInfo;
 };  // namespace google_cloud_debugger_portable_pdb
 
 namespace google_cloud_debugger {
 
+class CSharpExpression;
 class IEvalCoordinator;
 class IStackFrameCollection;
 class IDbgStackFrame;
@@ -65,6 +66,19 @@ class DbgBreakpoint : public StringStreamWrapper {
   bool TrySetBreakpoint(
       google_cloud_debugger_portable_pdb::IPortablePdbFile *pdb_file);
 
+  // Returns the index of the document in pdb_file that best matches the
+  // file path of this breakpoint, or -1 if there is none. Breakpoints
+  // with the same file path have the same document.
+  std::int32_t FindDocument(
+      const google_cloud_debugger_portable_pdb::IPortablePdbFile &pdb_file)
+      const;
+
+  // Same as TrySetBreakpoint but searches only the document at
+  // document_index in pdb_file, as returned by FindDocument.
+  bool TrySetBreakpointInDocument(
+      const google_cloud_debugger_portable_pdb::IPortablePdbFile &pdb_file,
+      std::int32_t document_index);
+
   // Returns the IL Offset that corresponds to this breakpoint location.
   uint32_t GetILOffset() { return il_offset_; }
 
@@ -85,6 +99,14 @@ class DbgBreakpoint : public StringStreamWrapper {
     method_token_ = method_token;
   }
 
+  // Returns the base address of the module this breakpoint is in.
+  CORDB_ADDRESS GetModuleBaseAddress() const { return module_base_address_; }
+
+  // Sets the base address of the module this breakpoint is in.
+  void SetModuleBaseAddress(CORDB_ADDRESS module_base_address) {
+    module_base_address_ = module_base_address;
+  }
+
   // Returns the path of the file this breakpoint is in.
   const std::string &GetFilePath() const { return file_path_; }
 
@@ -137,8 +159,8 @@ class DbgBreakpoint : public StringStreamWrapper {
   // Returns the condition of the breakpoint.
   const std::string &GetCondition() const { return condition_; }
 
-  // Sets the condition of the breakpoint.
-  void SetCondition(const std::string &condition) { condition_ = condition; }
+  // Sets the condition of the breakpoint and parses it.
+  void SetCondition(const std::string &condition);
 
   // Gets the result of the evaluated condition.
   // This should only be called after EvaluateCondition is called.
@@ -149,10 +171,8 @@ class DbgBreakpoint : public StringStreamWrapper {
     return expressions_;
   }
 
-  // Sets the expressions of the breakpoint.
-  void SetExpressions(const std::vector<std::string> &expressions) {
-    expressions_ = expressions;
-  }
+  // Sets the expressions of the breakpoint and parses them.
+  void SetExpressions(const std::vector<std::string> &expressions);
 
   // Returns a string representation of the breakpoint location
   // by concatenating file path and line number.
@@ -160,6 +180,13 @@ class DbgBreakpoint : public StringStreamWrapper {
     return file_path_ + "##" + std::to_string(line_);
   }
 
+  // Returns the location the breakpoint was requested at. This is the
+  // same as GetBreakpointLocation until the breakpoint is set, which may
+  // move it to the line of a sequence point.
+  std::string GetRequestedLocation() const {
+    return file_path_ + "##" + std::to_string(requested_line_);
+  }
+
   // Evaluates condition condition_ using the provided stack frame
   // and eval coordinator. Sets the result to evaluated_condition_.
   HRESULT EvaluateCondition(IDbgStackFrame *stack_frame,
@@ -205,10 +232,11 @@ class DbgBreakpoint : public StringStreamWrapper {
       google::cloud::diagnostics::debug::Breakpoint *breakpoint,
       IEvalCoordinator *eval_coordinator);
 
-  // Given a method, try to see whether we can set this breakpoint in
-  // the method.
-  bool TrySetBreakpointInMethod(
-      const google_cloud_debugger_portable_pdb::MethodInfo &method);
+  // Parses condition_ into parsed_condition_.
+  void ParseCondition();
+
+  // Parses expressions_ into parsed_expressions_.
+  void ParseExpressions();
 
   // Split up file path into segments (using '/' as delimiter).
   // The returned vector will be reversed with the file name
@@ -218,6 +246,9 @@ class DbgBreakpoint : public StringStreamWrapper {
   // The line number of the breakpoint.
   uint32_t line_;
 
+  // The line number the breakpoint was requested at.
+  uint32_t requested_line_;
+
   // The column number of the breakpoint.
   uint32_t column_;
 
@@ -240,12 +271,24 @@ class DbgBreakpoint : public StringStreamWrapper {
   // The method token of the method this breakpoint is in.
   mdMethodDef method_token_;
 
+  // The base address of the module this breakpoint is in.
+  CORDB_ADDRESS module_base_address_ = 0;
+
   // Condition of a breakpoint. If false, don't report information back.
   std::string condition_;
 
   // Expressions of a breakpoint.
   std::vector<std::string> expressions_;
 
+  // Parsed tree of condition_. This is null if the condition is empty
+  // or cannot be parsed. The tree is never modified after parsing, so it is
+  // shared between breakpoints at the same location.
+  std::shared_ptr<CSharpExpression> parsed_condition_;
+
+  // Parsed trees of expressions_, in the same order. An entry is null
+  // if the corresponding expression cannot be parsed.
+  std::vector<std::shared_ptr<CSharpExpression>> parsed_expressions_;
+
   // Map where key is the expression and value is its evaluated value.
   std::unordered_map<std::string, std::shared_ptr<DbgObject>> expressions_map_;
 
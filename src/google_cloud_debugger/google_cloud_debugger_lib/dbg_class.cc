@@ -18,6 +18,7 @@
 #include <array>
 #include <cstdint>
 #include <iostream>
+#include <unordered_set>
 
 #include "dbg_array.h"
 #include "dbg_builtin_collection.h"
@@ -43,6 +44,8 @@ std::unordered_map<
     std::unordered_map<std::string, std::shared_ptr<IDbgClassMember>>>
     DbgClass::static_class_members_;
 
+ClassMetadataCache DbgClass::metadata_cache_;
+
 HRESULT DbgClass::GetNonStaticField(const std::string &field_name,
                                     std::shared_ptr<DbgObject> *field_value) {
   if (!class_fields_.empty()) {
@@ -148,15 +151,51 @@ HRESULT DbgClass::GetGenericTypes(
   return S_OK;
 }
 
-HRESULT DbgClass::ProcessFields(IMetaDataImport *metadata_import,
-                                ICorDebugObjectValue *debug_obj_value,
-                                ICorDebugClass *debug_class) {
-  CComPtr<ICorDebugType> debug_type;
+HRESULT DbgClass::GetClassMetadata(
+    IMetaDataImport *metadata_import,
+    std::shared_ptr<const ClassMetadata> *metadata) {
+  // Classes whose module is not known are not cached.
+  CORDB_ADDRESS module_base_address = 0;
+  bool cacheable =
+      debug_module_ &&
+      SUCCEEDED(debug_module_->GetBaseAddress(&module_base_address));
+  if (cacheable) {
+    *metadata = metadata_cache_.Find(module_base_address, class_token_);
+    if (*metadata) {
+      return S_OK;
+    }
+  }
+
+  std::shared_ptr<ClassMetadata> class_metadata(new (std::nothrow)
+                                                    ClassMetadata());
+  if (!class_metadata) {
+    WriteError("Ran out of memory while trying to read class metadata.");
+    return E_OUTOFMEMORY;
+  }
+
+  HRESULT hr = ReadClassMetadata(metadata_import, class_metadata.get());
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  if (cacheable) {
+    *metadata = metadata_cache_.Add(module_base_address, class_token_,
+                                    std::move(class_metadata));
+  } else {
+    *metadata = std::move(class_metadata);
+  }
+  return S_OK;
+}
+
+HRESULT DbgClass::ReadClassMetadata(IMetaDataImport *metadata_import,
+                                    ClassMetadata *metadata) {
+  HRESULT hr;
   HCORENUM cor_enum = nullptr;
+  metadata->metadata_import = metadata_import;
 
-  debug_type = GetDebugType();
+  // Sets of all the backing fields' names.
+  std::unordered_set<std::string> backing_fields_names;
   while (true) {
-    HRESULT hr;
     array<mdFieldDef, 100> field_defs;
     ULONG field_defs_returned = 0;
 
@@ -167,48 +206,32 @@ HRESULT DbgClass::ProcessFields(IMetaDataImport *metadata_import,
       return hr;
     }
 
-    if (field_defs_returned != 0) {
-      class_fields_.reserve(class_fields_.size() + field_defs_returned);
-
-      for (int i = 0; i < field_defs_returned; ++i) {
-        unique_ptr<DbgClassField> class_field(new (std::nothrow) DbgClassField(
-            field_defs[i], GetCreationDepth() - 1, debug_type, debug_helper_,
-            object_factory_));
-        if (!class_field) {
-          WriteError("Run out of memory when trying to create field ");
-          WriteError(std::to_string(field_defs[i]));
-          return E_OUTOFMEMORY;
-        }
-
-        class_field->Initialize(debug_module_, metadata_import, debug_obj_value,
-                                debug_class);
-        if (class_field->IsBackingField()) {
-          // Insert class names into set so we can use it to check later
-          // for backing fields.
-          class_backing_fields_names_.insert(class_field->GetMemberName());
-        }
+    if (field_defs_returned == 0) {
+      break;
+    }
 
-        AddStaticClassMemberToVector(std::move(class_field), &class_fields_);
+    metadata->fields.reserve(metadata->fields.size() + field_defs_returned);
+    for (int i = 0; i < field_defs_returned; ++i) {
+      ClassFieldMetadata field;
+      DbgClassField::ReadMetadata(field_defs[i], metadata_import, &field);
+      if (field.is_backing_field) {
+        // Insert class names into set so we can use it to check later
+        // for backing fields.
+        backing_fields_names.insert(field.name);
       }
-    } else {
-      break;
+      metadata->fields.push_back(std::move(field));
     }
   }
 
   if (cor_enum) {
     metadata_import->CloseEnum(cor_enum);
+    cor_enum = nullptr;
   }
 
-  return S_OK;
-}
-
-HRESULT DbgClass::ProcessProperties(IMetaDataImport *metadata_import) {
-  HRESULT hr;
-  array<mdProperty, 100> property_defs;
-  HCORENUM cor_enum = nullptr;
-  ULONG property_defs_returned = 0;
-
   while (true) {
+    array<mdProperty, 100> property_defs;
+    ULONG property_defs_returned = 0;
+
     hr = metadata_import->EnumProperties(
         &cor_enum, class_token_, property_defs.data(), property_defs.size(),
         &property_defs_returned);
@@ -217,64 +240,101 @@ HRESULT DbgClass::ProcessProperties(IMetaDataImport *metadata_import) {
       return hr;
     }
 
-    if (property_defs_returned != 0) {
-      class_properties_.reserve(class_properties_.size() +
-                                property_defs_returned);
-
-      for (int i = 0; i < property_defs_returned; ++i) {
-        unique_ptr<DbgClassProperty> class_property(new (
-            std::nothrow) DbgClassProperty(debug_helper_, object_factory_));
-        if (!class_property) {
-          WriteError(
-              "Ran out of memory while trying to initialize class property ");
-          WriteError(std::to_string(property_defs[i]));
-          return E_OUTOFMEMORY;
-        }
-
-        class_property->Initialize(property_defs[i], metadata_import,
-                                   debug_module_, GetCreationDepth() - 1);
-        // If property name is MyProperty, checks whether there is a backing
-        // field with the name <MyProperty>k__BackingField. Note that we have
-        // logic to process backing fields' names to strip out the "<" and
-        // ">k__BackingField" of the field name and places them in the set
-        // class_backing_fields_names. Hence, we only need to check whether
-        // MyProperty is in this set or not. If it is, then it is backed
-        // by a field already, so don't add it to class_properties_.
-        if (class_backing_fields_names_.find(class_property->GetMemberName()) !=
-            class_backing_fields_names_.end()) {
-          continue;
-        }
+    if (property_defs_returned == 0) {
+      break;
+    }
 
-        if (class_property->IsStatic()) {
-          // Checks whether we already have a shared pointer of this property
-          // in the cache. If not, moves the unique_ptr there.
-          shared_ptr<IDbgClassMember> static_property_value =
-              GetStaticClassMember(module_name_, class_name_,
-                                   class_property->GetMemberName());
-          if (!static_property_value) {
-            std::string property_name = class_property->GetMemberName();
-            static_property_value =
-                shared_ptr<IDbgClassMember>(class_property.release());
-            StoreStaticClassMember(module_name_, class_name_, property_name,
-                                   static_property_value);
-          }
-          class_properties_.emplace_back(static_property_value);
-        } else {
-          class_properties_.push_back(std::move(class_property));
-        }
+    metadata->properties.reserve(metadata->properties.size() +
+                                 property_defs_returned);
+    for (int i = 0; i < property_defs_returned; ++i) {
+      ClassPropertyMetadata property;
+      DbgClassProperty::ReadMetadata(property_defs[i], metadata_import,
+                                     &property);
+      // If property name is MyProperty, checks whether there is a backing
+      // field with the name <MyProperty>k__BackingField. Note that we have
+      // logic to process backing fields' names to strip out the "<" and
+      // ">k__BackingField" of the field name and places them in the set
+      // backing_fields_names. Hence, we only need to check whether
+      // MyProperty is in this set or not. If it is, then it is backed
+      // by a field already, so don't add it to the properties.
+      if (backing_fields_names.find(property.name) !=
+          backing_fields_names.end()) {
+        continue;
       }
-    } else {
-      break;
+
+      metadata->properties.push_back(std::move(property));
     }
   }
 
-  if (cor_enum != nullptr) {
+  if (cor_enum) {
     metadata_import->CloseEnum(cor_enum);
   }
 
   return S_OK;
 }
 
+HRESULT DbgClass::ProcessFields(IMetaDataImport *metadata_import,
+                                const ClassMetadata &metadata,
+                                ICorDebugObjectValue *debug_obj_value,
+                                ICorDebugClass *debug_class) {
+  CComPtr<ICorDebugType> debug_type;
+  debug_type = GetDebugType();
+  class_fields_.reserve(class_fields_.size() + metadata.fields.size());
+  for (const ClassFieldMetadata &field : metadata.fields) {
+    unique_ptr<DbgClassField> class_field(new (std::nothrow) DbgClassField(
+        field.field_def, GetCreationDepth() - 1, debug_type, debug_helper_,
+        object_factory_));
+    if (!class_field) {
+      WriteError("Run out of memory when trying to create field ");
+      WriteError(std::to_string(field.field_def));
+      return E_OUTOFMEMORY;
+    }
+
+    class_field->Initialize(field, debug_module_, metadata_import,
+                            debug_obj_value, debug_class);
+    AddStaticClassMemberToVector(std::move(class_field), &class_fields_);
+  }
+
+  return S_OK;
+}
+
+HRESULT DbgClass::ProcessProperties(const ClassMetadata &metadata) {
+  class_properties_.reserve(class_properties_.size() +
+                            metadata.properties.size());
+  for (const ClassPropertyMetadata &property : metadata.properties) {
+    unique_ptr<DbgClassProperty> class_property(
+        new (std::nothrow) DbgClassProperty(debug_helper_, object_factory_));
+    if (!class_property) {
+      WriteError(
+          "Ran out of memory while trying to initialize class property ");
+      WriteError(std::to_string(property.property_def));
+      return E_OUTOFMEMORY;
+    }
+
+    class_property->Initialize(property, debug_module_,
+                               GetCreationDepth() - 1);
+    if (class_property->IsStatic()) {
+      // Checks whether we already have a shared pointer of this property
+      // in the cache. If not, moves the unique_ptr there.
+      shared_ptr<IDbgClassMember> static_property_value =
+          GetStaticClassMember(module_name_, class_name_,
+                               class_property->GetMemberName());
+      if (!static_property_value) {
+        std::string property_name = class_property->GetMemberName();
+        static_property_value =
+            shared_ptr<IDbgClassMember>(class_property.release());
+        StoreStaticClassMember(module_name_, class_name_, property_name,
+                               static_property_value);
+      }
+      class_properties_.emplace_back(static_property_value);
+    } else {
+      class_properties_.push_back(std::move(class_property));
+    }
+  }
+
+  return S_OK;
+}
+
 HRESULT DbgClass::ProcessClassMembers() {
   if (processed_) {
     return S_OK;
@@ -343,15 +403,23 @@ HRESULT DbgClass::ProcessClassMembersHelper(ICorDebugValue *debug_value,
     return S_OK;
   }
 
+  // Fields and properties share one lookup so that classes that cannot
+  // be cached are not read from the metadata twice.
+  std::shared_ptr<const ClassMetadata> metadata;
+  hr = GetClassMetadata(metadata_import, &metadata);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
   // Populates the fields first before the properties in case
   // we have backing fields for properties.
-  hr = ProcessFields(metadata_import, debug_obj_value, debug_class);
+  hr = ProcessFields(metadata_import, *metadata, debug_obj_value, debug_class);
   if (FAILED(hr)) {
     WriteError("Failed to populate class fields.");
     return hr;
   }
 
-  hr = ProcessProperties(metadata_import);
+  hr = ProcessProperties(*metadata);
   if (FAILED(hr)) {
     WriteError("Failed to populate class properties.");
     return hr;
@@ -17,9 +17,9 @@
 
 #include <memory>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
+#include "class_metadata_cache.h"
 #include "dbg_class_field.h"
 #include "dbg_class_property.h"
 #include "dbg_primitive.h"
@@ -107,6 +107,15 @@ class DbgClass : public DbgReferenceObject {
   // Clear cache of static field and properties.
   static void ClearStaticCache() { static_class_members_.clear(); }
 
+  // Removes the cached metadata of the classes in the module at
+  // module_base_address. This has to be called when the module is unloaded.
+  static void RemoveModuleMetadata(CORDB_ADDRESS module_base_address) {
+    metadata_cache_.RemoveModule(module_base_address);
+  }
+
+  // Clear cache of class metadata.
+  static void ClearMetadataCache() { metadata_cache_.Clear(); }
+
   // Sets the name of the module this class is in.
   void SetModuleName(const std::string &module_name) {
     module_name_ = module_name;
@@ -183,13 +192,24 @@ class DbgClass : public DbgReferenceObject {
       const std::string &module_name, const std::string &class_name,
       const std::string &member_name);
 
-  // Processes the class fields and stores the fields in class_fields_.
+  // Gets the fields and properties of this class from metadata_cache_,
+  // reading them from metadata_import if they are not cached.
+  HRESULT GetClassMetadata(IMetaDataImport *metadata_import,
+                           std::shared_ptr<const ClassMetadata> *metadata);
+
+  // Reads the fields and properties of this class from metadata_import.
+  HRESULT ReadClassMetadata(IMetaDataImport *metadata_import,
+                            ClassMetadata *metadata);
+
+  // Processes the fields in metadata and stores them in class_fields_.
   HRESULT ProcessFields(IMetaDataImport *metadata_import,
+                        const ClassMetadata &metadata,
                         ICorDebugObjectValue *debug_obj_value,
                         ICorDebugClass *debug_class);
 
-  // Processes the class properties and stores the fields in class_fields_.
-  HRESULT ProcessProperties(IMetaDataImport *metadata_import);
+  // Processes the properties in metadata and stores them in
+  // class_properties_.
+  HRESULT ProcessProperties(const ClassMetadata &metadata);
 
   // Given a field name, creates a DbgObject that represents the value
   // of the field in this object.
@@ -226,9 +246,6 @@ class DbgClass : public DbgReferenceObject {
   std::vector<std::shared_ptr<IDbgClassMember>> class_fields_;
   std::vector<std::shared_ptr<IDbgClassMember>> class_properties_;
 
-  // Sets of all the fields' names.
-  std::unordered_set<std::string> class_backing_fields_names_;
-
   // Vector of objects representing all generic types of the class.
   // This is used for printing out the class name.
   std::vector<std::unique_ptr<DbgObject>> empty_generic_objects_;
@@ -250,6 +267,10 @@ class DbgClass : public DbgReferenceObject {
       std::string,
       std::unordered_map<std::string, std::shared_ptr<IDbgClassMember>>>
       static_class_members_;
+
+  // Cache of the fields and properties of classes. Unlike
+  // static_class_members_, this is kept across breakpoint hits.
+  static ClassMetadataCache metadata_cache_;
 };
 
 }  //  namespace google_cloud_debugger
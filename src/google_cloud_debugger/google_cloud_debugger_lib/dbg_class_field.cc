@@ -56,51 +56,91 @@ void DbgClassField::Initialize(ICorDebugModule *debug_module,
     return;
   }
 
-  CComPtr<ICorDebugValue> field_value;
+  ClassFieldMetadata metadata;
+  ReadMetadata(field_def_, metadata_import, &metadata);
+  Initialize(metadata, debug_module, metadata_import, debug_obj_value,
+             debug_class);
+}
+
+HRESULT DbgClassField::ReadMetadata(mdFieldDef field_def,
+                                    IMetaDataImport *metadata_import,
+                                    ClassFieldMetadata *metadata) {
+  if (!metadata_import || !metadata) {
+    return E_INVALIDARG;
+  }
+
   ULONG len_field_name;
+  metadata->field_def = field_def;
 
   // First call to get length of array.
-  initialized_hr_ = metadata_import->GetFieldProps(
-      field_def_, &parent_token_, nullptr, 0, &len_field_name,
-      &member_attributes_, &signature_metadata_, &sig_metadata_length_,
-      &default_value_type_flags_, &default_value_, &default_value_len_);
-  if (FAILED(initialized_hr_)) {
-    WriteError("Failed to populate field metadata.");
-    return;
+  metadata->hr = metadata_import->GetFieldProps(
+      field_def, &metadata->parent_token, nullptr, 0, &len_field_name,
+      &metadata->attributes, &metadata->signature,
+      &metadata->signature_length, &metadata->default_value_type_flags,
+      &metadata->default_value, &metadata->default_value_len);
+  if (FAILED(metadata->hr)) {
+    return metadata->hr;
   }
 
   std::vector<WCHAR> wchar_field_name(len_field_name, 0);
 
   // Second call to get the actual name.
-  initialized_hr_ = metadata_import->GetFieldProps(
-      field_def_, &parent_token_, wchar_field_name.data(), len_field_name,
-      &len_field_name, &member_attributes_, &signature_metadata_,
-      &sig_metadata_length_, &default_value_type_flags_, &default_value_,
-      &default_value_len_);
-  if (FAILED(initialized_hr_)) {
-    WriteError("Failed to populate field metadata.");
-    return;
+  metadata->hr = metadata_import->GetFieldProps(
+      field_def, &metadata->parent_token, wchar_field_name.data(),
+      len_field_name, &len_field_name, &metadata->attributes,
+      &metadata->signature, &metadata->signature_length,
+      &metadata->default_value_type_flags, &metadata->default_value,
+      &metadata->default_value_len);
+  if (FAILED(metadata->hr)) {
+    return metadata->hr;
   }
 
-  member_name_ = ConvertWCharPtrToString(wchar_field_name);
+  string field_name = ConvertWCharPtrToString(wchar_field_name);
 
   // If field name is <MyProperty>k__BackingField, change it to
   // MyProperty because it is the backing field of a property.
-  if (member_name_.size() > kBackingField.size() + 1) {
+  if (field_name.size() > kBackingField.size() + 1) {
     // Checks that field name is of the form <Property>k__BackingField.
-    if (member_name_[0] == '<') {
+    if (field_name[0] == '<') {
       string::size_type position;
-      // Checks that field_name_ ends with k_BackingField.
-      position = member_name_.find(kBackingField,
-                                   member_name_.size() - kBackingField.size());
+      // Checks that field_name ends with k_BackingField.
+      position = field_name.find(kBackingField,
+                                 field_name.size() - kBackingField.size());
       // Extracts out the field name.
       if (position != string::npos) {
-        is_backing_field_ = true;
-        member_name_ = member_name_.substr(1, position - 1);
+        metadata->is_backing_field = true;
+        field_name = field_name.substr(1, position - 1);
       }
     }
   }
 
+  metadata->name = std::move(field_name);
+  return S_OK;
+}
+
+void DbgClassField::Initialize(const ClassFieldMetadata &metadata,
+                               ICorDebugModule *debug_module,
+                               IMetaDataImport *metadata_import,
+                               ICorDebugObjectValue *debug_obj_value,
+                               ICorDebugClass *debug_class) {
+  initialized_hr_ = metadata.hr;
+  if (FAILED(initialized_hr_)) {
+    WriteError("Failed to populate field metadata.");
+    return;
+  }
+
+  CComPtr<ICorDebugValue> field_value;
+  field_def_ = metadata.field_def;
+  parent_token_ = metadata.parent_token;
+  member_attributes_ = metadata.attributes;
+  signature_metadata_ = metadata.signature;
+  sig_metadata_length_ = metadata.signature_length;
+  default_value_type_flags_ = metadata.default_value_type_flags;
+  default_value_ = metadata.default_value;
+  default_value_len_ = metadata.default_value_len;
+  member_name_ = metadata.name;
+  is_backing_field_ = metadata.is_backing_field;
+
   // This will point to the value of the field if the field is const.
   if (default_value_ && IsFdLiteral(member_attributes_)) {
     initialized_hr_ = ProcessConstField(debug_module, metadata_import);
@@ -18,6 +18,7 @@
 #include <memory>
 #include <vector>
 
+#include "class_metadata_cache.h"
 #include "dbg_object.h"
 #include "i_dbg_class_member.h"
 
@@ -45,6 +46,21 @@ class DbgClassField : public IDbgClassMember {
                   ICorDebugObjectValue *debug_obj_value,
                   ICorDebugClass *debug_class);
 
+  // Same as Initialize but takes the field names, metadata signature
+  // and flags from metadata, which is read by ReadMetadata, instead of
+  // metadata_import. Only the value of the field is read.
+  void Initialize(const ClassFieldMetadata &metadata,
+                  ICorDebugModule *debug_module,
+                  IMetaDataImport *metadata_import,
+                  ICorDebugObjectValue *debug_obj_value,
+                  ICorDebugClass *debug_class);
+
+  // Reads the metadata of field field_def from metadata_import
+  // into metadata. The HRESULT is also stored in metadata.
+  static HRESULT ReadMetadata(mdFieldDef field_def,
+                              IMetaDataImport *metadata_import,
+                              ClassFieldMetadata *metadata);
+
   // Evaluates and sets member_value_ to the value of the field
   // that is represented by this class.
   // Reference_value and generic_types are ignored.
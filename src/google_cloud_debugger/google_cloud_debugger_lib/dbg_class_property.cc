@@ -40,41 +40,74 @@ void DbgClassProperty::Initialize(mdProperty property_def,
     return;
   }
 
+  ClassPropertyMetadata metadata;
+  ReadMetadata(property_def, metadata_import, &metadata);
+  Initialize(metadata, debug_module, creation_depth);
+}
+
+void DbgClassProperty::Initialize(const ClassPropertyMetadata &metadata,
+                                  ICorDebugModule *debug_module,
+                                  int creation_depth) {
+  property_def_ = metadata.property_def;
+  parent_token_ = metadata.parent_token;
+  member_attributes_ = metadata.attributes;
+  signature_metadata_ = metadata.signature;
+  sig_metadata_length_ = metadata.signature_length;
+  default_value_type_flags_ = metadata.default_value_type_flags;
+  default_value_ = metadata.default_value;
+  default_value_len_ = metadata.default_value_len;
+  property_setter_function = metadata.setter_function;
+  property_getter_function = metadata.getter_function;
+  other_methods_ = metadata.other_methods;
+  member_name_ = metadata.name;
+  creation_depth_ = creation_depth;
+  debug_module_ = debug_module;
+
+  initialized_hr_ = metadata.hr;
+  if (FAILED(initialized_hr_)) {
+    WriteError("Failed to get property metadata.");
+  }
+}
+
+HRESULT DbgClassProperty::ReadMetadata(mdProperty property_def,
+                                       IMetaDataImport *metadata_import,
+                                       ClassPropertyMetadata *metadata) {
+  if (!metadata_import || !metadata) {
+    return E_INVALIDARG;
+  }
+
   ULONG property_name_length;
   ULONG other_methods_length;
 
-  property_def_ = property_def;
+  metadata->property_def = property_def;
   // First call to get length of array and length of other methods.
-  initialized_hr_ = metadata_import->GetPropertyProps(
-      property_def_, &parent_token_, nullptr, 0, &property_name_length,
-      &member_attributes_, &signature_metadata_, &sig_metadata_length_,
-      &default_value_type_flags_, &default_value_, &default_value_len_,
-      &property_setter_function, &property_getter_function, nullptr, 0,
+  metadata->hr = metadata_import->GetPropertyProps(
+      property_def, &metadata->parent_token, nullptr, 0,
+      &property_name_length, &metadata->attributes, &metadata->signature,
+      &metadata->signature_length, &metadata->default_value_type_flags,
+      &metadata->default_value, &metadata->default_value_len,
+      &metadata->setter_function, &metadata->getter_function, nullptr, 0,
       &other_methods_length);
-
-  if (FAILED(initialized_hr_)) {
-    WriteError("Failed to get property metadata.");
-    return;
+  if (FAILED(metadata->hr)) {
+    return metadata->hr;
   }
 
   std::vector<WCHAR> wchar_property_name(property_name_length, 0);
-  other_methods_.resize(other_methods_length);
-
-  initialized_hr_ = metadata_import->GetPropertyProps(
-      property_def_, &parent_token_, wchar_property_name.data(),
-      wchar_property_name.size(), &property_name_length, &member_attributes_,
-      &signature_metadata_, &sig_metadata_length_, &default_value_type_flags_,
-      &default_value_, &default_value_len_, &property_setter_function,
-      &property_getter_function, other_methods_.data(), other_methods_.size(),
+  metadata->other_methods.resize(other_methods_length);
+
+  metadata->hr = metadata_import->GetPropertyProps(
+      property_def, &metadata->parent_token, wchar_property_name.data(),
+      wchar_property_name.size(), &property_name_length,
+      &metadata->attributes, &metadata->signature,
+      &metadata->signature_length, &metadata->default_value_type_flags,
+      &metadata->default_value, &metadata->default_value_len,
+      &metadata->setter_function, &metadata->getter_function,
+      metadata->other_methods.data(), metadata->other_methods.size(),
       &other_methods_length);
 
-  if (FAILED(initialized_hr_)) {
-    WriteError("Failed to get property metadata.");
-  }
-
-  member_name_ = ConvertWCharPtrToString(wchar_property_name);
-  creation_depth_ = creation_depth;
-  debug_module_ = debug_module;
+  // The name is kept even if the second call fails.
+  metadata->name = ConvertWCharPtrToString(wchar_property_name);
+  return metadata->hr;
 }
 
 HRESULT DbgClassProperty::Evaluate(
@@ -18,6 +18,7 @@
 #include <memory>
 #include <vector>
 
+#include "class_metadata_cache.h"
 #include "dbg_object.h"
 #include "i_dbg_class_member.h"
 #include "type_signature.h"
@@ -43,6 +44,17 @@ class DbgClassProperty : public IDbgClassMember {
   void Initialize(mdProperty property_def, IMetaDataImport *metadata_import,
                   ICorDebugModule *debug_module, int creation_depth);
 
+  // Same as Initialize but takes the property name, metadata signature,
+  // attributes and tokens from metadata, which is read by ReadMetadata.
+  void Initialize(const ClassPropertyMetadata &metadata,
+                  ICorDebugModule *debug_module, int creation_depth);
+
+  // Reads the metadata of property property_def from metadata_import
+  // into metadata. The HRESULT is also stored in metadata.
+  static HRESULT ReadMetadata(mdProperty property_def,
+                              IMetaDataImport *metadata_import,
+                              ClassPropertyMetadata *metadata);
+
   // Evaluates the property and stores the value in member_value_.
   // reference_value is a reference to the class object that this property
   // belongs to. eval_coordinator is needed to perform the function
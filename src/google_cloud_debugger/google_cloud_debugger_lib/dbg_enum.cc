@@ -155,7 +155,13 @@ HRESULT DbgEnum::ProcessEnum(ICorDebugValue *debug_value,
 }
 
 HRESULT DbgEnum::ProcessEnumFields(IMetaDataImport *metadata_import) {
-  HRESULT hr = ProcessFields(metadata_import, nullptr, nullptr);
+  std::shared_ptr<const ClassMetadata> metadata;
+  HRESULT hr = GetClassMetadata(metadata_import, &metadata);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  hr = ProcessFields(metadata_import, *metadata, nullptr, nullptr);
   if (FAILED(hr)) {
     WriteError("Failed to process enum fields.");
     return hr;
@@ -117,6 +117,16 @@ class DbgObject : public StringStreamWrapper {
   // Sets the address of the object.
   void SetAddress(const CORDB_ADDRESS &address) { address_ = address; }
 
+  // Reads the address of the object again. GetAddress returns the
+  // address the object had when it was created, which is out of date if
+  // the garbage collector moved the object since, for example while a
+  // property getter was evaluated. Returns S_FALSE if the object has no
+  // address.
+  virtual HRESULT GetCurrentAddress(CORDB_ADDRESS *address) {
+    *address = address_;
+    return address_ != 0 ? S_OK : S_FALSE;
+  }
+
  private:
   // The underlying type of the object.
   CComPtr<ICorDebugType> debug_type_;
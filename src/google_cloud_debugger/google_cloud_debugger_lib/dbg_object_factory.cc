@@ -36,6 +36,20 @@ using std::vector;
 
 namespace google_cloud_debugger {
 
+namespace {
+
+// Returns the factory the created objects use to create their members.
+// A DbgObjectFactory with the default CorDebugHelper has no state, so
+// all the objects share one instead of allocating a factory and a
+// helper each.
+std::shared_ptr<DbgObjectFactory> GetMemberFactory() {
+  static std::shared_ptr<DbgObjectFactory> member_factory(
+      new DbgObjectFactory());
+  return member_factory;
+}
+
+}  // namespace
+
 DbgObjectFactory::DbgObjectFactory() : debug_helper_(new CorDebugHelper()) {}
 
 DbgObjectFactory::DbgObjectFactory(
@@ -119,8 +133,7 @@ HRESULT DbgObjectFactory::CreateDbgObjectHelper(
     case CorElementType::ELEMENT_TYPE_SZARRAY:
     case CorElementType::ELEMENT_TYPE_ARRAY:
       temp_object = unique_ptr<DbgObject>(new (std::nothrow) DbgArray(
-          debug_type, depth, debug_helper_,
-          std::shared_ptr<DbgObjectFactory>(new DbgObjectFactory)));
+          debug_type, depth, debug_helper_, GetMemberFactory()));
       break;
     case CorElementType::ELEMENT_TYPE_CLASS:
     case CorElementType::ELEMENT_TYPE_VALUETYPE:
@@ -277,8 +290,7 @@ HRESULT DbgObjectFactory::CreateDbgClassObject(
 
   if (is_null) {
     unique_ptr<DbgClass> null_obj(new (std::nothrow) DbgClass(
-        debug_type, depth, debug_helper_,
-        std::shared_ptr<DbgObjectFactory>(new DbgObjectFactory())));
+        debug_type, depth, debug_helper_, GetMemberFactory()));
     if (!null_obj) {
       *err_stream << "Ran out of memory to create null class object.";
       return E_OUTOFMEMORY;
@@ -310,10 +322,12 @@ HRESULT DbgObjectFactory::CreateDbgClassObject(
       unique_ptr<DbgEnum> enum_obj =
           unique_ptr<DbgEnum>(new (std::nothrow) DbgEnum(
               debug_type, depth, class_name, class_token, debug_helper_,
-              std::shared_ptr<DbgObjectFactory>(new DbgObjectFactory())));
+              GetMemberFactory()));
       // Only process class type for enum (since it is ValueType and we don't
       // store reference to the class object). Delay processing fields and
       // properties of non-ValueType class until we need them.
+      // The module is set first so that the fields of the enum are cached.
+      enum_obj->SetICorDebugModule(debug_module);
       hr = enum_obj->ProcessEnum(debug_value, metadata_import);
       if (FAILED(hr)) {
         *err_stream << "Failed to process class based on their types.";
@@ -325,12 +339,10 @@ HRESULT DbgObjectFactory::CreateDbgClassObject(
                kDictionaryClassName.compare(class_name) == 0) {
       class_obj = unique_ptr<DbgBuiltinCollection>(
           new (std::nothrow) DbgBuiltinCollection(
-              debug_type, depth, debug_helper_,
-              std::shared_ptr<DbgObjectFactory>(new DbgObjectFactory())));
+              debug_type, depth, debug_helper_, GetMemberFactory()));
     } else {
       class_obj = unique_ptr<DbgClass>(new (std::nothrow) DbgClass(
-          debug_type, depth, debug_helper_,
-          std::shared_ptr<DbgObjectFactory>(new DbgObjectFactory())));
+          debug_type, depth, debug_helper_, GetMemberFactory()));
     }
 
     if (!class_obj) {
@@ -119,4 +119,25 @@ HRESULT DbgReferenceObject::GetDebugHandle(ICorDebugHandleValue **result) {
   return GetICorDebugValue(reinterpret_cast<ICorDebugValue **>(result), nullptr);
 }
 
+HRESULT DbgReferenceObject::GetCurrentAddress(CORDB_ADDRESS *address) {
+  if (!object_handle_) {
+    return DbgObject::GetCurrentAddress(address);
+  }
+
+  CComPtr<ICorDebugValue> debug_value;
+  HRESULT hr = object_handle_->Dereference(&debug_value);
+  if (FAILED(hr)) {
+    WriteError("Failed to dereference the object handle.");
+    return hr;
+  }
+
+  hr = debug_value->GetAddress(address);
+  if (FAILED(hr)) {
+    WriteError("Failed to get address of the object.");
+    return hr;
+  }
+
+  return *address != 0 ? S_OK : S_FALSE;
+}
+
 }
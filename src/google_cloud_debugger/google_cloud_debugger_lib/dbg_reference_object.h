@@ -44,6 +44,10 @@ class DbgReferenceObject : public DbgObject {
   // Returns the underlying ICorDebugHandleValue for this object.
   HRESULT GetDebugHandle(ICorDebugHandleValue **result);
 
+  // Reads the address of the object through object_handle_, which
+  // follows the object when the garbage collector moves it.
+  virtual HRESULT GetCurrentAddress(CORDB_ADDRESS *address) override;
+
  protected:
   // Handle for the object.
   // Only applicable for class, array and string.
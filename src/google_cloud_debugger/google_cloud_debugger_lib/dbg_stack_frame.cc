@@ -858,14 +858,15 @@ HRESULT DbgStackFrame::PopulateStackFrame(
   }
 
   if (bfs_queue.size() != 0) {
+    // The BFS keeps frame_size up to date as it populates the variables.
+    std::int64_t frame_size = stack_frame->ByteSizeLong();
     return VariableWrapper::PerformBFS(&bfs_queue,
-                                       [stack_frame, stack_frame_size]() {
+                                       [&frame_size, stack_frame_size]() {
                                          // Terminates the BFS if stack frame
                                          // reaches the maximum size.
-                                         return stack_frame->ByteSize() >
-                                                stack_frame_size;
+                                         return frame_size > stack_frame_size;
                                        },
-                                       eval_coordinator);
+                                       eval_coordinator, &frame_size);
   }
 
   return S_OK;
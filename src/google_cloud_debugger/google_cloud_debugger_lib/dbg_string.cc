@@ -15,10 +15,12 @@
 #include "dbg_string.h"
 
 #include <iostream>
+#include <limits>
 
 #include "class_names.h"
 #include "i_cor_debug_helper.h"
 #include "i_eval_coordinator.h"
+#include "string_stream_wrapper.h"
 
 using google::cloud::diagnostics::debug::Variable;
 using std::string;
@@ -53,12 +55,18 @@ HRESULT DbgString::PopulateValue(Variable *variable) {
     return S_OK;
   }
 
-  HRESULT hr = ExtractStringFromReference();
+  HRESULT hr = ExtractStringFromReference(kMaximumStringLength);
   if (FAILED(hr)) {
     return hr;
   }
 
   variable->set_value(string_obj_);
+  if (string_truncated_) {
+    SetStatusMessage(variable, "Only the first " +
+                                   std::to_string(string_obj_length_) +
+                                   " of " + std::to_string(string_length_) +
+                                   " characters were captured.");
+  }
   return S_OK;
 }
 
@@ -81,7 +89,8 @@ HRESULT DbgString::GetString(DbgObject *object, string *returned_string) {
     return E_INVALIDARG;
   }
 
-  HRESULT hr = dbg_string->ExtractStringFromReference();
+  HRESULT hr = dbg_string->ExtractStringFromReference(
+      std::numeric_limits<std::uint32_t>::max());
   if (FAILED(hr)) {
     return hr;
   }
@@ -90,8 +99,9 @@ HRESULT DbgString::GetString(DbgObject *object, string *returned_string) {
   return S_OK;
 }
 
-HRESULT DbgString::ExtractStringFromReference() {
-  if (string_obj_set_) {
+HRESULT DbgString::ExtractStringFromReference(std::uint32_t max_length) {
+  if (string_obj_set_ &&
+      (!string_truncated_ || max_length <= string_obj_max_length_)) {
     return S_OK;
   }
 
@@ -118,13 +128,16 @@ HRESULT DbgString::ExtractStringFromReference() {
     return hr;
   }
 
-  hr = debug_helper_->ExtractStringFromICorDebugStringValue(
-      debug_string, &string_obj_, GetErrorStream());
+  hr = debug_helper_->ExtractStringPrefixFromICorDebugStringValue(
+      debug_string, max_length, &string_obj_, &string_obj_length_,
+      &string_length_, GetErrorStream());
   if (FAILED(hr)) {
     return hr;
   }
 
   string_obj_set_ = true;
+  string_obj_max_length_ = max_length;
+  string_truncated_ = string_length_ > max_length;
   return S_OK;
 }
 
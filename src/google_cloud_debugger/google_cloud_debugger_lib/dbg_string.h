@@ -15,6 +15,11 @@
 #ifndef DBG_STRING_H_
 #define DBG_STRING_H_
 
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "dbg_breakpoint.h"
 #include "dbg_reference_object.h"
 
 namespace google_cloud_debugger {
@@ -51,18 +56,39 @@ class DbgString : public DbgReferenceObject {
 
   // Extracts string from DbgObject.
   // Fails if DbgObject is not a DbgString.
+  // Unlike PopulateValue, this returns the whole string, since it is
+  // used to evaluate expressions.
   static HRESULT GetString(DbgObject *object, std::string *returned_string);
 
+  // Strings longer than this do not fit in a breakpoint, so
+  // PopulateValue only reads this many characters.
+  static const std::uint32_t kMaximumStringLength =
+      DbgBreakpoint::kMaximumBreakpointSize;
+
  private:
-  // Dereferences the string handle and extracts out the string
-  // into string_obj_. Will not do anything if string_obj_set_ is true.
-  HRESULT ExtractStringFromReference();
+  // Dereferences the string handle and extracts out at most max_length
+  // characters of the string into string_obj_. Will not do anything if
+  // string_obj_set_ is true and string_obj_ already has these characters.
+  HRESULT ExtractStringFromReference(std::uint32_t max_length);
 
   // The underlying string object.
   std::string string_obj_;
 
   // True if string_obj_ is set.
   bool string_obj_set_ = false;
+
+  // The maximum number of characters string_obj_ was read with.
+  std::uint32_t string_obj_max_length_ =
+      std::numeric_limits<std::uint32_t>::max();
+
+  // The number of characters in string_obj_.
+  std::uint32_t string_obj_length_ = 0;
+
+  // The length of the whole string in characters.
+  std::uint32_t string_length_ = 0;
+
+  // True if string_obj_ only has a prefix of the string.
+  bool string_truncated_ = false;
 };
 
 }  //  namespace google_cloud_debugger
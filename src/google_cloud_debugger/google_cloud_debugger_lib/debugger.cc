@@ -115,6 +115,11 @@ HRESULT Debugger::StartDebugging(DWORD process_id, bool kill_proc) {
     return hr;
   }
 
+  if (!symbol_cache_directory_.empty()) {
+    debugger_callback_->SetSymbolCacheDirectory(symbol_cache_directory_);
+  }
+  debugger_callback_->SetPipeProtocolVersion(pipe_protocol_version_);
+
   // Using the processId, we register for debugging. If the process is ready,
   // it will call the CallbackFunction that we passed to
   // RegisterForRuntimeStartup.
@@ -66,10 +66,30 @@ class Debugger final {
     debugger_callback_->SetMethodEvaluation(eval);
   }
 
+  // Sets the directory the indices of PDB files are cached in, so they
+  // do not have to be parsed again the next time the debugger starts.
+  // This has to be called before StartDebugging.
+  void SetSymbolCacheDirectory(const std::string &cache_directory) {
+    symbol_cache_directory_ = cache_directory;
+  }
+
+  // Sets the version of the protocol used to exchange breakpoints with
+  // the agent over the pipe. This has to be called before StartDebugging.
+  void SetPipeProtocolVersion(int protocol_version) {
+    pipe_protocol_version_ = protocol_version;
+  }
+
  private:
   // The name of the pipe the debugger will use to communicate with the agent.
   std::string pipe_name_;
 
+  // The directory the indices of PDB files are cached in. Empty if the
+  // indices should not be cached.
+  std::string symbol_cache_directory_;
+
+  // The version of the protocol used to exchange breakpoints over the pipe.
+  int pipe_protocol_version_ = kMarkerPipeProtocolVersion;
+
   // The unregister token that is used in the callback function to
   // unregister for runtime startup.
   void *unregister_token_;
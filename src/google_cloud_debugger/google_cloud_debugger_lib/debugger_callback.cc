@@ -23,6 +23,7 @@
 #include "breakpoint_collection.h"
 #include "ccomptr.h"
 #include "constants.h"
+#include "dbg_class.h"
 #include "dbg_stack_frame.h"
 #include "cor_debug_helper.h"
 #include "portable_pdb_file.h"
@@ -30,6 +31,7 @@
 
 using google_cloud_debugger_portable_pdb::IPortablePdbFile;
 using google_cloud_debugger_portable_pdb::PortablePdbFile;
+using google_cloud_debugger_portable_pdb::SymbolCache;
 using std::cerr;
 using std::cout;
 using std::string;
@@ -136,10 +138,12 @@ HRESULT STDMETHODCALLTYPE DebuggerCallback::Breakpoint(
   HRESULT hr;
   CComPtr<IMetaDataImport> metadata_import;
 
+  CORDB_ADDRESS module_base_address = 0;
   mdMethodDef function_token;
   ULONG32 il_offset = 0;
-  hr = GetFunctionTokenAndILOffset(debug_breakpoint, &function_token,
-                                   &il_offset, &metadata_import);
+  hr = GetFunctionTokenAndILOffset(debug_breakpoint, &module_base_address,
+                                   &function_token, &il_offset,
+                                   &metadata_import);
   if (FAILED(hr)) {
     cerr << "Failed to get function token and IL Offset from breakpoint.";
     appdomain->Continue(FALSE);
@@ -147,8 +151,8 @@ HRESULT STDMETHODCALLTYPE DebuggerCallback::Breakpoint(
   }
 
   hr = breakpoint_collection_->EvaluateAndPrintBreakpoint(
-      function_token, il_offset, eval_coordinator_.get(),
-      debug_thread, portable_pdbs_);
+      module_base_address, function_token, il_offset, eval_coordinator_.get(),
+      debug_thread, GetPdbFiles());
   if (FAILED(hr)) {
     cerr << "Failed to get stack frame's information.";
     appdomain->Continue(FALSE);
@@ -184,8 +188,8 @@ HRESULT STDMETHODCALLTYPE DebuggerCallback::EvalException(
 
 HRESULT DebuggerCallback::LoadModule(ICorDebugAppDomain *appdomain,
                                      ICorDebugModule *debug_module) {
-  std::unique_ptr<IPortablePdbFile> portable_pdb(new (std::nothrow)
-                                                     PortablePdbFile());
+  std::unique_ptr<PortablePdbFile> portable_pdb(new (std::nothrow)
+                                                    PortablePdbFile());
   if (!portable_pdb) {
     cerr << "Cannot create PortablePdbFile object.";
     appdomain->Continue(FALSE);
@@ -198,19 +202,105 @@ HRESULT DebuggerCallback::LoadModule(ICorDebugAppDomain *appdomain,
     return appdomain->Continue(FALSE);
   }
 
-  portable_pdbs_.push_back(std::move(portable_pdb));
+  if (symbol_cache_) {
+    portable_pdb->SetSymbolCache(symbol_cache_);
+  }
+
+  // The names of the tokens of the module are cached until it is
+  // unloaded.
+  CComPtr<IMetaDataImport> metadata_import;
+  hr = debug_helper_->GetMetadataImportFromICorDebugModule(
+      debug_module, &metadata_import, &cerr);
+  if (SUCCEEDED(hr)) {
+    CorDebugHelper::AddMetaDataImportNames(metadata_import);
+  }
+
+  // Starts parsing the PDB now so it is likely ready by the time
+  // a breakpoint in the module is set or hit.
+  std::shared_ptr<IPortablePdbFile> shared_pdb(std::move(portable_pdb));
+  {
+    std::lock_guard<std::mutex> lock(portable_pdbs_mutex_);
+    portable_pdbs_.push_back(shared_pdb);
+  }
+
+  // Breakpoints that were waiting for this module are set before it
+  // runs any code.
+  if (breakpoint_collection_) {
+    hr = breakpoint_collection_->ResolvePendingBreakpoints(shared_pdb.get());
+    if (FAILED(hr)) {
+      cerr << "Failed to set pending breakpoints in module.";
+    }
+  }
+  pdb_parser_pool_.Enqueue(std::move(shared_pdb));
+
+  return appdomain->Continue(FALSE);
+}
+
+HRESULT DebuggerCallback::UnloadModule(ICorDebugAppDomain *appdomain,
+                                       ICorDebugModule *debug_module) {
+  CORDB_ADDRESS module_base_address;
+  HRESULT hr = debug_module->GetBaseAddress(&module_base_address);
+  if (FAILED(hr)) {
+    cerr << "Failed to get base address of unloaded module.";
+    appdomain->Continue(FALSE);
+    return hr;
+  }
+
+  // The debugger keeps returning the same ICorDebugModule for a module,
+  // so the PDB file of the module is the one that holds debug_module.
+  std::shared_ptr<IPortablePdbFile> unloaded_pdb;
+  {
+    std::lock_guard<std::mutex> lock(portable_pdbs_mutex_);
+    for (auto pdb = portable_pdbs_.begin(); pdb != portable_pdbs_.end();
+         ++pdb) {
+      CComPtr<ICorDebugModule> pdb_module;
+      if (*pdb && SUCCEEDED((*pdb)->GetDebugModule(&pdb_module)) &&
+          pdb_module == debug_module) {
+        unloaded_pdb = std::move(*pdb);
+        portable_pdbs_.erase(pdb);
+        break;
+      }
+    }
+  }
+
+  if (unloaded_pdb) {
+    pdb_parser_pool_.Remove(unloaded_pdb.get());
+  }
+
+  // The metadata of the classes in the module is cached across hits.
+  DbgClass::RemoveModuleMetadata(module_base_address);
+
+  // So are the names of its tokens, which are keyed by its metadata.
+  CComPtr<IMetaDataImport> metadata_import;
+  hr = debug_helper_->GetMetadataImportFromICorDebugModule(
+      debug_module, &metadata_import, &cerr);
+  if (SUCCEEDED(hr)) {
+    CorDebugHelper::RemoveMetaDataImportNames(metadata_import);
+  }
+
+  if (breakpoint_collection_) {
+    hr = breakpoint_collection_->RemoveModuleBreakpoints(module_base_address);
+    if (FAILED(hr)) {
+      cerr << "Failed to remove breakpoints of unloaded module.";
+    }
+  }
 
   return appdomain->Continue(FALSE);
 }
 
+void DebuggerCallback::SetSymbolCacheDirectory(const string &cache_directory) {
+  symbol_cache_ = std::make_shared<SymbolCache>(cache_directory);
+}
+
 HRESULT STDMETHODCALLTYPE DebuggerCallback::CustomNotification(
     ICorDebugThread *debug_thread, ICorDebugAppDomain *appdomain) {
   return appdomain->Continue(FALSE);
 }
 
 HRESULT DebuggerCallback::GetFunctionTokenAndILOffset(
-    ICorDebugBreakpoint *debug_breakpoint, mdMethodDef *function_token,
-    ULONG32 *il_offset, IMetaDataImport **metadata_import) {
+    ICorDebugBreakpoint *debug_breakpoint, CORDB_ADDRESS *module_base_address,
+    mdMethodDef *function_token, ULONG32 *il_offset,
+    IMetaDataImport **metadata_import) {
   CComPtr<ICorDebugFunctionBreakpoint> function_breakpoint;
   CComPtr<ICorDebugFunction> debug_function;
 
@@ -248,6 +338,12 @@ HRESULT DebuggerCallback::GetFunctionTokenAndILOffset(
     return hr;
   }
 
+  hr = debug_module->GetBaseAddress(module_base_address);
+  if (FAILED(hr)) {
+    cerr << "Failed to get base address of debug module.";
+    return hr;
+  }
+
   hr = debug_helper_->GetMetadataImportFromICorDebugModule(debug_module, metadata_import,
                                             &cerr);
   if (FAILED(hr)) {
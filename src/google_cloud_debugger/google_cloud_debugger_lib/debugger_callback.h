@@ -18,12 +18,17 @@
 #include <atomic>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "i_breakpoint_collection.h"
+#include "constants.h"
 #include "cor.h"
 #include "cordebug.h"
 #include "corsym.h"
 #include "i_eval_coordinator.h"
+#include "portable_pdb_parser_pool.h"
+#include "symbol_cache.h"
 
 namespace google_cloud_debugger {
 
@@ -67,6 +72,11 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
   HRESULT STDMETHODCALLTYPE LoadModule(ICorDebugAppDomain *appdomain,
                                        ICorDebugModule *debug_module) override;
 
+  // This method is called when a module is unloaded. The PDB file and
+  // the breakpoints of the module are dropped.
+  HRESULT STDMETHODCALLTYPE UnloadModule(
+      ICorDebugAppDomain *appdomain, ICorDebugModule *debug_module) override;
+
   // This method is called when the process the debugger is watching exits.
   HRESULT STDMETHODCALLTYPE ExitProcess(ICorDebugProcess *process) override;
 
@@ -96,8 +106,6 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
                         ICorDebugThread *debug_thread);
   DEBUGGERCALLBACK_STUB(ExitThread, ICorDebugAppDomain,
                         ICorDebugThread *debug_thread);
-  DEBUGGERCALLBACK_STUB(UnloadModule, ICorDebugAppDomain,
-                        ICorDebugModule *debug_module);
   DEBUGGERCALLBACK_STUB(LoadClass, ICorDebugAppDomain,
                         ICorDebugClass *debug_class);
   DEBUGGERCALLBACK_STUB(UnloadClass, ICorDebugAppDomain,
@@ -168,10 +176,13 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
     debug_process_ = debug_process;
   };
 
-  // Returns all the PDB files that are parsed.
-  const std::vector<
+  // Returns the PDB files of all the loaded modules. The files may still
+  // be being parsed in the background, so callers have to call
+  // ReadDocumentPaths or ParsePdbFile before using them.
+  std::vector<
       std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-      &GetPdbFiles() const {
+  GetPdbFiles() const {
+    std::lock_guard<std::mutex> lock(portable_pdbs_mutex_);
     return portable_pdbs_;
   }
 
@@ -195,14 +206,30 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
     eval_coordinator_->SetMethodEvaluation(eval);
   }
 
+  // Caches the indices of the PDB files of modules loaded from now on in
+  // the existing directory cache_directory.
+  void SetSymbolCacheDirectory(const std::string &cache_directory);
+
   // Gets the name of the pipe the debugger will use to communicate with
   // the agent.
   std::string GetPipeName() { return pipe_name_; }
+
+  // Sets the version of the protocol used to exchange breakpoints with
+  // the agent over the pipe.
+  void SetPipeProtocolVersion(int protocol_version) {
+    pipe_protocol_version_ = protocol_version;
+  }
+
+  // Gets the version of the protocol used to exchange breakpoints with
+  // the agent over the pipe.
+  int GetPipeProtocolVersion() { return pipe_protocol_version_; }
   
  private:
-  // Given an ICorDebugBreakpoint, gets the function token, IL offset
-  // and metadata of the function that the breakpoint is in.
+  // Given an ICorDebugBreakpoint, gets the base address of the module,
+  // the function token, IL offset and metadata of the function that
+  // the breakpoint is in.
   HRESULT GetFunctionTokenAndILOffset(ICorDebugBreakpoint *debug_breakpoint,
+                                      CORDB_ADDRESS *module_base_address,
                                       mdMethodDef *function_token,
                                       ULONG32 *il_offset,
                                       IMetaDataImport **metadata_import);
@@ -215,11 +242,22 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
   // This field is used for reference counting (AddRef and Release).
   std::atomic<ULONG> ref_count_;
 
-  // Vector containing all the portable PDB files that are parsed.
+  // Vector containing the portable PDB files of all the loaded modules.
   std::vector<
       std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
       portable_pdbs_;
 
+  // Mutex protecting portable_pdbs_. Modules are loaded on the debugger
+  // callback thread while breakpoints are set on the breakpoint sync thread.
+  mutable std::mutex portable_pdbs_mutex_;
+
+  // Parses the PDB files of loaded modules in the background.
+  google_cloud_debugger_portable_pdb::PortablePdbParserPool pdb_parser_pool_;
+
+  // Cache of the indices of the PDB files. Null if caching is disabled.
+  std::shared_ptr<google_cloud_debugger_portable_pdb::SymbolCache>
+      symbol_cache_;
+
   // The ICorDebugProcess of the debugged process.
   CComPtr<ICorDebugProcess> debug_process_;
 
@@ -234,6 +272,9 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
 
   // The name of the pipe the debugger will use to communicate with the agent.
   std::string pipe_name_;
+
+  // The version of the protocol used to exchange breakpoints over the pipe.
+  int pipe_protocol_version_ = kMarkerPipeProtocolVersion;
 };
 
 }  //  namespace google_cloud_debugger
@@ -29,7 +29,71 @@ using std::vector;
 
 namespace google_cloud_debugger_portable_pdb {
 
+bool FindSequencePointAtILOffset(const MethodInfo &method, uint32_t il_offset,
+                                 uint32_t *sequence_point_index) {
+  if (!sequence_point_index) {
+    return false;
+  }
+
+  const vector<SequencePoint> &sequence_points = method.sequence_points;
+  auto it = std::upper_bound(
+      sequence_points.begin(), sequence_points.end(), il_offset,
+      [](uint32_t offset, const SequencePoint &sequence_point) {
+        return offset < sequence_point.il_offset;
+      });
+
+  while (it != sequence_points.begin()) {
+    --it;
+    if (!it->is_hidden) {
+      *sequence_point_index = it - sequence_points.begin();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void GetLocalsAtILOffset(const MethodInfo &method, uint32_t il_offset,
+                         vector<LocalVariableInfo> *local_variables,
+                         vector<LocalConstantInfo> *local_constants) {
+  const vector<Scope> &scopes = method.local_scope;
+  auto scopes_end = std::upper_bound(
+      scopes.begin(), scopes.end(), il_offset,
+      [](uint32_t offset, const Scope &scope) {
+        return offset < scope.start_offset;
+      });
+
+  for (auto scope = scopes.begin(); scope != scopes_end; ++scope) {
+    if (scope->start_offset + scope->length < il_offset) {
+      continue;
+    }
+
+    local_variables->insert(local_variables->end(),
+                            scope->local_variables.begin(),
+                            scope->local_variables.end());
+    local_constants->insert(local_constants->end(),
+                            scope->local_constants.begin(),
+                            scope->local_constants.end());
+  }
+}
+
 bool DocumentIndex::Initialize(const IPortablePdbFile &pdb, int doc_index) {
+  RowBuckets methods_by_document;
+  methods_by_document.Initialize(
+      pdb.GetMethodDebugInfoTable(), pdb.GetDocumentTable().size(),
+      [](const MethodDebugInformationRow &row) { return row.document; });
+
+  RowBuckets scopes_by_method;
+  scopes_by_method.Initialize(
+      pdb.GetLocalScopeTable(), pdb.GetMethodDebugInfoTable().size(),
+      [](const LocalScopeRow &row) { return row.method_def; });
+
+  return Initialize(pdb, doc_index, methods_by_document, scopes_by_method);
+}
+
+bool DocumentIndex::Initialize(const IPortablePdbFile &pdb, int doc_index,
+                               const RowBuckets &methods_by_document,
+                               const RowBuckets &scopes_by_method) {
   if (doc_index == 0) {
     cerr << "Document index has to be larger than 0.";
     return false;
@@ -74,21 +138,21 @@ bool DocumentIndex::Initialize(const IPortablePdbFile &pdb, int doc_index) {
   }
 
   // We rely on the 1:1 mapping between the Method and MethodDebugInfo tables.
-  vector<MethodDebugInformationRow> method_debug_info_rows =
+  // Pedantically we are ignoring methods that span multiple files.
+  const vector<MethodDebugInformationRow> &method_debug_info_rows =
       pdb.GetMethodDebugInfoTable();
-  size_t num_of_methods = method_debug_info_rows.size();
-  methods_.reserve(num_of_methods);
+  auto methods_begin = methods_by_document.BucketBegin(doc_index);
+  auto methods_end = methods_by_document.BucketEnd(doc_index);
+  methods_.reserve(methods_end - methods_begin);
 
-  for (size_t method_def = 1; method_def < num_of_methods; ++method_def) {
-    MethodDebugInformationRow debug_info_row =
+  for (auto it = methods_begin; it != methods_end; ++it) {
+    uint32_t method_def = *it;
+    const MethodDebugInformationRow &debug_info_row =
         method_debug_info_rows[method_def];
-    // Pedantically we are ignoring methods that span multiple files.
-    if (debug_info_row.document != doc_index) {
-      continue;
-    }
 
     MethodInfo method;
-    if (!ParseMethod(&method, pdb, debug_info_row, method_def, doc_index)) {
+    if (!ParseMethod(&method, pdb, debug_info_row, method_def, doc_index,
+                     scopes_by_method)) {
       cerr << "Failed to parse the method " << std::to_string(method_def)
            << " in document " << std::to_string(doc_index);
       return false;
@@ -97,12 +161,20 @@ bool DocumentIndex::Initialize(const IPortablePdbFile &pdb, int doc_index) {
     methods_.push_back(std::move(method));
   }
 
+  method_line_index_.Initialize(methods_);
   return true;
 }
 
+void DocumentIndex::Initialize(string file_path, vector<MethodInfo> methods) {
+  file_path_ = std::move(file_path);
+  methods_ = std::move(methods);
+  method_line_index_.Initialize(methods_);
+}
+
 bool DocumentIndex::ParseMethod(MethodInfo *method, const IPortablePdbFile &pdb,
                                 const MethodDebugInformationRow &debug_info_row,
-                                uint32_t method_def, uint32_t doc_index) {
+                                uint32_t method_def, uint32_t doc_index,
+                                const RowBuckets &scopes_by_method) {
   assert(method != nullptr);
 
   method->method_def = method_def;
@@ -143,17 +215,17 @@ bool DocumentIndex::ParseMethod(MethodInfo *method, const IPortablePdbFile &pdb,
     method->sequence_points.push_back(std::move(seq_point));
   }
 
-  bool first_scope = true;
   const vector<LocalScopeRow> &local_scope_table = pdb.GetLocalScopeTable();
   const vector<LocalVariableRow> &local_variable_table =
       pdb.GetLocalVariableTable();
   const vector<LocalConstantRow> &local_constant_table =
       pdb.GetLocalConstantTable();
-  for (size_t index = 1; index < local_scope_table.size(); ++index) {
+  auto scopes_begin = scopes_by_method.BucketBegin(method_def);
+  auto scopes_end = scopes_by_method.BucketEnd(method_def);
+  method->local_scope.reserve(scopes_end - scopes_begin);
+  for (auto it = scopes_begin; it != scopes_end; ++it) {
+    uint32_t index = *it;
     const LocalScopeRow &local_scope_row = local_scope_table[index];
-    if (local_scope_row.method_def != method_def) {
-      continue;
-    }
 
     Scope local_scope;
     if (!ParseScope(&local_scope, pdb, local_scope_row, local_scope_table,
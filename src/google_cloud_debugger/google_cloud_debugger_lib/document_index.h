@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "metadata_tables.h"
+#include "method_line_index.h"
 
 namespace google_cloud_debugger_portable_pdb {
 
@@ -119,6 +120,85 @@ struct MethodInfo {
   std::vector<Scope> local_scope;
 };
 
+// Finds the last non-hidden sequence point of method whose IL offset is not
+// larger than il_offset, which is the sequence point an instruction at
+// il_offset belongs to. Sequence points are sorted by IL offset in the PDB,
+// so this is a binary search. Returns false if there is no such point.
+bool FindSequencePointAtILOffset(const MethodInfo &method,
+                                 std::uint32_t il_offset,
+                                 std::uint32_t *sequence_point_index);
+
+// Appends the local variables and constants of the scopes of method that
+// contain il_offset to local_variables and local_constants. Scopes are
+// sorted by start offset in the PDB so the ones starting after il_offset
+// are skipped with a binary search.
+void GetLocalsAtILOffset(const MethodInfo &method, std::uint32_t il_offset,
+                         std::vector<LocalVariableInfo> *local_variables,
+                         std::vector<LocalConstantInfo> *local_constants);
+
+// Groups the row indices of a metadata table by a key that is itself
+// a row index into another table, for example the document of a
+// MethodDebugInformation row or the method of a LocalScope row.
+// The groups are built with a counting pass over the table, so finding
+// the rows of every key costs O(rows + keys) instead of O(rows * keys).
+class RowBuckets {
+ public:
+  // Groups rows [1, table.size()) of table by get_key(row). num_keys is
+  // the size of the table that the keys index into and rows whose key is
+  // not smaller than num_keys are dropped. Rows keep their table order
+  // within a group.
+  template <typename Row, typename GetKey>
+  void Initialize(const std::vector<Row> &table, std::uint32_t num_keys,
+                  GetKey get_key) {
+    bucket_starts_.assign(num_keys + 1, 0);
+    for (size_t row = 1; row < table.size(); ++row) {
+      std::uint32_t key = get_key(table[row]);
+      if (key < num_keys) {
+        ++bucket_starts_[key + 1];
+      }
+    }
+
+    for (size_t key = 1; key < bucket_starts_.size(); ++key) {
+      bucket_starts_[key] += bucket_starts_[key - 1];
+    }
+
+    rows_.resize(bucket_starts_.back());
+    std::vector<std::uint32_t> next_row(bucket_starts_.begin(),
+                                        bucket_starts_.end() - 1);
+    for (size_t row = 1; row < table.size(); ++row) {
+      std::uint32_t key = get_key(table[row]);
+      if (key < num_keys) {
+        rows_[next_row[key]++] = row;
+      }
+    }
+  }
+
+  // Returns the start of the rows that have key.
+  std::vector<std::uint32_t>::const_iterator BucketBegin(
+      std::uint32_t key) const {
+    if (key + 1 >= bucket_starts_.size()) {
+      return rows_.end();
+    }
+    return rows_.begin() + bucket_starts_[key];
+  }
+
+  // Returns the end of the rows that have key.
+  std::vector<std::uint32_t>::const_iterator BucketEnd(
+      std::uint32_t key) const {
+    if (key + 1 >= bucket_starts_.size()) {
+      return rows_.end();
+    }
+    return rows_.begin() + bucket_starts_[key + 1];
+  }
+
+ private:
+  // The rows of the table, sorted by key.
+  std::vector<std::uint32_t> rows_;
+
+  // The rows that have key k are rows_[bucket_starts_[k], bucket_starts_[k+1]).
+  std::vector<std::uint32_t> bucket_starts_;
+};
+
 // Index for a single source file described in a Portable PDB. Essentially a
 // user-friendly copy of all the data encoded in the PDB's metadata table.
 //
@@ -137,6 +217,10 @@ class IDocumentIndex {
 
   // Returns all the methods in this document.
   virtual const std::vector<MethodInfo> &GetMethods() const = 0;
+
+  // Returns the index from source lines to the methods returned
+  // by GetMethods.
+  virtual const MethodLineIndex &GetMethodLineIndex() const = 0;
 };
 
 // Implementation of IDocumentIndex interface.
@@ -146,19 +230,38 @@ class DocumentIndex : public IDocumentIndex {
   // in the DocumentTable of the Portable PDB file pdb.
   bool Initialize(const IPortablePdbFile &pdb, int doc_index);
 
+  // Same as Initialize above but uses methods_by_document (rows of the
+  // MethodDebugInformation table grouped by document) and scopes_by_method
+  // (rows of the LocalScope table grouped by method) instead of scanning
+  // the tables. Use this when indexing all the documents of a PDB so the
+  // groups are only built once.
+  bool Initialize(const IPortablePdbFile &pdb, int doc_index,
+                  const RowBuckets &methods_by_document,
+                  const RowBuckets &scopes_by_method);
+
+  // Initializes this document index with the file path and methods of
+  // a document that was indexed before, for example by a SymbolCache.
+  void Initialize(std::string file_path, std::vector<MethodInfo> methods);
+
   // Returns the file path of this document.
   const std::string &GetFilePath() const { return file_path_; }
 
   // Returns all the methods in this document.
   const std::vector<MethodInfo> &GetMethods() const { return methods_; }
 
+  // Returns the index from source lines to the methods of this document.
+  const MethodLineIndex &GetMethodLineIndex() const {
+    return method_line_index_;
+  }
+
  private:
   // Populate a method object that corresponds to MethodDebugInformationRow
   // debug_info_row. This function assumes that the method only spans
   // 1 document.
   bool ParseMethod(MethodInfo *method, const IPortablePdbFile &pdb,
                    const MethodDebugInformationRow &debug_info_row,
-                   std::uint32_t method_def, std::uint32_t doc_index);
+                   std::uint32_t method_def, std::uint32_t doc_index,
+                   const RowBuckets &scopes_by_method);
 
   // Returns a Scope object that corresponds with LocalScopeRow
   // local_scope_row. The Scope object will have its variable
@@ -185,6 +288,9 @@ class DocumentIndex : public IDocumentIndex {
 
   // The methods of this document.
   std::vector<MethodInfo> methods_;
+
+  // Index from source lines to methods_.
+  MethodLineIndex method_line_index_;
 };
 
 }  // namespace google_cloud_debugger_portable_pdb
@@ -0,0 +1,92 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "document_path_trie.h"
+
+#include <algorithm>
+#include <cctype>
+
+using std::string;
+using std::vector;
+
+namespace google_cloud_debugger_portable_pdb {
+
+DocumentPathTrie::DocumentPathTrie() : nodes_(1) {}
+
+void DocumentPathTrie::AddPath(const string &path, uint32_t document_index) {
+  string normalized_path = path;
+  // Normalize path separators. The PDB may use either Unix or Windows-style
+  // paths, but the Cloud Debugger only uses Unix.
+  std::replace(normalized_path.begin(), normalized_path.end(), '\\', '/');
+  std::transform(
+      normalized_path.begin(), normalized_path.end(), normalized_path.begin(),
+      [](unsigned char c) -> unsigned char { return std::tolower(c); });
+
+  // Walks the segments from the file name to the root directory.
+  uint32_t node = 0;
+  size_t segment_end = normalized_path.size();
+  while (true) {
+    size_t delimiter_position =
+        segment_end == 0 ? string::npos
+                         : normalized_path.rfind('/', segment_end - 1);
+    size_t segment_start =
+        delimiter_position == string::npos ? 0 : delimiter_position + 1;
+    string segment =
+        normalized_path.substr(segment_start, segment_end - segment_start);
+
+    auto child = nodes_[node].children.find(segment);
+    if (child == nodes_[node].children.end()) {
+      uint32_t new_node = nodes_.size();
+      nodes_[node].children.emplace(std::move(segment), new_node);
+      nodes_.emplace_back();
+      node = new_node;
+    } else {
+      node = child->second;
+    }
+
+    nodes_[node].min_document_index =
+        std::min(nodes_[node].min_document_index, document_index);
+
+    if (delimiter_position == string::npos) {
+      break;
+    }
+    segment_end = delimiter_position;
+  }
+}
+
+int32_t DocumentPathTrie::FindBestMatch(
+    const vector<string> &reversed_segments) const {
+  uint32_t node = 0;
+  for (const string &segment : reversed_segments) {
+    auto child = nodes_[node].children.find(segment);
+    if (child == nodes_[node].children.end()) {
+      break;
+    }
+    node = child->second;
+  }
+
+  // The root means not even the file name matched.
+  if (node == 0) {
+    return -1;
+  }
+
+  return static_cast<int32_t>(nodes_[node].min_document_index);
+}
+
+void DocumentPathTrie::Clear() {
+  nodes_.clear();
+  nodes_.emplace_back();
+}
+
+}  // namespace google_cloud_debugger_portable_pdb
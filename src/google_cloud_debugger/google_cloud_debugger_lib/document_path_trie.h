@@ -0,0 +1,70 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DOCUMENT_PATH_TRIE_H_
+#define DOCUMENT_PATH_TRIE_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace google_cloud_debugger_portable_pdb {
+
+// Trie over the reversed segments of the document paths of a PDB
+// (the file name is the first segment, then its parent directory and so on).
+// It is used to find the document that best matches a breakpoint's file
+// path in time proportional to the depth of the path instead of the number
+// of documents.
+//
+// Paths are normalized when added: '\' is replaced by '/' and the path
+// is lowercased.
+class DocumentPathTrie {
+ public:
+  DocumentPathTrie();
+
+  // Adds the path of the document at document_index
+  // in the document index table of the PDB.
+  void AddPath(const std::string &path, std::uint32_t document_index);
+
+  // Returns the index of the document whose path has the longest run of
+  // trailing segments in common with reversed_segments, which is a
+  // normalized path split by '/' with the file name as the first item.
+  // If several documents have the same longest match, the one with the
+  // smallest index is returned. Returns -1 if no document has the same
+  // file name.
+  std::int32_t FindBestMatch(
+      const std::vector<std::string> &reversed_segments) const;
+
+  // Removes all the paths.
+  void Clear();
+
+ private:
+  // A node of the trie. The path from the root to a node is a run of
+  // trailing segments shared by one or more documents.
+  struct Node {
+    // Child nodes keyed by the next segment (towards the root directory).
+    std::unordered_map<std::string, std::uint32_t> children;
+
+    // Smallest index of the documents whose paths go through this node.
+    std::uint32_t min_document_index = UINT32_MAX;
+  };
+
+  // Nodes of the trie. The root is nodes_[0].
+  std::vector<Node> nodes_;
+};
+
+}  // namespace google_cloud_debugger_portable_pdb
+
+#endif  //  DOCUMENT_PATH_TRIE_H_
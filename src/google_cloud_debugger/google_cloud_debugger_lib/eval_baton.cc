@@ -0,0 +1,81 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval_baton.h"
+
+#include <thread>
+
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger {
+
+void EvalBaton::HandTo(EvalPhase phase) {
+  phase_.store(static_cast<int>(phase));
+  Wake();
+}
+
+bool EvalBaton::HandFrom(EvalPhase expected, EvalPhase phase) {
+  int current = static_cast<int>(expected);
+  if (!phase_.compare_exchange_strong(current, static_cast<int>(phase))) {
+    return false;
+  }
+
+  Wake();
+  return true;
+}
+
+EvalPhase EvalBaton::Wait(unsigned phases) {
+  return Wait(phases, steady_clock::time_point::max());
+}
+
+EvalPhase EvalBaton::Wait(unsigned phases, steady_clock::time_point deadline) {
+  for (int i = 0; i < kSpinCount; ++i) {
+    EvalPhase phase = GetPhase();
+    if (EvalPhaseBit(phase) & phases) {
+      return phase;
+    }
+    std::this_thread::yield();
+  }
+
+  // waiters_ and phase_ are sequentially consistent, so either HandTo
+  // sees the increment and signals, or the check below sees its phase.
+  std::unique_lock<std::mutex> lock(mutex_);
+  waiters_.fetch_add(1);
+  EvalPhase phase = static_cast<EvalPhase>(phase_.load());
+  while (!(EvalPhaseBit(phase) & phases)) {
+    if (deadline == steady_clock::time_point::max()) {
+      phase_changed_.wait(lock);
+    } else if (phase_changed_.wait_until(lock, deadline) ==
+               std::cv_status::timeout) {
+      phase = static_cast<EvalPhase>(phase_.load());
+      break;
+    }
+    phase = static_cast<EvalPhase>(phase_.load());
+  }
+  waiters_.fetch_sub(1);
+  return phase;
+}
+
+void EvalBaton::Wake() {
+  if (waiters_.load() == 0) {
+    return;
+  }
+
+  // Taking the mutex makes sure the waiter is either before its check of
+  // the phase or already blocked, so the notification is not lost.
+  { std::lock_guard<std::mutex> lock(mutex_); }
+  phase_changed_.notify_all();
+}
+
+}  // namespace google_cloud_debugger
@@ -0,0 +1,102 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EVAL_BATON_H_
+#define EVAL_BATON_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace google_cloud_debugger {
+
+// The phases of a breakpoint hit. The phase says which of the debugger
+// callback thread and the capture thread owns the stopped debuggee.
+enum class EvalPhase {
+  // The debugger callback thread owns the debuggee. This is the phase
+  // between breakpoint hits and while a finished evaluation is handed
+  // back to the capture thread.
+  kCallback = 0,
+  // The capture thread owns the debuggee and is reading its state. The
+  // debugger callback thread waits.
+  kCapture = 1,
+  // The capture thread started a function evaluation and waits for the
+  // debugger callback thread to let the debuggee run it.
+  kEval = 2,
+  // The capture thread is done with the debuggee and the debugger
+  // callback thread can resume it.
+  kFinished = 3,
+};
+
+// Returns the bit of phase in the phase sets passed to EvalBaton::Wait.
+inline unsigned EvalPhaseBit(EvalPhase phase) {
+  return 1u << static_cast<unsigned>(phase);
+}
+
+// Hands the debuggee back and forth between the debugger callback thread
+// and the capture thread.
+//
+// The current phase is an atomic. A thread that hands the debuggee over
+// stores the next phase and only takes the mutex and signals the condition
+// variable if the other thread is already blocked in Wait. A thread that
+// waits spins briefly before it blocks, so a handoff that completes quickly
+// costs no system call on either side.
+class EvalBaton {
+ public:
+  // Returns the current phase.
+  EvalPhase GetPhase() const {
+    return static_cast<EvalPhase>(phase_.load(std::memory_order_acquire));
+  }
+
+  // Moves to phase and wakes up the other thread if it is waiting.
+  void HandTo(EvalPhase phase);
+
+  // Moves to phase if the current phase is expected and wakes up the
+  // other thread if it is waiting. Returns false, without changing the
+  // phase, if the current phase is not expected.
+  bool HandFrom(EvalPhase expected, EvalPhase phase);
+
+  // Blocks until the phase is in phases, a bitwise or of EvalPhaseBit
+  // values, and returns that phase.
+  EvalPhase Wait(unsigned phases);
+
+  // Blocks until the phase is in phases or until deadline. Returns the
+  // phase that was current when the wait ended.
+  EvalPhase Wait(unsigned phases,
+                 std::chrono::steady_clock::time_point deadline);
+
+ private:
+  // Wakes up the waiting thread, if any.
+  void Wake();
+
+  // Number of times Wait checks the phase before it blocks.
+  static const int kSpinCount = 64;
+
+  // The current EvalPhase.
+  std::atomic<int> phase_{static_cast<int>(EvalPhase::kCallback)};
+
+  // Number of threads blocked, or about to block, on phase_changed_.
+  std::atomic<int> waiters_{0};
+
+  // Mutex used with phase_changed_. It does not protect phase_.
+  std::mutex mutex_;
+
+  // Signaled when the phase changes and a thread is waiting.
+  std::condition_variable phase_changed_;
+};
+
+}  // namespace google_cloud_debugger
+
+#endif  //  EVAL_BATON_H_
@@ -15,7 +15,7 @@
 #include "eval_coordinator.h"
 
 #include <chrono>
-#include <future>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <thread>
@@ -30,20 +30,15 @@
 
 using google::cloud::diagnostics::debug::Breakpoint;
 using std::cerr;
-using std::lock_guard;
-using std::mutex;
-using std::unique_lock;
 using std::unique_ptr;
-using std::chrono::high_resolution_clock;
 using std::chrono::minutes;
+using std::chrono::steady_clock;
 
 namespace google_cloud_debugger {
 
 minutes EvalCoordinator::one_minute = minutes(1);
 
 HRESULT EvalCoordinator::CreateEval(ICorDebugEval **eval) {
-  lock_guard<mutex> lk(mutex_);
-
   if (active_debug_thread_ == nullptr) {
     std::cerr << "Active debug thread is missing";
     return E_FAIL;
@@ -74,63 +69,56 @@ HRESULT EvalCoordinator::CreateStackWalk(
 HRESULT EvalCoordinator::WaitForEval(BOOL *exception_thrown,
                                      ICorDebugEval *eval,
                                      ICorDebugValue **eval_result) {
-  // Let the debugger continue so we can get back the eval result.
-  unique_lock<mutex> lk(mutex_);
-
-  waiting_for_eval_ = TRUE;
-  debuggercallback_can_continue_ = TRUE;
-  eval_exception_occurred_ = FALSE;
+  eval_exception_occurred_ = false;
   HRESULT hr = CORDBG_E_FUNC_EVAL_NOT_COMPLETE;
-  auto start = high_resolution_clock::now();
+  steady_clock::time_point deadline = steady_clock::now() + one_minute;
 
   // Wait until evaluation is done.
-  while (hr == CORDBG_E_FUNC_EVAL_NOT_COMPLETE ||
-         hr == CORDBG_E_PROCESS_NOT_SYNCHRONIZED) {
-    auto current = high_resolution_clock::now();
-    if (current - start > one_minute) {
+  while (true) {
+    hr = eval->GetResult(eval_result);
+    if (hr != CORDBG_E_FUNC_EVAL_NOT_COMPLETE &&
+        hr != CORDBG_E_PROCESS_NOT_SYNCHRONIZED) {
+      break;
+    }
+
+    if (steady_clock::now() >= deadline) {
       hr = CORDBG_E_FUNC_EVAL_NOT_COMPLETE;
       cerr << "Timed out while trying to evaluate function.";
       break;
     }
 
-    hr = eval->GetResult(eval_result);
-
-    if (hr == CORDBG_E_FUNC_EVAL_NOT_COMPLETE ||
-        hr == CORDBG_E_PROCESS_NOT_SYNCHRONIZED) {
-      // Wake up the debugger thread to do the evaluation.
-      debugger_callback_cv_.notify_one();
-      variable_threads_cv_.wait_for(lk, one_minute);
-    } else {
-      break;
+    // Let the DebuggerCallback continue the debuggee so the evaluation
+    // runs. SignalFinishedEval hands the debuggee back when it is done.
+    baton_.HandTo(EvalPhase::kEval);
+    EvalPhase phase = baton_.Wait(EvalPhaseBit(EvalPhase::kCapture), deadline);
+    if (phase != EvalPhase::kCapture &&
+        !baton_.HandFrom(EvalPhase::kEval, EvalPhase::kCapture)) {
+      // SignalFinishedEval claimed the debuggee just before the deadline.
+      // Let it finish handing the debuggee back so that a late
+      // EvalComplete never touches active_debug_thread_ after this.
+      baton_.Wait(EvalPhaseBit(EvalPhase::kCapture));
     }
   }
 
-  // We got our lock back!
-  // Tells the debugger to chill out until our next eval call or we reach the
-  // end.
-  debuggercallback_can_continue_ = FALSE;
-  waiting_for_eval_ = FALSE;
-
   *exception_thrown = eval_exception_occurred_;
   return hr;
 }
 
 void EvalCoordinator::SignalFinishedEval(ICorDebugThread *debug_thread) {
-  unique_lock<mutex> lk(mutex_);
+  // Takes the debuggee back before changing active_debug_thread_, which
+  // the capture thread reads whenever it owns the debuggee. If WaitForEval
+  // timed out, nobody is waiting for this evaluation.
+  if (!baton_.HandFrom(EvalPhase::kEval, EvalPhase::kCallback)) {
+    return;
+  }
 
-  debuggercallback_can_continue_ = FALSE;
   active_debug_thread_ = debug_thread;
-  // Wake up all variable threads and so one of them can
-  // use the evaluation result.
-  variable_threads_cv_.notify_all();
-
-  // finished_printing_variables_ is set to true if the StackFrame
-  // decides to call SignalFinishedPrintingVariable to signal that it has
-  // finished printing the variables.
-  // debuggercallback_can_continue_ is set to true if the StackFrame
-  // makes another evaluation by calling WaitForEval.
-  debugger_callback_cv_.wait(lk,
-                             [&] { return debuggercallback_can_continue_; });
+  baton_.HandTo(EvalPhase::kCapture);
+
+  // The StackFrame either makes another evaluation by calling WaitForEval
+  // or calls SignalFinishedPrintingVariable when it is done.
+  baton_.Wait(EvalPhaseBit(EvalPhase::kEval) |
+              EvalPhaseBit(EvalPhase::kFinished));
 }
 
 HRESULT EvalCoordinator::ProcessBreakpoints(
@@ -144,51 +132,43 @@ HRESULT EvalCoordinator::ProcessBreakpoints(
     return E_INVALIDARG;
   }
 
+  // The debuggee is stopped at the breakpoint from now until
+  // ProcessBreakpointsTask calls SignalFinishedPrintingVariable.
+  steady_clock::time_point hit_time = steady_clock::now();
   active_debug_thread_ = debug_thread;
+  baton_.HandTo(EvalPhase::kCapture);
+
+  bool posted = capture_worker_.Post(
+      std::bind(&EvalCoordinator::ProcessBreakpointsTask, this,
+                breakpoint_collection, std::move(breakpoints), pdb_files,
+                hit_time));
+  if (!posted) {
+    baton_.HandTo(EvalPhase::kCallback);
+    cerr << "The capture worker is shut down.";
+    return E_ABORT;
+  }
 
-  unique_lock<mutex> lk(mutex_);
-
-  std::future<HRESULT> print_breakpoint_task = std::async(
-      std::launch::async, &EvalCoordinator::ProcessBreakpointsTask, this,
-      breakpoint_collection, std::move(breakpoints), pdb_files);
-  print_breakpoint_tasks_.push_back(std::move(print_breakpoint_task));
-
-  ready_to_print_variables_ = TRUE;
-  debuggercallback_can_continue_ = FALSE;
-
-  // Notify the StackFrame threads we are ready.
-  variable_threads_cv_.notify_all();
-
-  // The StackFrame in active_debug_thread_ will have to set
-  // debuggerCallBackCanContinue to TRUE by either calling WaitForEval
-  // or SignalFinishPrintingVariable.
-  debugger_callback_cv_.wait(lk,
-                             [&] { return debuggercallback_can_continue_; });
+  // The StackFrame will hand the debuggee back by either calling
+  // WaitForEval or SignalFinishedPrintingVariable.
+  baton_.Wait(EvalPhaseBit(EvalPhase::kEval) |
+              EvalPhaseBit(EvalPhase::kFinished));
+  baton_.HandFrom(EvalPhase::kFinished, EvalPhase::kCallback);
 
   return S_OK;
 }
 
-void EvalCoordinator::HandleException() {
-  lock_guard<mutex> lk(mutex_);
-  eval_exception_occurred_ = TRUE;
-}
+void EvalCoordinator::HandleException() { eval_exception_occurred_ = true; }
 
 void EvalCoordinator::WaitForReadySignal() {
-  {
-    unique_lock<mutex> lk(mutex_);
-
-    // Wait for ready signal from debugger calback.
-    variable_threads_cv_.wait(lk, [&] { return ready_to_print_variables_; });
-  }
+  // Wait for ready signal from debugger calback.
+  baton_.Wait(EvalPhaseBit(EvalPhase::kCapture) |
+              EvalPhaseBit(EvalPhase::kEval) |
+              EvalPhaseBit(EvalPhase::kFinished));
 }
 
 void EvalCoordinator::SignalFinishedPrintingVariable() {
-  {
-    lock_guard<mutex> lk(mutex_);
-    DbgClass::ClearStaticCache();
-    debuggercallback_can_continue_ = TRUE;
-  }
-  debugger_callback_cv_.notify_one();
+  DbgClass::ClearStaticCache();
+  baton_.HandTo(EvalPhase::kFinished);
 }
 
 HRESULT EvalCoordinator::GetActiveDebugThread(ICorDebugThread **debug_thread) {
@@ -227,8 +207,7 @@ HRESULT EvalCoordinator::GetActiveDebugFrame(
 }
 
 BOOL EvalCoordinator::WaitingForEval() {
-  lock_guard<mutex> lk(mutex_);
-  return waiting_for_eval_;
+  return baton_.GetPhase() == EvalPhase::kEval;
 }
 
 HRESULT EvalCoordinator::ProcessBreakpointsTask(
@@ -236,21 +215,8 @@ HRESULT EvalCoordinator::ProcessBreakpointsTask(
     std::vector<std::shared_ptr<DbgBreakpoint>> breakpoints,
     const std::vector<
         std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &pdb_files) {
-  // Vector of PDB files that are parsed successfully.
-  std::vector<
-      std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-      parsed_pdb_files;
-  for (auto &&pdb_file : pdb_files) {
-    if (!pdb_file) {
-      continue;
-    }
-
-    if (pdb_file->ParsePdbFile()) {
-      parsed_pdb_files.push_back(pdb_file);
-    }
-  }
-
+        &pdb_files,
+    steady_clock::time_point hit_time) {
   // Creates and initializes stack frame collection based on the
   // ICorDebugStackWalk object.
   unique_ptr<IStackFrameCollection> stack_frames(
@@ -262,21 +228,27 @@ HRESULT EvalCoordinator::ProcessBreakpointsTask(
     return E_OUTOFMEMORY;
   }
 
+  // Snapshots are only captured while the debuggee is stopped. They do
+  // not reference any ICorDebug object, so they are serialized and written
+  // by the write queue of breakpoint_collection after the debuggee resumes.
+  // Written snapshots are reused so that their messages are not allocated
+  // again for every hit. The generated Breakpoint has no move constructor,
+  // so snapshots is reserved up front and never reallocated, and the
+  // snapshots are swapped into the write queue.
+  std::vector<Breakpoint> snapshots;
+  snapshots.reserve(breakpoints.size());
   HRESULT hr = S_OK;
   for (auto &&breakpoint : breakpoints) {
-    hr = stack_frames->ProcessBreakpoint(parsed_pdb_files, breakpoint.get(),
-                                         this);
+    // The PDB files are not parsed here. StackFrameCollection only parses
+    // the PDB files of the modules on the stack.
+    hr = stack_frames->ProcessBreakpoint(pdb_files, breakpoint.get(), this);
     if (FAILED(hr)) {
       std::cerr << "Failed to process breakpoint \"" << breakpoint->GetId()
                 << "\" with HRESULT: " << std::hex << hr;
-      Breakpoint error_breakpoint;
-      breakpoint->PopulateBreakpoint(&error_breakpoint);
-
-      hr = breakpoint_collection->WriteBreakpoint(error_breakpoint);
-      if (FAILED(hr)) {
-        cerr << "Failed to write error breakpoint: " << std::hex << hr;
-        break;
-      }
+      // We should still write the breakpoint to report the error to the user.
+      snapshots.emplace_back();
+      breakpoint_collection->ReuseSnapshot(&snapshots.back());
+      breakpoint->PopulateBreakpoint(&snapshots.back());
       continue;
     }
 
@@ -287,23 +259,30 @@ HRESULT EvalCoordinator::ProcessBreakpointsTask(
       continue;
     }
 
-    Breakpoint proto_breakpoint;
-    hr = breakpoint->PopulateBreakpoint(&proto_breakpoint, stack_frames.get(),
+    snapshots.emplace_back();
+    breakpoint_collection->ReuseSnapshot(&snapshots.back());
+    hr = breakpoint->PopulateBreakpoint(&snapshots.back(), stack_frames.get(),
                                         this);
     if (FAILED(hr)) {
       // We should still write the breakpoint to report the error to the user.
       cerr << "Failed to print out variables: " << std::hex << hr;
     }
+  }
+
+  stack_frames.reset();
+  SignalFinishedPrintingVariable();
+  steady_clock::time_point resume_time = steady_clock::now();
 
-    hr = breakpoint_collection->WriteBreakpoint(proto_breakpoint);
+  hr = S_OK;
+  for (auto &&snapshot : snapshots) {
+    hr = breakpoint_collection->QueueBreakpoint(&snapshot, hit_time,
+                                                resume_time);
     if (FAILED(hr)) {
       cerr << "Failed to write breakpoint: " << std::hex << hr;
       break;
     }
   }
 
-  stack_frames.reset();
-  SignalFinishedPrintingVariable();
   return hr;
 }
 
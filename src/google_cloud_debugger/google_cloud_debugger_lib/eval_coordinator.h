@@ -15,9 +15,11 @@
 #ifndef EVAL_COORDINATOR_H_
 #define EVAL_COORDINATOR_H_
 
+#include <atomic>
 #include <chrono>
-#include <future>
 
+#include "capture_worker.h"
+#include "eval_baton.h"
 #include "i_eval_coordinator.h"
 
 namespace google_cloud_debugger {
@@ -25,8 +27,9 @@ namespace google_cloud_debugger {
 class IStackFrameCollection;
 
 // An EvalCoordinator object is used by DebuggerCallback object to evaluate
-// and print out variables. It does so by creating a StackFrame on a new
-// thread and coordinates between the StackFrame and DebuggerCallback.
+// and print out variables. It does so by creating a StackFrame on a
+// long-lived capture thread and coordinates between the StackFrame and
+// DebuggerCallback.
 //
 // We need an EvalCoordinator for coordination because if we want to print
 // out properties and perform function evaluation, we would have to do it
@@ -46,6 +49,13 @@ class IStackFrameCollection;
 // inspection on a different thread than the thread that the DebuggerCallback
 // is on. Otherwise, the DebuggerCallback thread will be blocked and
 // cannot perform evaluation.
+//
+// The two threads hand the debuggee to each other through an EvalBaton.
+// A breakpoint hit moves it from kCallback to kCapture, every function
+// evaluation goes to kEval and back to kCapture, and the capture thread
+// ends the hit with kFinished. A finished evaluation passes through
+// kCallback on its way back so the callback thread can update the active
+// thread while the capture thread waits.
 class EvalCoordinator : public IEvalCoordinator {
  public:
   // This method is used to create an ICorDebugEval object
@@ -119,12 +129,16 @@ class EvalCoordinator : public IEvalCoordinator {
   // using the stack frame collection. The stack frame collection
   // will first be used to evaluate the breakpoint condition. If this succeeds,
   // the function will proceed to get stack frame information at the breakpoint.
+  // The debuggee is resumed as soon as the snapshots are captured and the
+  // snapshots are then queued to be written. hit_time is when the debuggee
+  // stopped at the breakpoint.
   HRESULT ProcessBreakpointsTask(
       IBreakpointCollection *breakpoint_collection,
       std::vector<std::shared_ptr<DbgBreakpoint>> breakpoints,
       const std::vector<
           std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &pdb_files);
+          &pdb_files,
+      std::chrono::steady_clock::time_point hit_time);
 
   // If sets to true, object evaluation will be performed when evaluating property.
   BOOL property_evaluation_ = FALSE;
@@ -133,26 +147,22 @@ class EvalCoordinator : public IEvalCoordinator {
   // when evaluating condition.
   BOOL condition_evaluation_ = FALSE;
 
-  // The tasks that help us enumerate and print out variables.
-  std::vector<std::future<HRESULT>> print_breakpoint_tasks_;
-
-  // The ICorDebugThread that the active StackFrame is on.
+  // The ICorDebugThread that the active StackFrame is on. Only the thread
+  // that owns the debuggee according to baton_ changes it.
   CComPtr<ICorDebugThread> active_debug_thread_;
 
-  // variable_thread_ and the thread that DebuggerCallback object is on
-  // will use this condition_variable_ and mutex_ to communicate.
-  std::condition_variable variable_threads_cv_;
-
-  std::condition_variable debugger_callback_cv_;
+  // Says whether the DebuggerCallback thread or the capture thread owns
+  // the debuggee.
+  EvalBaton baton_;
 
-  std::mutex mutex_;
-
-  BOOL ready_to_print_variables_ = FALSE;
-  BOOL debuggercallback_can_continue_ = FALSE;
-  BOOL eval_exception_occurred_ = FALSE;
-  BOOL waiting_for_eval_ = FALSE;
+  // True if an exception occurred during the current function evaluation.
+  std::atomic<bool> eval_exception_occurred_{false};
 
   static std::chrono::minutes one_minute;
+
+  // Runs ProcessBreakpointsTask for every hit. This is declared last so it
+  // is destroyed, and its thread stopped, before the members its tasks use.
+  CaptureWorker capture_worker_;
 };
 
 }  //  namespace google_cloud_debugger
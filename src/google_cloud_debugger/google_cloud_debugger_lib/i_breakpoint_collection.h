@@ -15,6 +15,7 @@
 #ifndef I_BREAKPOINT_COLLECTION_H_
 #define I_BREAKPOINT_COLLECTION_H_
 
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -53,6 +54,26 @@ class IBreakpointCollection {
   // This means duplicate breakpoints will be silently rejected.
   virtual HRESULT UpdateBreakpoint(const DbgBreakpoint &breakpoint) = 0;
 
+  // Same as calling UpdateBreakpoint on each breakpoint in order, but the
+  // new breakpoints are grouped by file path so each PDB is searched for
+  // each file only once. A status for every breakpoint that fails to
+  // update is appended to errors.
+  virtual HRESULT UpdateBreakpoints(
+      const std::vector<DbgBreakpoint> &breakpoints,
+      std::vector<google::cloud::diagnostics::debug::Breakpoint> *errors) = 0;
+
+  // Tries to set the breakpoints that are pending because their files
+  // were not in any loaded module in pdb_file, the PDB file of a module
+  // that was just loaded. Returns S_FALSE if none of them are set.
+  virtual HRESULT ResolvePendingBreakpoints(
+      google_cloud_debugger_portable_pdb::IPortablePdbFile *pdb_file) = 0;
+
+  // Removes the breakpoints in the module loaded at module_base_address,
+  // which is being unloaded. The active ones become pending again so
+  // they are set if the module is loaded again.
+  virtual HRESULT RemoveModuleBreakpoints(
+      CORDB_ADDRESS module_base_address) = 0;
+
   // Using the breakpoint_client_read_ name pipe, try to read and parse
   // any incoming breakpoints that are written to the named pipe.
   // This method will then try to activate or deactivate these breakpoints.
@@ -68,16 +89,33 @@ class IBreakpointCollection {
   virtual HRESULT WriteBreakpoint(
       const google::cloud::diagnostics::debug::Breakpoint &breakpoint) = 0;
 
+  // Queues a breakpoint snapshot to be written to the named pipe server
+  // by a writer thread, so the caller does not wait for serialization and
+  // pipe I/O. The snapshot is swapped into the queue rather than copied
+  // and breakpoint is left empty. hit_time is when the debuggee stopped
+  // at the breakpoint and resume_time is when it was allowed to continue.
+  virtual HRESULT QueueBreakpoint(
+      google::cloud::diagnostics::debug::Breakpoint *breakpoint,
+      std::chrono::steady_clock::time_point hit_time,
+      std::chrono::steady_clock::time_point resume_time) = 0;
+
+  // Swaps snapshot, which should be empty, with a cleared snapshot that
+  // was already written, if there is one. Populating a reused snapshot
+  // allocates fewer messages.
+  virtual void ReuseSnapshot(
+      google::cloud::diagnostics::debug::Breakpoint *snapshot) = 0;
+
   // Reads a breakpoint from the named pipe server.
   virtual HRESULT ReadBreakpoint(
       google::cloud::diagnostics::debug::Breakpoint *breakpoint) = 0;
 
   // Evaluates and prints out the breakpoint that corresponds to
   // the IL offset il_offset inside the function with token
-  // function_token.
+  // function_token in the module loaded at module_base_address.
   virtual HRESULT EvaluateAndPrintBreakpoint(
-      mdMethodDef function_token, ULONG32 il_offset,
-      IEvalCoordinator *eval_coordinator, ICorDebugThread *debug_thread,
+      CORDB_ADDRESS module_base_address, mdMethodDef function_token,
+      ULONG32 il_offset, IEvalCoordinator *eval_coordinator,
+      ICorDebugThread *debug_thread,
       const std::vector<
           std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
           &pdb_files) = 0;
@@ -101,6 +101,17 @@ class ICorDebugHelper {
       ICorDebugStringValue *debug_string, std::string *returned_string,
       std::ostream *err_stream) = 0;
 
+  // Extracts out at most max_length characters from the start of
+  // ICorDebugStringValue. Only these characters are read from the
+  // debuggee. Sets returned_length to the number of characters in
+  // returned_string, which is one less than max_length if a surrogate
+  // pair would be split, and string_length to the length of the whole
+  // string.
+  virtual HRESULT ExtractStringPrefixFromICorDebugStringValue(
+      ICorDebugStringValue *debug_string, ULONG32 max_length,
+      std::string *returned_string, ULONG32 *returned_length,
+      ULONG32 *string_length, std::ostream *err_stream) = 0;
+
   // Given a metadata token for the parameter param_token,
   // extracts out the parameter name.
   // metadata_import is the MetaDataImport of the module
@@ -194,6 +205,14 @@ class ICorDebugHelper {
                                          std::string *type_name,
                                          std::ostream *err_stream) = 0;
 
+  // Gets the name of the method with mdMethodDef token method_token,
+  // the mdTypeDef token of its class and the relative virtual address
+  // of its code.
+  virtual HRESULT GetMethodNameFromMdMethodDef(
+      mdMethodDef method_token, IMetaDataImport *metadata_import,
+      std::string *method_name, mdTypeDef *class_token, ULONG *code_rva,
+      std::ostream *err_stream) = 0;
+
   // Given a TypeRef token and its MetaDataImport, this function
   // converts it into a TypeDef token. The function will also return
   // the corresponding MetaDataImport for that token.
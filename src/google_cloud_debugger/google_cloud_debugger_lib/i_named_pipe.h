@@ -16,8 +16,10 @@
 #define I_NAMED_PIPE_H_
 
 #include <string>
+#include <vector>
 
 #include "cor.h"
+#include "pipe_receive_buffer.h"
 
 namespace google_cloud_debugger {
 
@@ -45,6 +47,37 @@ class INamedPipe {
   // Note: strings are used only as containers.
   virtual HRESULT Write(const std::string &message) = 0;
 
+  // Reads from the pipe directly into the free space of buffer and
+  // returns an HRESULT. This function will block until there is a
+  // message to read. The default implementation reads into a string
+  // with Read and appends it to buffer.
+  virtual HRESULT ReadInto(PipeReceiveBuffer *buffer) {
+    if (buffer == nullptr) {
+      return E_POINTER;
+    }
+
+    std::string message;
+    HRESULT hr = Read(&message);
+    if (FAILED(hr)) {
+      return hr;
+    }
+    buffer->Append(message.data(), message.size());
+    return S_OK;
+  }
+
+  // Writes messages to the pipe one after the other, as if they were a
+  // single message, and returns an HRESULT. Implementations should gather
+  // them into as few system calls as possible. The default implementation
+  // concatenates them and calls Write.
+  virtual HRESULT WriteGather(
+      const std::vector<const std::string *> &messages) {
+    std::string message;
+    for (const std::string *part : messages) {
+      message += *part;
+    }
+    return Write(message);
+  }
+
   // Cancels any pending operations and shuts down the pipe.
   virtual HRESULT ShutDown() = 0;
 };
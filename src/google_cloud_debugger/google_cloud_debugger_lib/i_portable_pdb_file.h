@@ -24,6 +24,7 @@
 #include "cor.h"
 #include "cordebug.h"
 #include "document_index.h"
+#include "document_path_trie.h"
 #include "metadata_tables.h"
 
 namespace google_cloud_debugger {
@@ -55,10 +56,24 @@ class IPortablePdbFile {
   virtual HRESULT Initialize(ICorDebugModule *debug_module,
                              google_cloud_debugger::ICorDebugHelper *debug_helper) = 0;
 
+  // Reads the file paths of the documents of the pdb file, so that
+  // GetDocumentPathTrie can be used before the file is parsed. This is
+  // much cheaper than ParsePdbFile: the method and scope information of
+  // the documents is not read. Like ParsePdbFile, the paths are only read
+  // once and this is safe to call from multiple threads.
+  virtual bool ReadDocumentPaths() = 0;
+
   // Parses the pdb file. The name of the file will come from the
   // ICorDebugModule object that is used to initialize this object.
+  // The file is only parsed once and later calls return the same result.
+  // This is safe to call from multiple threads: if another thread is
+  // parsing the file, this waits for it to finish.
   virtual bool ParsePdbFile() = 0;
 
+  // Returns true if ParsePdbFile has finished, successfully or not,
+  // so calling it will not block.
+  virtual bool ParseAttempted() const = 0;
+
   // Finds the stream header with a given name. Returns false if not found.
   // name is the name of the stream header.
   // stream_header is the stream header that has name name.
@@ -113,6 +128,18 @@ class IPortablePdbFile {
   virtual const std::vector<std::unique_ptr<IDocumentIndex>>
       &GetDocumentIndexTable() const = 0;
 
+  // Returns the trie of the file paths of the documents in the document
+  // index table, which is used to find the document of a breakpoint.
+  // This can be used once ReadDocumentPaths has returned true.
+  virtual const DocumentPathTrie &GetDocumentPathTrie() const = 0;
+
+  // Finds the method with MethodDef row method_def and the document
+  // index it belongs to. Returns false if no document of this PDB has
+  // the method.
+  virtual bool FindMethod(std::uint32_t method_def,
+                          const IDocumentIndex **document_index,
+                          const MethodInfo **method) const = 0;
+
   // Gets the name of the module of this PDB.
   virtual const std::string &GetModuleName() const = 0;
 
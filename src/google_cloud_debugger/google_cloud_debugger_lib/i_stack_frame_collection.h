@@ -39,6 +39,9 @@ class IStackFrameCollection {
   // any expressions in the breakpoint will be evaluated.
   // Afterwards, stack information will be collected at the
   // breakpoint's location.
+  // A PDB file in pdb_files is only parsed, or waited on if it is
+  // being parsed in the background, when a frame in its module is
+  // processed.
   virtual HRESULT ProcessBreakpoint(
       const std::vector<
           std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
@@ -0,0 +1,114 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "memory_mapped_file.h"
+
+#ifdef PLATFORM_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif _WIN32
+#include <windows.h>
+#endif
+
+namespace google_cloud_debugger_portable_pdb {
+
+MemoryMappedFile::~MemoryMappedFile() { Close(); }
+
+#ifdef PLATFORM_UNIX
+
+bool MemoryMappedFile::Open(const std::string &file) {
+  Close();
+
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1 || file_stat.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+
+  void *mapping =
+      mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the file descriptor is closed.
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  data_ = static_cast<const std::uint8_t *>(mapping);
+  size_ = file_stat.st_size;
+  return true;
+}
+
+void MemoryMappedFile::Close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<std::uint8_t *>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+
+#elif _WIN32
+
+bool MemoryMappedFile::Open(const std::string &file) {
+  Close();
+
+  HANDLE file_handle =
+      CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_handle == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart <= 0) {
+    CloseHandle(file_handle);
+    return false;
+  }
+
+  HANDLE mapping_handle =
+      CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file_handle);
+  if (mapping_handle == nullptr) {
+    return false;
+  }
+
+  // The view keeps the mapping alive after its handle is closed.
+  void *view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping_handle);
+  if (view == nullptr) {
+    return false;
+  }
+
+  data_ = static_cast<const std::uint8_t *>(view);
+  size_ = file_size.QuadPart;
+  return true;
+}
+
+void MemoryMappedFile::Close() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+
+#endif
+
+}  // namespace google_cloud_debugger_portable_pdb
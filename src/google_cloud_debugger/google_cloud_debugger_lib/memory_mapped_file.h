@@ -0,0 +1,56 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEMORY_MAPPED_FILE_H_
+#define MEMORY_MAPPED_FILE_H_
+
+#include <cstdint>
+#include <string>
+
+namespace google_cloud_debugger_portable_pdb {
+
+// Class that maps a whole file into memory as read-only.
+// The mapping is released when the object is destroyed.
+class MemoryMappedFile {
+ public:
+  MemoryMappedFile() = default;
+  ~MemoryMappedFile();
+
+  MemoryMappedFile(const MemoryMappedFile &) = delete;
+  MemoryMappedFile &operator=(const MemoryMappedFile &) = delete;
+
+  // Maps file into memory. Returns false if the file cannot be
+  // opened or mapped (for example, if the file is empty).
+  bool Open(const std::string &file);
+
+  // Returns the start of the mapped content.
+  const std::uint8_t *GetData() const { return data_; }
+
+  // Returns the size of the mapped content in bytes.
+  std::uint64_t GetSize() const { return size_; }
+
+ private:
+  // Unmaps the file if it is mapped.
+  void Close();
+
+  // Start of the mapped content.
+  const std::uint8_t *data_ = nullptr;
+
+  // Size of the mapped content.
+  std::uint64_t size_ = 0;
+};
+
+}  // namespace google_cloud_debugger_portable_pdb
+
+#endif  // MEMORY_MAPPED_FILE_H_
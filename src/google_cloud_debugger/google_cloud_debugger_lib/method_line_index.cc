@@ -0,0 +1,118 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "method_line_index.h"
+
+#include <algorithm>
+
+#include "document_index.h"
+
+using std::vector;
+
+namespace google_cloud_debugger_portable_pdb {
+
+void MethodLineIndex::Initialize(const vector<MethodInfo> &methods) {
+  uint32_t num_methods = methods.size();
+
+  methods_by_first_line_.resize(num_methods);
+  for (uint32_t i = 0; i < num_methods; ++i) {
+    methods_by_first_line_[i] = i;
+  }
+
+  std::sort(methods_by_first_line_.begin(), methods_by_first_line_.end(),
+            [&methods](uint32_t first, uint32_t second) {
+              if (methods[first].first_line != methods[second].first_line) {
+                return methods[first].first_line < methods[second].first_line;
+              }
+              return first > second;
+            });
+
+  first_lines_.resize(num_methods);
+  max_last_lines_.resize(num_methods);
+  uint32_t max_last_line = 0;
+  for (uint32_t i = 0; i < num_methods; ++i) {
+    const MethodInfo &method = methods[methods_by_first_line_[i]];
+    first_lines_[i] = method.first_line;
+    max_last_line = std::max(max_last_line, method.last_line);
+    max_last_lines_[i] = max_last_line;
+  }
+
+  sequence_points_by_line_.clear();
+  sequence_points_by_line_.resize(num_methods);
+  for (uint32_t i = 0; i < num_methods; ++i) {
+    const vector<SequencePoint> &sequence_points = methods[i].sequence_points;
+    vector<uint32_t> &sorted_points = sequence_points_by_line_[i];
+    for (uint32_t j = 0; j < sequence_points.size(); ++j) {
+      if (!sequence_points[j].is_hidden) {
+        sorted_points.push_back(j);
+      }
+    }
+
+    // Sequence points are stored in IL order so a stable sort keeps
+    // the smallest IL offset first among points on the same line.
+    std::stable_sort(sorted_points.begin(), sorted_points.end(),
+                     [&sequence_points](uint32_t first, uint32_t second) {
+                       return sequence_points[first].start_line <
+                              sequence_points[second].start_line;
+                     });
+  }
+}
+
+bool MethodLineIndex::FindLocation(const vector<MethodInfo> &methods,
+                                   uint32_t line, uint32_t *method_index,
+                                   uint32_t *sequence_point_index) const {
+  if (methods.size() != sequence_points_by_line_.size()) {
+    return false;
+  }
+
+  // Methods that start after line cannot contain it.
+  size_t candidate = std::upper_bound(first_lines_.begin(), first_lines_.end(),
+                                      line) -
+                     first_lines_.begin();
+
+  // Walks back from the method with the largest first line.
+  while (candidate > 0) {
+    --candidate;
+    if (max_last_lines_[candidate] < line) {
+      break;
+    }
+
+    uint32_t current_method = methods_by_first_line_[candidate];
+    const MethodInfo &method = methods[current_method];
+    if (method.last_line < line) {
+      continue;
+    }
+
+    const vector<SequencePoint> &sequence_points = method.sequence_points;
+    const vector<uint32_t> &sorted_points =
+        sequence_points_by_line_[current_method];
+    auto sequence_point = std::lower_bound(
+        sorted_points.begin(), sorted_points.end(), line,
+        [&sequence_points](uint32_t point, uint32_t line) {
+          return sequence_points[point].start_line < line;
+        });
+    if (sequence_point == sorted_points.end()) {
+      // No sequence points in the method correspond to this line.
+      continue;
+    }
+
+    *method_index = current_method;
+    *sequence_point_index = *sequence_point;
+    return true;
+  }
+
+  return false;
+}
+
+}  // namespace google_cloud_debugger_portable_pdb
@@ -0,0 +1,69 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef METHOD_LINE_INDEX_H_
+#define METHOD_LINE_INDEX_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace google_cloud_debugger_portable_pdb {
+
+struct MethodInfo;
+
+// Index from source lines to the methods of a document and the
+// sequence points of those methods. It is used to find where a breakpoint
+// on a line should be set in time logarithmic in the number of methods
+// and sequence points (plus the number of methods nested around the line).
+//
+// The index stores positions in the vector of methods it is initialized
+// with, so the same vector has to be passed to FindLocation.
+class MethodLineIndex {
+ public:
+  // Builds the index for methods.
+  void Initialize(const std::vector<MethodInfo> &methods);
+
+  // Finds the innermost method (the one with the largest first line)
+  // that contains line and has a non-hidden sequence point on or after
+  // line. Sets method_index to the position of that method in methods and
+  // sequence_point_index to the position of the sequence point with the
+  // smallest start line on or after line in the method's sequence points.
+  // If several sequence points start on that line, the one with the
+  // smallest IL offset is chosen. Returns false if no method matches.
+  bool FindLocation(const std::vector<MethodInfo> &methods, std::uint32_t line,
+                    std::uint32_t *method_index,
+                    std::uint32_t *sequence_point_index) const;
+
+ private:
+  // Positions of the methods sorted by first line. Methods with the same
+  // first line are in reverse order so that searching backward from the
+  // end finds the first of them in methods.
+  std::vector<std::uint32_t> methods_by_first_line_;
+
+  // First line of each method in methods_by_first_line_.
+  std::vector<std::uint32_t> first_lines_;
+
+  // max_last_lines_[i] is the largest last line of the methods
+  // methods_by_first_line_[0] to methods_by_first_line_[i]. This lets the
+  // backward search stop once no earlier method can contain the line.
+  std::vector<std::uint32_t> max_last_lines_;
+
+  // For each method, the positions of its non-hidden sequence points
+  // sorted by start line (and by IL offset for the same start line).
+  std::vector<std::vector<std::uint32_t>> sequence_points_by_line_;
+};
+
+}  // namespace google_cloud_debugger_portable_pdb
+
+#endif  //  METHOD_LINE_INDEX_H_
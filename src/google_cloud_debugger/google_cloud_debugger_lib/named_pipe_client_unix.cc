@@ -17,7 +17,9 @@
 #include <errno.h>
 #include <sys/un.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#include <algorithm>
 #include <iostream>
 
 #include "named_pipe_client_unix.h"
@@ -101,20 +103,79 @@ HRESULT NamedPipeClient::Read(string *message) {
 }
 
 HRESULT NamedPipeClient::Write(const string &message) {
-  const char *buf = message.c_str();
-  DWORD bytes_left = message.length();
+  return WriteGather({&message});
+}
+
+HRESULT NamedPipeClient::ReadInto(PipeReceiveBuffer *buffer) {
+  if (buffer == nullptr) {
+    return E_POINTER;
+  }
+
+  char *destination = buffer->PrepareWrite(read_size_);
+  std::size_t capacity = buffer->WritableSize();
+  ssize_t read = recv(pipe_, destination, capacity, 0);
+
+  if (read == -1) {
+    cerr << "recv error: " << strerror(errno) << std::endl;
+    return E_FAIL;
+  }
+
+  if (read == 0) {
+    cerr << "recv error: the pipe is closed" << std::endl;
+    return E_FAIL;
+  }
+
+  buffer->CommitWrite(read);
 
-  while (bytes_left > 0) {
-    int write = bytes_left > kBufferSize ? kBufferSize : bytes_left;
+  // Reads more at a time while messages keep filling the buffer and less
+  // once they are much smaller than it.
+  if (static_cast<std::size_t>(read) == capacity) {
+    read_size_ = std::min(read_size_ * 2,
+                          static_cast<std::size_t>(kMaximumPipeReadSize));
+  } else if (static_cast<std::size_t>(read) < read_size_ / 4) {
+    read_size_ =
+        std::max(read_size_ / 2, static_cast<std::size_t>(kBufferSize));
+  }
+  return S_OK;
+}
 
-    int written = send(pipe_, buf, write, 0);
+HRESULT NamedPipeClient::WriteGather(
+    const std::vector<const string *> &messages) {
+  std::vector<struct iovec> buffers;
+  buffers.reserve(messages.size());
+  for (const string *message : messages) {
+    if (!message->empty()) {
+      struct iovec buffer;
+      buffer.iov_base = const_cast<char *>(message->data());
+      buffer.iov_len = message->size();
+      buffers.push_back(buffer);
+    }
+  }
+
+  // writev may write only part of the buffers, so keep writing from
+  // where it stopped.
+  std::size_t current = 0;
+  while (current < buffers.size()) {
+    ssize_t written =
+        writev(pipe_, &buffers[current], buffers.size() - current);
     if (written == -1) {
-      cerr << "send error: " << strerror(errno) << std::endl;
+      if (errno == EINTR) {
+        continue;
+      }
+      cerr << "writev error: " << strerror(errno) << std::endl;
       return E_FAIL;
     }
 
-    bytes_left -= written;
-    buf += written;
+    while (current < buffers.size() &&
+           static_cast<std::size_t>(written) >= buffers[current].iov_len) {
+      written -= buffers[current].iov_len;
+      ++current;
+    }
+    if (written > 0) {
+      buffers[current].iov_base =
+          static_cast<char *>(buffers[current].iov_base) + written;
+      buffers[current].iov_len -= written;
+    }
   }
   return S_OK;
 }
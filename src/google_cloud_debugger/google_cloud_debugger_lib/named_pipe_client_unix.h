@@ -18,6 +18,7 @@
 #define NAMED_PIPE_CLIENT_H_
 
 #include <string>
+#include <vector>
 
 #include "i_named_pipe.h"
 #include "constants.h"
@@ -33,6 +34,9 @@ class NamedPipeClient : public INamedPipe {
   HRESULT WaitForConnection() override;
   HRESULT Read(std::string *message) override;
   HRESULT Write(const std::string &message) override;
+  HRESULT ReadInto(PipeReceiveBuffer *buffer) override;
+  HRESULT WriteGather(
+      const std::vector<const std::string *> &messages) override;
   HRESULT ShutDown() override;
 
  private:
@@ -41,6 +45,10 @@ class NamedPipeClient : public INamedPipe {
 
   // The socket descriptor for the pipe.
   int pipe_ = -1;
+
+  // The number of bytes ReadInto tries to read. This adapts to the size of
+  // the messages, between kBufferSize and kMaximumPipeReadSize.
+  std::size_t read_size_ = kBufferSize;
 };
 
 }  // namespace google_cloud_debugger
@@ -14,6 +14,7 @@
 
 #ifdef _WIN32
 
+#include <algorithm>
 #include <string>
 
 #include "named_pipe_client_windows.h"
@@ -100,22 +101,58 @@ HRESULT NamedPipeClient::Read(string *message) {
 }
 
 HRESULT NamedPipeClient::Write(const string &message) {
-  const CHAR *buf = message.c_str();
-  DWORD bytes_left = message.size();
+  return WriteGather({&message});
+}
 
-  while (bytes_left > 0) {
-    DWORD written = 0;
-    int write = bytes_left > kBufferSize ? kBufferSize : bytes_left;
+HRESULT NamedPipeClient::ReadInto(PipeReceiveBuffer *buffer) {
+  if (buffer == nullptr) {
+    return E_POINTER;
+  }
 
-    BOOL success = WriteFile(pipe_, buf, write, &written, NULL);
-    if (!success) {
-      std::cerr << "WriteFile error: " << HRESULT_FROM_WIN32(GetLastError())
-                << std::endl;
-      return HRESULT_FROM_WIN32(GetLastError());
-    }
+  CHAR *destination = buffer->PrepareWrite(read_size_);
+  DWORD capacity = static_cast<DWORD>(buffer->WritableSize());
+  DWORD read = 0;
+  BOOL success = ReadFile(pipe_, destination, capacity, &read, NULL);
 
-    bytes_left -= written;
-    buf += written;
+  if (!success) {
+    std::cerr << "ReadFile error: " << HRESULT_FROM_WIN32(GetLastError())
+              << std::endl;
+    return HRESULT_FROM_WIN32(GetLastError());
+  }
+
+  buffer->CommitWrite(read);
+
+  // Reads more at a time while messages keep filling the buffer and less
+  // once they are much smaller than it.
+  if (read == capacity) {
+    read_size_ =
+        std::min(read_size_ * 2, static_cast<DWORD>(kMaximumPipeReadSize));
+  } else if (read < read_size_ / 4) {
+    read_size_ = std::max(read_size_ / 2, static_cast<DWORD>(kBufferSize));
+  }
+  return S_OK;
+}
+
+HRESULT NamedPipeClient::WriteGather(
+    const std::vector<const string *> &messages) {
+  // Named pipes do not support gathered writes, so each message is
+  // written with as few WriteFile calls as it takes.
+  for (const string *message : messages) {
+    const CHAR *buf = message->data();
+    DWORD bytes_left = message->size();
+
+    while (bytes_left > 0) {
+      DWORD written = 0;
+      BOOL success = WriteFile(pipe_, buf, bytes_left, &written, NULL);
+      if (!success) {
+        std::cerr << "WriteFile error: " << HRESULT_FROM_WIN32(GetLastError())
+                  << std::endl;
+        return HRESULT_FROM_WIN32(GetLastError());
+      }
+
+      bytes_left -= written;
+      buf += written;
+    }
   }
   return S_OK;
 }
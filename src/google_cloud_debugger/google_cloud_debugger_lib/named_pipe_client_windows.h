@@ -20,6 +20,7 @@
 #include <windef.h>
 #include <iostream>
 #include <string>
+#include <vector>
 #include <codecvt>
 
 #include "constants.h"
@@ -36,6 +37,9 @@ class NamedPipeClient : public INamedPipe {
   HRESULT WaitForConnection() override;
   HRESULT Read(std::string *message) override;
   HRESULT Write(const std::string &message) override;
+  HRESULT ReadInto(PipeReceiveBuffer *buffer) override;
+  HRESULT WriteGather(
+      const std::vector<const std::string *> &messages) override;
   HRESULT ShutDown() override;
 
  private:
@@ -44,6 +48,10 @@ class NamedPipeClient : public INamedPipe {
 
   // A handle to the open pipe.
   HANDLE pipe_ = INVALID_HANDLE_VALUE;
+
+  // The number of bytes ReadInto tries to read. This adapts to the size of
+  // the messages, between kBufferSize and kMaximumPipeReadSize.
+  DWORD read_size_ = kBufferSize;
 };
 
 }  // namespace google_cloud_debugger
@@ -0,0 +1,128 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pending_breakpoints.h"
+
+#include <algorithm>
+
+#include "i_portable_pdb_file.h"
+
+using google_cloud_debugger_portable_pdb::IPortablePdbFile;
+using std::unique_ptr;
+using std::vector;
+
+namespace google_cloud_debugger {
+
+HRESULT PendingBreakpoints::Add(const DbgBreakpoint &breakpoint) {
+  unique_ptr<DbgBreakpoint> pending(new (std::nothrow) DbgBreakpoint);
+  if (!pending) {
+    return E_OUTOFMEMORY;
+  }
+
+  pending->Initialize(breakpoint);
+  pending->SetActivated(true);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  vector<unique_ptr<DbgBreakpoint>> &file_breakpoints =
+      breakpoints_by_file_[breakpoint.GetFilePath()];
+  for (auto &existing : file_breakpoints) {
+    if (existing->GetId() == breakpoint.GetId()) {
+      existing = std::move(pending);
+      return S_OK;
+    }
+  }
+
+  file_breakpoints.push_back(std::move(pending));
+  ++size_;
+  return S_OK;
+}
+
+bool PendingBreakpoints::Remove(const DbgBreakpoint &breakpoint) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto file = breakpoints_by_file_.find(breakpoint.GetFilePath());
+  if (file == breakpoints_by_file_.end()) {
+    return false;
+  }
+
+  vector<unique_ptr<DbgBreakpoint>> &file_breakpoints = file->second;
+  auto existing = std::find_if(
+      file_breakpoints.begin(), file_breakpoints.end(),
+      [&breakpoint](const unique_ptr<DbgBreakpoint> &pending) {
+        return pending->GetId() == breakpoint.GetId();
+      });
+  if (existing == file_breakpoints.end()) {
+    return false;
+  }
+
+  file_breakpoints.erase(existing);
+  if (file_breakpoints.empty()) {
+    breakpoints_by_file_.erase(file);
+  }
+  --size_;
+  return true;
+}
+
+size_t PendingBreakpoints::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+vector<ResolvedBreakpoint> PendingBreakpoints::SetInPdbFile(
+    const IPortablePdbFile &pdb_file) {
+  vector<ResolvedBreakpoint> resolved;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto file = breakpoints_by_file_.begin();
+  while (file != breakpoints_by_file_.end()) {
+    vector<unique_ptr<DbgBreakpoint>> &file_breakpoints = file->second;
+    int32_t document_index = file_breakpoints.front()->FindDocument(pdb_file);
+    if (document_index < 0) {
+      ++file;
+      continue;
+    }
+
+    // The pending breakpoint is only copied, so it stays unchanged if
+    // it cannot be set.
+    auto pending = file_breakpoints.begin();
+    while (pending != file_breakpoints.end()) {
+      std::shared_ptr<DbgBreakpoint> breakpoint(new (std::nothrow)
+                                                    DbgBreakpoint);
+      if (!breakpoint) {
+        return resolved;
+      }
+
+      breakpoint->Initialize(**pending);
+      breakpoint->SetActivated(true);
+      if (!breakpoint->TrySetBreakpointInDocument(pdb_file, document_index)) {
+        ++pending;
+        continue;
+      }
+
+      resolved.push_back(
+          {(*pending)->GetRequestedLocation(), std::move(breakpoint)});
+      pending = file_breakpoints.erase(pending);
+      --size_;
+    }
+
+    if (file_breakpoints.empty()) {
+      file = breakpoints_by_file_.erase(file);
+    } else {
+      ++file;
+    }
+  }
+
+  return resolved;
+}
+
+}  // namespace google_cloud_debugger
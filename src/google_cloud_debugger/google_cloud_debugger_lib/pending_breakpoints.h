@@ -0,0 +1,84 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PENDING_BREAKPOINTS_H_
+#define PENDING_BREAKPOINTS_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dbg_breakpoint.h"
+
+namespace google_cloud_debugger_portable_pdb {
+class IPortablePdbFile;
+}  // namespace google_cloud_debugger_portable_pdb
+
+namespace google_cloud_debugger {
+
+// A pending breakpoint that was set in a PDB file by
+// PendingBreakpoints::SetInPdbFile.
+struct ResolvedBreakpoint {
+  // The location the breakpoint was requested at. This may differ from the
+  // location of the breakpoint, which is moved to its sequence point.
+  std::string requested_location;
+
+  // The breakpoint, with its IL offset and method set.
+  std::shared_ptr<DbgBreakpoint> breakpoint;
+};
+
+// Table of the active breakpoints whose file is not in any loaded module.
+// The breakpoints are grouped by file path so that, when a module is
+// loaded, only the pending breakpoints are tried against its PDB file and
+// each document is looked up once per file path. This class is thread-safe.
+class PendingBreakpoints {
+ public:
+  // Adds a copy of breakpoint, replacing the pending breakpoint with the
+  // same ID and file path if there is one. breakpoint may already be set,
+  // for example in a module that is unloaded.
+  HRESULT Add(const DbgBreakpoint &breakpoint);
+
+  // Removes the pending breakpoint with the same ID and file path as
+  // breakpoint. Returns true if there was one.
+  bool Remove(const DbgBreakpoint &breakpoint);
+
+  // Returns the number of pending breakpoints.
+  size_t Size() const;
+
+  // Returns true if there are no pending breakpoints.
+  bool Empty() const { return Size() == 0; }
+
+  // Tries to set the pending breakpoints in pdb_file, which has to be
+  // parsed already. The breakpoints that are set are removed from this
+  // table and returned.
+  std::vector<ResolvedBreakpoint> SetInPdbFile(
+      const google_cloud_debugger_portable_pdb::IPortablePdbFile &pdb_file);
+
+ private:
+  // Map of a file path to the pending breakpoints in that file.
+  std::unordered_map<std::string, std::vector<std::unique_ptr<DbgBreakpoint>>>
+      breakpoints_by_file_;
+
+  // The number of breakpoints in breakpoints_by_file_.
+  size_t size_ = 0;
+
+  // Protects breakpoints_by_file_ and size_.
+  mutable std::mutex mutex_;
+};
+
+}  // namespace google_cloud_debugger
+
+#endif  //  PENDING_BREAKPOINTS_H_
@@ -0,0 +1,58 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pipe_receive_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace google_cloud_debugger {
+
+void PipeReceiveBuffer::Consume(std::size_t count) {
+  read_position_ += std::min(count, Size());
+  if (read_position_ == write_position_) {
+    read_position_ = 0;
+    write_position_ = 0;
+  }
+}
+
+char *PipeReceiveBuffer::PrepareWrite(std::size_t min_size) {
+  if (WritableSize() >= min_size) {
+    return buffer_.data() + write_position_;
+  }
+
+  // Reclaims the consumed bytes at the front before growing the storage.
+  std::size_t unread = Size();
+  if (read_position_ != 0) {
+    std::memmove(buffer_.data(), buffer_.data() + read_position_, unread);
+    read_position_ = 0;
+    write_position_ = unread;
+  }
+
+  if (WritableSize() < min_size) {
+    buffer_.resize(std::max(unread + min_size, buffer_.size() * 2));
+  }
+  return buffer_.data() + write_position_;
+}
+
+void PipeReceiveBuffer::Append(const char *data, std::size_t size) {
+  if (size == 0) {
+    return;
+  }
+
+  std::memcpy(PrepareWrite(size), data, size);
+  CommitWrite(size);
+}
+
+}  // namespace google_cloud_debugger
@@ -0,0 +1,77 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PIPE_RECEIVE_BUFFER_H_
+#define PIPE_RECEIVE_BUFFER_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace google_cloud_debugger {
+
+// Buffer that bytes received from a pipe are read into and messages are
+// parsed from in place. Unread bytes are kept contiguous so a message can be
+// parsed without being copied out first. The storage is reused across
+// messages: consumed bytes at the front are reclaimed by moving the unread
+// bytes back to the start, and the storage only grows when a message does
+// not fit.
+//
+// To use this class, call PrepareWrite to get space for the pipe to read
+// into, then CommitWrite with the number of bytes read. Parse from Data and
+// Size, then call Consume with the size of the parsed message.
+class PipeReceiveBuffer {
+ public:
+  // Returns the first unread byte.
+  const char *Data() const { return buffer_.data() + read_position_; }
+
+  // Returns the number of unread bytes.
+  std::size_t Size() const { return write_position_ - read_position_; }
+
+  // Marks the first count unread bytes as read. count must not be more
+  // than Size().
+  void Consume(std::size_t count);
+
+  // Makes sure at least min_size bytes can be written after the unread
+  // bytes and returns where to write them. The unread bytes may be moved,
+  // so pointers returned by Data are invalidated.
+  char *PrepareWrite(std::size_t min_size);
+
+  // Returns the number of bytes that can be written at the pointer
+  // returned by the last PrepareWrite.
+  std::size_t WritableSize() const { return buffer_.size() - write_position_; }
+
+  // Marks count bytes written at the pointer returned by the last
+  // PrepareWrite as unread. count must not be more than WritableSize().
+  void CommitWrite(std::size_t count) { write_position_ += count; }
+
+  // Copies size bytes from data after the unread bytes.
+  void Append(const char *data, std::size_t size);
+
+  // Returns the size of the storage of the buffer.
+  std::size_t Capacity() const { return buffer_.size(); }
+
+ private:
+  // Storage of the buffer.
+  std::vector<char> buffer_;
+
+  // Position of the first unread byte in buffer_.
+  std::size_t read_position_ = 0;
+
+  // Position after the last unread byte in buffer_.
+  std::size_t write_position_ = 0;
+};
+
+}  // namespace google_cloud_debugger
+
+#endif  //  PIPE_RECEIVE_BUFFER_H_
@@ -26,6 +26,7 @@
 #include "i_cor_debug_helper.h"
 #include "metadata_headers.h"
 #include "metadata_tables.h"
+#include "symbol_cache.h"
 
 using google_cloud_debugger::CComPtr;
 using google_cloud_debugger::kDllExtension;
@@ -63,8 +64,17 @@ bool PortablePdbFile::InitializeStringsHeap() {
 }
 
 bool PortablePdbFile::GetHeapString(uint32_t index, string *heap_string) const {
-  return pdb_file_binary_stream_.GetString(heap_string,
-                                           string_heap_header_.offset + index);
+  // The string is read in place from the #Strings heap and only copied
+  // into heap_string, which has to outlive the mapping of the PDB file.
+  const char *view;
+  uint32_t length;
+  if (!pdb_file_binary_stream_.GetStringView(string_heap_header_.offset + index,
+                                             &view, &length)) {
+    return false;
+  }
+
+  heap_string->assign(view, length);
+  return true;
 }
 
 bool PortablePdbFile::GetBlobBytes(
@@ -73,21 +83,55 @@ bool PortablePdbFile::GetBlobBytes(
     blob_heap_header_.offset + index, result);
 }
 
+bool PortablePdbFile::ReadDocumentPaths() {
+  // The paths may already be read by a background thread.
+  if (paths_read_attempted_.load(std::memory_order_acquire)) {
+    return paths_read_succeeded_;
+  }
+
+  std::lock_guard<std::mutex> lock(paths_mutex_);
+  if (!paths_read_attempted_.load(std::memory_order_relaxed)) {
+    paths_read_succeeded_ = ReadDocumentPathsHelper();
+    paths_read_attempted_.store(true, std::memory_order_release);
+  }
+
+  return paths_read_succeeded_;
+}
+
 bool PortablePdbFile::ParsePdbFile() {
-  if (parsed) {
-    return true;
+  // The file may already be parsed by a background thread.
+  if (parse_attempted_.load(std::memory_order_acquire)) {
+    return parse_succeeded_;
   }
 
-  string module_name = GetModuleName();
-  size_t last_dll_extension_pos = module_name.rfind(kDllExtension);
-  if (last_dll_extension_pos != module_name.size() - kDllExtension.size()) {
+  std::lock_guard<std::mutex> lock(parse_mutex_);
+  if (!parse_attempted_.load(std::memory_order_relaxed)) {
+    parse_succeeded_ = ReadDocumentPaths() && ParsePdbFileHelper();
+    parse_attempted_.store(true, std::memory_order_release);
+  }
+
+  return parse_succeeded_;
+}
+
+bool PortablePdbFile::GetPdbPath(string *pdb_path) const {
+  *pdb_path = GetModuleName();
+  size_t last_dll_extension_pos = pdb_path->rfind(kDllExtension);
+  if (last_dll_extension_pos != pdb_path->size() - kDllExtension.size()) {
     return false;
   }
 
-  module_name.replace(last_dll_extension_pos, kDllExtension.size(),
-                      kPdbExtension);
+  pdb_path->replace(last_dll_extension_pos, kDllExtension.size(),
+                    kPdbExtension);
+  return true;
+}
+
+bool PortablePdbFile::ReadDocumentPathsHelper() {
+  string pdb_path;
+  if (!GetPdbPath(&pdb_path)) {
+    return false;
+  }
 
-  if (!pdb_file_binary_stream_.ConsumeFile(module_name)) {
+  if (!pdb_file_binary_stream_.ConsumeFile(pdb_path)) {
     return false;
   }
 
@@ -110,23 +154,106 @@ bool PortablePdbFile::ParsePdbFile() {
     return false;
   }
 
-  if (!ParseCompressedMetadataTableStream() || !ParsePortablePdbStream()) {
+  if (!ParsePortablePdbStream()) {
     return false;
   }
 
+  // The PDB ID identifies the content of the PDB, so a cached index
+  // of the same PDB can be used instead of parsing the metadata tables.
+  if (symbol_cache_ &&
+      symbol_cache_->Load(pdb_path, pdb_metadata_header_.pdb_id,
+                          &document_indices_)) {
+    loaded_from_cache_ = true;
+    for (size_t i = 0; i < document_indices_.size(); ++i) {
+      document_path_trie_.AddPath(document_indices_[i]->GetFilePath(), i);
+    }
+    return true;
+  }
+
+  if (!ParseCompressedMetadataTableStream()) {
+    return false;
+  }
+
+  // Row i of the document table becomes document index i - 1, so the
+  // trie can be searched before the document indices are built.
+  for (size_t i = 1; i < document_table_.size(); ++i) {
+    string file_path;
+    if (!GetDocumentName(document_table_[i].name, &file_path)) {
+      return false;
+    }
+    document_path_trie_.AddPath(file_path, i - 1);
+  }
+
+  return true;
+}
+
+bool PortablePdbFile::ParsePdbFileHelper() {
+  if (loaded_from_cache_) {
+    IndexMethods();
+    return true;
+  }
+
   if (document_table_.size() > 1) {
+    // Groups methods by document and scopes by method in one pass over
+    // each table instead of scanning the tables for every document.
+    RowBuckets methods_by_document;
+    methods_by_document.Initialize(
+        method_debug_info_table_, document_table_.size(),
+        [](const MethodDebugInformationRow &row) { return row.document; });
+
+    RowBuckets scopes_by_method;
+    scopes_by_method.Initialize(
+        local_scope_table_, method_debug_info_table_.size(),
+        [](const LocalScopeRow &row) { return row.method_def; });
+
     document_indices_.reserve(document_table_.size() - 1);
     for (size_t i = 1; i < document_table_.size(); ++i) {
       unique_ptr<DocumentIndex> document_index(new (std::nothrow)
                                                    DocumentIndex());
-      if (!document_index || !document_index->Initialize(*this, i)) {
+      if (!document_index ||
+          !document_index->Initialize(*this, i, methods_by_document,
+                                      scopes_by_method)) {
         return false;
       }
       document_indices_.push_back(std::move(document_index));
     }
   }
 
-  parsed = true;
+  IndexMethods();
+  string pdb_path;
+  if (symbol_cache_ && GetPdbPath(&pdb_path) &&
+      !symbol_cache_->Save(pdb_path, pdb_metadata_header_.pdb_id,
+                           document_indices_)) {
+    std::cerr << "Failed to save the index of " << pdb_path
+         << " to the symbol cache.";
+  }
+
+  return true;
+}
+
+void PortablePdbFile::IndexMethods() {
+  for (size_t i = 0; i < document_indices_.size(); ++i) {
+    const vector<MethodInfo> &methods = document_indices_[i]->GetMethods();
+    for (size_t j = 0; j < methods.size(); ++j) {
+      method_locations_.emplace(methods[j].method_def, std::make_pair(i, j));
+    }
+  }
+}
+
+bool PortablePdbFile::FindMethod(uint32_t method_def,
+                                 const IDocumentIndex **document_index,
+                                 const MethodInfo **method) const {
+  if (!document_index || !method) {
+    return false;
+  }
+
+  auto location = method_locations_.find(method_def);
+  if (location == method_locations_.end()) {
+    return false;
+  }
+
+  *document_index = document_indices_[location->second.first].get();
+  *method = &(*document_index)->GetMethods()[location->second.second];
   return true;
 }
 
@@ -183,25 +310,17 @@ bool PortablePdbFile::GetDocumentName(uint32_t index, string *doc_name) const {
   for (uint32_t part_index : part_indices) {
     // 0 means empty string.
     if (part_index != 0) {
-      if (!pdb_file_binary_stream_.SeekFromOrigin(blob_heap_header_.offset +
-                                                  part_index)) {
-        return false;
-      }
-
-      uint32_t component_string_length;
-      if (!pdb_file_binary_stream_.ReadCompressedUInt32(
-              &component_string_length)) {
-        return false;
-      }
-
-      uint32_t bytes_read;
-      vector<uint8_t> component_string(component_string_length, 0);
-      if (!pdb_file_binary_stream_.ReadBytes(
-              component_string.data(), component_string_length, &bytes_read)) {
+      // The component is appended straight from the #Blob heap.
+      const uint8_t *component;
+      uint32_t component_length;
+      if (!pdb_file_binary_stream_.GetBlobView(
+              blob_heap_header_.offset + part_index, &component,
+              &component_length)) {
         return false;
       }
 
-      result.append(component_string.begin(), component_string.end());
+      result.append(reinterpret_cast<const char *>(component),
+                    component_length);
     }
 
     result += separator;
@@ -15,16 +15,24 @@
 #ifndef PORTABLE_PDB_H_
 #define PORTABLE_PDB_H_
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "custom_binary_reader.h"
+#include "document_path_trie.h"
 #include "i_portable_pdb_file.h"
 #include "metadata_headers.h"
 
 namespace google_cloud_debugger_portable_pdb {
 
+class SymbolCache;
+
 // PortablePDB file. Wraps all the gory details of PE headers and metadata
 // compression.
 //
@@ -45,10 +53,25 @@ class PortablePdbFile : public IPortablePdbFile {
   HRESULT Initialize(ICorDebugModule *debug_module,
                      google_cloud_debugger::ICorDebugHelper *debug_helper);
 
+  // Sets the cache the document indices of this PDB are loaded from and
+  // saved to. This has to be called before ParsePdbFile.
+  void SetSymbolCache(std::shared_ptr<SymbolCache> symbol_cache) {
+    symbol_cache_ = std::move(symbol_cache);
+  }
+
+  // Reads the file paths of the documents of the pdb file into the
+  // document path trie.
+  bool ReadDocumentPaths();
+
   // Parses the pdb file. The name of the file will come from the
   // ICorDebugModule object that is used to initialize this object.
   bool ParsePdbFile();
 
+  // Returns true if ParsePdbFile has finished.
+  bool ParseAttempted() const {
+    return parse_attempted_.load(std::memory_order_acquire);
+  }
+
   // Finds the stream header with a given name. Returns false if not found.
   // name is the name of the stream header.
   // stream_header is the stream header that has name name.
@@ -108,6 +131,16 @@ class PortablePdbFile : public IPortablePdbFile {
     return document_indices_;
   }
 
+  // Returns the trie of the file paths of the documents.
+  const DocumentPathTrie &GetDocumentPathTrie() const {
+    return document_path_trie_;
+  }
+
+  // Finds the method with MethodDef row method_def and its document.
+  bool FindMethod(std::uint32_t method_def,
+                  const IDocumentIndex **document_index,
+                  const MethodInfo **method) const;
+
   // Gets the name of the module of this PDB.
   const std::string &GetModuleName() const { return module_name_; }
 
@@ -151,13 +184,18 @@ class PortablePdbFile : public IPortablePdbFile {
   std::vector<LocalVariableRow> local_variable_table_;
   std::vector<LocalConstantRow> local_constant_table_;
 
-  // Vectors that contains all the strings in the Strings Heap.
-  // This vector is used to cache the strings.
-  mutable std::vector<std::string> heap_strings_;
-
   // Vector of all document indices inside this pdb.
   std::vector<std::unique_ptr<IDocumentIndex>> document_indices_;
 
+  // Trie of the file paths of document_indices_.
+  DocumentPathTrie document_path_trie_;
+
+  // Map of a MethodDef row to the position of its MethodInfo in
+  // document_indices_, as the index of the document and the index of
+  // the method in that document.
+  std::unordered_map<std::uint32_t, std::pair<std::uint32_t, std::uint32_t>>
+      method_locations_;
+
   // The ICorDebugModule of the module of this PDB.
   google_cloud_debugger::CComPtr<ICorDebugModule> debug_module_;
 
@@ -202,8 +240,49 @@ class PortablePdbFile : public IPortablePdbFile {
   // Parses the compressed metadata tables stream.
   bool ParseCompressedMetadataTableStream();
 
-  // True if ParsePdbFile method is already called.
-  bool parsed = false;
+  // Sets pdb_path to the path of the pdb file of the module. Returns
+  // false if the name of the module does not end with ".dll".
+  bool GetPdbPath(std::string *pdb_path) const;
+
+  // Does the actual reading for ReadDocumentPaths. This reads the headers
+  // and the metadata tables, or loads the document indices from
+  // symbol_cache_, and builds document_path_trie_.
+  bool ReadDocumentPathsHelper();
+
+  // Does the actual parsing for ParsePdbFile after ReadDocumentPaths.
+  // This builds document_indices_ unless they were loaded from
+  // symbol_cache_.
+  bool ParsePdbFileHelper();
+
+  // Builds method_locations_ from document_indices_.
+  void IndexMethods();
+
+  // The cache of document indices. May be null.
+  std::shared_ptr<SymbolCache> symbol_cache_;
+
+  // Makes sure that only one thread reads the document paths.
+  std::mutex paths_mutex_;
+
+  // True once ReadDocumentPathsHelper has returned. document_path_trie_
+  // is published to other threads by the release store to this flag.
+  std::atomic<bool> paths_read_attempted_{false};
+
+  // The result of ReadDocumentPathsHelper. Only valid if
+  // paths_read_attempted_ is true.
+  bool paths_read_succeeded_ = false;
+
+  // True if document_indices_ were loaded from symbol_cache_.
+  bool loaded_from_cache_ = false;
+
+  // Makes sure that only one thread parses the file.
+  std::mutex parse_mutex_;
+
+  // True once ParsePdbFileHelper has returned. The parsed tables are
+  // published to other threads by the release store to this flag.
+  std::atomic<bool> parse_attempted_{false};
+
+  // The result of ParsePdbFileHelper. Only valid if parse_attempted_ is true.
+  bool parse_succeeded_ = false;
 };
 
 }  // namespace google_cloud_debugger_portable_pdb
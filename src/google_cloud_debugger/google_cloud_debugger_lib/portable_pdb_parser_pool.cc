@@ -0,0 +1,113 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "portable_pdb_parser_pool.h"
+
+#include <algorithm>
+
+#include "i_portable_pdb_file.h"
+
+namespace google_cloud_debugger_portable_pdb {
+
+PortablePdbParserPool::PortablePdbParserPool(size_t max_threads)
+    : max_threads_(std::max<size_t>(max_threads, 1)) {}
+
+PortablePdbParserPool::~PortablePdbParserPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    queue_.clear();
+  }
+  work_available_.notify_all();
+
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+void PortablePdbParserPool::Enqueue(
+    std::shared_ptr<IPortablePdbFile> pdb_file) {
+  if (!pdb_file) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      return;
+    }
+
+    queue_.push_back(std::move(pdb_file));
+    // Starts another worker if all the existing ones are busy.
+    if (workers_.size() < max_threads_ &&
+        workers_.size() < queue_.size() + files_in_progress_) {
+      workers_.push_back(
+          std::thread(&PortablePdbParserPool::WorkerLoop, this));
+    }
+  }
+  work_available_.notify_one();
+}
+
+void PortablePdbParserPool::Remove(const IPortablePdbFile *pdb_file) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.erase(std::remove_if(queue_.begin(), queue_.end(),
+                                [pdb_file](
+                                    const std::shared_ptr<IPortablePdbFile>
+                                        &queued_file) {
+                                  return queued_file.get() == pdb_file;
+                                }),
+                 queue_.end());
+  }
+  work_done_.notify_all();
+}
+
+void PortablePdbParserPool::WaitUntilIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  work_done_.wait(lock, [this] {
+    return stopping_ || (queue_.empty() && files_in_progress_ == 0);
+  });
+}
+
+void PortablePdbParserPool::WorkerLoop() {
+  while (true) {
+    std::shared_ptr<IPortablePdbFile> pdb_file;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_available_.wait(lock,
+                           [this] { return stopping_ || !queue_.empty(); });
+      if (stopping_) {
+        return;
+      }
+
+      pdb_file = std::move(queue_.front());
+      queue_.pop_front();
+      ++files_in_progress_;
+    }
+
+    // Failures are not reported here. Whoever needs the file will get
+    // the same result when it calls ParsePdbFile.
+    pdb_file->ParsePdbFile();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --files_in_progress_;
+    }
+    work_done_.notify_all();
+  }
+}
+
+}  // namespace google_cloud_debugger_portable_pdb
@@ -0,0 +1,92 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PORTABLE_PDB_PARSER_POOL_H_
+#define PORTABLE_PDB_PARSER_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace google_cloud_debugger_portable_pdb {
+
+class IPortablePdbFile;
+
+// Pool of worker threads that parse PDB files in the background
+// so that the first breakpoint set or hit after a module is loaded does
+// not have to wait for the PDB to be parsed.
+//
+// Queued PDB files are parsed by calling ParsePdbFile, which only parses
+// a file once. A caller that needs a PDB that is still queued or
+// being parsed can call ParsePdbFile itself: it will either parse the
+// file or wait for the worker that is parsing it.
+class PortablePdbParserPool {
+ public:
+  // Creates a pool with at most max_threads worker threads.
+  // The threads are only started when the first file is queued.
+  explicit PortablePdbParserPool(size_t max_threads = kMaxThreads);
+
+  // Stops the worker threads. Files that are still queued are not parsed.
+  ~PortablePdbParserPool();
+
+  // Queues pdb_file to be parsed by a worker thread.
+  void Enqueue(std::shared_ptr<IPortablePdbFile> pdb_file);
+
+  // Removes pdb_file from the queue if it is not being parsed yet, so
+  // the file of a module that is unloaded is not parsed and can be freed.
+  void Remove(const IPortablePdbFile *pdb_file);
+
+  // Blocks until all the queued files are parsed.
+  void WaitUntilIdle();
+
+  // Default maximum number of worker threads. Parsing is I/O and
+  // memory bound so a couple of threads is enough to keep up with
+  // module loads without taking CPU away from the debuggee.
+  static const size_t kMaxThreads = 2;
+
+ private:
+  // Main loop of a worker thread.
+  void WorkerLoop();
+
+  // Maximum number of worker threads.
+  size_t max_threads_;
+
+  // Worker threads of the pool.
+  std::vector<std::thread> workers_;
+
+  // Files waiting to be parsed.
+  std::deque<std::shared_ptr<IPortablePdbFile>> queue_;
+
+  // Number of files that are being parsed by the workers.
+  size_t files_in_progress_ = 0;
+
+  // True if the workers should exit.
+  bool stopping_ = false;
+
+  // Mutex protecting all the members above.
+  std::mutex mutex_;
+
+  // Signaled when a file is queued or the pool is stopping.
+  std::condition_variable work_available_;
+
+  // Signaled when a worker finishes parsing a file.
+  std::condition_variable work_done_;
+};
+
+}  // namespace google_cloud_debugger_portable_pdb
+
+#endif  //  PORTABLE_PDB_PARSER_POOL_H_
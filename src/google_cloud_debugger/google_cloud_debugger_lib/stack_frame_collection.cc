@@ -23,17 +23,21 @@
 #include "i_cor_debug_helper.h"
 #include "i_dbg_object_factory.h"
 #include "i_eval_coordinator.h"
+#include "string_stream_wrapper.h"
 
 using google::cloud::diagnostics::debug::Breakpoint;
 using google::cloud::diagnostics::debug::SourceLocation;
 using google::cloud::diagnostics::debug::StackFrame;
 using google::cloud::diagnostics::debug::Variable;
+using google_cloud_debugger_portable_pdb::FindSequencePointAtILOffset;
+using google_cloud_debugger_portable_pdb::GetLocalsAtILOffset;
+using google_cloud_debugger_portable_pdb::IDocumentIndex;
 using google_cloud_debugger_portable_pdb::LocalConstantInfo;
 using google_cloud_debugger_portable_pdb::LocalVariableInfo;
+using google_cloud_debugger_portable_pdb::MethodInfo;
 using google_cloud_debugger_portable_pdb::SequencePoint;
 using std::cerr;
 using std::cout;
-using std::max;
 using std::string;
 using std::vector;
 
@@ -101,23 +105,27 @@ HRESULT StackFrameCollection::PopulateStackFrames(
 
   HRESULT hr = S_OK;
 
+  // Serialized size of the breakpoint. This is computed once and then
+  // updated with the size of each frame.
+  std::int64_t breakpoint_size = breakpoint->ByteSizeLong();
+
   // Gives the first frame half available kb in the breakpoint.
-  int frame_max_size =
-      (DbgBreakpoint::kMaximumBreakpointSize - breakpoint->ByteSize()) / 2;
+  std::int64_t frame_max_size =
+      (DbgBreakpoint::kMaximumBreakpointSize - breakpoint_size) / 2;
   int processed_il_frames_so_far = 0;
 
   for (auto &&dbg_stack_frame : stack_frames_) {
     // If this is the last processed IL frame, just gives it the rest
     // of the size available.
     if (processed_il_frames_so_far == number_of_processed_il_frames_ - 1) {
-      frame_max_size =
-          DbgBreakpoint::kMaximumBreakpointSize - breakpoint->ByteSize();
+      frame_max_size = DbgBreakpoint::kMaximumBreakpointSize - breakpoint_size;
     }
 
     StackFrame *frame = breakpoint->add_stack_frames();
     // If dbg_stack_frame is an empty stack frame, just says it's undebuggable.
     if (dbg_stack_frame->IsEmpty()) {
       frame->set_method_name("Undebuggable code.");
+      breakpoint_size += GetSerializedFieldSize(*frame);
       continue;
     }
 
@@ -143,13 +151,15 @@ HRESULT StackFrameCollection::PopulateStackFrames(
       ++processed_il_frames_so_far;
     }
 
-    if (breakpoint->ByteSize() > DbgBreakpoint::kMaximumBreakpointSize) {
+    // The frame is serialized once here instead of the whole breakpoint.
+    breakpoint_size += GetSerializedFieldSize(*frame);
+    if (breakpoint_size > DbgBreakpoint::kMaximumBreakpointSize) {
       break;
     }
 
     // Updates frame_max_size to half of whatever is left.
     frame_max_size =
-        (DbgBreakpoint::kMaximumBreakpointSize - breakpoint->ByteSize()) / 2;
+        (DbgBreakpoint::kMaximumBreakpointSize - breakpoint_size) / 2;
   }
 
   return S_OK;
@@ -159,7 +169,7 @@ HRESULT StackFrameCollection::PopulateAsyncStackFrameInfo(
     DbgStackFrame *async_frame, ICorDebugStackWalk *stack_walk,
     const std::vector<
         std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files) {
+        &pdb_files) {
   HRESULT hr;
   // To get to the stack frame with the actual method information,
   // we have to step through the stack twice.
@@ -180,7 +190,7 @@ HRESULT StackFrameCollection::PopulateAsyncStackFrameInfo(
 
   std::shared_ptr<DbgStackFrame> real_method_stack_frame(
       new DbgStackFrame(debug_helper_, obj_factory_));
-  hr = PopulateDbgStackFrameHelper(parsed_pdb_files, real_method_frame,
+  hr = PopulateDbgStackFrameHelper(pdb_files, real_method_frame,
                                    real_method_stack_frame.get(), false);
   if (FAILED(hr)) {
     cerr << "Failed to get stack frame's information.";
@@ -219,82 +229,35 @@ HRESULT StackFrameCollection::PopulateLocalVarsAndMethodArgs(
     return S_FALSE;
   }
 
-  // Loops through all methods in all the documents of the pdb file to find
-  // a MethodInfo object that corresponds with the method at this breakpoint.
-  for (auto &&document_index : pdb_file->GetDocumentIndexTable()) {
-    for (auto &&method : document_index->GetMethods()) {
-      PCCOR_SIGNATURE current_method_signature = 0;
-      ULONG current_method_virtual_addr = 0;
-      mdTypeDef type_def = 0;
-      ULONG method_name_length = 0;
-      DWORD flags1 = 0;
-      ULONG signature_blob;
-      DWORD flags2 = 0;
-
-      hr = metadata_import->GetMethodProps(
-          method.method_def, &type_def, nullptr, 0, &method_name_length,
-          &flags1, &current_method_signature, &signature_blob,
-          &current_method_virtual_addr, &flags2);
-      if (FAILED(hr)) {
-        cerr << "Failed to extract method info from method "
-             << method.method_def;
-        return hr;
-      }
-
-      // Checks that the virtual address of this method matches the one of the
-      // stack frame.
-      if (current_method_virtual_addr !=
-          dbg_stack_frame->GetFuncVirtualAddr()) {
-        continue;
-      }
-
-      // Sets the file path since we know we are in the correct function.
-      dbg_stack_frame->SetFile(document_index->GetFilePath());
+  // The MethodDebugInformation rows of the PDB line up with the MethodDef
+  // rows of the module, so the method is looked up by the row of the token.
+  const IDocumentIndex *document_index;
+  const MethodInfo *method;
+  if (!pdb_file->FindMethod(RidFromToken(target_function_token),
+                            &document_index, &method)) {
+    return S_OK;
+  }
 
-      long matching_sequence_point_position = -1;
+  // Sets the file path since we know we are in the correct function.
+  dbg_stack_frame->SetFile(document_index->GetFilePath());
 
-      // We find the first non-hidden sequence point that is just larger than
-      // the ip offset.
-      for (long index = 0; index < method.sequence_points.size(); index++) {
-        if (!method.sequence_points[index].is_hidden &&
-            method.sequence_points[index].il_offset <= ip_offset) {
-          matching_sequence_point_position =
-              max(matching_sequence_point_position, index);
-        }
-      }
+  // If we find the matching sequence point, populates the list of local
+  // variables in dbg_stack_frame from the local scopes that contain the
+  // matching sequence point.
+  uint32_t sequence_point_index;
+  if (FindSequencePointAtILOffset(*method, ip_offset, &sequence_point_index)) {
+    const SequencePoint &sequence_point =
+        method->sequence_points[sequence_point_index];
 
-      // If we find the matching sequence point, populates the list of local
-      // variables in dbg_stack_frame from the local variable's vector of the
-      // matching sequence point.
-      if (matching_sequence_point_position != -1) {
-        SequencePoint sequence_point =
-            method.sequence_points[matching_sequence_point_position];
-
-        dbg_stack_frame->SetLineNumber(sequence_point.start_line);
-        vector<LocalVariableInfo> local_variables;
-        vector<LocalConstantInfo> local_constants;
-        for (auto &&local_scope : method.local_scope) {
-          if (local_scope.start_offset > sequence_point.il_offset ||
-              local_scope.start_offset + local_scope.length <
-                  sequence_point.il_offset) {
-            continue;
-          }
-
-          local_variables.insert(local_variables.end(),
-                                 local_scope.local_variables.begin(),
-                                 local_scope.local_variables.end());
-          local_constants.insert(local_constants.end(),
-                                 local_scope.local_constants.begin(),
-                                 local_scope.local_constants.end());
-        }
-
-        hr = dbg_stack_frame->Initialize(il_frame, local_variables,
-                                         local_constants, target_function_token,
-                                         metadata_import);
-      }
+    dbg_stack_frame->SetLineNumber(sequence_point.start_line);
+    vector<LocalVariableInfo> local_variables;
+    vector<LocalConstantInfo> local_constants;
+    GetLocalsAtILOffset(*method, sequence_point.il_offset, &local_variables,
+                        &local_constants);
 
-      return S_OK;
-    }
+    hr = dbg_stack_frame->Initialize(il_frame, local_variables,
+                                     local_constants, target_function_token,
+                                     metadata_import);
   }
 
   return S_OK;
@@ -307,55 +270,23 @@ HRESULT StackFrameCollection::PopulateModuleClassAndFunctionName(
     return E_INVALIDARG;
   }
 
-  HRESULT hr;
+  // Both names are cached by the debug helper, so frames of a method
+  // that was already seen do not read the metadata again.
+  std::string method_name;
   mdTypeDef type_def = 0;
-  ULONG method_name_length = 0;
-  DWORD flags1 = 0;
-  ULONG signature_blob = 0;
   ULONG target_method_virtual_addr = 0;
-  DWORD flags2 = 0;
-  PCCOR_SIGNATURE target_method_signature = 0;
-
-  // Retrieves the length of the name of the method that this stack frame
-  // is at.
-  hr = metadata_import->GetMethodProps(
-      function_token, &type_def, nullptr, 0, &method_name_length, &flags1,
-      &target_method_signature, &signature_blob, &target_method_virtual_addr,
-      &flags2);
-
-  if (FAILED(hr)) {
-    cerr << "Failed to get length of name of method for stack frame.";
-    return hr;
-  }
-
-  std::vector<WCHAR> method_name(method_name_length, 0);
-
-  // Retrieves the name of the method that this stack frame is at.
-  hr = metadata_import->GetMethodProps(
-      function_token, &type_def, method_name.data(), method_name.size(),
-      &method_name_length, &flags1, &target_method_signature, &signature_blob,
-      &target_method_virtual_addr, &flags2);
+  HRESULT hr = debug_helper_->GetMethodNameFromMdMethodDef(
+      function_token, metadata_import, &method_name, &type_def,
+      &target_method_virtual_addr, &cerr);
   if (FAILED(hr)) {
     cerr << "Failed to get name of method for stack frame.";
     return hr;
   }
 
-  // Retrieves the class name.
-  // TODO(quoct): Cache the class name in MethodInfo method.
+  std::string class_name;
   mdToken extends_token;
-  DWORD class_flags;
-  ULONG class_name_length;
-  hr = metadata_import->GetTypeDefProps(
-      type_def, nullptr, 0, &class_name_length, &class_flags, &extends_token);
-  if (FAILED(hr)) {
-    cerr << "Failed to get length of name of class type for stack frame.";
-    return hr;
-  }
-
-  std::vector<WCHAR> class_name(class_name_length, 0);
-  hr = metadata_import->GetTypeDefProps(type_def, class_name.data(),
-                                        class_name.size(), &class_name_length,
-                                        &class_flags, &extends_token);
+  hr = debug_helper_->GetTypeNameFromMdTypeDef(
+      type_def, metadata_import, &class_name, &extends_token, &cerr);
   if (FAILED(hr)) {
     cerr << "Failed to get name of class type for stack frame.";
     return hr;
@@ -375,7 +306,7 @@ HRESULT StackFrameCollection::WalkStackAndProcessStackFrame(
     IEvalCoordinator *eval_coordinator,
     const std::vector<
         std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files) {
+        &pdb_files) {
   if (stack_walked_) {
     return S_OK;
   }
@@ -430,7 +361,7 @@ HRESULT StackFrameCollection::WalkStackAndProcessStackFrame(
 
     std::shared_ptr<DbgStackFrame> stack_frame(
         new DbgStackFrame(debug_helper_, obj_factory_));
-    hr = PopulateDbgStackFrameHelper(parsed_pdb_files, frame, stack_frame.get(),
+    hr = PopulateDbgStackFrameHelper(pdb_files, frame, stack_frame.get(),
                                      process_il_frame);
     if (FAILED(hr)) {
       cerr << "Failed to process stack frame.";
@@ -447,7 +378,7 @@ HRESULT StackFrameCollection::WalkStackAndProcessStackFrame(
     // will populate stack_frame with the correct method name and class token.
     if (stack_frame->IsAsyncMethod()) {
       hr = PopulateAsyncStackFrameInfo(stack_frame.get(), debug_stack_walk,
-                                       parsed_pdb_files);
+                                       pdb_files);
       if (FAILED(hr)) {
         cerr << "Failed to get async stack frame's information.";
         return hr;
@@ -470,8 +401,8 @@ HRESULT StackFrameCollection::EvaluateBreakpointCondition(
     DbgBreakpoint *breakpoint, IEvalCoordinator *eval_coordinator,
     const std::vector<
         std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files) {
-  HRESULT hr = ProcessFirstStack(eval_coordinator, parsed_pdb_files);
+        &pdb_files) {
+  HRESULT hr = ProcessFirstStack(eval_coordinator, pdb_files);
   if (FAILED(hr)) {
     std::cerr << "Failed to process the first stack.";
     return hr;
@@ -491,8 +422,8 @@ HRESULT StackFrameCollection::ProcessExpressions(
     DbgBreakpoint *breakpoint, IEvalCoordinator *eval_coordinator,
     const std::vector<
         std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files) {
-  HRESULT hr = ProcessFirstStack(eval_coordinator, parsed_pdb_files);
+        &pdb_files) {
+  HRESULT hr = ProcessFirstStack(eval_coordinator, pdb_files);
   if (FAILED(hr)) {
     std::cerr << "Failed to process the first stack.";
     return hr;
@@ -512,7 +443,7 @@ HRESULT StackFrameCollection::ProcessFirstStack(
     IEvalCoordinator *eval_coordinator,
     const std::vector<
         std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files) {
+        &pdb_files) {
   if (first_stack_) {
     return S_OK;
   }
@@ -533,7 +464,7 @@ HRESULT StackFrameCollection::ProcessFirstStack(
 
   first_stack_ = std::shared_ptr<DbgStackFrame>(
       new DbgStackFrame(debug_helper_, obj_factory_));
-  hr = PopulateDbgStackFrameHelper(parsed_pdb_files, debug_frame,
+  hr = PopulateDbgStackFrameHelper(pdb_files, debug_frame,
                                    first_stack_.get(), true);
   if (FAILED(hr)) {
     std::cerr << "Failed to process stack frame.";
@@ -554,7 +485,7 @@ HRESULT StackFrameCollection::ProcessFirstStack(
     }
 
     hr = PopulateAsyncStackFrameInfo(first_stack_.get(), debug_stack_walk,
-                                     parsed_pdb_files);
+                                     pdb_files);
     if (FAILED(hr)) {
       cerr << "Failed to get async stack frame's information.";
       first_stack_.reset();
@@ -568,7 +499,7 @@ HRESULT StackFrameCollection::ProcessFirstStack(
 HRESULT StackFrameCollection::PopulateDbgStackFrameHelper(
     const std::vector<
         std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files,
+        &pdb_files,
     ICorDebugFrame *debug_frame, DbgStackFrame *stack_frame,
     bool process_il_frame) {
   // Gets ICorDebugFunction that corresponds to the function at this frame.
@@ -649,14 +580,24 @@ HRESULT StackFrameCollection::PopulateDbgStackFrameHelper(
     return hr;
   }
 
-  for (auto &&pdb_file : parsed_pdb_files) {
+  for (auto &&pdb_file : pdb_files) {
     // TODO(quoct): Possible performance improvement by caching the pdb_file
     // based on token.
+    if (!pdb_file) {
+      continue;
+    }
+
     string pdb_module_name = pdb_file->GetModuleName();
     if (pdb_module_name.compare(target_module_name) != 0) {
       continue;
     }
 
+    // Only the PDBs of the modules on the stack are parsed here, so a hit
+    // does not wait for PDBs that are still parsed in the background.
+    if (!pdb_file->ParsePdbFile()) {
+      return S_FALSE;
+    }
+
     // Tries to populate local variables and method arguments of this frame.
     hr = PopulateLocalVarsAndMethodArgs(target_function_token, stack_frame,
                                         il_frame, metadata_import,
@@ -33,6 +33,9 @@ class StackFrameCollection : public IStackFrameCollection {
   // any expressions in the breakpoint will be evaluated.
   // Afterwards, WalkStackAndProcessStackFrame will be called to
   // populate stack_frames_ vector.
+  // A PDB file in pdb_files is only parsed, or waited on if it is
+  // being parsed in the background, when a frame in its module is
+  // processed.
   HRESULT ProcessBreakpoint(
       const std::vector<
           std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
@@ -62,7 +65,7 @@ class StackFrameCollection : public IStackFrameCollection {
       DbgStackFrame *async_frame, ICorDebugStackWalk *stack_walk,
       const std::vector<
           std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files);
+          &pdb_files);
 
   // Given a PDB file, this function tries to find the metadata of the function
   // with token target_function_token in the PDB file. If found, this function
@@ -84,22 +87,22 @@ class StackFrameCollection : public IStackFrameCollection {
   // into stack_frames_. If the stack is already walked, this function will
   // do nothing.
   // IEvalCoordinator eval_coordinator is used to create the stack walk.
-  // Parsed_pdb_files vector is needed for mapping each stack frame to a file
+  // The pdb_files vector is needed for mapping each stack frame to a file
   // location.
   HRESULT WalkStackAndProcessStackFrame(
       IEvalCoordinator *eval_coordinator,
       const std::vector<
           std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files);
+          &pdb_files);
 
   // Helper function to evaluate the condition stored in DbgBreakpoint
   // breakpoint. IEvalCoordinator is needed to get the active debug thread and
-  // frame. Parsed_pdb_files vector is needed to retrieve local variables names.
+  // frame. The pdb_files vector is needed to retrieve local variables names.
   HRESULT EvaluateBreakpointCondition(
       DbgBreakpoint *breakpoint, IEvalCoordinator *eval_coordinator,
       const std::vector<
           std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files);
+          &pdb_files);
 
   // Given a breakpoint, evaluates the expressions in the breakpoint using
   // the first stack of this stack frame collection.
@@ -107,7 +110,7 @@ class StackFrameCollection : public IStackFrameCollection {
       DbgBreakpoint *breakpoint, IEvalCoordinator *eval_coordinator,
       const std::vector<
           std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files);
+          &pdb_files);
 
   // Processes information in the first stack of this stack frame collection
   // and caches the result in first_stack_.
@@ -115,7 +118,7 @@ class StackFrameCollection : public IStackFrameCollection {
       IEvalCoordinator *eval_coordinator,
       const std::vector<
           std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files);
+          &pdb_files);
 
   // Helper function to process information in ICorDebugFrame debug_frame
   // and initialize DbgStackFrame stack_frame with that information.
@@ -125,7 +128,7 @@ class StackFrameCollection : public IStackFrameCollection {
   HRESULT PopulateDbgStackFrameHelper(
       const std::vector<
           std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files,
+          &pdb_files,
       ICorDebugFrame *debug_frame, DbgStackFrame *stack_frame,
       bool process_il_frame);
 
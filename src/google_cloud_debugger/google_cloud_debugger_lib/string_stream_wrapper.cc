@@ -14,12 +14,14 @@
 
 #include "string_stream_wrapper.h"
 
+#include <google/protobuf/io/coded_stream.h>
 #include <string>
 
 #include "breakpoint.pb.h"
 
 using google::cloud::diagnostics::debug::Status;
 using google::cloud::diagnostics::debug::Variable;
+using google::protobuf::io::CodedOutputStream;
 using std::string;
 using std::vector;
 
@@ -34,6 +36,15 @@ void SetErrorStatusMessage(Variable *variable, const std::string &err_string) {
   variable->set_allocated_status(status.release());
 }
 
+void SetStatusMessage(Variable *variable, const std::string &message) {
+  assert(variable != nullptr);
+
+  std::unique_ptr<Status> status(new (std::nothrow) Status());
+  status->set_message(message);
+  status->set_iserror(false);
+  variable->set_allocated_status(status.release());
+}
+
 void SetErrorStatusMessage(Variable *variable,
     StringStreamWrapper *string_stream) {
   assert(string_stream != nullptr);
@@ -53,6 +64,12 @@ void SetErrorStatusMessage(
   breakpoint->set_allocated_status(status.release());
 }
 
+std::int64_t GetSerializedFieldSize(
+    const google::protobuf::MessageLite &message) {
+  size_t size = message.ByteSizeLong();
+  return 1 + CodedOutputStream::VarintSize64(size) + size;
+}
+
 vector<WCHAR> ConvertStringToWCharPtr(const std::string &target_string) {
   if (target_string.size() == 0) {
     return vector<WCHAR>();
@@ -15,9 +15,13 @@
 #ifndef STRING_STREAM_WRAPPER_H_
 #define STRING_STREAM_WRAPPER_H_
 
+#include <cstdint>
 #include <memory>
+#include <ostream>
 #include <sstream>
+#include <streambuf>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "breakpoint.pb.h"
@@ -25,47 +29,88 @@
 
 namespace google_cloud_debugger {
 
+// Stream buffer that collects the characters written to it in a string.
+// Unlike std::stringbuf, it does not allocate anything until characters
+// are written to it.
+class ErrorStreamBuffer : public std::streambuf {
+ public:
+  // Returns the characters written so far.
+  const std::string &str() const { return buffer_; }
+
+  // Removes the characters written so far.
+  void Clear() { buffer_.clear(); }
+
+ protected:
+  int_type overflow(int_type c) override {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      buffer_.push_back(traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize count) override {
+    buffer_.append(s, count);
+    return count;
+  }
+
+ private:
+  // The characters written so far.
+  std::string buffer_;
+};
+
 // This class is meant to be inherited and used for outputting error and
-// output stream to the underlying ostringstream. It has methods to set the
-// underlying streams as well as collecting the output and error stream.
+// output stream to the underlying error stream. It has methods to write
+// to the stream as well as collecting what was written.
+// Most objects never write an error, so the stream does not allocate
+// any memory until an error is written.
 // This class is NOT thread-safe.
 class StringStreamWrapper {
  public:
-  // Sets error_stream_ to error_stream and returns the old error stream.
-  std::ostringstream *SetErrorStream(std::ostringstream *error_stream) {
-    std::ostringstream *old_stream = error_stream_.release();
-    error_stream_.reset(error_stream);
-    return old_stream;
+  StringStreamWrapper() : error_stream_(&error_buffer_) {}
+
+  StringStreamWrapper(StringStreamWrapper &&other)
+      : error_buffer_(std::move(other.error_buffer_)),
+        error_stream_(&error_buffer_) {}
+
+  StringStreamWrapper &operator=(StringStreamWrapper &&other) {
+    error_buffer_ = std::move(other.error_buffer_);
+    error_stream_.clear();
+    return *this;
   }
 
   // Writes the string error to the error_stream_.
   void WriteError(const std::string &error) {
-    *error_stream_ << error << std::endl;
+    error_stream_ << error << std::endl;
   }
 
   // Gets the underlying error stream.
-  std::ostringstream *GetErrorStream() { return error_stream_.get(); }
+  std::ostream *GetErrorStream() { return &error_stream_; }
 
   // Gets string collected in the error stream.
-  std::string GetErrorString() { return error_stream_->str(); }
+  std::string GetErrorString() { return error_buffer_.str(); }
 
   // Resets the error stream.
   void ResetErrorStream() {
-    error_stream_->str("");
-    error_stream_->clear();
+    error_buffer_.Clear();
+    error_stream_.clear();
   }
 
  private:
-  // The underlying error stream.
-  std::unique_ptr<std::ostringstream> error_stream_ =
-      std::unique_ptr<std::ostringstream>(new (std::nothrow)
-                                              std::ostringstream());
+  // Holds the characters written to error_stream_.
+  ErrorStreamBuffer error_buffer_;
+
+  // The underlying error stream. This writes to error_buffer_.
+  std::ostream error_stream_;
 };
 
 // Sets the Status field of variable using error string err_string.
 void SetErrorStatusMessage(google::cloud::diagnostics::debug::Variable *var,
                            const std::string &err_string);
 
+// Sets the Status field of variable to message, which is not an error.
+void SetStatusMessage(google::cloud::diagnostics::debug::Variable *var,
+                      const std::string &message);
+
 // Sets the Status field of variable using error string from string_stream
 // object. This will reset the error stream of string_stream afterwards.
 void SetErrorStatusMessage(google::cloud::diagnostics::debug::Variable *var,
@@ -76,6 +121,12 @@ void SetErrorStatusMessage(
     google::cloud::diagnostics::debug::Breakpoint *breakpoint,
     const std::string &err_string);
 
+// Returns the number of bytes message takes when it is serialized as a
+// field of another message, including the tag and the length prefix.
+// The number of the field must be less than 16.
+std::int64_t GetSerializedFieldSize(
+    const google::protobuf::MessageLite &message);
+
 // Helper function to convert a string to null-terminated WCHAR vector.
 // If target_string is empty or if there are failures,
 // this function returns an empty vector.
@@ -0,0 +1,407 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "symbol_cache.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#ifdef PLATFORM_UNIX
+#include <unistd.h>
+#elif _WIN32
+#include <process.h>
+#endif
+
+#include "custom_binary_reader.h"
+#include "document_index.h"
+
+using std::array;
+using std::cerr;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace google_cloud_debugger_portable_pdb {
+
+namespace {
+
+// Marks the start of a cache file ("GCSI" in little endian).
+const std::uint32_t kCacheMagic = 0x49534347;
+
+// Version of the cache file format. This has to be increased whenever
+// the format or the content of the indices changes.
+const std::uint32_t kCacheVersion = 1;
+
+// Extension of the cache files.
+const char kCacheFileExtension[] = ".symidx";
+
+// Gets the size and the modification time of file. Returns false if
+// the file does not exist.
+bool GetFileStamp(const string &file, std::uint64_t *size,
+                  std::int64_t *modified_time) {
+#ifdef PLATFORM_UNIX
+  struct stat file_stat;
+  if (stat(file.c_str(), &file_stat) != 0) {
+    return false;
+  }
+#elif _WIN32
+  struct _stat64 file_stat;
+  if (_stat64(file.c_str(), &file_stat) != 0) {
+    return false;
+  }
+#endif
+
+  *size = file_stat.st_size;
+  *modified_time = file_stat.st_mtime;
+  return true;
+}
+
+// Returns the ID of the current process.
+std::uint32_t GetProcessId() {
+#ifdef PLATFORM_UNIX
+  return getpid();
+#elif _WIN32
+  return _getpid();
+#endif
+}
+
+// Appends value to buffer in the byte order of this machine.
+// Cache files are only read on the machine that wrote them.
+template <typename T>
+void AppendValue(T value, string *buffer) {
+  buffer->append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// Appends the length of value followed by its bytes to buffer.
+void AppendString(const string &value, string *buffer) {
+  AppendValue<std::uint32_t>(value.size(), buffer);
+  buffer->append(value);
+}
+
+// Appends the length of value followed by its bytes to buffer.
+void AppendBytes(const vector<std::uint8_t> &value, string *buffer) {
+  AppendValue<std::uint32_t>(value.size(), buffer);
+  buffer->append(value.begin(), value.end());
+}
+
+// Appends method and all its sequence points and scopes to buffer.
+void AppendMethod(const MethodInfo &method, string *buffer) {
+  AppendValue(method.method_def, buffer);
+  AppendValue(method.first_line, buffer);
+  AppendValue(method.last_line, buffer);
+
+  AppendValue<std::uint32_t>(method.sequence_points.size(), buffer);
+  for (const SequencePoint &sequence_point : method.sequence_points) {
+    AppendValue(sequence_point.il_offset, buffer);
+    AppendValue(sequence_point.start_line, buffer);
+    AppendValue(sequence_point.start_col, buffer);
+    AppendValue(sequence_point.end_line, buffer);
+    AppendValue(sequence_point.end_col, buffer);
+    AppendValue<std::uint8_t>(sequence_point.is_hidden, buffer);
+  }
+
+  AppendValue<std::uint32_t>(method.local_scope.size(), buffer);
+  for (const Scope &scope : method.local_scope) {
+    AppendValue(scope.index, buffer);
+    AppendValue(scope.local_var_row_start_index, buffer);
+    AppendValue(scope.local_var_row_end_index, buffer);
+    AppendValue(scope.local_const_row_start_index, buffer);
+    AppendValue(scope.local_const_row_end_index, buffer);
+    AppendValue(scope.start_offset, buffer);
+    AppendValue(scope.length, buffer);
+
+    AppendValue<std::uint32_t>(scope.local_variables.size(), buffer);
+    for (const LocalVariableInfo &variable : scope.local_variables) {
+      AppendValue(variable.slot, buffer);
+      AppendString(variable.name, buffer);
+      AppendValue<std::uint8_t>(variable.debugger_hidden, buffer);
+    }
+
+    AppendValue<std::uint32_t>(scope.local_constants.size(), buffer);
+    for (const LocalConstantInfo &constant : scope.local_constants) {
+      AppendString(constant.name, buffer);
+      AppendBytes(constant.signature_data, buffer);
+    }
+  }
+}
+
+// Reads a value written by AppendValue from stream.
+template <typename T>
+bool ReadValue(CustomBinaryStream *stream, T *value) {
+  std::uint32_t bytes_read;
+  return stream->ReadBytes(reinterpret_cast<std::uint8_t *>(value),
+                           sizeof(T), &bytes_read);
+}
+
+// Reads a bool written by AppendValue from stream.
+bool ReadBool(CustomBinaryStream *stream, bool *value) {
+  std::uint8_t byte;
+  if (!stream->ReadByte(&byte)) {
+    return false;
+  }
+
+  *value = byte != 0;
+  return true;
+}
+
+// Reads a string written by AppendString from stream.
+bool ReadString(CustomBinaryStream *stream, string *value) {
+  std::uint32_t length;
+  if (!ReadValue(stream, &length)) {
+    return false;
+  }
+
+  value->resize(length);
+  std::uint32_t bytes_read;
+  return length == 0 ||
+         stream->ReadBytes(reinterpret_cast<std::uint8_t *>(&(*value)[0]),
+                           length, &bytes_read);
+}
+
+// Reads bytes written by AppendBytes from stream.
+bool ReadBytes(CustomBinaryStream *stream, vector<std::uint8_t> *value) {
+  std::uint32_t length;
+  if (!ReadValue(stream, &length)) {
+    return false;
+  }
+
+  value->resize(length);
+  std::uint32_t bytes_read;
+  return length == 0 || stream->ReadBytes(value->data(), length, &bytes_read);
+}
+
+// Reads the number of items that follow in stream. Every item takes at
+// least one byte, so counts larger than the rest of the stream mean the
+// file is corrupted and are rejected before anything is allocated.
+bool ReadCount(CustomBinaryStream *stream, std::uint32_t *count) {
+  return ReadValue(stream, count) && *count <= stream->GetRemainingSize();
+}
+
+// Reads a method written by AppendMethod from stream.
+bool ReadMethod(CustomBinaryStream *stream, MethodInfo *method) {
+  std::uint32_t count;
+  if (!ReadValue(stream, &method->method_def) ||
+      !ReadValue(stream, &method->first_line) ||
+      !ReadValue(stream, &method->last_line) || !ReadCount(stream, &count)) {
+    return false;
+  }
+
+  method->sequence_points.resize(count);
+  for (SequencePoint &sequence_point : method->sequence_points) {
+    if (!ReadValue(stream, &sequence_point.il_offset) ||
+        !ReadValue(stream, &sequence_point.start_line) ||
+        !ReadValue(stream, &sequence_point.start_col) ||
+        !ReadValue(stream, &sequence_point.end_line) ||
+        !ReadValue(stream, &sequence_point.end_col) ||
+        !ReadBool(stream, &sequence_point.is_hidden)) {
+      return false;
+    }
+  }
+
+  if (!ReadCount(stream, &count)) {
+    return false;
+  }
+
+  method->local_scope.resize(count);
+  for (Scope &scope : method->local_scope) {
+    if (!ReadValue(stream, &scope.index) ||
+        !ReadValue(stream, &scope.local_var_row_start_index) ||
+        !ReadValue(stream, &scope.local_var_row_end_index) ||
+        !ReadValue(stream, &scope.local_const_row_start_index) ||
+        !ReadValue(stream, &scope.local_const_row_end_index) ||
+        !ReadValue(stream, &scope.start_offset) ||
+        !ReadValue(stream, &scope.length) || !ReadCount(stream, &count)) {
+      return false;
+    }
+
+    scope.local_variables.resize(count);
+    for (LocalVariableInfo &variable : scope.local_variables) {
+      if (!ReadValue(stream, &variable.slot) ||
+          !ReadString(stream, &variable.name) ||
+          !ReadBool(stream, &variable.debugger_hidden)) {
+        return false;
+      }
+    }
+
+    if (!ReadCount(stream, &count)) {
+      return false;
+    }
+
+    scope.local_constants.resize(count);
+    for (LocalConstantInfo &constant : scope.local_constants) {
+      if (!ReadString(stream, &constant.name) ||
+          !ReadBytes(stream, &constant.signature_data)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+}  // namespace
+
+bool SymbolCache::Load(const string &pdb_path,
+                       const array<std::uint8_t, 20> &pdb_id,
+                       vector<unique_ptr<IDocumentIndex>> *document_indices)
+    const {
+  if (!document_indices) {
+    return false;
+  }
+
+  std::uint64_t pdb_size;
+  std::int64_t pdb_modified_time;
+  if (!GetFileStamp(pdb_path, &pdb_size, &pdb_modified_time)) {
+    return false;
+  }
+
+  string cache_file = GetCacheFilePath(pdb_id);
+  CustomBinaryStream stream;
+  if (!stream.ConsumeFile(cache_file)) {
+    return false;
+  }
+
+  std::uint32_t magic;
+  std::uint32_t version;
+  array<std::uint8_t, 20> cached_pdb_id;
+  std::uint64_t cached_pdb_size;
+  std::int64_t cached_pdb_modified_time;
+  std::uint32_t num_documents;
+  std::uint32_t bytes_read;
+  if (!ReadValue(&stream, &magic) || magic != kCacheMagic ||
+      !ReadValue(&stream, &version) || version != kCacheVersion ||
+      !stream.ReadBytes(cached_pdb_id.data(), cached_pdb_id.size(),
+                        &bytes_read) ||
+      cached_pdb_id != pdb_id || !ReadValue(&stream, &cached_pdb_size) ||
+      cached_pdb_size != pdb_size ||
+      !ReadValue(&stream, &cached_pdb_modified_time) ||
+      cached_pdb_modified_time != pdb_modified_time ||
+      !ReadCount(&stream, &num_documents)) {
+    return false;
+  }
+
+  vector<unique_ptr<IDocumentIndex>> loaded_indices;
+  loaded_indices.reserve(num_documents);
+  for (std::uint32_t i = 0; i < num_documents; ++i) {
+    string file_path;
+    std::uint32_t num_methods;
+    if (!ReadString(&stream, &file_path) ||
+        !ReadCount(&stream, &num_methods)) {
+      cerr << "Symbol cache file " << cache_file << " is corrupted.";
+      return false;
+    }
+
+    vector<MethodInfo> methods(num_methods);
+    for (MethodInfo &method : methods) {
+      if (!ReadMethod(&stream, &method)) {
+        cerr << "Symbol cache file " << cache_file << " is corrupted.";
+        return false;
+      }
+    }
+
+    unique_ptr<DocumentIndex> document_index(new (std::nothrow)
+                                                 DocumentIndex());
+    if (!document_index) {
+      return false;
+    }
+    document_index->Initialize(std::move(file_path), std::move(methods));
+    loaded_indices.push_back(std::move(document_index));
+  }
+
+  *document_indices = std::move(loaded_indices);
+  return true;
+}
+
+bool SymbolCache::Save(
+    const string &pdb_path, const array<std::uint8_t, 20> &pdb_id,
+    const vector<unique_ptr<IDocumentIndex>> &document_indices) const {
+  std::uint64_t pdb_size;
+  std::int64_t pdb_modified_time;
+  if (!GetFileStamp(pdb_path, &pdb_size, &pdb_modified_time)) {
+    return false;
+  }
+
+  string buffer;
+  AppendValue(kCacheMagic, &buffer);
+  AppendValue(kCacheVersion, &buffer);
+  buffer.append(pdb_id.begin(), pdb_id.end());
+  AppendValue(pdb_size, &buffer);
+  AppendValue(pdb_modified_time, &buffer);
+  AppendValue<std::uint32_t>(document_indices.size(), &buffer);
+  for (const auto &document_index : document_indices) {
+    AppendString(document_index->GetFilePath(), &buffer);
+    const vector<MethodInfo> &methods = document_index->GetMethods();
+    AppendValue<std::uint32_t>(methods.size(), &buffer);
+    for (const MethodInfo &method : methods) {
+      AppendMethod(method, &buffer);
+    }
+  }
+
+  // Writes to a file only this thread uses and then renames it, so readers
+  // never see a partially written cache file.
+  string cache_file = GetCacheFilePath(pdb_id);
+  string temp_file =
+      cache_file + "." + std::to_string(GetProcessId()) + "." +
+      std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  {
+    std::ofstream output(temp_file, std::ios::binary | std::ios::trunc);
+    if (!output.write(buffer.data(), buffer.size())) {
+      cerr << "Failed to write symbol cache file " << temp_file;
+      std::remove(temp_file.c_str());
+      return false;
+    }
+  }
+
+#ifdef _WIN32
+  // On Windows, rename fails if another debugger already saved the file.
+  std::remove(cache_file.c_str());
+#endif
+  if (std::rename(temp_file.c_str(), cache_file.c_str()) != 0) {
+    std::remove(temp_file.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+string SymbolCache::GetCacheFilePath(const array<std::uint8_t, 20> &pdb_id)
+    const {
+  static const char kHexDigits[] = "0123456789abcdef";
+  string file_name;
+  file_name.reserve(pdb_id.size() * 2 + sizeof(kCacheFileExtension));
+  for (std::uint8_t byte : pdb_id) {
+    file_name.push_back(kHexDigits[byte >> 4]);
+    file_name.push_back(kHexDigits[byte & 0xf]);
+  }
+  file_name += kCacheFileExtension;
+
+  if (cache_directory_.empty()) {
+    return file_name;
+  }
+
+  char last = cache_directory_.back();
+  if (last == '/' || last == '\\') {
+    return cache_directory_ + file_name;
+  }
+  return cache_directory_ + "/" + file_name;
+}
+
+}  // namespace google_cloud_debugger_portable_pdb
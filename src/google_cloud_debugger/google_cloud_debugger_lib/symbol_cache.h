@@ -0,0 +1,73 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SYMBOL_CACHE_H_
+#define SYMBOL_CACHE_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google_cloud_debugger_portable_pdb {
+
+class IDocumentIndex;
+
+// On-disk cache of the document indices of portable PDB files, so a
+// debugger that attaches to a new instance of the same application
+// does not have to parse and index the same PDBs again.
+//
+// Each PDB is cached in its own file in the cache directory, named after
+// the PDB ID (the hash of the debugging metadata stored in the #Pdb
+// stream). The size and modification time of the PDB are stored in the
+// cache file as well and a cache file is only used if they still match.
+//
+// Cache files are written to a temporary file first and then renamed,
+// so several debuggers can share a cache directory. A SymbolCache object
+// is immutable and can be used from multiple threads.
+class SymbolCache {
+ public:
+  // The cache files are stored in the existing directory cache_directory.
+  explicit SymbolCache(const std::string &cache_directory)
+      : cache_directory_(cache_directory) {}
+
+  // Loads the document indices of the PDB file pdb_path, whose PDB ID
+  // is pdb_id, into document_indices. Returns false if the PDB is not
+  // cached, the cache file is stale or the cache file cannot be read.
+  bool Load(const std::string &pdb_path,
+            const std::array<std::uint8_t, 20> &pdb_id,
+            std::vector<std::unique_ptr<IDocumentIndex>> *document_indices)
+      const;
+
+  // Saves document_indices of the PDB file pdb_path, whose PDB ID is
+  // pdb_id, to the cache. Returns false if the cache file cannot be
+  // written.
+  bool Save(const std::string &pdb_path,
+            const std::array<std::uint8_t, 20> &pdb_id,
+            const std::vector<std::unique_ptr<IDocumentIndex>>
+                &document_indices) const;
+
+ private:
+  // Returns the path of the cache file of the PDB with ID pdb_id.
+  std::string GetCacheFilePath(
+      const std::array<std::uint8_t, 20> &pdb_id) const;
+
+  // The directory the cache files are stored in.
+  std::string cache_directory_;
+};
+
+}  // namespace google_cloud_debugger_portable_pdb
+
+#endif  // SYMBOL_CACHE_H_
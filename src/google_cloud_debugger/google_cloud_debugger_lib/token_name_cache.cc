@@ -0,0 +1,120 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "token_name_cache.h"
+
+using std::lock_guard;
+using std::make_pair;
+using std::mutex;
+
+namespace google_cloud_debugger {
+
+void TokenNameCache::AddMetaDataImport(IMetaDataImport *metadata_import) {
+  lock_guard<mutex> lock(mutex_);
+  metadata_imports_[metadata_import] = metadata_import;
+}
+
+bool TokenNameCache::Find(IMetaDataImport *metadata_import, mdToken token,
+                          TokenInfo *token_info) {
+  {
+    lock_guard<mutex> lock(mutex_);
+    auto cached = token_infos_.find(make_pair(metadata_import, token));
+    if (cached != token_infos_.end()) {
+      *token_info = cached->second;
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void TokenNameCache::Add(IMetaDataImport *metadata_import, mdToken token,
+                         const TokenInfo &token_info) {
+  lock_guard<mutex> lock(mutex_);
+  if (metadata_imports_.find(metadata_import) == metadata_imports_.end()) {
+    return;
+  }
+
+  token_infos_[make_pair(metadata_import, token)] = token_info;
+}
+
+bool TokenNameCache::FindResolvedTypeRef(
+    IMetaDataImport *metadata_import, mdTypeRef type_ref, mdTypeDef *type_def,
+    IMetaDataImport **type_def_metadata_import) {
+  {
+    lock_guard<mutex> lock(mutex_);
+    auto cached =
+        resolved_type_refs_.find(make_pair(metadata_import, type_ref));
+    if (cached != resolved_type_refs_.end()) {
+      // The reference is added before the lock is released, as the
+      // module may be removed right after.
+      *type_def_metadata_import = cached->second.first;
+      (*type_def_metadata_import)->AddRef();
+      *type_def = cached->second.second;
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void TokenNameCache::AddResolvedTypeRef(
+    IMetaDataImport *metadata_import, mdTypeRef type_ref, mdTypeDef type_def,
+    IMetaDataImport *type_def_metadata_import) {
+  lock_guard<mutex> lock(mutex_);
+  if (metadata_imports_.find(metadata_import) == metadata_imports_.end() ||
+      metadata_imports_.find(type_def_metadata_import) ==
+          metadata_imports_.end()) {
+    return;
+  }
+
+  resolved_type_refs_[make_pair(metadata_import, type_ref)] =
+      make_pair(type_def_metadata_import, type_def);
+}
+
+void TokenNameCache::RemoveMetaDataImport(IMetaDataImport *metadata_import) {
+  lock_guard<mutex> lock(mutex_);
+  TokenKey first_key = make_pair(metadata_import, mdToken(0));
+  auto last = token_infos_.lower_bound(first_key);
+  auto first = last;
+  while (last != token_infos_.end() && last->first.first == metadata_import) {
+    ++last;
+  }
+  token_infos_.erase(first, last);
+
+  for (auto type_ref = resolved_type_refs_.begin();
+       type_ref != resolved_type_refs_.end();) {
+    if (type_ref->first.first == metadata_import ||
+        type_ref->second.first == metadata_import) {
+      type_ref = resolved_type_refs_.erase(type_ref);
+    } else {
+      ++type_ref;
+    }
+  }
+
+  metadata_imports_.erase(metadata_import);
+}
+
+void TokenNameCache::Clear() {
+  lock_guard<mutex> lock(mutex_);
+  token_infos_.clear();
+  resolved_type_refs_.clear();
+  metadata_imports_.clear();
+}
+
+}  // namespace google_cloud_debugger
@@ -0,0 +1,123 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TOKEN_NAME_CACHE_H_
+#define TOKEN_NAME_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "ccomptr.h"
+#include "cor.h"
+
+namespace google_cloud_debugger {
+
+// What the metadata of a module says about a token.
+struct TokenInfo {
+  // Name of the token.
+  std::string name;
+
+  // For a TypeDef, the token of the type it extends. For a MethodDef,
+  // the TypeDef of its class.
+  mdToken parent_token = 0;
+
+  // For a MethodDef, the relative virtual address of its code.
+  ULONG code_rva = 0;
+};
+
+// Cache of the names of metadata tokens, keyed by the IMetaDataImport of
+// the module and the token. Only the tokens of modules added with
+// AddMetaDataImport are cached. The cache holds a reference to their
+// IMetaDataImports until RemoveMetaDataImport is called when they are
+// unloaded, so the address of a cached IMetaDataImport cannot be reused
+// by another module while its names are cached. The metadata of a module
+// cannot change while it is loaded. This class is thread-safe.
+class TokenNameCache {
+ public:
+  // Starts caching the tokens of metadata_import and adds a reference
+  // to it.
+  void AddMetaDataImport(IMetaDataImport *metadata_import);
+
+  // Looks up token of metadata_import and stores it in token_info.
+  // Returns false if it is not cached. Counts a hit or a miss.
+  bool Find(IMetaDataImport *metadata_import, mdToken token,
+            TokenInfo *token_info);
+
+  // Caches token_info for token of metadata_import, if metadata_import
+  // was added.
+  void Add(IMetaDataImport *metadata_import, mdToken token,
+           const TokenInfo &token_info);
+
+  // Looks up the TypeDef that type_ref of metadata_import resolves to.
+  // Stores the TypeDef and the IMetaDataImport of its module, with a
+  // reference added. Returns false if it is not cached. Counts a hit
+  // or a miss.
+  bool FindResolvedTypeRef(IMetaDataImport *metadata_import,
+                           mdTypeRef type_ref, mdTypeDef *type_def,
+                           IMetaDataImport **type_def_metadata_import);
+
+  // Caches that type_ref of metadata_import resolves to type_def of
+  // type_def_metadata_import, if both were added.
+  void AddResolvedTypeRef(IMetaDataImport *metadata_import,
+                          mdTypeRef type_ref, mdTypeDef type_def,
+                          IMetaDataImport *type_def_metadata_import);
+
+  // Removes all the entries of metadata_import, including the TypeRefs
+  // of other modules that resolve to it, and releases it.
+  void RemoveMetaDataImport(IMetaDataImport *metadata_import);
+
+  // Removes all the entries and releases all the IMetaDataImports.
+  void Clear();
+
+  // Returns the number of lookups that were found in the cache.
+  std::uint64_t GetHits() const {
+    return hits_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the number of lookups that were not found in the cache.
+  std::uint64_t GetMisses() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // A token of a module.
+  typedef std::pair<IMetaDataImport *, mdToken> TokenKey;
+
+  // Map of a token to its name. The map is ordered so that the tokens
+  // of a module are adjacent.
+  std::map<TokenKey, TokenInfo> token_infos_;
+
+  // Map of a TypeRef to the TypeDef it resolves to.
+  std::map<TokenKey, TokenKey> resolved_type_refs_;
+
+  // The IMetaDataImports whose tokens are cached.
+  std::map<IMetaDataImport *, CComPtr<IMetaDataImport>> metadata_imports_;
+
+  // Protects token_infos_, resolved_type_refs_ and metadata_imports_.
+  std::mutex mutex_;
+
+  // Number of lookups that were found.
+  std::atomic<std::uint64_t> hits_{0};
+
+  // Number of lookups that were not found.
+  std::atomic<std::uint64_t> misses_{0};
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  TOKEN_NAME_CACHE_H_
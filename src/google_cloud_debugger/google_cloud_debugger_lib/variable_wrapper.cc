@@ -16,6 +16,7 @@
 
 #include <iostream>
 #include <queue>
+#include <unordered_map>
 #include <vector>
 
 #include "string_stream_wrapper.h"
@@ -30,9 +31,65 @@ using std::vector;
 
 namespace google_cloud_debugger {
 
+namespace {
+
+// Returns true if object is a reference object that can be reached
+// through several variables. Value types are not included since a value
+// type can have the same address as its first field.
+bool IsSharedObject(const DbgObject &object) {
+  if (object.GetAddress() == 0) {
+    return false;
+  }
+
+  switch (object.GetCorElementType()) {
+    case CorElementType::ELEMENT_TYPE_CLASS:
+    case CorElementType::ELEMENT_TYPE_OBJECT:
+    case CorElementType::ELEMENT_TYPE_ARRAY:
+    case CorElementType::ELEMENT_TYPE_SZARRAY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the path of variable, for example "request.Headers[0]",
+// using parents to find the variable each member belongs to.
+string GetVariablePath(
+    const Variable *variable,
+    const std::unordered_map<const Variable *, const Variable *> &parents) {
+  vector<const Variable *> path;
+  while (variable) {
+    path.push_back(variable);
+    auto parent = parents.find(variable);
+    variable = parent == parents.end() ? nullptr : parent->second;
+  }
+
+  string result;
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    const string &name = (*it)->name();
+    if (!result.empty() && !name.empty() && name[0] != '[') {
+      result += '.';
+    }
+    result += name;
+  }
+  return result;
+}
+
+// An object that PerformBFS expanded.
+struct ExpandedObject {
+  // The object, kept to read its address again.
+  std::shared_ptr<DbgObject> object;
+
+  // The variable the object was first expanded as.
+  const Variable *variable = nullptr;
+};
+
+}  // namespace
+
 HRESULT VariableWrapper::PerformBFS(queue<VariableWrapper>* bfs_queue,
                                     const function<bool()> &terminate_condition,
-                                    IEvalCoordinator *eval_coordinator) {
+                                    IEvalCoordinator *eval_coordinator,
+                                    std::int64_t *size) {
   if (!bfs_queue) {
     return E_INVALIDARG;
   }
@@ -44,16 +101,40 @@ HRESULT VariableWrapper::PerformBFS(queue<VariableWrapper>* bfs_queue,
   //  3. If the BFS level of X is kDefaultObjectEvalDepth,
   // sets an error status on X saying that we cannot evaluate
   // its children and continue with the loop.
-  //  4. Otherwise, try to get members (children) of X.
-  //  5. If there are members, push them into the queue. We
+  //  4. If X is an object that was already expanded through another
+  // variable, sets a status on X that refers to the first variable and
+  // continue with the loop.
+  //  5. Otherwise, try to get members (children) of X.
+  //  6. If there are members, push them into the queue. We
   // also set the BFS level of the members to be the BFS
   // level of the node X + 1. If not, call PopulateValue on X.
-  while (!bfs_queue->empty()) {
-    if (terminate_condition()) {
+  //
+  // Maps the address each expanded object had when it was expanded to
+  // the object.
+  std::unordered_map<CORDB_ADDRESS, ExpandedObject> expanded_objects;
+  // Maps each member that was pushed into the queue to the variable it
+  // is a member of. Only used to name the first variable of an object.
+  std::unordered_map<const Variable *, const Variable *> parents;
+  // The variable that was populated last and its size before that. Its
+  // members only contain their names, so computing its size is cheap.
+  const Variable *last_variable = nullptr;
+  std::int64_t last_variable_size = 0;
+  while (true) {
+    if (size && last_variable) {
+      *size += GetSerializedFieldSize(*last_variable) - last_variable_size;
+      last_variable = nullptr;
+    }
+
+    if (bfs_queue->empty() || terminate_condition()) {
       return S_OK;
     }
 
     VariableWrapper current_variable = bfs_queue->front();
+    if (size && current_variable.variable_proto_) {
+      last_variable = current_variable.variable_proto_;
+      last_variable_size = GetSerializedFieldSize(*last_variable);
+    }
+
     // Populates the type of the variable into the variable proto.
     hr = current_variable.PopulateType();
 
@@ -78,6 +159,35 @@ HRESULT VariableWrapper::PerformBFS(queue<VariableWrapper>* bfs_queue,
       continue;
     }
 
+    // Objects shared by several variables are only expanded once.
+    // Evaluating a property getter can let the garbage collector move
+    // objects, so another object can now be at the address an expanded
+    // object had. Both addresses are read again before they are
+    // compared, and an expanded object that has moved is replaced by
+    // the current one.
+    CORDB_ADDRESS address = 0;
+    if (IsSharedObject(*current_variable.variable_value_) &&
+        current_variable.variable_value_->GetCurrentAddress(&address) ==
+            S_OK) {
+      auto expanded = expanded_objects.find(address);
+      CORDB_ADDRESS expanded_address = 0;
+      if (expanded != expanded_objects.end() &&
+          expanded->second.object->GetCurrentAddress(&expanded_address) ==
+              S_OK &&
+          expanded_address == address) {
+        SetStatusMessage(
+            current_variable.variable_proto_,
+            "Same object as " +
+                GetVariablePath(expanded->second.variable, parents) + ".");
+        bfs_queue->pop();
+        continue;
+      }
+
+      ExpandedObject &expanded_object = expanded_objects[address];
+      expanded_object.object = current_variable.variable_value_;
+      expanded_object.variable = current_variable.variable_proto_;
+    }
+
     // Tries to see whether we can get any members (children) from
     // this variable.
     vector<VariableWrapper> variable_members;
@@ -92,6 +202,8 @@ HRESULT VariableWrapper::PerformBFS(queue<VariableWrapper>* bfs_queue,
     else if (SUCCEEDED(hr)) {
       for (auto &member_value : variable_members) {
         member_value.bfs_level_ = current_variable.bfs_level_ + 1;
+        parents[member_value.variable_proto_] =
+            current_variable.variable_proto_;
         bfs_queue->push(member_value);
       }
     }
@@ -102,8 +214,6 @@ HRESULT VariableWrapper::PerformBFS(queue<VariableWrapper>* bfs_queue,
     }
     bfs_queue->pop();
   }
-
-  return S_OK;
 }
 
 // Populates variable proto variable_proto_ with
@@ -15,6 +15,7 @@
 #ifndef VARIABLE_WRAPPER_H_
 #define VARIABLE_WRAPPER_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <queue>
@@ -55,13 +56,25 @@ public:
   //  4. If the BFS level of X is kDefaultObjectEvalDepth,
   // sets an error status on X saying that we cannot evaluate
   // its children and continues with the loop.
-  //  5. Otherwise, tries to get members (children) of X.
-  //  6. If there are members, pushes them into the queue. We
+  //  5. If X is an object that was already reached through another
+  // variable in the queue, sets a status on X that names the first
+  // variable instead of evaluating X again and continues with the loop.
+  //  6. Otherwise, tries to get members (children) of X.
+  //  7. If there are members, pushes them into the queue. We
   // also set the BFS level of the members to be the BFS
   // level of the node X + 1. If not, call PopulateValue on X.
+  //
+  // If size is not null, it should hold the serialized size of the
+  // message that contains the variables in the queue. Each time a
+  // variable is populated, the number of bytes it grew by is added to
+  // size, so terminate_condition can check the size of the message
+  // without serializing it. The growth of the length prefixes of the
+  // enclosing variables is not counted, so size can be a few bytes per
+  // BFS level below the real size.
   static HRESULT PerformBFS(std::queue<VariableWrapper> *bfs_queue,
                             const std::function<bool()> &terminate_condition,
-                            IEvalCoordinator *eval_coordinator);
+                            IEvalCoordinator *eval_coordinator,
+                            std::int64_t *size = nullptr);
 
   // Populates variable proto variable_proto_ with
   // variable_value_ object.
@@ -29,6 +29,7 @@ using ::testing::_;
 using google::cloud::diagnostics::debug::Breakpoint;
 using google::cloud::diagnostics::debug::SourceLocation;
 using google_cloud_debugger::BreakpointClient;
+using google_cloud_debugger::kLengthPrefixedPipeProtocolVersion;
 using std::string;
 using std::unique_ptr;
 using std::vector;
@@ -176,4 +177,246 @@ TEST(BreakpointClientTest, WriteBreakpointError) {
   EXPECT_EQ(client.WriteBreakpoint(breakpoint), E_ABORT);
 }
 
+// Sets properties activated, line and path of Breakpoint breakpoint
+// and serialize and returns that as a length-prefixed breakpoint frame.
+string SetBreakpointAndSerializeFrame(Breakpoint *breakpoint, bool activated,
+                                      int32_t line, const string &path) {
+  breakpoint->set_activated(activated);
+  SourceLocation *source_location = breakpoint->mutable_location();
+  source_location->set_line(line);
+  source_location->set_path(path);
+
+  string breakpoint_string;
+  breakpoint->SerializeToString(&breakpoint_string);
+  string frame = google_cloud_debugger::kBreakpointFrameMagic;
+  uint32_t size = breakpoint_string.size();
+  for (int i = 0; i < 4; ++i) {
+    frame.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+  }
+  return frame + breakpoint_string;
+}
+
+// Tests that ReadBreakpoint reads consecutive length-prefixed frames
+// that arrive in chunks not aligned with the frames.
+TEST(BreakpointClientTest, ReadFramedBreakpoints) {
+  Breakpoint first_breakpoint;
+  Breakpoint second_breakpoint;
+  string frames =
+      SetBreakpointAndSerializeFrame(&first_breakpoint, true, 35, "My Path") +
+      SetBreakpointAndSerializeFrame(&second_breakpoint, false, 12,
+                                     "My Other Path");
+
+  // Breaks up the frames into chunks.
+  vector<string> frame_chunks;
+  int32_t chunk_size = 3;
+  for (string::size_type i = 0; i < frames.length(); i += chunk_size) {
+    frame_chunks.push_back(frames.substr(i, chunk_size));
+  }
+
+  std::reverse(begin(frame_chunks), end(frame_chunks));
+
+  unique_ptr<INamedPipeMock> named_pipe(new (std::nothrow) INamedPipeMock());
+  EXPECT_CALL(*named_pipe, Read(_))
+      .WillRepeatedly(
+          DoAll(ReadFromStringVectorToArg0(&frame_chunks), Return(S_OK)));
+  BreakpointClient client(std::move(named_pipe),
+                          kLengthPrefixedPipeProtocolVersion);
+
+  Breakpoint read_breakpoint;
+  EXPECT_EQ(client.ReadBreakpoint(&read_breakpoint), S_OK);
+  EXPECT_TRUE(read_breakpoint.activated());
+  EXPECT_EQ(read_breakpoint.location().line(), 35);
+  EXPECT_EQ(read_breakpoint.location().path(), "My Path");
+
+  EXPECT_EQ(client.ReadBreakpoint(&read_breakpoint), S_OK);
+  EXPECT_FALSE(read_breakpoint.activated());
+  EXPECT_EQ(read_breakpoint.location().line(), 12);
+  EXPECT_EQ(read_breakpoint.location().path(), "My Other Path");
+  EXPECT_TRUE(frame_chunks.empty());
+}
+
+// Tests that ReadBreakpoint fails on a frame without the frame magic.
+TEST(BreakpointClientTest, ReadFramedBreakpointInvalidMagic) {
+  Breakpoint breakpoint;
+  string frame =
+      SetBreakpointAndSerializeFrame(&breakpoint, true, 35, "My Path");
+  frame[0] = 'X';
+  vector<string> frame_chunks = {frame};
+
+  unique_ptr<INamedPipeMock> named_pipe(new (std::nothrow) INamedPipeMock());
+  EXPECT_CALL(*named_pipe, Read(_))
+      .WillRepeatedly(
+          DoAll(ReadFromStringVectorToArg0(&frame_chunks), Return(S_OK)));
+  BreakpointClient client(std::move(named_pipe),
+                          kLengthPrefixedPipeProtocolVersion);
+
+  Breakpoint read_breakpoint;
+  EXPECT_EQ(client.ReadBreakpoint(&read_breakpoint), E_FAIL);
+}
+
+// Tests that WriteBreakpoint writes a length-prefixed frame.
+TEST(BreakpointClientTest, WriteFramedBreakpoint) {
+  Breakpoint breakpoint;
+  string frame =
+      SetBreakpointAndSerializeFrame(&breakpoint, true, 35, "My Path");
+
+  unique_ptr<INamedPipeMock> named_pipe(new (std::nothrow) INamedPipeMock());
+
+  string breakpoint_to_write;
+  EXPECT_CALL(*named_pipe, Write(_))
+      .WillRepeatedly(DoAll(SaveArg<0>(&breakpoint_to_write), Return(S_OK)));
+  BreakpointClient client(std::move(named_pipe),
+                          kLengthPrefixedPipeProtocolVersion);
+
+  EXPECT_EQ(client.WriteBreakpoint(breakpoint), S_OK);
+  EXPECT_EQ(breakpoint_to_write, frame);
+}
+
+// Returns a batch frame that holds breakpoints.
+string SerializeBatchFrame(const vector<Breakpoint> &breakpoints) {
+  string message;
+  for (const Breakpoint &breakpoint : breakpoints) {
+    string breakpoint_string;
+    breakpoint.SerializeToString(&breakpoint_string);
+    uint32_t size = breakpoint_string.size();
+    for (int i = 0; i < 4; ++i) {
+      message.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+    }
+    message += breakpoint_string;
+  }
+
+  string frame = google_cloud_debugger::kBreakpointBatchFrameMagic;
+  uint32_t size = message.size();
+  for (int i = 0; i < 4; ++i) {
+    frame.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+  }
+  return frame + message;
+}
+
+// Tests that ReadBreakpoints reads a batch frame followed by a single
+// breakpoint frame.
+TEST(BreakpointClientTest, ReadBreakpointBatch) {
+  vector<Breakpoint> batch(3);
+  SetBreakpointAndSerializeFrame(&batch[0], true, 35, "My Path");
+  SetBreakpointAndSerializeFrame(&batch[1], false, 12, "My Other Path");
+  SetBreakpointAndSerializeFrame(&batch[2], true, 7, "My Path");
+  Breakpoint single_breakpoint;
+  string frames =
+      SerializeBatchFrame(batch) +
+      SetBreakpointAndSerializeFrame(&single_breakpoint, true, 99, "Single");
+
+  // Breaks up the frames into chunks.
+  vector<string> frame_chunks;
+  int32_t chunk_size = 5;
+  for (string::size_type i = 0; i < frames.length(); i += chunk_size) {
+    frame_chunks.push_back(frames.substr(i, chunk_size));
+  }
+
+  std::reverse(begin(frame_chunks), end(frame_chunks));
+
+  unique_ptr<INamedPipeMock> named_pipe(new (std::nothrow) INamedPipeMock());
+  EXPECT_CALL(*named_pipe, Read(_))
+      .WillRepeatedly(
+          DoAll(ReadFromStringVectorToArg0(&frame_chunks), Return(S_OK)));
+  BreakpointClient client(std::move(named_pipe),
+                          kLengthPrefixedPipeProtocolVersion);
+
+  vector<Breakpoint> read_breakpoints;
+  bool is_batch = false;
+  EXPECT_EQ(client.ReadBreakpoints(&read_breakpoints, &is_batch), S_OK);
+  EXPECT_TRUE(is_batch);
+  ASSERT_EQ(read_breakpoints.size(), 3);
+  for (size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_EQ(read_breakpoints[i].SerializeAsString(),
+              batch[i].SerializeAsString());
+  }
+
+  EXPECT_EQ(client.ReadBreakpoints(&read_breakpoints, &is_batch), S_OK);
+  EXPECT_FALSE(is_batch);
+  ASSERT_EQ(read_breakpoints.size(), 1);
+  EXPECT_EQ(read_breakpoints[0].location().path(), "Single");
+  EXPECT_TRUE(frame_chunks.empty());
+}
+
+// Tests that ReadBreakpoint returns the breakpoints of a batch frame one
+// by one and that ReadBreakpoints returns the ones it has not returned.
+TEST(BreakpointClientTest, ReadBreakpointFromBatch) {
+  vector<Breakpoint> batch(3);
+  SetBreakpointAndSerializeFrame(&batch[0], true, 35, "My Path");
+  SetBreakpointAndSerializeFrame(&batch[1], false, 12, "My Other Path");
+  SetBreakpointAndSerializeFrame(&batch[2], true, 7, "My Path");
+  Breakpoint single_breakpoint;
+  vector<string> frame_chunks = {
+      SetBreakpointAndSerializeFrame(&single_breakpoint, true, 99, "Single"),
+      SerializeBatchFrame(batch)};
+
+  unique_ptr<INamedPipeMock> named_pipe(new (std::nothrow) INamedPipeMock());
+  EXPECT_CALL(*named_pipe, Read(_))
+      .WillRepeatedly(
+          DoAll(ReadFromStringVectorToArg0(&frame_chunks), Return(S_OK)));
+  BreakpointClient client(std::move(named_pipe),
+                          kLengthPrefixedPipeProtocolVersion);
+
+  Breakpoint read_breakpoint;
+  EXPECT_EQ(client.ReadBreakpoint(&read_breakpoint), S_OK);
+  EXPECT_EQ(read_breakpoint.SerializeAsString(), batch[0].SerializeAsString());
+
+  vector<Breakpoint> read_breakpoints;
+  bool is_batch = false;
+  EXPECT_EQ(client.ReadBreakpoints(&read_breakpoints, &is_batch), S_OK);
+  EXPECT_TRUE(is_batch);
+  ASSERT_EQ(read_breakpoints.size(), 2);
+  EXPECT_EQ(read_breakpoints[0].SerializeAsString(),
+            batch[1].SerializeAsString());
+  EXPECT_EQ(read_breakpoints[1].SerializeAsString(),
+            batch[2].SerializeAsString());
+
+  EXPECT_EQ(client.ReadBreakpoint(&read_breakpoint), S_OK);
+  EXPECT_EQ(read_breakpoint.location().path(), "Single");
+  EXPECT_TRUE(frame_chunks.empty());
+}
+
+// Tests that ReadBreakpoints fails on a batch frame whose last breakpoint
+// is cut off.
+TEST(BreakpointClientTest, ReadBreakpointBatchTruncated) {
+  vector<Breakpoint> batch(1);
+  SetBreakpointAndSerializeFrame(&batch[0], true, 35, "My Path");
+  string frame = SerializeBatchFrame(batch);
+
+  // Makes the breakpoint size larger than the frame.
+  frame[google_cloud_debugger::kBreakpointFrameHeaderSize] += 1;
+  vector<string> frame_chunks = {frame};
+
+  unique_ptr<INamedPipeMock> named_pipe(new (std::nothrow) INamedPipeMock());
+  EXPECT_CALL(*named_pipe, Read(_))
+      .WillRepeatedly(
+          DoAll(ReadFromStringVectorToArg0(&frame_chunks), Return(S_OK)));
+  BreakpointClient client(std::move(named_pipe),
+                          kLengthPrefixedPipeProtocolVersion);
+
+  vector<Breakpoint> read_breakpoints;
+  bool is_batch = false;
+  EXPECT_EQ(client.ReadBreakpoints(&read_breakpoints, &is_batch), E_FAIL);
+}
+
+// Tests that WriteBreakpoints writes one batch frame.
+TEST(BreakpointClientTest, WriteBreakpointBatch) {
+  vector<Breakpoint> batch(2);
+  SetBreakpointAndSerializeFrame(&batch[0], true, 35, "My Path");
+  SetBreakpointAndSerializeFrame(&batch[1], false, 12, "My Other Path");
+  batch[1].mutable_status()->set_iserror(true);
+
+  unique_ptr<INamedPipeMock> named_pipe(new (std::nothrow) INamedPipeMock());
+
+  string batch_to_write;
+  EXPECT_CALL(*named_pipe, Write(_))
+      .Times(1)
+      .WillOnce(DoAll(SaveArg<0>(&batch_to_write), Return(S_OK)));
+  BreakpointClient client(std::move(named_pipe),
+                          kLengthPrefixedPipeProtocolVersion);
+
+  EXPECT_EQ(client.WriteBreakpoints(batch), S_OK);
+  EXPECT_EQ(batch_to_write, SerializeBatchFrame(batch));
+}
+
 }  // namespace google_cloud_debugger_test
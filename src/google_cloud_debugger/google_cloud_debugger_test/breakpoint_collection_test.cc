@@ -0,0 +1,230 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "breakpoint_collection.h"
+#include "ccomptr.h"
+#include "dbg_breakpoint.h"
+#include "debugger_callback.h"
+#include "i_cor_debug_mocks.h"
+#include "i_eval_coordinator_mock.h"
+#include "i_metadata_import_mock.h"
+#include "i_portable_pdb_mocks.h"
+
+using google::cloud::diagnostics::debug::Breakpoint_LogLevel;
+using google_cloud_debugger::BreakpointCollection;
+using google_cloud_debugger::CComPtr;
+using google_cloud_debugger::DbgBreakpoint;
+using google_cloud_debugger::DebuggerCallback;
+using google_cloud_debugger_portable_pdb::IPortablePdbFile;
+using google_cloud_debugger_portable_pdb::MethodInfo;
+using google_cloud_debugger_portable_pdb::SequencePoint;
+using std::string;
+using std::vector;
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::SizeIs;
+
+namespace google_cloud_debugger_test {
+
+// Test Fixture for BreakpointCollection.
+// Sets up a PDB file with one document that has a method with a
+// sequence point at line_ and the ICorDebug objects that breakpoints
+// in that method are activated with.
+class BreakpointCollectionTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    callback_ = new DebuggerCallback("pipe-name");
+    collection_.SetDebuggerCallback(callback_);
+
+    MethodInfo method;
+    method.first_line = 10;
+    method.last_line = 30;
+    method.method_def = method_def_;
+
+    SequencePoint sequence_point;
+    sequence_point.start_line = line_;
+    sequence_point.end_line = line_;
+    sequence_point.il_offset = il_offset_;
+    method.sequence_points.push_back(sequence_point);
+
+    IDocumentIndexFixture document;
+    document.file_name_ = "app/program.cs";
+    document.methods_.push_back(method);
+    pdb_file_fixture_.documents_.push_back(document);
+    pdb_file_fixture_.SetUpIPortablePDBFile(&file_mock_);
+
+    ON_CALL(file_mock_, GetDebugModule(_))
+        .WillByDefault(DoAll(SetArgPointee<0>(&debug_module_), Return(S_OK)));
+    ON_CALL(file_mock_, GetMetaDataImport(_))
+        .WillByDefault(
+            DoAll(SetArgPointee<0>(&metadata_import_), Return(S_OK)));
+    ON_CALL(metadata_import_, GetMethodProps(_, _, _, _, _, _, _, _, _, _))
+        .WillByDefault(DoAll(SetArgPointee<4>(0), Return(S_OK)));
+    ON_CALL(debug_module_, GetBaseAddress(_))
+        .WillByDefault(
+            DoAll(SetArgPointee<0>(module_base_address_), Return(S_OK)));
+    ON_CALL(debug_module_, GetFunctionFromToken(_, _))
+        .WillByDefault(
+            DoAll(SetArgPointee<1>(&debug_function_), Return(S_OK)));
+    ON_CALL(debug_function_, GetILCode(_))
+        .WillByDefault(DoAll(SetArgPointee<0>(&debug_code_), Return(S_OK)));
+  }
+
+  // Returns an active breakpoint with ID id at line line of program.cs.
+  DbgBreakpoint MakeBreakpoint(const string &id, uint32_t line) {
+    DbgBreakpoint breakpoint;
+    breakpoint.Initialize("program.cs", id, line, 0, false, "",
+                          Breakpoint_LogLevel::Breakpoint_LogLevel_INFO, "",
+                          vector<string>());
+    breakpoint.SetActivated(true);
+    return breakpoint;
+  }
+
+  // Hits the breakpoints at the sequence point of the method.
+  HRESULT HitBreakpoint() {
+    vector<std::shared_ptr<IPortablePdbFile>> pdb_files;
+    return collection_.EvaluateAndPrintBreakpoint(
+        module_base_address_, TokenFromRid(method_def_, mdtMethodDef),
+        il_offset_, &eval_coordinator_mock_, nullptr, pdb_files);
+  }
+
+  // Method of the document in the PDB file.
+  uint32_t method_def_ = 100;
+
+  // Line and IL offset of the sequence point of the method.
+  uint32_t line_ = 12;
+  uint32_t il_offset_ = 4;
+
+  // Base address of the module of the PDB file.
+  CORDB_ADDRESS module_base_address_ = 0x1000;
+
+  // Mock of the PDB file of a newly loaded module.
+  IPortablePdbFileMock file_mock_;
+
+  // Fixture for file_mock_.
+  PortablePDBFileFixture pdb_file_fixture_;
+
+  // ICorDebug objects of the module of file_mock_.
+  ICorDebugModuleMock debug_module_;
+  IMetaDataImportMock metadata_import_;
+  ICorDebugFunctionMock debug_function_;
+  ICorDebugCodeMock debug_code_;
+
+  // Function breakpoints that are created by debug_code_.
+  ICorDebugFunctionBreakpointMock first_function_breakpoint_;
+  ICorDebugFunctionBreakpointMock second_function_breakpoint_;
+
+  // Used to check the breakpoints that are hit.
+  IEvalCoordinatorMock eval_coordinator_mock_;
+
+  // Callback that the PDB files of loaded modules are taken from.
+  // No modules are loaded, so breakpoints are only set through
+  // ResolvePendingBreakpoints.
+  CComPtr<DebuggerCallback> callback_;
+
+  // The collection being tested. This is declared last as its
+  // breakpoints hold the mocks above.
+  BreakpointCollection collection_;
+};
+
+// Tests that a location added by another path while a breakpoint is
+// being activated is merged with instead of replaced. The pending
+// breakpoint "1" is resolved and, while its ICorDebugBreakpoint is
+// created, breakpoint "2" is updated and resolved at the same location.
+TEST_F(BreakpointCollectionTest, ResolveSameLocationFromBothPaths) {
+  EXPECT_EQ(collection_.UpdateBreakpoint(MakeBreakpoint("1", line_)), S_FALSE);
+
+  int created = 0;
+  EXPECT_CALL(debug_code_, CreateBreakpoint(il_offset_, _))
+      .Times(2)
+      .WillRepeatedly(
+          Invoke([&](ULONG32, ICorDebugFunctionBreakpoint **breakpoint) {
+            ++created;
+            if (created == 1) {
+              EXPECT_EQ(
+                  collection_.UpdateBreakpoint(MakeBreakpoint("2", line_)),
+                  S_FALSE);
+              EXPECT_EQ(collection_.ResolvePendingBreakpoints(&file_mock_),
+                        S_OK);
+              *breakpoint = &first_function_breakpoint_;
+            } else {
+              *breakpoint = &second_function_breakpoint_;
+            }
+            return S_OK;
+          }));
+
+  // The breakpoint that lost the race is deactivated and the one that
+  // is hit stays active.
+  EXPECT_CALL(first_function_breakpoint_, Activate(TRUE))
+      .WillOnce(Return(S_OK));
+  EXPECT_CALL(first_function_breakpoint_, Activate(FALSE))
+      .WillOnce(Return(S_OK));
+  EXPECT_CALL(second_function_breakpoint_, Activate(TRUE))
+      .WillOnce(Return(S_OK));
+  EXPECT_CALL(second_function_breakpoint_, Activate(FALSE)).Times(0);
+  ON_CALL(second_function_breakpoint_, IsActive(_))
+      .WillByDefault(DoAll(SetArgPointee<0>(TRUE), Return(S_OK)));
+
+  EXPECT_EQ(collection_.ResolvePendingBreakpoints(&file_mock_), S_OK);
+
+  // Both breakpoints are hit at the location.
+  EXPECT_CALL(eval_coordinator_mock_, ProcessBreakpoints(_, _, SizeIs(2), _))
+      .WillOnce(Return(S_OK));
+  EXPECT_EQ(HitBreakpoint(), S_OK);
+}
+
+// Tests that breakpoints requested at different lines that are set at
+// the same sequence point share one collection, so all of them are hit
+// and removing their module removes all of them.
+TEST_F(BreakpointCollectionTest, LocationsAtSameSequencePoint) {
+  EXPECT_EQ(collection_.UpdateBreakpoint(MakeBreakpoint("1", line_ - 1)),
+            S_FALSE);
+  EXPECT_EQ(collection_.UpdateBreakpoint(MakeBreakpoint("2", line_)),
+            S_FALSE);
+
+  EXPECT_CALL(debug_code_, CreateBreakpoint(il_offset_, _))
+      .WillOnce(DoAll(SetArgPointee<1>(&first_function_breakpoint_),
+                      Return(S_OK)))
+      .WillOnce(DoAll(SetArgPointee<1>(&second_function_breakpoint_),
+                      Return(S_OK)));
+  EXPECT_CALL(first_function_breakpoint_, Activate(TRUE))
+      .WillOnce(Return(S_OK));
+  EXPECT_CALL(first_function_breakpoint_, Activate(FALSE)).Times(0);
+  EXPECT_CALL(second_function_breakpoint_, Activate(TRUE))
+      .WillOnce(Return(S_OK));
+  EXPECT_CALL(second_function_breakpoint_, Activate(FALSE))
+      .WillOnce(Return(S_OK));
+  ON_CALL(first_function_breakpoint_, IsActive(_))
+      .WillByDefault(DoAll(SetArgPointee<0>(TRUE), Return(S_OK)));
+
+  EXPECT_EQ(collection_.ResolvePendingBreakpoints(&file_mock_), S_OK);
+
+  EXPECT_CALL(eval_coordinator_mock_, ProcessBreakpoints(_, _, SizeIs(2), _))
+      .WillOnce(Return(S_OK));
+  EXPECT_EQ(HitBreakpoint(), S_OK);
+
+  EXPECT_EQ(collection_.RemoveModuleBreakpoints(module_base_address_), S_OK);
+  EXPECT_EQ(HitBreakpoint(), S_FALSE);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,191 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "breakpoint_write_queue.h"
+
+using google::cloud::diagnostics::debug::Breakpoint;
+using google::cloud::diagnostics::debug::StackFrame;
+using google_cloud_debugger::BreakpointWriteQueue;
+using google_cloud_debugger::BreakpointWriteStats;
+using std::string;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger_test {
+
+// Returns a breakpoint with id id.
+Breakpoint CreateBreakpoint(const string &id) {
+  Breakpoint breakpoint;
+  breakpoint.set_id(id);
+  return breakpoint;
+}
+
+// Tests that queued breakpoints are written in order and timed.
+TEST(BreakpointWriteQueueTest, WritesInOrder) {
+  vector<string> written_ids;
+  BreakpointWriteQueue queue([&](const Breakpoint &breakpoint) {
+    written_ids.push_back(breakpoint.id());
+    return S_OK;
+  });
+
+  steady_clock::time_point resume_time = steady_clock::now();
+  steady_clock::time_point hit_time = resume_time - milliseconds(5);
+  for (int i = 0; i < 10; ++i) {
+    Breakpoint breakpoint = CreateBreakpoint(std::to_string(i));
+    EXPECT_EQ(queue.Enqueue(&breakpoint, hit_time, resume_time), S_OK);
+  }
+  queue.Flush();
+
+  ASSERT_EQ(written_ids.size(), 10);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(written_ids[i], std::to_string(i));
+  }
+
+  BreakpointWriteStats stats = queue.GetStats();
+  EXPECT_EQ(stats.written, 10);
+  EXPECT_EQ(stats.failed, 0);
+  EXPECT_EQ(stats.max_pause_us, 5000);
+  EXPECT_EQ(stats.total_pause_us, 50000);
+  EXPECT_GE(stats.max_latency_us, stats.max_pause_us);
+}
+
+// Tests that Enqueue blocks while the queue is full and does not wait
+// for the write of the breakpoint it queues.
+TEST(BreakpointWriteQueueTest, BoundedQueue) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool release_writer = false;
+  BreakpointWriteQueue queue(
+      [&](const Breakpoint &breakpoint) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return release_writer; });
+        return S_OK;
+      },
+      2);
+
+  steady_clock::time_point now = steady_clock::now();
+  // The writer takes the first breakpoint and blocks, the next two fill
+  // the queue.
+  for (int i = 0; i < 3; ++i) {
+    Breakpoint breakpoint = CreateBreakpoint("full");
+    EXPECT_EQ(queue.Enqueue(&breakpoint, now, now), S_OK);
+    std::this_thread::sleep_for(milliseconds(10));
+  }
+
+  bool fourth_queued = false;
+  std::thread producer([&] {
+    Breakpoint breakpoint = CreateBreakpoint("blocked");
+    queue.Enqueue(&breakpoint, now, now);
+    std::lock_guard<std::mutex> lock(mutex);
+    fourth_queued = true;
+  });
+
+  std::this_thread::sleep_for(milliseconds(50));
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_FALSE(fourth_queued);
+    release_writer = true;
+  }
+  cv.notify_all();
+
+  producer.join();
+  queue.Flush();
+  EXPECT_TRUE(fourth_queued);
+  EXPECT_EQ(queue.GetStats().written, 4);
+}
+
+// Tests that Enqueue returns the error of a failed write.
+TEST(BreakpointWriteQueueTest, WriteError) {
+  BreakpointWriteQueue queue(
+      [](const Breakpoint &breakpoint) { return E_ACCESSDENIED; });
+
+  steady_clock::time_point now = steady_clock::now();
+  Breakpoint first = CreateBreakpoint("first");
+  EXPECT_EQ(queue.Enqueue(&first, now, now), S_OK);
+  queue.Flush();
+
+  Breakpoint second = CreateBreakpoint("second");
+  EXPECT_EQ(queue.Enqueue(&second, now, now), E_ACCESSDENIED);
+  EXPECT_EQ(queue.GetStats().written, 0);
+  EXPECT_EQ(queue.GetStats().failed, 1);
+}
+
+// Tests that the queued breakpoints are written before the queue
+// shuts down and that Enqueue fails afterwards.
+TEST(BreakpointWriteQueueTest, ShutDown) {
+  int written = 0;
+  BreakpointWriteQueue queue([&](const Breakpoint &breakpoint) {
+    std::this_thread::sleep_for(milliseconds(1));
+    ++written;
+    return S_OK;
+  });
+
+  steady_clock::time_point now = steady_clock::now();
+  for (int i = 0; i < 5; ++i) {
+    Breakpoint breakpoint = CreateBreakpoint(std::to_string(i));
+    queue.Enqueue(&breakpoint, now, now);
+  }
+  queue.ShutDown();
+
+  EXPECT_EQ(written, 5);
+  Breakpoint late = CreateBreakpoint("late");
+  EXPECT_EQ(queue.Enqueue(&late, now, now), E_ABORT);
+}
+
+// Tests that written breakpoints are cleared and reused, keeping the
+// messages of their repeated fields.
+TEST(BreakpointWriteQueueTest, ReuseBreakpoint) {
+  BreakpointWriteQueue queue(
+      [](const Breakpoint &breakpoint) { return S_OK; });
+  steady_clock::time_point now = steady_clock::now();
+
+  // Nothing is reused before a breakpoint is written.
+  Breakpoint breakpoint;
+  queue.ReuseBreakpoint(&breakpoint);
+  EXPECT_EQ(breakpoint.stack_frames().ClearedCount(), 0);
+
+  breakpoint.set_id("id");
+  StackFrame *frame = breakpoint.add_stack_frames();
+  frame->add_locals()->set_name("local");
+  EXPECT_EQ(queue.Enqueue(&breakpoint, now, now), S_OK);
+
+  // The breakpoint is swapped into the queue, not copied.
+  EXPECT_EQ(breakpoint.id(), "");
+  EXPECT_EQ(breakpoint.stack_frames_size(), 0);
+  EXPECT_EQ(breakpoint.stack_frames().ClearedCount(), 0);
+  queue.Flush();
+
+  Breakpoint reused;
+  queue.ReuseBreakpoint(&reused);
+  EXPECT_EQ(reused.id(), "");
+  EXPECT_EQ(reused.stack_frames_size(), 0);
+  EXPECT_EQ(reused.add_stack_frames(), frame);
+  EXPECT_EQ(frame->locals_size(), 0);
+
+  // A written breakpoint is only reused once.
+  Breakpoint not_reused;
+  queue.ReuseBreakpoint(&not_reused);
+  EXPECT_EQ(not_reused.stack_frames().ClearedCount(), 0);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,62 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <future>
+#include <iostream>
+
+#include "capture_worker.h"
+
+using google_cloud_debugger::CaptureWorker;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger_test {
+
+// Compares the latency between handing a task to the capture worker
+// and the task starting with the latency of starting a thread with
+// std::async, which is what every breakpoint hit used to do.
+TEST(CaptureWorkerBenchmark, HandoffLatency) {
+  const int kIterations = 1000;
+
+  CaptureWorker worker;
+  microseconds worker_latency(0);
+  for (int i = 0; i < kIterations; ++i) {
+    std::promise<steady_clock::time_point> started;
+    std::future<steady_clock::time_point> start_time = started.get_future();
+    steady_clock::time_point post_time = steady_clock::now();
+    ASSERT_TRUE(
+        worker.Post([&started]() { started.set_value(steady_clock::now()); }));
+    worker_latency +=
+        duration_cast<microseconds>(start_time.get() - post_time);
+  }
+
+  microseconds async_latency(0);
+  for (int i = 0; i < kIterations; ++i) {
+    steady_clock::time_point launch_time = steady_clock::now();
+    std::future<steady_clock::time_point> start_time = std::async(
+        std::launch::async, []() { return steady_clock::now(); });
+    async_latency +=
+        duration_cast<microseconds>(start_time.get() - launch_time);
+  }
+
+  std::cout << "Average handoff latency over " << kIterations
+            << " tasks: capture worker "
+            << worker_latency.count() / kIterations << "us, std::async "
+            << async_latency.count() / kIterations << "us" << std::endl;
+}
+
+}  // namespace google_cloud_debugger_test
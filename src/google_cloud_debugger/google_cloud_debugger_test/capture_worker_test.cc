@@ -0,0 +1,110 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "capture_worker.h"
+
+using google_cloud_debugger::CaptureWorker;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// Tests that tasks run in the order they are posted.
+TEST(CaptureWorkerTest, RunsTasksInOrder) {
+  vector<int> order;
+  {
+    CaptureWorker worker;
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_TRUE(worker.Post([&order, i]() { order.push_back(i); }));
+    }
+  }
+
+  ASSERT_EQ(order.size(), 100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+// Tests that ShutDown runs the tasks that are already queued.
+TEST(CaptureWorkerTest, ShutDownRunsQueuedTasks) {
+  CaptureWorker worker;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool release = false;
+  int tasks_run = 0;
+
+  // Blocks the worker so the other tasks stay queued.
+  EXPECT_TRUE(worker.Post([&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return release; });
+    ++tasks_run;
+  }));
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(worker.Post([&]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++tasks_run;
+    }));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    release = true;
+  }
+  cv.notify_all();
+  worker.ShutDown();
+
+  EXPECT_EQ(tasks_run, 6);
+}
+
+// Tests that tasks are rejected after ShutDown.
+TEST(CaptureWorkerTest, PostAfterShutDown) {
+  CaptureWorker worker;
+  worker.ShutDown();
+
+  bool ran = false;
+  EXPECT_FALSE(worker.Post([&ran]() { ran = true; }));
+  worker.ShutDown();
+  EXPECT_FALSE(ran);
+}
+
+// Tests that the tasks run on one thread that is not the thread that
+// posts them and that waiting on each task in turn completes.
+TEST(CaptureWorkerTest, RunsTasksOnWorkerThread) {
+  CaptureWorker worker;
+  vector<std::thread::id> thread_ids;
+  for (int i = 0; i < 5; ++i) {
+    std::promise<std::thread::id> started;
+    std::future<std::thread::id> thread_id = started.get_future();
+    ASSERT_TRUE(worker.Post(
+        [&started]() { started.set_value(std::this_thread::get_id()); }));
+    ASSERT_EQ(thread_id.wait_for(std::chrono::seconds(10)),
+              std::future_status::ready);
+    thread_ids.push_back(thread_id.get());
+  }
+
+  for (const auto &thread_id : thread_ids) {
+    EXPECT_NE(thread_id, std::this_thread::get_id());
+    EXPECT_EQ(thread_id, thread_ids.front());
+  }
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,76 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "class_metadata_cache.h"
+
+using google_cloud_debugger::ClassMetadata;
+using google_cloud_debugger::ClassMetadataCache;
+using std::make_shared;
+using std::shared_ptr;
+
+namespace google_cloud_debugger_test {
+
+// Test Fixture for ClassMetadataCache.
+class ClassMetadataCacheTest : public ::testing::Test {
+ protected:
+  // Base address of the first module.
+  CORDB_ADDRESS first_module_ = 0x1000;
+
+  // Base address of the second module.
+  CORDB_ADDRESS second_module_ = 0x2000;
+
+  // Tokens of the classes in the modules.
+  mdTypeDef first_class_ = 0x02000002;
+  mdTypeDef second_class_ = 0x02000003;
+
+  // The cache under test.
+  ClassMetadataCache cache_;
+};
+
+// Tests that cached metadata is found by module and class token.
+TEST_F(ClassMetadataCacheTest, AddAndFind) {
+  shared_ptr<const ClassMetadata> metadata = make_shared<ClassMetadata>();
+  EXPECT_EQ(cache_.Add(first_module_, first_class_, metadata), metadata);
+
+  EXPECT_EQ(cache_.Find(first_module_, first_class_), metadata);
+  EXPECT_EQ(cache_.Find(first_module_, second_class_), nullptr);
+  EXPECT_EQ(cache_.Find(second_module_, first_class_), nullptr);
+
+  // The metadata cached first is kept.
+  shared_ptr<const ClassMetadata> other = make_shared<ClassMetadata>();
+  EXPECT_EQ(cache_.Add(first_module_, first_class_, other), metadata);
+  EXPECT_EQ(cache_.Size(), 1);
+}
+
+// Tests that RemoveModule only removes the classes of that module.
+TEST_F(ClassMetadataCacheTest, RemoveModule) {
+  cache_.Add(first_module_, first_class_, make_shared<ClassMetadata>());
+  cache_.Add(first_module_, second_class_, make_shared<ClassMetadata>());
+  cache_.Add(second_module_, first_class_, make_shared<ClassMetadata>());
+  EXPECT_EQ(cache_.Size(), 3);
+
+  cache_.RemoveModule(first_module_);
+  EXPECT_EQ(cache_.Size(), 1);
+  EXPECT_EQ(cache_.Find(first_module_, first_class_), nullptr);
+  EXPECT_EQ(cache_.Find(first_module_, second_class_), nullptr);
+  EXPECT_NE(cache_.Find(second_module_, first_class_), nullptr);
+
+  cache_.Clear();
+  EXPECT_EQ(cache_.Size(), 0);
+}
+
+}  // namespace google_cloud_debugger_test
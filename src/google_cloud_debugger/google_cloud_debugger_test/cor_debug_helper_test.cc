@@ -190,4 +190,51 @@ TEST_F(CorDebugHelperTest, GetModuleNameFromICorDebugModuleError) {
   EXPECT_EQ(hr, E_FAIL);
 }
 
+// Tests that GetTypeNameFromMdTypeDef reads the metadata of a type once
+// and returns the cached name afterwards, until the module is unloaded.
+TEST_F(CorDebugHelperTest, GetTypeNameFromMdTypeDefCached) {
+  mdTypeDef type_token = 0x02000002;
+  mdToken base_token = 0x01000001;
+  string type_name = "MyNamespace.MyClass";
+  vector<WCHAR> wchar_type_name =
+      google_cloud_debugger::ConvertStringToWCharPtr(type_name);
+  ULONG type_name_len = wchar_type_name.size();
+
+  EXPECT_CALL(metadata_import_,
+              GetTypeDefProps(type_token, nullptr, 0, _, _, _))
+      .Times(2)
+      .WillRepeatedly(DoAll(SetArgPointee<3>(type_name_len),
+                            SetArgPointee<5>(base_token), Return(S_OK)));
+  EXPECT_CALL(metadata_import_,
+              GetTypeDefProps(type_token, _, type_name_len, _, _, _))
+      .Times(2)
+      .WillRepeatedly(DoAll(
+          SetArg1ToWcharArray(wchar_type_name.data(), type_name_len),
+          SetArgPointee<3>(type_name_len), SetArgPointee<5>(base_token),
+          Return(S_OK)));
+
+  // Only the names of loaded modules are cached.
+  CorDebugHelper::AddMetaDataImportNames(&metadata_import_);
+  uint64_t hits = CorDebugHelper::GetNameCache().GetHits();
+  for (int i = 0; i < 3; ++i) {
+    string result_name;
+    mdToken result_base_token = 0;
+    HRESULT hr = debug_helper_.GetTypeNameFromMdTypeDef(
+        type_token, &metadata_import_, &result_name, &result_base_token,
+        &std::cerr);
+    EXPECT_EQ(hr, S_OK);
+    EXPECT_EQ(result_name, type_name);
+    EXPECT_EQ(result_base_token, base_token);
+  }
+  EXPECT_EQ(CorDebugHelper::GetNameCache().GetHits() - hits, 2);
+
+  // Unloading the module drops its names, so they are read again.
+  CorDebugHelper::RemoveMetaDataImportNames(&metadata_import_);
+  string result_name;
+  HRESULT hr = debug_helper_.GetTypeNameFromMdTypeDef(
+      type_token, &metadata_import_, &result_name, nullptr, &std::cerr);
+  EXPECT_EQ(hr, S_OK);
+  EXPECT_EQ(result_name, type_name);
+}
+
 }  // namespace google_cloud_debugger_test
@@ -170,4 +170,45 @@ TEST(BinaryReader, GetStringTest) {
   EXPECT_EQ(second_string, "def");
 }
 
+// Tests that GetStringView function of CustomBinaryReader returns
+// views into the stream without moving the stream pointer.
+TEST(BinaryReader, GetStringViewTest) {
+  char test_data[] = {'a', 'b', 'c', 0, 'd', 'e', 'f'};
+  unique_ptr<stringstream> test_stream =
+      SetUpStream(test_data, sizeof(test_data));
+  google_cloud_debugger_portable_pdb::CustomBinaryStream binary_stream;
+
+  EXPECT_TRUE(binary_stream.ConsumeStream(test_stream.release()));
+
+  const char *view;
+  uint32_t length;
+  EXPECT_TRUE(binary_stream.GetStringView(0, &view, &length));
+  EXPECT_EQ(std::string(view, length), "abc");
+
+  // The last string is not null terminated so it ends at the stream end.
+  EXPECT_TRUE(binary_stream.GetStringView(4, &view, &length));
+  EXPECT_EQ(std::string(view, length), "def");
+
+  EXPECT_FALSE(binary_stream.GetStringView(10, &view, &length));
+  EXPECT_EQ(binary_stream.Current(), 0);
+}
+
+// Tests that GetBlobBytes function of CustomBinaryReader works.
+TEST(BinaryReader, GetBlobBytesTest) {
+  char test_data[] = {0x02, 0x0A, 0x0B, 0x03, 0x01};
+  unique_ptr<stringstream> test_stream =
+      SetUpStream(test_data, sizeof(test_data));
+  google_cloud_debugger_portable_pdb::CustomBinaryStream binary_stream;
+
+  EXPECT_TRUE(binary_stream.ConsumeStream(test_stream.release()));
+
+  std::vector<uint8_t> blob;
+  EXPECT_TRUE(binary_stream.GetBlobBytes(0, &blob));
+  EXPECT_EQ(blob, std::vector<uint8_t>({0x0A, 0x0B}));
+
+  // The blob at offset 3 claims 3 bytes but only 1 is left.
+  EXPECT_FALSE(binary_stream.GetBlobBytes(3, &blob));
+  EXPECT_EQ(binary_stream.Current(), 0);
+}
+
 }  // namespace google_cloud_debugger_test
@@ -59,15 +59,16 @@ class DbgArrayTest : public ::testing::Test {
   }
 
   // Sets up various mock objects so when we use them with
-  // a DbgArray class, we will get an array with 2 elements.
-  void SetUpArray() {
+  // a DbgArray class, we will get an array with 2 elements
+  // of type element_type.
+  void SetUpArray(
+      CorElementType element_type = CorElementType::ELEMENT_TYPE_I4) {
     EXPECT_CALL(array_type_, GetFirstTypeParameter(_))
         .WillRepeatedly(
             DoAll(SetArgPointee<0>(&array_element_type_), Return(S_OK)));
 
     EXPECT_CALL(array_element_type_, GetType(_))
-        .WillRepeatedly(DoAll(SetArgPointee<0>(CorElementType::ELEMENT_TYPE_I4),
-                              Return(S_OK)));
+        .WillRepeatedly(DoAll(SetArgPointee<0>(element_type), Return(S_OK)));
 
     // If queried for ICorDebugHeapValue2, returns heap_value.
     // This happens when the Initialize function tries to create a strong
@@ -361,6 +362,109 @@ TEST_F(DbgArrayTest, TestPopulateMembers) {
   EXPECT_EQ(variable.members(1).value(), std::to_string(value1));
 }
 
+// Tests that PopulateMembers reads the items of an array of primitives
+// with a single read of the debuggee memory.
+TEST_F(DbgArrayTest, TestPopulateMembersBulkRead) {
+  SetUpArray();
+
+  Variable variable;
+  vector<VariableWrapper> variable_wrappers;
+  DbgArray dbgarray(&array_type_, 1, debug_helper_, dbg_object_factory_);
+  dbgarray.Initialize(&array_value_, FALSE);
+
+  ICorDebugThreadMock debug_thread;
+  ICorDebugProcessMock debug_process;
+  EXPECT_CALL(eval_coordinator_, GetActiveDebugThread(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(&debug_thread), Return(S_OK)));
+  EXPECT_CALL(debug_thread, GetProcess(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(&debug_process), Return(S_OK)));
+
+  // Only the first item is retrieved, to find where the items are.
+  ICorDebugGenericValueMock item0;
+  CORDB_ADDRESS item_address = 0x1000;
+  ULONG32 item_size = sizeof(int32_t);
+  EXPECT_CALL(item0, GetSize(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(item_size), Return(S_OK)));
+  EXPECT_CALL(item0, GetAddress(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(item_address), Return(S_OK)));
+  EXPECT_CALL(array_value_, GetElementAtPosition(0, _))
+      .Times(1)
+      .WillRepeatedly(DoAll(SetArgPointee<1>(&item0), Return(S_OK)));
+  EXPECT_CALL(array_value_, GetElementAtPosition(1, _)).Times(0);
+
+  int32_t values[2] = {20, 40};
+  const BYTE *value_bytes = reinterpret_cast<const BYTE *>(values);
+  SIZE_T values_size = sizeof(values);
+  EXPECT_CALL(debug_process, ReadMemory(item_address, values_size, _, _))
+      .Times(1)
+      .WillRepeatedly(
+          DoAll(SetArrayArgument<2>(value_bytes, value_bytes + values_size),
+                SetArgPointee<3>(values_size), Return(S_OK)));
+
+  HRESULT hr = dbgarray.PopulateMembers(&variable, &variable_wrappers,
+                                        &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  ASSERT_EQ(variable_wrappers.size(), 2);
+
+  PopulateTypeAndValue(variable_wrappers);
+
+  EXPECT_EQ(variable.members(0).name(), "[0]");
+  EXPECT_EQ(variable.members(1).name(), "[1]");
+  EXPECT_EQ(variable.members(0).type(), "System.Int32");
+  EXPECT_EQ(variable.members(1).type(), "System.Int32");
+  EXPECT_EQ(variable.members(0).value(), std::to_string(values[0]));
+  EXPECT_EQ(variable.members(1).value(), std::to_string(values[1]));
+}
+
+// Tests that PopulateMembers reads any nonzero byte of a Boolean array
+// as true.
+TEST_F(DbgArrayTest, TestPopulateMembersBulkReadBoolean) {
+  SetUpArray(CorElementType::ELEMENT_TYPE_BOOLEAN);
+
+  Variable variable;
+  vector<VariableWrapper> variable_wrappers;
+  DbgArray dbgarray(&array_type_, 1, debug_helper_, dbg_object_factory_);
+  dbgarray.Initialize(&array_value_, FALSE);
+
+  ICorDebugThreadMock debug_thread;
+  ICorDebugProcessMock debug_process;
+  EXPECT_CALL(eval_coordinator_, GetActiveDebugThread(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(&debug_thread), Return(S_OK)));
+  EXPECT_CALL(debug_thread, GetProcess(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(&debug_process), Return(S_OK)));
+
+  ICorDebugGenericValueMock item0;
+  CORDB_ADDRESS item_address = 0x1000;
+  ULONG32 item_size = sizeof(BYTE);
+  EXPECT_CALL(item0, GetSize(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(item_size), Return(S_OK)));
+  EXPECT_CALL(item0, GetAddress(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(item_address), Return(S_OK)));
+  EXPECT_CALL(array_value_, GetElementAtPosition(0, _))
+      .Times(1)
+      .WillRepeatedly(DoAll(SetArgPointee<1>(&item0), Return(S_OK)));
+
+  // A Boolean set through interop or unsafe code can hold any byte.
+  BYTE values[2] = {0, 2};
+  SIZE_T values_size = sizeof(values);
+  EXPECT_CALL(debug_process, ReadMemory(item_address, values_size, _, _))
+      .Times(1)
+      .WillRepeatedly(DoAll(SetArrayArgument<2>(values, values + values_size),
+                            SetArgPointee<3>(values_size), Return(S_OK)));
+
+  HRESULT hr = dbgarray.PopulateMembers(&variable, &variable_wrappers,
+                                        &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  ASSERT_EQ(variable_wrappers.size(), 2);
+
+  PopulateTypeAndValue(variable_wrappers);
+
+  EXPECT_EQ(variable.members(0).type(), "System.Boolean");
+  EXPECT_EQ(variable.members(1).type(), "System.Boolean");
+  EXPECT_EQ(variable.members(0).value(), std::to_string(false));
+  EXPECT_EQ(variable.members(1).value(), std::to_string(true));
+}
+
 // Tests error case for PopulateMembers function of DbgArray.
 TEST_F(DbgArrayTest, TestPopulateMembersError) {
   SetUpArray();
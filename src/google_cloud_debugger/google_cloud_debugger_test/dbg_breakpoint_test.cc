@@ -282,6 +282,25 @@ TEST_F(DbgBreakpointTest, TrySetBreakpoint) {
   EXPECT_EQ(breakpoint_.GetMethodDef(), method_def);
 }
 
+// Test the FindDocument and TrySetBreakpointInDocument functions
+// of DbgBreakpoint.
+TEST_F(DbgBreakpointTest, TrySetBreakpointInDocument) {
+  uint32_t method_def = 100;
+  uint32_t il_offset = 99;
+  first_doc_.methods_.push_back(
+      MakeMatchingMethod(line_, line_ - 4, method_def, il_offset));
+
+  SetUpBreakpoint();
+
+  int32_t document_index = breakpoint_.FindDocument(file_mock_);
+  EXPECT_EQ(document_index, 0);
+  EXPECT_FALSE(breakpoint_.TrySetBreakpointInDocument(file_mock_, -1));
+  EXPECT_TRUE(
+      breakpoint_.TrySetBreakpointInDocument(file_mock_, document_index));
+  EXPECT_EQ(breakpoint_.GetILOffset(), il_offset);
+  EXPECT_EQ(breakpoint_.GetMethodDef(), method_def);
+}
+
 // Test the TrySetBreakpoint function of DbgBreakpoint when there are
 // multiple documents.
 TEST_F(DbgBreakpointTest, TrySetBreakpointMultipleFilesOne) {
@@ -53,7 +53,10 @@ class DbgClassTest : public ::testing::Test {
  protected:
   virtual void SetUp() {}
 
-  virtual void TearDown() { DbgClass::ClearStaticCache(); }
+  virtual void TearDown() {
+    DbgClass::ClearStaticCache();
+    DbgClass::ClearMetadataCache();
+  }
 
   // Sets up class with element type as ELEMENT_TYPE_CLASS by default.
   void SetUpDbgClass(
@@ -685,6 +688,79 @@ TEST_F(DbgClassTest, TestPopulateMembersBackingField) {
   EXPECT_EQ(variable.members(1).value(), std::to_string(second_field_value_));
 }
 
+// Tests that the metadata of the fields and properties of a class is read
+// once for all its objects, even after the static cache is cleared.
+TEST_F(DbgClassTest, TestPopulateMembersCachedMetadata) {
+  SetUpDbgClass();
+  SetUpBaseClass();
+  SetUpMetaDataImport();
+  SetUpClassField();
+  SetUpClassProperty();
+
+  // Only evaluates the fields.
+  ON_CALL(eval_coordinator_, PropertyEvaluation())
+      .WillByDefault(Return(false));
+
+  for (int i = 0; i < 2; ++i) {
+    Variable variable;
+    vector<VariableWrapper> variable_wrappers;
+    unique_ptr<DbgObject> dbgclass;
+    std::ostringstream err_stream;
+    HRESULT hr = object_factory_.CreateDbgClassObject(
+        &debug_type_, 1, &object_value_, FALSE, &dbgclass, &err_stream);
+    EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+    dbgclass->Initialize(&object_value_, FALSE);
+
+    hr = dbgclass->PopulateMembers(&variable, &variable_wrappers,
+                                   &eval_coordinator_);
+    EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+    PopulateTypeAndValue(variable_wrappers);
+
+    EXPECT_EQ(variable.members_size(), 2);
+    EXPECT_EQ(variable.members(0).value(), std::to_string(first_field_value_));
+    EXPECT_EQ(variable.members(1).value(),
+              std::to_string(second_field_value_));
+
+    // The static cache is cleared after every breakpoint hit.
+    DbgClass::ClearStaticCache();
+  }
+}
+
+// Tests that the metadata of a class that cannot be cached is read once
+// for both its fields and its properties.
+TEST_F(DbgClassTest, TestPopulateMembersUncachedMetadata) {
+  SetUpDbgClass();
+  SetUpBaseClass();
+  SetUpMetaDataImport();
+  SetUpClassField();
+  SetUpClassProperty();
+
+  // Classes whose module has no base address are not cached.
+  ON_CALL(debug_module_, GetBaseAddress(_)).WillByDefault(Return(E_FAIL));
+
+  // Only evaluates the fields.
+  ON_CALL(eval_coordinator_, PropertyEvaluation())
+      .WillByDefault(Return(false));
+
+  Variable variable;
+  vector<VariableWrapper> variable_wrappers;
+  unique_ptr<DbgObject> dbgclass;
+  std::ostringstream err_stream;
+  HRESULT hr = object_factory_.CreateDbgClassObject(
+      &debug_type_, 1, &object_value_, FALSE, &dbgclass, &err_stream);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  dbgclass->Initialize(&object_value_, FALSE);
+
+  hr = dbgclass->PopulateMembers(&variable, &variable_wrappers,
+                                 &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  PopulateTypeAndValue(variable_wrappers);
+
+  EXPECT_EQ(variable.members_size(), 2);
+  EXPECT_EQ(variable.members(0).value(), std::to_string(first_field_value_));
+  EXPECT_EQ(variable.members(1).value(), std::to_string(second_field_value_));
+}
+
 // Test error cases for PopulateMembers function.
 TEST_F(DbgClassTest, TestPopulateMembersError) {
   SetUpDbgClass();
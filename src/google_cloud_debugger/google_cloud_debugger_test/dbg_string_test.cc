@@ -185,4 +185,85 @@ TEST_F(DbgStringTest, GetStringError) {
   }
 }
 
+// Tests that PopulateValue only reads the first characters of a long
+// string while GetString still returns the whole string.
+TEST_F(DbgStringTest, PopulateValueTruncated) {
+  uint32_t max_length = DbgString::kMaximumStringLength;
+  uint32_t string_length = max_length + 5;
+  string test_string_value(string_length, 'a');
+  vector<WCHAR> wchar_string = ConvertStringToWCharPtr(test_string_value);
+
+  EXPECT_CALL(string_value_, GetLength(_))
+      .Times(2)
+      .WillRepeatedly(DoAll(SetArgPointee<0>(string_length), Return(S_OK)));
+
+  // Only the prefix is read for the value.
+  EXPECT_CALL(string_value_, GetString(max_length, _, _))
+      .Times(1)
+      .WillRepeatedly(
+          DoAll(SetArrayArgument<2>(wchar_string.data(),
+                                    wchar_string.data() + max_length),
+                Return(S_OK)));
+
+  // The whole string is read for GetString.
+  EXPECT_CALL(string_value_, GetString(string_length + 1, _, _))
+      .Times(1)
+      .WillRepeatedly(
+          DoAll(SetArrayArgument<2>(wchar_string.data(),
+                                    wchar_string.data() + wchar_string.size()),
+                Return(S_OK)));
+
+  DbgString dbg_string(nullptr, debug_helper_);
+  SetUpString();
+  dbg_string.Initialize(&string_value_, FALSE);
+
+  Variable variable;
+  EXPECT_EQ(dbg_string.PopulateValue(&variable), S_OK);
+  EXPECT_EQ(variable.value(), string(max_length, 'a'));
+  EXPECT_FALSE(variable.status().iserror());
+  EXPECT_EQ(variable.status().message(),
+            "Only the first " + std::to_string(max_length) + " of " +
+                std::to_string(string_length) + " characters were captured.");
+
+  // Populating the value again does not read the string again.
+  Variable second_variable;
+  EXPECT_EQ(dbg_string.PopulateValue(&second_variable), S_OK);
+  EXPECT_EQ(second_variable.value(), string(max_length, 'a'));
+
+  std::string returned_string;
+  EXPECT_EQ(DbgString::GetString(&dbg_string, &returned_string), S_OK);
+  EXPECT_EQ(returned_string, test_string_value);
+}
+
+// Tests that PopulateValue does not split a surrogate pair at the end of
+// the prefix and reports the number of characters it kept.
+TEST_F(DbgStringTest, PopulateValueTruncatedSurrogatePair) {
+  uint32_t max_length = DbgString::kMaximumStringLength;
+  uint32_t string_length = max_length + 5;
+  vector<WCHAR> wchar_string(string_length, 'a');
+  // A surrogate pair starts at the last character of the prefix.
+  wchar_string[max_length - 1] = 0xD83D;
+  wchar_string[max_length] = 0xDE00;
+
+  EXPECT_CALL(string_value_, GetLength(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(string_length), Return(S_OK)));
+  EXPECT_CALL(string_value_, GetString(max_length, _, _))
+      .Times(1)
+      .WillRepeatedly(
+          DoAll(SetArrayArgument<2>(wchar_string.data(),
+                                    wchar_string.data() + max_length),
+                Return(S_OK)));
+
+  DbgString dbg_string(nullptr, debug_helper_);
+  SetUpString();
+  dbg_string.Initialize(&string_value_, FALSE);
+
+  Variable variable;
+  EXPECT_EQ(dbg_string.PopulateValue(&variable), S_OK);
+  EXPECT_EQ(variable.value(), string(max_length - 1, 'a'));
+  EXPECT_EQ(variable.status().message(),
+            "Only the first " + std::to_string(max_length - 1) + " of " +
+                std::to_string(string_length) + " characters were captured.");
+}
+
 }  // namespace google_cloud_debugger_test
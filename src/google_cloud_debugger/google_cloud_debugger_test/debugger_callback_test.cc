@@ -14,7 +14,10 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "ccomptr.h"
@@ -23,6 +26,7 @@
 #include "i_cor_debug_mocks.h"
 #include "i_eval_coordinator_mock.h"
 #include "i_metadata_import_mock.h"
+#include "i_portable_pdb_file.h"
 
 using ::testing::_;
 using ::testing::AtLeast;
@@ -33,6 +37,7 @@ using ::testing::SetArrayArgument;
 using google_cloud_debugger::CComPtr;
 using google_cloud_debugger::ConvertStringToWCharPtr;
 using google_cloud_debugger::DebuggerCallback;
+using google_cloud_debugger_portable_pdb::IPortablePdbFile;
 using std::string;
 using std::vector;
 
@@ -82,6 +87,10 @@ class DebuggerCallbackTest : public ::testing::Test {
         .Times(1)
         .WillRepeatedly(DoAll(SetArgPointee<0>(&debug_module_), Return(S_OK)));
 
+    EXPECT_CALL(debug_module_, GetBaseAddress(_))
+        .Times(1)
+        .WillRepeatedly(Return(S_OK));
+
     EXPECT_CALL(debug_module_, GetMetaDataInterface(_, _))
         .Times(1)
         .WillRepeatedly(
@@ -144,4 +153,49 @@ TEST_F(DebuggerCallbackTest, BreakpointError) {
   EXPECT_EQ(hr, CORDBG_E_FUNCTION_NOT_IL);
 }
 
+// Tests that unloading a module drops its PDB file, so loading and
+// unloading modules repeatedly does not keep growing memory.
+TEST_F(DebuggerCallbackTest, LoadAndUnloadModules) {
+  HRESULT hr = callback->Initialize();
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  vector<WCHAR> module_name = ConvertStringToWCharPtr("unloaded_module.dll");
+  ULONG32 module_name_len = module_name.size();
+  ON_CALL(debug_module_, GetMetaDataInterface(_, _))
+      .WillByDefault(DoAll(SetArgPointee<1>(&metadata_import_), Return(S_OK)));
+  ON_CALL(debug_module_, GetName(0, _, nullptr))
+      .WillByDefault(DoAll(SetArgPointee<1>(module_name_len), Return(S_OK)));
+  ON_CALL(debug_module_, GetName(module_name_len, _, _))
+      .WillByDefault(DoAll(
+          SetArgPointee<1>(module_name_len),
+          SetArg2ToWcharArray(module_name.data(), module_name_len),
+          Return(S_OK)));
+  ON_CALL(debug_module_, GetBaseAddress(_))
+      .WillByDefault(DoAll(SetArgPointee<0>(0x1000), Return(S_OK)));
+  EXPECT_CALL(app_domain_mock_, Continue(FALSE))
+      .WillRepeatedly(Return(S_OK));
+
+  vector<std::weak_ptr<IPortablePdbFile>> unloaded_pdbs;
+  for (int i = 0; i < 100; ++i) {
+    hr = callback->LoadModule(&app_domain_mock_, &debug_module_);
+    EXPECT_EQ(hr, S_OK);
+    ASSERT_EQ(callback->GetPdbFiles().size(), 1);
+    unloaded_pdbs.push_back(callback->GetPdbFiles().front());
+
+    hr = callback->UnloadModule(&app_domain_mock_, &debug_module_);
+    EXPECT_EQ(hr, S_OK);
+    EXPECT_TRUE(callback->GetPdbFiles().empty());
+  }
+
+  // A PDB file that a background thread started parsing before its
+  // module was unloaded is freed when the parse finishes.
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  for (const auto &pdb : unloaded_pdbs) {
+    while (!pdb.expired() && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(pdb.expired());
+  }
+}
+
 }  // namespace google_cloud_debugger_test
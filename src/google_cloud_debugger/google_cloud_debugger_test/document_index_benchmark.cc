@@ -0,0 +1,60 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "document_index.h"
+#include "i_portable_pdb_mocks.h"
+
+using google_cloud_debugger_portable_pdb::DocumentIndex;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// Indexes a large synthetic PDB. Indexing all the documents with shared
+// buckets is linear in the size of the tables while initializing each
+// document on its own has to go through the tables once per document.
+TEST(DocumentIndexBenchmark, LargeSyntheticPdb) {
+  const uint32_t kNumDocuments = 1000;
+  const uint32_t kNumMethods = 20000;
+  const uint32_t kNumScopesPerMethod = 2;
+  SyntheticPdbFixture pdb_fixture;
+  pdb_fixture.SetUpPdb(kNumDocuments, kNumMethods, kNumScopesPerMethod);
+
+  steady_clock::time_point start = steady_clock::now();
+  vector<DocumentIndex> document_indices;
+  EXPECT_TRUE(pdb_fixture.IndexAllDocuments(&document_indices));
+  milliseconds one_pass_time =
+      duration_cast<milliseconds>(steady_clock::now() - start);
+
+  start = steady_clock::now();
+  vector<DocumentIndex> per_document_indices;
+  EXPECT_TRUE(pdb_fixture.IndexEachDocument(&per_document_indices));
+  milliseconds per_document_time =
+      duration_cast<milliseconds>(steady_clock::now() - start);
+
+  std::cout << "Indexing " << kNumDocuments << " documents with "
+            << kNumMethods << " methods: one pass "
+            << one_pass_time.count() << "ms, per document "
+            << per_document_time.count() << "ms" << std::endl;
+}
+
+}  // namespace google_cloud_debugger_test
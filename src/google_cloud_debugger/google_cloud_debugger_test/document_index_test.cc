@@ -0,0 +1,225 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "document_index.h"
+#include "i_portable_pdb_mocks.h"
+
+using google_cloud_debugger_portable_pdb::DocumentIndex;
+using google_cloud_debugger_portable_pdb::FindSequencePointAtILOffset;
+using google_cloud_debugger_portable_pdb::GetLocalsAtILOffset;
+using google_cloud_debugger_portable_pdb::LocalConstantInfo;
+using google_cloud_debugger_portable_pdb::LocalScopeRow;
+using google_cloud_debugger_portable_pdb::LocalVariableInfo;
+using google_cloud_debugger_portable_pdb::MethodInfo;
+using google_cloud_debugger_portable_pdb::RowBuckets;
+using google_cloud_debugger_portable_pdb::Scope;
+using google_cloud_debugger_portable_pdb::SequencePoint;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// Test Fixture for DocumentIndex.
+// Uses a synthetic Portable PDB from SyntheticPdbFixture.
+class DocumentIndexTest : public ::testing::Test {
+ protected:
+  // Checks that document_index contains exactly the methods of doc_index
+  // and that each method has its own local scopes in table order.
+  void CheckDocument(const DocumentIndex &document_index, uint32_t doc_index,
+                     uint32_t num_methods, uint32_t num_scopes_per_method) {
+    const vector<MethodInfo> &methods = document_index.GetMethods();
+    uint32_t expected_method_count = 0;
+    for (uint32_t method_def = 1; method_def <= num_methods; ++method_def) {
+      if (pdb_fixture_.GetDocumentOfMethod(method_def) == doc_index) {
+        ++expected_method_count;
+      }
+    }
+    ASSERT_EQ(methods.size(), expected_method_count);
+
+    uint32_t previous_method_def = 0;
+    for (const MethodInfo &method : methods) {
+      EXPECT_EQ(pdb_fixture_.GetDocumentOfMethod(method.method_def),
+                doc_index);
+      EXPECT_GT(method.method_def, previous_method_def);
+      previous_method_def = method.method_def;
+
+      EXPECT_EQ(method.first_line, 10);
+      EXPECT_EQ(method.last_line, 12);
+      ASSERT_EQ(method.local_scope.size(), num_scopes_per_method);
+      for (uint32_t i = 0; i < num_scopes_per_method; ++i) {
+        const LocalScopeRow &scope_row =
+            pdb_fixture_.local_scope_table_[method.local_scope[i].index];
+        EXPECT_EQ(scope_row.method_def, method.method_def);
+        EXPECT_EQ(method.local_scope[i].start_offset, i);
+      }
+    }
+  }
+
+  // Fixture for the synthetic PDB.
+  SyntheticPdbFixture pdb_fixture_;
+};
+
+// Tests that RowBuckets groups rows by key and drops keys out of range.
+TEST(RowBucketsTest, GroupsRowsByKey) {
+  vector<uint32_t> keys = {0, 2, 1, 2, 5, 1, 2};
+  RowBuckets buckets;
+  buckets.Initialize(keys, 3, [](uint32_t key) { return key; });
+
+  EXPECT_EQ(vector<uint32_t>(buckets.BucketBegin(0), buckets.BucketEnd(0)),
+            vector<uint32_t>());
+  EXPECT_EQ(vector<uint32_t>(buckets.BucketBegin(1), buckets.BucketEnd(1)),
+            vector<uint32_t>({2, 5}));
+  EXPECT_EQ(vector<uint32_t>(buckets.BucketBegin(2), buckets.BucketEnd(2)),
+            vector<uint32_t>({1, 3, 6}));
+  // Key 5 is out of range so its row is dropped.
+  EXPECT_EQ(buckets.BucketBegin(5), buckets.BucketEnd(5));
+}
+
+// Tests that indexing one document finds its methods and scopes.
+TEST_F(DocumentIndexTest, InitializeSingleDocument) {
+  pdb_fixture_.SetUpPdb(3, 10, 2);
+
+  DocumentIndex document_index;
+  EXPECT_TRUE(document_index.Initialize(pdb_fixture_.pdb_mock_, 2));
+  CheckDocument(document_index, 2, 10, 2);
+}
+
+// Tests that indexing all documents with shared buckets gives every
+// document its own methods and every method its own scopes.
+TEST_F(DocumentIndexTest, InitializeAllDocuments) {
+  pdb_fixture_.SetUpPdb(4, 21, 3);
+
+  vector<DocumentIndex> document_indices;
+  EXPECT_TRUE(pdb_fixture_.IndexAllDocuments(&document_indices));
+  for (uint32_t i = 1; i <= 4; ++i) {
+    CheckDocument(document_indices[i], i, 21, 3);
+  }
+}
+
+// Tests that document index 0 and out of range indices are rejected.
+TEST_F(DocumentIndexTest, InitializeInvalidDocument) {
+  pdb_fixture_.SetUpPdb(2, 4, 1);
+
+  DocumentIndex document_index;
+  EXPECT_FALSE(document_index.Initialize(pdb_fixture_.pdb_mock_, 0));
+  EXPECT_FALSE(document_index.Initialize(pdb_fixture_.pdb_mock_, 3));
+}
+
+// Tests that indexing all the documents with shared buckets gives the
+// same methods and scopes as initializing each document on its own.
+TEST_F(DocumentIndexTest, OnePassMatchesPerDocument) {
+  pdb_fixture_.SetUpPdb(7, 50, 3);
+
+  vector<DocumentIndex> document_indices;
+  EXPECT_TRUE(pdb_fixture_.IndexAllDocuments(&document_indices));
+  vector<DocumentIndex> per_document_indices;
+  EXPECT_TRUE(pdb_fixture_.IndexEachDocument(&per_document_indices));
+  ASSERT_EQ(document_indices.size(), per_document_indices.size());
+
+  for (uint32_t i = 1; i < document_indices.size(); ++i) {
+    const vector<MethodInfo> &methods = document_indices[i].GetMethods();
+    const vector<MethodInfo> &per_document_methods =
+        per_document_indices[i].GetMethods();
+    ASSERT_EQ(methods.size(), per_document_methods.size());
+    for (size_t j = 0; j < methods.size(); ++j) {
+      EXPECT_EQ(methods[j].method_def, per_document_methods[j].method_def);
+      EXPECT_EQ(methods[j].first_line, per_document_methods[j].first_line);
+      EXPECT_EQ(methods[j].last_line, per_document_methods[j].last_line);
+      ASSERT_EQ(methods[j].local_scope.size(),
+                per_document_methods[j].local_scope.size());
+      for (size_t k = 0; k < methods[j].local_scope.size(); ++k) {
+        EXPECT_EQ(methods[j].local_scope[k].index,
+                  per_document_methods[j].local_scope[k].index);
+      }
+    }
+    CheckDocument(document_indices[i], i, 50, 3);
+  }
+}
+
+// Tests that the sequence point of an IL offset is the last non-hidden
+// sequence point at or before the offset.
+TEST(DocumentIndexILOffsetTest, FindSequencePointAtILOffset) {
+  MethodInfo method;
+  uint32_t il_offsets[] = {0, 4, 8, 12, 20};
+  for (uint32_t il_offset : il_offsets) {
+    SequencePoint sequence_point;
+    sequence_point.il_offset = il_offset;
+    sequence_point.is_hidden = (il_offset == 8 || il_offset == 0);
+    method.sequence_points.push_back(sequence_point);
+  }
+
+  uint32_t index;
+  EXPECT_TRUE(FindSequencePointAtILOffset(method, 4, &index));
+  EXPECT_EQ(index, 1);
+  EXPECT_TRUE(FindSequencePointAtILOffset(method, 7, &index));
+  EXPECT_EQ(index, 1);
+  // IL offset 8 is hidden so the point at 4 is used.
+  EXPECT_TRUE(FindSequencePointAtILOffset(method, 10, &index));
+  EXPECT_EQ(index, 1);
+  EXPECT_TRUE(FindSequencePointAtILOffset(method, 100, &index));
+  EXPECT_EQ(index, 4);
+  // Only a hidden sequence point precedes these offsets.
+  EXPECT_FALSE(FindSequencePointAtILOffset(method, 3, &index));
+  EXPECT_FALSE(FindSequencePointAtILOffset(MethodInfo(), 3, &index));
+}
+
+// Tests that only the locals of the scopes containing an IL offset
+// are returned.
+TEST(DocumentIndexILOffsetTest, GetLocalsAtILOffset) {
+  MethodInfo method;
+  // Scopes are sorted by start offset: an outer scope [0, 40] with
+  // nested scopes [4, 10] and [12, 30].
+  uint32_t starts[] = {0, 4, 12};
+  uint32_t lengths[] = {40, 6, 18};
+  for (size_t i = 0; i < 3; ++i) {
+    Scope scope;
+    scope.start_offset = starts[i];
+    scope.length = lengths[i];
+    LocalVariableInfo variable;
+    variable.name = "variable" + std::to_string(i);
+    scope.local_variables.push_back(variable);
+    LocalConstantInfo constant;
+    constant.name = "constant" + std::to_string(i);
+    scope.local_constants.push_back(constant);
+    method.local_scope.push_back(scope);
+  }
+
+  vector<LocalVariableInfo> variables;
+  vector<LocalConstantInfo> constants;
+  GetLocalsAtILOffset(method, 20, &variables, &constants);
+  ASSERT_EQ(variables.size(), 2);
+  EXPECT_EQ(variables[0].name, "variable0");
+  EXPECT_EQ(variables[1].name, "variable2");
+  ASSERT_EQ(constants.size(), 2);
+  EXPECT_EQ(constants[1].name, "constant2");
+
+  variables.clear();
+  constants.clear();
+  GetLocalsAtILOffset(method, 11, &variables, &constants);
+  ASSERT_EQ(variables.size(), 1);
+  EXPECT_EQ(variables[0].name, "variable0");
+
+  variables.clear();
+  constants.clear();
+  GetLocalsAtILOffset(method, 50, &variables, &constants);
+  EXPECT_TRUE(variables.empty());
+  EXPECT_TRUE(constants.empty());
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,75 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "document_path_trie.h"
+
+using google_cloud_debugger_portable_pdb::DocumentPathTrie;
+using std::string;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// Tests that the document sharing the most trailing segments is chosen.
+TEST(DocumentPathTrieTest, LongestSuffixMatch) {
+  DocumentPathTrie trie;
+  trie.AddPath("wrong_src/test/program.cs", 0);
+  trie.AddPath("blah/test/program.cs", 1);
+  trie.AddPath("src/test/program.cs", 2);
+  trie.AddPath("src/other.cs", 3);
+
+  EXPECT_EQ(trie.FindBestMatch({"program.cs", "test", "src"}), 2);
+  EXPECT_EQ(trie.FindBestMatch({"program.cs", "test", "blah", "c:"}), 1);
+  EXPECT_EQ(trie.FindBestMatch({"other.cs", "src"}), 3);
+}
+
+// Tests that ties go to the document with the smallest index.
+TEST(DocumentPathTrieTest, TiesGoToFirstDocument) {
+  DocumentPathTrie trie;
+  trie.AddPath("a/program.cs", 0);
+  trie.AddPath("b/program.cs", 1);
+
+  EXPECT_EQ(trie.FindBestMatch({"program.cs"}), 0);
+  EXPECT_EQ(trie.FindBestMatch({"program.cs", "c"}), 0);
+  EXPECT_EQ(trie.FindBestMatch({"program.cs", "b"}), 1);
+}
+
+// Tests that a document is only matched if its file name matches.
+TEST(DocumentPathTrieTest, FileNameMustMatch) {
+  DocumentPathTrie trie;
+  trie.AddPath("test/aprogram.cs", 0);
+  trie.AddPath("different_program.cs", 1);
+
+  EXPECT_EQ(trie.FindBestMatch({"program.cs", "test"}), -1);
+  EXPECT_EQ(trie.FindBestMatch({}), -1);
+}
+
+// Tests that document paths are normalized.
+TEST(DocumentPathTrieTest, NormalizesPaths) {
+  DocumentPathTrie trie;
+  trie.AddPath("C:\\Src\\Test\\Program.cs", 0);
+  trie.AddPath("/test/program.cs", 1);
+
+  EXPECT_EQ(trie.FindBestMatch({"program.cs", "test", "src", "c:"}), 0);
+  // Leading '/' gives an empty segment for the root.
+  EXPECT_EQ(trie.FindBestMatch({"program.cs", "test", ""}), 1);
+
+  trie.Clear();
+  EXPECT_EQ(trie.FindBestMatch({"program.cs"}), -1);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,132 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "eval_baton.h"
+
+using google_cloud_debugger::EvalBaton;
+using google_cloud_debugger::EvalPhase;
+using google_cloud_debugger::EvalPhaseBit;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger_test {
+
+// Number of function evaluations in each round trip benchmark.
+const int kEvalCount = 20000;
+
+// Runs kEvalCount function evaluations between a capture thread and a
+// debugger callback thread using the EvalCoordinator protocol on baton.
+// Returns the total time taken.
+nanoseconds RunBatonEvals(EvalBaton *baton) {
+  int evals_run = 0;
+  steady_clock::time_point start = steady_clock::now();
+
+  baton->HandTo(EvalPhase::kCapture);
+  std::thread capture_thread([baton, &evals_run]() {
+    for (int i = 0; i < kEvalCount; ++i) {
+      baton->HandTo(EvalPhase::kEval);
+      baton->Wait(EvalPhaseBit(EvalPhase::kCapture));
+      ++evals_run;
+    }
+    baton->HandTo(EvalPhase::kFinished);
+  });
+
+  // The debugger callback thread.
+  while (baton->Wait(EvalPhaseBit(EvalPhase::kEval) |
+                     EvalPhaseBit(EvalPhase::kFinished)) == EvalPhase::kEval) {
+    baton->HandFrom(EvalPhase::kEval, EvalPhase::kCapture);
+  }
+  capture_thread.join();
+
+  nanoseconds elapsed =
+      duration_cast<nanoseconds>(steady_clock::now() - start);
+  EXPECT_EQ(evals_run, kEvalCount);
+  return elapsed;
+}
+
+// Runs kEvalCount function evaluations with a mutex and two condition
+// variables, the way EvalCoordinator used to. Returns the total time taken.
+nanoseconds RunConditionVariableEvals() {
+  std::mutex mutex;
+  std::condition_variable capture_cv;
+  std::condition_variable callback_cv;
+  bool callback_can_continue = false;
+  bool eval_finished = false;
+  bool finished = false;
+  int evals_run = 0;
+  steady_clock::time_point start = steady_clock::now();
+
+  std::thread capture_thread([&]() {
+    for (int i = 0; i < kEvalCount; ++i) {
+      std::unique_lock<std::mutex> lock(mutex);
+      callback_can_continue = true;
+      eval_finished = false;
+      callback_cv.notify_one();
+      capture_cv.wait(lock, [&]() { return eval_finished; });
+      callback_can_continue = false;
+      ++evals_run;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      finished = true;
+      callback_can_continue = true;
+    }
+    callback_cv.notify_one();
+  });
+
+  // The debugger callback thread.
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    callback_cv.wait(lock, [&]() { return callback_can_continue; });
+    if (finished) {
+      break;
+    }
+
+    callback_can_continue = false;
+    eval_finished = true;
+    capture_cv.notify_all();
+  }
+  lock.unlock();
+  capture_thread.join();
+
+  nanoseconds elapsed =
+      duration_cast<nanoseconds>(steady_clock::now() - start);
+  EXPECT_EQ(evals_run, kEvalCount);
+  return elapsed;
+}
+
+// Compares the per evaluation overhead of EvalBaton with the
+// mutex and condition variables EvalCoordinator used to use.
+TEST(EvalBatonBenchmark, EvalRoundTrip) {
+  EvalBaton baton;
+  nanoseconds baton_time = RunBatonEvals(&baton);
+  nanoseconds condition_variable_time = RunConditionVariableEvals();
+
+  std::cout << "Average function evaluation round trip over " << kEvalCount
+            << " evaluations: EvalBaton " << baton_time.count() / kEvalCount
+            << "ns, condition variables "
+            << condition_variable_time.count() / kEvalCount << "ns"
+            << std::endl;
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,105 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+#include "eval_baton.h"
+
+using google_cloud_debugger::EvalBaton;
+using google_cloud_debugger::EvalPhase;
+using google_cloud_debugger::EvalPhaseBit;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger_test {
+
+// Tests that HandTo changes the phase.
+TEST(EvalBatonTest, HandTo) {
+  EvalBaton baton;
+  EXPECT_EQ(baton.GetPhase(), EvalPhase::kCallback);
+
+  baton.HandTo(EvalPhase::kCapture);
+  EXPECT_EQ(baton.GetPhase(), EvalPhase::kCapture);
+  EXPECT_EQ(baton.Wait(EvalPhaseBit(EvalPhase::kCapture)),
+            EvalPhase::kCapture);
+}
+
+// Tests that HandFrom only changes the phase from the expected phase.
+TEST(EvalBatonTest, HandFrom) {
+  EvalBaton baton;
+  EXPECT_FALSE(baton.HandFrom(EvalPhase::kEval, EvalPhase::kCapture));
+  EXPECT_EQ(baton.GetPhase(), EvalPhase::kCallback);
+
+  EXPECT_TRUE(baton.HandFrom(EvalPhase::kCallback, EvalPhase::kCapture));
+  EXPECT_EQ(baton.GetPhase(), EvalPhase::kCapture);
+}
+
+// Tests that Wait returns the current phase at the deadline.
+TEST(EvalBatonTest, WaitTimesOut) {
+  EvalBaton baton;
+  baton.HandTo(EvalPhase::kEval);
+
+  steady_clock::time_point deadline = steady_clock::now() + milliseconds(20);
+  EXPECT_EQ(baton.Wait(EvalPhaseBit(EvalPhase::kCapture), deadline),
+            EvalPhase::kEval);
+  EXPECT_GE(steady_clock::now(), deadline);
+}
+
+// Tests that a blocked Wait is woken up by another thread.
+TEST(EvalBatonTest, WakesUpWaiter) {
+  EvalBaton baton;
+  std::thread other_thread([&baton]() {
+    std::this_thread::sleep_for(milliseconds(20));
+    baton.HandTo(EvalPhase::kFinished);
+  });
+
+  EXPECT_EQ(baton.Wait(EvalPhaseBit(EvalPhase::kFinished)),
+            EvalPhase::kFinished);
+  other_thread.join();
+}
+
+// Tests that a capture thread and a debugger callback thread hand the
+// debuggee back and forth for every function evaluation and finish.
+TEST(EvalBatonTest, EvalRoundTrips) {
+  const int kEvalCount = 100;
+  EvalBaton baton;
+  int evals_run = 0;
+  int evals_let_run = 0;
+
+  baton.HandTo(EvalPhase::kCapture);
+  std::thread capture_thread([&baton, &evals_run]() {
+    for (int i = 0; i < kEvalCount; ++i) {
+      baton.HandTo(EvalPhase::kEval);
+      baton.Wait(EvalPhaseBit(EvalPhase::kCapture));
+      ++evals_run;
+    }
+    baton.HandTo(EvalPhase::kFinished);
+  });
+
+  // The debugger callback thread.
+  while (baton.Wait(EvalPhaseBit(EvalPhase::kEval) |
+                    EvalPhaseBit(EvalPhase::kFinished)) == EvalPhase::kEval) {
+    ++evals_let_run;
+    EXPECT_TRUE(baton.HandFrom(EvalPhase::kEval, EvalPhase::kCapture));
+  }
+  capture_thread.join();
+
+  EXPECT_EQ(evals_run, kEvalCount);
+  EXPECT_EQ(evals_let_run, kEvalCount);
+  EXPECT_EQ(baton.GetPhase(), EvalPhase::kFinished);
+}
+
+}  // namespace google_cloud_debugger_test
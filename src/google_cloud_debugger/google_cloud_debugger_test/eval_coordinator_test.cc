@@ -110,6 +110,12 @@ TEST_F(EvalCoordinatorTest, TestWaitForEvalTimeOut) {
   EXPECT_TRUE(end - start > one_minute);
 
   EXPECT_EQ(hr, CORDBG_E_FUNC_EVAL_NOT_COMPLETE);
+
+  // An EvalComplete that arrives after the time out is ignored and does
+  // not change the active thread.
+  eval_coordinator_.SignalFinishedEval(&debug_thread_);
+  CComPtr<ICorDebugThread> active_thread;
+  EXPECT_EQ(eval_coordinator_.GetActiveDebugThread(&active_thread), E_FAIL);
 }
 
 // Tests that ProcessBreakpoint will return.
@@ -119,6 +125,8 @@ TEST_F(EvalCoordinatorTest, TestProcessBreakpoint) {
   // TODO(quoct): Add a test when breakpoints_ have members.
   EXPECT_CALL(breakpoint_collection_, WriteBreakpoint(_))
       .Times(0);
+  EXPECT_CALL(breakpoint_collection_, QueueBreakpoint(_, _, _))
+      .Times(0);
   HRESULT hr = eval_coordinator_.ProcessBreakpoints(
       &debug_thread_, &breakpoint_collection_, breakpoints_,
       pdb_files_);
@@ -0,0 +1,177 @@
+// Copyright 2018 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef FAKE_DBG_OBJECT_H_
+#define FAKE_DBG_OBJECT_H_
+
+#include <cstdlib>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "breakpoint.pb.h"
+#include "dbg_object.h"
+#include "i_cor_debug_helper.h"
+#include "i_eval_coordinator.h"
+#include "variable_wrapper.h"
+
+namespace google_cloud_debugger_test {
+
+// Helper class that implements DbgObject.
+// This class contains its own variable proto.
+class FakeDbgObjectBase : public google_cloud_debugger::DbgObject {
+ public:
+  FakeDbgObjectBase(ICorDebugType *debug_type, int depth)
+      : DbgObject(debug_type, depth,
+                  std::shared_ptr<google_cloud_debugger::ICorDebugHelper>()) {}
+
+  virtual void Initialize(ICorDebugValue *debug_value, BOOL is_null) override {}
+
+  virtual HRESULT GetTypeString(std::string *type_string) override {
+    *type_string = type_;
+    return S_OK;
+  }
+
+  virtual HRESULT GetICorDebugValue(ICorDebugValue **debug_value,
+                                    ICorDebugEval *debug_eval) override {
+    return E_NOTIMPL;
+  }
+
+  // Type of the object.
+  std::string type_ = "Type" + std::to_string(rand());
+
+  // Proto of the object.
+  google::cloud::diagnostics::debug::Variable variable_proto_;
+};
+
+// Helper class that implements DbgObject.
+// This class returns no members.
+class FakeDbgObjectValue : public FakeDbgObjectBase {
+ public:
+  FakeDbgObjectValue(ICorDebugType *debug_type, int depth)
+      : FakeDbgObjectBase(debug_type, depth) {}
+
+  virtual HRESULT PopulateValue(
+      google::cloud::diagnostics::debug::Variable *variable) override {
+    variable->set_value(value_);
+    return S_OK;
+  }
+
+  virtual HRESULT PopulateMembers(
+      google::cloud::diagnostics::debug::Variable *variable_proto,
+      std::vector<google_cloud_debugger::VariableWrapper> *members,
+      google_cloud_debugger::IEvalCoordinator *eval_coordinator) override {
+    return S_FALSE;
+  }
+
+  // Creates a variable wrapper. The proto of the wrapper
+  // will be variable_proto_ field of the object.
+  static google_cloud_debugger::VariableWrapper GetVariableWrapper() {
+    std::shared_ptr<FakeDbgObjectValue> object(
+        new FakeDbgObjectValue(nullptr, 0));
+    return google_cloud_debugger::VariableWrapper(&object->variable_proto_,
+                                                  object);
+  }
+  // Value of the object.
+  std::string value_ = "Value" + std::to_string(rand());
+};
+
+// Helper class that implements DbgObject.
+// This class returns members but no value.
+class FakeDbgObjectMembers : public FakeDbgObjectBase {
+ public:
+  FakeDbgObjectMembers(ICorDebugType *debug_type, int depth)
+      : FakeDbgObjectBase(debug_type, depth) {}
+
+  virtual HRESULT PopulateValue(
+      google::cloud::diagnostics::debug::Variable *variable) override {
+    return S_FALSE;
+  }
+
+  virtual HRESULT PopulateMembers(
+      google::cloud::diagnostics::debug::Variable *variable_proto,
+      std::vector<google_cloud_debugger::VariableWrapper> *members,
+      google_cloud_debugger::IEvalCoordinator *eval_coordinator) override {
+    members->insert(members->begin(), members_.begin(), members_.end());
+    return S_OK;
+  }
+
+  // Creates a variable wrapper. The proto of the wrapper
+  // will be variable_proto_ field of the object.
+  static google_cloud_debugger::VariableWrapper GetVariableWrapper() {
+    std::shared_ptr<FakeDbgObjectMembers> object(
+        new FakeDbgObjectMembers(nullptr, 0));
+    return google_cloud_debugger::VariableWrapper(&object->variable_proto_,
+                                                  object);
+  }
+
+  // Members of the object.
+  std::vector<google_cloud_debugger::VariableWrapper> members_;
+};
+
+// Helper class that implements DbgObject.
+// Like DbgClass, this class adds its members to the variable proto
+// it populates. The members are FakeDbgObjectValue.
+class FakeDbgObjectProtoMembers : public FakeDbgObjectBase {
+ public:
+  FakeDbgObjectProtoMembers(int member_count)
+      : FakeDbgObjectBase(nullptr, 0), member_count_(member_count) {}
+
+  virtual HRESULT PopulateValue(
+      google::cloud::diagnostics::debug::Variable *variable) override {
+    return S_FALSE;
+  }
+
+  virtual HRESULT PopulateMembers(
+      google::cloud::diagnostics::debug::Variable *variable_proto,
+      std::vector<google_cloud_debugger::VariableWrapper> *members,
+      google_cloud_debugger::IEvalCoordinator *eval_coordinator) override {
+    for (int i = 0; i < member_count_; ++i) {
+      google::cloud::diagnostics::debug::Variable *member_proto =
+          variable_proto->add_members();
+      member_proto->set_name("Member" + std::to_string(i));
+      std::shared_ptr<FakeDbgObjectValue> member(
+          new FakeDbgObjectValue(nullptr, 0));
+      members->push_back(
+          google_cloud_debugger::VariableWrapper(member_proto, member));
+    }
+    return S_OK;
+  }
+
+  // Adds local_count locals with member_count members each to
+  // stack_frame and pushes them into bfs_queue.
+  static void AddLocals(
+      google::cloud::diagnostics::debug::StackFrame *stack_frame,
+      int local_count, int member_count,
+      std::queue<google_cloud_debugger::VariableWrapper> *bfs_queue) {
+    for (int i = 0; i < local_count; ++i) {
+      google::cloud::diagnostics::debug::Variable *local_proto =
+          stack_frame->add_locals();
+      local_proto->set_name("Local" + std::to_string(i));
+      std::shared_ptr<FakeDbgObjectProtoMembers> local(
+          new FakeDbgObjectProtoMembers(member_count));
+      bfs_queue->push(google_cloud_debugger::VariableWrapper(local_proto,
+                                                             local));
+    }
+  }
+
+ private:
+  // Number of members of the object.
+  int member_count_;
+};
+
+}  // namespace google_cloud_debugger_test
+
+#endif  //  FAKE_DBG_OBJECT_H_
@@ -39,17 +39,36 @@ class IBreakpointCollectionMock
       HRESULT(google_cloud_debugger::DebuggerCallback *debugger_callback));
   MOCK_METHOD1(UpdateBreakpoint,
                HRESULT(const google_cloud_debugger::DbgBreakpoint &breakpoint));
+  MOCK_METHOD2(
+      UpdateBreakpoints,
+      HRESULT(const std::vector<google_cloud_debugger::DbgBreakpoint>
+                  &breakpoints,
+              std::vector<google::cloud::diagnostics::debug::Breakpoint>
+                  *errors));
+  MOCK_METHOD1(
+      ResolvePendingBreakpoints,
+      HRESULT(google_cloud_debugger_portable_pdb::IPortablePdbFile *pdb_file));
+  MOCK_METHOD1(RemoveModuleBreakpoints,
+               HRESULT(CORDB_ADDRESS module_base_address));
   MOCK_METHOD0(SyncBreakpoints, HRESULT());
   MOCK_METHOD0(CancelSyncBreakpoints, HRESULT());
   MOCK_METHOD1(
       WriteBreakpoint,
       HRESULT(const google::cloud::diagnostics::debug::Breakpoint &breakpoint));
+  MOCK_METHOD3(
+      QueueBreakpoint,
+      HRESULT(google::cloud::diagnostics::debug::Breakpoint *breakpoint,
+              std::chrono::steady_clock::time_point hit_time,
+              std::chrono::steady_clock::time_point resume_time));
+  MOCK_METHOD1(ReuseSnapshot,
+               void(google::cloud::diagnostics::debug::Breakpoint *snapshot));
   MOCK_METHOD1(
       ReadBreakpoint,
       HRESULT(google::cloud::diagnostics::debug::Breakpoint *breakpoint));
-  MOCK_METHOD5(
+  MOCK_METHOD6(
       EvaluateAndPrintBreakpoint,
-      HRESULT(mdMethodDef function_token, ULONG32 il_offset,
+      HRESULT(CORDB_ADDRESS module_base_address, mdMethodDef function_token,
+              ULONG32 il_offset,
               google_cloud_debugger::IEvalCoordinator *eval_coordinator,
               ICorDebugThread *debug_thread,
               const std::vector<std::shared_ptr<
@@ -67,6 +67,10 @@ class ICorDebugHelperMock : public google_cloud_debugger::ICorDebugHelper {
   MOCK_METHOD3(ExtractStringFromICorDebugStringValue,
                HRESULT(ICorDebugStringValue *debug_string,
                        std::string *returned_string, std::ostream *err_stream));
+  MOCK_METHOD6(ExtractStringPrefixFromICorDebugStringValue,
+               HRESULT(ICorDebugStringValue *debug_string, ULONG32 max_length,
+                       std::string *returned_string, ULONG32 *returned_length,
+                       ULONG32 *string_length, std::ostream *err_stream));
   MOCK_METHOD4(ExtractParamName,
                HRESULT(IMetaDataImport *metadata_import, mdParamDef param_token,
                        std::string *param_name, std::ostream *err_stream));
@@ -112,6 +116,11 @@ class ICorDebugHelperMock : public google_cloud_debugger::ICorDebugHelper {
   MOCK_METHOD4(GetTypeNameFromMdTypeRef,
                HRESULT(mdTypeRef type_token, IMetaDataImport *metadata_import,
                        std::string *type_name, std::ostream *err_stream));
+  MOCK_METHOD6(GetMethodNameFromMdMethodDef,
+               HRESULT(mdMethodDef method_token,
+                       IMetaDataImport *metadata_import,
+                       std::string *method_name, mdTypeDef *class_token,
+                       ULONG *code_rva, std::ostream *err_stream));
   MOCK_METHOD5(GetMdTypeDefAndMetaDataFromTypeRefHelper,
                HRESULT(mdTypeRef type_ref_token,
                        IMetaDataImport *type_ref_token_metadata,
@@ -187,6 +187,56 @@ class ICorDebugThreadMock : public ICorDebugThread {
   MOCK_METHOD1(GetObject, HRESULT(ICorDebugValue **ppObject));
 };
 
+class ICorDebugProcessMock : public ICorDebugProcess {
+ public:
+  IUNKNOWN_MOCK
+
+  MOCK_METHOD1(Stop, HRESULT(DWORD dwTimeoutIgnored));
+  MOCK_METHOD1(Continue, HRESULT(BOOL fIsOutOfBand));
+  MOCK_METHOD1(IsRunning, HRESULT(BOOL *pbRunning));
+  MOCK_METHOD2(HasQueuedCallbacks,
+               HRESULT(ICorDebugThread *pThread, BOOL *pbQueued));
+  MOCK_METHOD1(EnumerateThreads, HRESULT(ICorDebugThreadEnum **ppThreads));
+  MOCK_METHOD2(SetAllThreadsDebugState,
+               HRESULT(CorDebugThreadState state,
+                       ICorDebugThread *pExceptThisThread));
+  MOCK_METHOD0(Detach, HRESULT(void));
+  MOCK_METHOD1(Terminate, HRESULT(UINT exitCode));
+  MOCK_METHOD3(CanCommitChanges,
+               HRESULT(ULONG cSnapshots,
+                       ICorDebugEditAndContinueSnapshot *pSnapshots[],
+                       ICorDebugErrorInfoEnum **pError));
+  MOCK_METHOD3(CommitChanges,
+               HRESULT(ULONG cSnapshots,
+                       ICorDebugEditAndContinueSnapshot *pSnapshots[],
+                       ICorDebugErrorInfoEnum **pError));
+  MOCK_METHOD1(GetID, HRESULT(DWORD *pdwProcessId));
+  MOCK_METHOD1(GetHandle, HRESULT(HPROCESS *phProcessHandle));
+  MOCK_METHOD2(GetThread,
+               HRESULT(DWORD dwThreadId, ICorDebugThread **ppThread));
+  MOCK_METHOD1(EnumerateObjects, HRESULT(ICorDebugObjectEnum **ppObjects));
+  MOCK_METHOD2(IsTransitionStub,
+               HRESULT(CORDB_ADDRESS address, BOOL *pbTransitionStub));
+  MOCK_METHOD2(IsOSSuspended, HRESULT(DWORD threadID, BOOL *pbSuspended));
+  MOCK_METHOD3(GetThreadContext, HRESULT(DWORD threadID, ULONG32 contextSize,
+                                         BYTE context[]));
+  MOCK_METHOD3(SetThreadContext, HRESULT(DWORD threadID, ULONG32 contextSize,
+                                         BYTE context[]));
+  MOCK_METHOD4(ReadMemory, HRESULT(CORDB_ADDRESS address, DWORD size,
+                                   BYTE buffer[], SIZE_T *read));
+  MOCK_METHOD4(WriteMemory, HRESULT(CORDB_ADDRESS address, DWORD size,
+                                    BYTE buffer[], SIZE_T *written));
+  MOCK_METHOD1(ClearCurrentException, HRESULT(DWORD threadID));
+  MOCK_METHOD1(EnableLogMessages, HRESULT(BOOL fOnOff));
+  MOCK_METHOD2(ModifyLogSwitch, HRESULT(WCHAR *pLogSwitchName, LONG lLevel));
+  MOCK_METHOD1(EnumerateAppDomains,
+               HRESULT(ICorDebugAppDomainEnum **ppAppDomains));
+  MOCK_METHOD1(GetObject, HRESULT(ICorDebugValue **ppObject));
+  MOCK_METHOD2(ThreadForFiberCookie,
+               HRESULT(DWORD fiberCookie, ICorDebugThread **ppThread));
+  MOCK_METHOD1(GetHelperThreadID, HRESULT(DWORD *pThreadID));
+};
+
 class ICorDebugModuleMock : public ICorDebugModule {
  public:
   IUNKNOWN_MOCK
@@ -276,6 +326,29 @@ class ICorDebugFunctionMock : public ICorDebugFunction {
   MOCK_METHOD1(GetCurrentVersionNumber, HRESULT(ULONG32 *pnCurrentVersion));
 };
 
+class ICorDebugCodeMock : public ICorDebugCode {
+ public:
+  IUNKNOWN_MOCK
+
+  MOCK_METHOD1(IsIL, HRESULT(BOOL *pbIL));
+  MOCK_METHOD1(GetFunction, HRESULT(ICorDebugFunction **ppFunction));
+  MOCK_METHOD1(GetAddress, HRESULT(CORDB_ADDRESS *pStart));
+  MOCK_METHOD1(GetSize, HRESULT(ULONG32 *pcBytes));
+  MOCK_METHOD2(CreateBreakpoint,
+               HRESULT(ULONG32 offset,
+                       ICorDebugFunctionBreakpoint **ppBreakpoint));
+  MOCK_METHOD5(GetCode,
+               HRESULT(ULONG32 startOffset, ULONG32 endOffset,
+                       ULONG32 cBufferAlloc, BYTE buffer[],
+                       ULONG32 *pcBufferSize));
+  MOCK_METHOD1(GetVersionNumber, HRESULT(ULONG32 *nVersion));
+  MOCK_METHOD3(GetILToNativeMapping,
+               HRESULT(ULONG32 cMap, ULONG32 *pcMap,
+                       COR_DEBUG_IL_TO_NATIVE_MAP map[]));
+  MOCK_METHOD3(GetEnCRemapSequencePoints,
+               HRESULT(ULONG32 cMap, ULONG32 *pcMap, ULONG32 offsets[]));
+};
+
 class ICorDebugEvalMock : public ICorDebugEval {
  public:
   IUNKNOWN_MOCK
@@ -17,15 +17,33 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+using google_cloud_debugger_portable_pdb::DocumentIndex;
+using google_cloud_debugger_portable_pdb::DocumentRow;
+using google_cloud_debugger_portable_pdb::IDocumentIndex;
+using google_cloud_debugger_portable_pdb::LocalConstantRow;
+using google_cloud_debugger_portable_pdb::LocalScopeRow;
+using google_cloud_debugger_portable_pdb::LocalVariableRow;
+using google_cloud_debugger_portable_pdb::MethodDebugInformationRow;
+using google_cloud_debugger_portable_pdb::MethodInfo;
+using google_cloud_debugger_portable_pdb::RowBuckets;
+using google_cloud_debugger_portable_pdb::SequencePointRecord;
+using std::string;
 using std::unique_ptr;
+using std::vector;
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::ReturnRef;
+using ::testing::SetArgPointee;
 
 namespace google_cloud_debugger_test {
 
 void PortablePDBFileFixture::SetUpIPortablePDBFile(
     IPortablePdbFileMock *file_mock) {
+  ON_CALL(*file_mock, ReadDocumentPaths()).WillByDefault(Return(true));
   ON_CALL(*file_mock, ParsePdbFile()).WillByDefault(Return(true));
+  ON_CALL(*file_mock, ParseAttempted()).WillByDefault(Return(true));
 
   // Makes a vector with a Document Index mock
   for (auto &&document_fixture : documents_) {
@@ -35,16 +53,137 @@ void PortablePDBFileFixture::SetUpIPortablePDBFile(
         .WillByDefault(ReturnRef(document_fixture.methods_));
     ON_CALL(*doc_index, GetFilePath())
         .WillByDefault(ReturnRef(document_fixture.file_name_));
+    document_fixture.method_line_index_.Initialize(document_fixture.methods_);
+    ON_CALL(*doc_index, GetMethodLineIndex())
+        .WillByDefault(ReturnRef(document_fixture.method_line_index_));
 
+    document_path_trie_.AddPath(document_fixture.file_name_,
+                                document_indices_.size());
     document_indices_.push_back(std::move(doc_index));
   }
 
   // The portable PDB file will return a list of Document Indices.
   ON_CALL(*file_mock, GetDocumentIndexTable())
       .WillByDefault(ReturnRef(document_indices_));
+  ON_CALL(*file_mock, GetDocumentPathTrie())
+      .WillByDefault(ReturnRef(document_path_trie_));
+  ON_CALL(*file_mock, FindMethod(_, _, _))
+      .WillByDefault(Invoke(this, &PortablePDBFileFixture::FindMethod));
 
   // Module name should be the same as file name.
   ON_CALL(*file_mock, GetModuleName()).WillByDefault(ReturnRef(module_name_));
 }
 
+bool PortablePDBFileFixture::FindMethod(uint32_t method_def,
+                                        const IDocumentIndex **document_index,
+                                        const MethodInfo **method) const {
+  for (size_t i = 0; i < documents_.size(); ++i) {
+    for (auto &&document_method : documents_[i].methods_) {
+      if (document_method.method_def == method_def) {
+        *document_index = document_indices_[i].get();
+        *method = &document_method;
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void SyntheticPdbFixture::SetUpPdb(uint32_t num_documents,
+                                   uint32_t num_methods,
+                                   uint32_t num_scopes_per_method) {
+  num_documents_ = num_documents;
+
+  // Row 0 of each table is not used.
+  document_table_.assign(num_documents + 1, DocumentRow());
+
+  method_debug_info_table_.assign(num_methods + 1,
+                                  MethodDebugInformationRow());
+  for (uint32_t method_def = 1; method_def <= num_methods; ++method_def) {
+    method_debug_info_table_[method_def].document =
+        GetDocumentOfMethod(method_def);
+  }
+
+  // Local scopes are sorted by method as required by the spec.
+  local_scope_table_.assign(1, LocalScopeRow());
+  for (uint32_t method_def = 1; method_def <= num_methods; ++method_def) {
+    for (uint32_t i = 0; i < num_scopes_per_method; ++i) {
+      LocalScopeRow scope_row;
+      scope_row.method_def = method_def;
+      scope_row.import_scope = 0;
+      scope_row.variable_list = 1;
+      scope_row.constant_list = 1;
+      scope_row.start_offset = i;
+      scope_row.length = 1;
+      local_scope_table_.push_back(scope_row);
+    }
+  }
+
+  // No local variables or constants.
+  local_variable_table_.assign(1, LocalVariableRow());
+  local_constant_table_.assign(1, LocalConstantRow());
+
+  SequencePointRecord record;
+  record.start_line = 10;
+  record.end_line = 12;
+  record.start_col = 1;
+  record.end_col = 2;
+  sequence_point_info_.records.push_back(record);
+
+  ON_CALL(pdb_mock_, GetDocumentTable())
+      .WillByDefault(ReturnRef(document_table_));
+  ON_CALL(pdb_mock_, GetMethodDebugInfoTable())
+      .WillByDefault(ReturnRef(method_debug_info_table_));
+  ON_CALL(pdb_mock_, GetLocalScopeTable())
+      .WillByDefault(ReturnRef(local_scope_table_));
+  ON_CALL(pdb_mock_, GetLocalVariableTable())
+      .WillByDefault(ReturnRef(local_variable_table_));
+  ON_CALL(pdb_mock_, GetLocalConstantTable())
+      .WillByDefault(ReturnRef(local_constant_table_));
+  ON_CALL(pdb_mock_, GetDocumentName(_, _))
+      .WillByDefault(
+          DoAll(SetArgPointee<1>(string("document.cs")), Return(true)));
+  ON_CALL(pdb_mock_, GetHeapGuid(_, _)).WillByDefault(Return(true));
+  ON_CALL(pdb_mock_, GetHash(_, _)).WillByDefault(Return(true));
+  ON_CALL(pdb_mock_, GetMethodSeqInfo(_, _, _))
+      .WillByDefault(
+          DoAll(SetArgPointee<2>(sequence_point_info_), Return(true)));
+}
+
+bool SyntheticPdbFixture::IndexAllDocuments(
+    vector<DocumentIndex> *document_indices) {
+  RowBuckets methods_by_document;
+  methods_by_document.Initialize(
+      method_debug_info_table_, document_table_.size(),
+      [](const MethodDebugInformationRow &row) { return row.document; });
+
+  RowBuckets scopes_by_method;
+  scopes_by_method.Initialize(
+      local_scope_table_, method_debug_info_table_.size(),
+      [](const LocalScopeRow &row) { return row.method_def; });
+
+  document_indices->resize(document_table_.size());
+  for (uint32_t i = 1; i < document_table_.size(); ++i) {
+    if (!(*document_indices)[i].Initialize(pdb_mock_, i, methods_by_document,
+                                           scopes_by_method)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool SyntheticPdbFixture::IndexEachDocument(
+    vector<DocumentIndex> *document_indices) {
+  document_indices->resize(document_table_.size());
+  for (uint32_t i = 1; i < document_table_.size(); ++i) {
+    if (!(*document_indices)[i].Initialize(pdb_mock_, i)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 }  // namespace google_cloud_debugger_test
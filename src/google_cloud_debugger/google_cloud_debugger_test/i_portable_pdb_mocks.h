@@ -31,7 +31,9 @@ class IPortablePdbFileMock
  public:
   MOCK_METHOD2(Initialize, HRESULT(ICorDebugModule *debug_module,
       google_cloud_debugger::ICorDebugHelper *debug_helper));
+  MOCK_METHOD0(ReadDocumentPaths, bool());
   MOCK_METHOD0(ParsePdbFile, bool());
+  MOCK_CONST_METHOD0(ParseAttempted, bool());
   MOCK_CONST_METHOD2(
       GetStream,
       bool(const std::string &name,
@@ -71,6 +73,15 @@ class IPortablePdbFileMock
       const std::vector<
           std::unique_ptr<google_cloud_debugger_portable_pdb::IDocumentIndex>>
           &());
+  MOCK_CONST_METHOD0(
+      GetDocumentPathTrie,
+      const google_cloud_debugger_portable_pdb::DocumentPathTrie &());
+  MOCK_CONST_METHOD3(
+      FindMethod,
+      bool(std::uint32_t method_def,
+           const google_cloud_debugger_portable_pdb::IDocumentIndex
+               **document_index,
+           const google_cloud_debugger_portable_pdb::MethodInfo **method));
   MOCK_CONST_METHOD0(GetModuleName, const std::string &());
   MOCK_CONST_METHOD1(GetDebugModule, HRESULT(ICorDebugModule **debug_module));
   MOCK_CONST_METHOD1(GetMetaDataImport,
@@ -91,6 +102,9 @@ class IDocumentIndexMock
   MOCK_CONST_METHOD0(
       GetMethods,
       const std::vector<google_cloud_debugger_portable_pdb::MethodInfo> &());
+  MOCK_CONST_METHOD0(
+      GetMethodLineIndex,
+      const google_cloud_debugger_portable_pdb::MethodLineIndex &());
 };
 
 // Fixtures that contains information to mock an IDocumentIndex.
@@ -101,6 +115,9 @@ class IDocumentIndexFixture {
 
   // Method in the document index.
   std::vector<google_cloud_debugger_portable_pdb::MethodInfo> methods_;
+
+  // Line index of methods_.
+  google_cloud_debugger_portable_pdb::MethodLineIndex method_line_index_;
 };
 
 // Fixtures that contains information to mock a Portable PDB file.
@@ -109,6 +126,13 @@ class PortablePDBFileFixture {
   // Sets up mock calls for file_mock objecct.
   virtual void SetUpIPortablePDBFile(IPortablePdbFileMock *file_mock);
 
+  // Finds the method with method_def in documents_ and its document
+  // in document_indices_. Used as the FindMethod of the file mock.
+  bool FindMethod(
+      std::uint32_t method_def,
+      const google_cloud_debugger_portable_pdb::IDocumentIndex **document_index,
+      const google_cloud_debugger_portable_pdb::MethodInfo **method) const;
+
   // Module name of the PDB file.
   std::string module_name_ = "My module";
 
@@ -120,6 +144,61 @@ class PortablePDBFileFixture {
   std::vector<
       std::unique_ptr<google_cloud_debugger_portable_pdb::IDocumentIndex>>
       document_indices_;
+
+  // Trie of the file names of documents_.
+  google_cloud_debugger_portable_pdb::DocumentPathTrie document_path_trie_;
+};
+
+// Fixture that sets up a synthetic Portable PDB where methods are
+// assigned to documents in a round-robin manner and every method has
+// the same number of local scopes.
+class SyntheticPdbFixture {
+ public:
+  // Creates the metadata tables of a PDB with num_documents documents,
+  // num_methods methods and num_scopes_per_method scopes per method and
+  // sets up pdb_mock_ to return them.
+  void SetUpPdb(std::uint32_t num_documents, std::uint32_t num_methods,
+                std::uint32_t num_scopes_per_method);
+
+  // Returns the document that method_def belongs to.
+  std::uint32_t GetDocumentOfMethod(std::uint32_t method_def) const {
+    return (method_def - 1) % num_documents_ + 1;
+  }
+
+  // Indexes all the documents using the same method and scope buckets,
+  // which is what PortablePdbFile::ParsePdbFile does. Returns false if
+  // a document fails to initialize.
+  bool IndexAllDocuments(
+      std::vector<google_cloud_debugger_portable_pdb::DocumentIndex>
+          *document_indices);
+
+  // Indexes each document on its own, going through the tables once
+  // per document. Returns false if a document fails to initialize.
+  bool IndexEachDocument(
+      std::vector<google_cloud_debugger_portable_pdb::DocumentIndex>
+          *document_indices);
+
+  // Number of documents in the synthetic PDB.
+  std::uint32_t num_documents_ = 0;
+
+  // Metadata tables of the synthetic PDB.
+  std::vector<google_cloud_debugger_portable_pdb::DocumentRow>
+      document_table_;
+  std::vector<google_cloud_debugger_portable_pdb::MethodDebugInformationRow>
+      method_debug_info_table_;
+  std::vector<google_cloud_debugger_portable_pdb::LocalScopeRow>
+      local_scope_table_;
+  std::vector<google_cloud_debugger_portable_pdb::LocalVariableRow>
+      local_variable_table_;
+  std::vector<google_cloud_debugger_portable_pdb::LocalConstantRow>
+      local_constant_table_;
+
+  // Sequence points returned for every method.
+  google_cloud_debugger_portable_pdb::MethodSequencePointInformation
+      sequence_point_info_;
+
+  // Mock of the Portable PDB file.
+  ::testing::NiceMock<IPortablePdbFileMock> pdb_mock_;
 };
 
 }  // namespace google_cloud_debugger_test
@@ -0,0 +1,131 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "custom_binary_reader.h"
+#include "memory_mapped_file.h"
+
+using google_cloud_debugger_portable_pdb::CustomBinaryStream;
+using google_cloud_debugger_portable_pdb::MemoryMappedFile;
+using std::string;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// Test Fixture for MemoryMappedFile and CustomBinaryStream::ConsumeFile.
+// Writes the file to map in the current directory.
+class MemoryMappedFileTest : public ::testing::Test {
+ protected:
+  virtual void TearDown() { std::remove(file_path_.c_str()); }
+
+  // Replaces the content of the file.
+  void WriteFile(const string &content) {
+    std::ofstream file(file_path_, std::ios::binary | std::ios::trunc);
+    file << content;
+  }
+
+  string file_path_ = "memory_mapped_file_test.bin";
+
+  string missing_file_path_ = "memory_mapped_file_test_missing.bin";
+};
+
+// Tests that Open maps the whole content of a file.
+TEST_F(MemoryMappedFileTest, OpenMapsFile) {
+  string content("abc\0def", 7);
+  WriteFile(content);
+
+  MemoryMappedFile mapped_file;
+  EXPECT_TRUE(mapped_file.Open(file_path_));
+  ASSERT_EQ(mapped_file.GetSize(), content.size());
+  EXPECT_EQ(string(reinterpret_cast<const char *>(mapped_file.GetData()),
+                   mapped_file.GetSize()),
+            content);
+}
+
+// Tests that Open fails on an empty file.
+TEST_F(MemoryMappedFileTest, OpenEmptyFile) {
+  WriteFile("");
+
+  MemoryMappedFile mapped_file;
+  EXPECT_FALSE(mapped_file.Open(file_path_));
+  EXPECT_TRUE(mapped_file.GetData() == nullptr);
+  EXPECT_EQ(mapped_file.GetSize(), 0);
+}
+
+// Tests that Open fails on a file that does not exist.
+TEST_F(MemoryMappedFileTest, OpenMissingFile) {
+  MemoryMappedFile mapped_file;
+  EXPECT_FALSE(mapped_file.Open(missing_file_path_));
+  EXPECT_TRUE(mapped_file.GetData() == nullptr);
+  EXPECT_EQ(mapped_file.GetSize(), 0);
+}
+
+// Tests that a mapped file can be read with CustomBinaryStream and that
+// the views point into the mapping.
+TEST_F(MemoryMappedFileTest, ConsumeFileReadsMapping) {
+  char test_data[] = {'a', 'b', 'c', 0x00, 0x02, 0x0A, 0x0B, 0x04, 0x03};
+  WriteFile(string(test_data, sizeof(test_data)));
+
+  CustomBinaryStream binary_stream;
+  EXPECT_TRUE(binary_stream.ConsumeFile(file_path_));
+  EXPECT_EQ(binary_stream.GetRemainingSize(), sizeof(test_data));
+
+  const char *string_view;
+  uint32_t length;
+  EXPECT_TRUE(binary_stream.GetStringView(0, &string_view, &length));
+  EXPECT_EQ(string(string_view, length), "abc");
+
+  const uint8_t *blob_view;
+  EXPECT_TRUE(binary_stream.GetBlobView(4, &blob_view, &length));
+  EXPECT_EQ(vector<uint8_t>(blob_view, blob_view + length),
+            vector<uint8_t>({0x0A, 0x0B}));
+  EXPECT_EQ(reinterpret_cast<const char *>(blob_view), string_view + 5);
+
+  // The blob at offset 7 claims 4 bytes but only 1 is left.
+  EXPECT_FALSE(binary_stream.GetBlobView(7, &blob_view, &length));
+
+  uint8_t bytes[4];
+  uint32_t bytes_read;
+  EXPECT_TRUE(binary_stream.ReadBytes(bytes, 4, &bytes_read));
+  EXPECT_EQ(bytes_read, 4);
+  EXPECT_EQ(string(reinterpret_cast<char *>(bytes), 3), "abc");
+  EXPECT_EQ(binary_stream.Current(), 4);
+}
+
+// Tests that ConsumeFile falls back to reading an empty file, which
+// cannot be mapped, as an empty stream.
+TEST_F(MemoryMappedFileTest, ConsumeEmptyFile) {
+  WriteFile("");
+
+  CustomBinaryStream binary_stream;
+  EXPECT_TRUE(binary_stream.ConsumeFile(file_path_));
+  EXPECT_FALSE(binary_stream.HasNext());
+
+  uint8_t byte;
+  EXPECT_FALSE(binary_stream.ReadByte(&byte));
+}
+
+// Tests that ConsumeFile fails on a file that does not exist.
+TEST_F(MemoryMappedFileTest, ConsumeMissingFile) {
+  CustomBinaryStream binary_stream;
+  EXPECT_FALSE(binary_stream.ConsumeFile(missing_file_path_));
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,157 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include "document_index.h"
+#include "method_line_index.h"
+
+using google_cloud_debugger_portable_pdb::MethodInfo;
+using google_cloud_debugger_portable_pdb::MethodLineIndex;
+using google_cloud_debugger_portable_pdb::SequencePoint;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+namespace {
+
+// Adds a sequence point to method. Sequence points have to be added
+// in IL order.
+void AddSequencePoint(MethodInfo *method, uint32_t il_offset,
+                      uint32_t start_line, bool is_hidden = false) {
+  SequencePoint sequence_point;
+  sequence_point.il_offset = il_offset;
+  sequence_point.start_line = start_line;
+  sequence_point.end_line = start_line;
+  sequence_point.is_hidden = is_hidden;
+  method->sequence_points.push_back(sequence_point);
+}
+
+// Makes a method spanning first_line to last_line.
+MethodInfo MakeMethod(uint32_t method_def, uint32_t first_line,
+                      uint32_t last_line) {
+  MethodInfo method;
+  method.method_def = method_def;
+  method.first_line = first_line;
+  method.last_line = last_line;
+  return method;
+}
+
+}  // namespace
+
+// Tests that the innermost method containing the line is chosen.
+TEST(MethodLineIndexTest, InnermostMethod) {
+  vector<MethodInfo> methods;
+  // Outer method with a lambda defined on lines 12 to 14.
+  methods.push_back(MakeMethod(1, 10, 20));
+  AddSequencePoint(&methods[0], 0, 10);
+  AddSequencePoint(&methods[0], 5, 12);
+  AddSequencePoint(&methods[0], 10, 16);
+  methods.push_back(MakeMethod(2, 12, 14));
+  AddSequencePoint(&methods[1], 0, 13);
+  // Unrelated method.
+  methods.push_back(MakeMethod(3, 30, 40));
+  AddSequencePoint(&methods[2], 0, 31);
+
+  MethodLineIndex index;
+  index.Initialize(methods);
+
+  uint32_t method_index;
+  uint32_t sequence_point_index;
+  EXPECT_TRUE(index.FindLocation(methods, 13, &method_index,
+                                 &sequence_point_index));
+  EXPECT_EQ(method_index, 1);
+  EXPECT_EQ(sequence_point_index, 0);
+
+  // Line 15 is after the lambda so the outer method is used.
+  EXPECT_TRUE(index.FindLocation(methods, 15, &method_index,
+                                 &sequence_point_index));
+  EXPECT_EQ(method_index, 0);
+  EXPECT_EQ(sequence_point_index, 2);
+
+  EXPECT_TRUE(index.FindLocation(methods, 30, &method_index,
+                                 &sequence_point_index));
+  EXPECT_EQ(method_index, 2);
+
+  // No method contains these lines.
+  EXPECT_FALSE(index.FindLocation(methods, 25, &method_index,
+                                  &sequence_point_index));
+  EXPECT_FALSE(index.FindLocation(methods, 5, &method_index,
+                                  &sequence_point_index));
+}
+
+// Tests that the sequence point with the nearest start line is chosen
+// even if it is not the first one in IL order, and that hidden sequence
+// points are skipped.
+TEST(MethodLineIndexTest, NearestSequencePoint) {
+  vector<MethodInfo> methods;
+  // A loop whose condition on line 12 is emitted after its body.
+  methods.push_back(MakeMethod(1, 10, 20));
+  AddSequencePoint(&methods[0], 0, 10);
+  AddSequencePoint(&methods[0], 2, 12, true);
+  AddSequencePoint(&methods[0], 4, 14);
+  AddSequencePoint(&methods[0], 8, 12);
+  AddSequencePoint(&methods[0], 12, 12);
+  AddSequencePoint(&methods[0], 16, 18);
+
+  MethodLineIndex index;
+  index.Initialize(methods);
+
+  uint32_t method_index;
+  uint32_t sequence_point_index;
+  EXPECT_TRUE(index.FindLocation(methods, 11, &method_index,
+                                 &sequence_point_index));
+  // Line 12 at IL offset 8 is the first non-hidden point on line 12.
+  EXPECT_EQ(sequence_point_index, 3);
+
+  EXPECT_TRUE(index.FindLocation(methods, 15, &method_index,
+                                 &sequence_point_index));
+  EXPECT_EQ(sequence_point_index, 5);
+
+  // No sequence points after line 19.
+  EXPECT_FALSE(index.FindLocation(methods, 19, &method_index,
+                                  &sequence_point_index));
+}
+
+// Tests that among methods with the same first line the first one wins
+// and that methods without matching sequence points are skipped.
+TEST(MethodLineIndexTest, SameFirstLine) {
+  vector<MethodInfo> methods;
+  methods.push_back(MakeMethod(1, 10, 20));
+  AddSequencePoint(&methods[0], 0, 10);
+  methods.push_back(MakeMethod(2, 10, 20));
+  AddSequencePoint(&methods[1], 0, 10);
+  AddSequencePoint(&methods[1], 4, 15);
+  methods.push_back(MakeMethod(3, 10, 20));
+  AddSequencePoint(&methods[2], 0, 15);
+
+  MethodLineIndex index;
+  index.Initialize(methods);
+
+  uint32_t method_index;
+  uint32_t sequence_point_index;
+  EXPECT_TRUE(index.FindLocation(methods, 10, &method_index,
+                                 &sequence_point_index));
+  EXPECT_EQ(method_index, 0);
+
+  // The first method has no sequence point on or after line 12.
+  EXPECT_TRUE(index.FindLocation(methods, 12, &method_index,
+                                 &sequence_point_index));
+  EXPECT_EQ(method_index, 1);
+  EXPECT_EQ(sequence_point_index, 1);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,167 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "dbg_breakpoint.h"
+#include "i_portable_pdb_mocks.h"
+#include "pending_breakpoints.h"
+
+using google::cloud::diagnostics::debug::Breakpoint_LogLevel;
+using google_cloud_debugger::DbgBreakpoint;
+using google_cloud_debugger::PendingBreakpoints;
+using google_cloud_debugger::ResolvedBreakpoint;
+using google_cloud_debugger_portable_pdb::MethodInfo;
+using google_cloud_debugger_portable_pdb::SequencePoint;
+using std::string;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// Test Fixture for PendingBreakpoints.
+// Sets up a PDB file with one document that has a method with sequence
+// points at first_line_ and second_line_.
+class PendingBreakpointsTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    MethodInfo method;
+    method.first_line = 10;
+    method.last_line = 30;
+    method.method_def = method_def_;
+
+    SequencePoint first_point;
+    first_point.start_line = first_line_;
+    first_point.end_line = first_line_;
+    first_point.il_offset = first_il_offset_;
+    method.sequence_points.push_back(first_point);
+
+    SequencePoint second_point;
+    second_point.start_line = second_line_;
+    second_point.end_line = second_line_;
+    second_point.il_offset = second_il_offset_;
+    method.sequence_points.push_back(second_point);
+
+    IDocumentIndexFixture document;
+    document.file_name_ = "app/program.cs";
+    document.methods_.push_back(method);
+    pdb_file_fixture_.documents_.push_back(document);
+    pdb_file_fixture_.SetUpIPortablePDBFile(&file_mock_);
+  }
+
+  // Returns an active breakpoint with ID id at line line of file_path.
+  DbgBreakpoint MakeBreakpoint(const string &file_path, const string &id,
+                               uint32_t line) {
+    DbgBreakpoint breakpoint;
+    breakpoint.Initialize(file_path, id, line, 0, false, "",
+                          Breakpoint_LogLevel::Breakpoint_LogLevel_INFO, "",
+                          vector<string>());
+    breakpoint.SetActivated(true);
+    return breakpoint;
+  }
+
+  // Method of the document in the PDB file.
+  uint32_t method_def_ = 100;
+
+  // Lines and IL offsets of the sequence points of the method.
+  uint32_t first_line_ = 12;
+  uint32_t first_il_offset_ = 4;
+  uint32_t second_line_ = 20;
+  uint32_t second_il_offset_ = 8;
+
+  // The table being tested.
+  PendingBreakpoints pending_breakpoints_;
+
+  // Mock of the PDB file of a newly loaded module.
+  IPortablePdbFileMock file_mock_;
+
+  // Fixture for file_mock_.
+  PortablePDBFileFixture pdb_file_fixture_;
+};
+
+// Tests that Add replaces breakpoints with the same ID and that
+// Remove removes them.
+TEST_F(PendingBreakpointsTest, AddAndRemove) {
+  EXPECT_TRUE(pending_breakpoints_.Empty());
+  EXPECT_EQ(pending_breakpoints_.Add(MakeBreakpoint("program.cs", "1", 11)),
+            S_OK);
+  EXPECT_EQ(pending_breakpoints_.Add(MakeBreakpoint("program.cs", "2", 11)),
+            S_OK);
+  EXPECT_EQ(pending_breakpoints_.Add(MakeBreakpoint("other.cs", "3", 5)),
+            S_OK);
+  EXPECT_EQ(pending_breakpoints_.Add(MakeBreakpoint("program.cs", "1", 19)),
+            S_OK);
+  EXPECT_EQ(pending_breakpoints_.Size(), 3);
+
+  EXPECT_TRUE(
+      pending_breakpoints_.Remove(MakeBreakpoint("program.cs", "1", 19)));
+  EXPECT_FALSE(
+      pending_breakpoints_.Remove(MakeBreakpoint("program.cs", "1", 19)));
+  EXPECT_FALSE(
+      pending_breakpoints_.Remove(MakeBreakpoint("other.cs", "2", 11)));
+  EXPECT_EQ(pending_breakpoints_.Size(), 2);
+
+  EXPECT_TRUE(
+      pending_breakpoints_.Remove(MakeBreakpoint("program.cs", "2", 11)));
+  EXPECT_TRUE(pending_breakpoints_.Remove(MakeBreakpoint("other.cs", "3", 5)));
+  EXPECT_TRUE(pending_breakpoints_.Empty());
+}
+
+// Tests that SetInPdbFile sets and removes only the pending breakpoints
+// that are in the PDB file.
+TEST_F(PendingBreakpointsTest, SetInPdbFile) {
+  pending_breakpoints_.Add(MakeBreakpoint("program.cs", "1", first_line_ - 1));
+  pending_breakpoints_.Add(MakeBreakpoint("program.cs", "2", second_line_));
+  pending_breakpoints_.Add(MakeBreakpoint("program.cs", "3", 100));
+  pending_breakpoints_.Add(MakeBreakpoint("other.cs", "4", first_line_));
+
+  vector<ResolvedBreakpoint> resolved =
+      pending_breakpoints_.SetInPdbFile(file_mock_);
+  ASSERT_EQ(resolved.size(), 2);
+
+  // The first breakpoint is moved to its sequence point but keeps the
+  // location it was requested at.
+  EXPECT_EQ(resolved[0].requested_location, "program.cs##11");
+  EXPECT_EQ(resolved[0].breakpoint->GetId(), "1");
+  EXPECT_EQ(resolved[0].breakpoint->GetLine(), first_line_);
+  EXPECT_EQ(resolved[0].breakpoint->GetILOffset(), first_il_offset_);
+  EXPECT_EQ(resolved[0].breakpoint->GetMethodDef(), method_def_);
+  EXPECT_TRUE(resolved[0].breakpoint->Activated());
+
+  EXPECT_EQ(resolved[1].requested_location, "program.cs##20");
+  EXPECT_EQ(resolved[1].breakpoint->GetILOffset(), second_il_offset_);
+
+  // The breakpoint past the method and the one in the other file are
+  // still pending.
+  EXPECT_EQ(pending_breakpoints_.Size(), 2);
+  EXPECT_TRUE(pending_breakpoints_.SetInPdbFile(file_mock_).empty());
+  EXPECT_TRUE(pending_breakpoints_.Remove(MakeBreakpoint("other.cs", "4", 0)));
+}
+
+// Tests that SetInPdbFile looks up the document of a file path once
+// for all the pending breakpoints in that file.
+TEST_F(PendingBreakpointsTest, SetInPdbFileFindsDocumentOnce) {
+  for (int i = 0; i < 10; ++i) {
+    pending_breakpoints_.Add(
+        MakeBreakpoint("program.cs", std::to_string(i), second_line_));
+  }
+
+  EXPECT_CALL(file_mock_, GetDocumentPathTrie()).Times(1);
+  EXPECT_EQ(pending_breakpoints_.SetInPdbFile(file_mock_).size(), 10);
+  EXPECT_TRUE(pending_breakpoints_.Empty());
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,90 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "pipe_receive_buffer.h"
+
+using google_cloud_debugger::PipeReceiveBuffer;
+using std::string;
+
+namespace google_cloud_debugger_test {
+
+// Tests that appended bytes can be read back and consumed.
+TEST(PipeReceiveBufferTest, AppendAndConsume) {
+  PipeReceiveBuffer buffer;
+  EXPECT_EQ(buffer.Size(), 0);
+
+  buffer.Append("Hello", 5);
+  buffer.Append(" World", 6);
+  EXPECT_EQ(string(buffer.Data(), buffer.Size()), "Hello World");
+
+  buffer.Consume(6);
+  EXPECT_EQ(string(buffer.Data(), buffer.Size()), "World");
+
+  buffer.Consume(5);
+  EXPECT_EQ(buffer.Size(), 0);
+}
+
+// Tests that bytes written through PrepareWrite and CommitWrite are
+// added after the unread bytes.
+TEST(PipeReceiveBufferTest, PrepareAndCommitWrite) {
+  PipeReceiveBuffer buffer;
+  buffer.Append("ab", 2);
+
+  char *destination = buffer.PrepareWrite(3);
+  EXPECT_GE(buffer.WritableSize(), 3);
+  destination[0] = 'c';
+  destination[1] = 'd';
+  buffer.CommitWrite(2);
+
+  EXPECT_EQ(string(buffer.Data(), buffer.Size()), "abcd");
+}
+
+// Tests that consumed bytes are reclaimed instead of growing the storage.
+TEST(PipeReceiveBufferTest, ReusesConsumedSpace) {
+  PipeReceiveBuffer buffer;
+  buffer.PrepareWrite(16);
+  size_t capacity = buffer.Capacity();
+
+  for (int i = 0; i < 100; ++i) {
+    buffer.Append("0123456789", 10);
+    buffer.Consume(7);
+    EXPECT_LE(buffer.Size(), 10);
+    buffer.Consume(3);
+  }
+  EXPECT_EQ(buffer.Capacity(), capacity);
+
+  // Unread bytes are moved to the front when the free space at the end
+  // is not enough.
+  buffer.Append("0123456789", 10);
+  buffer.Consume(8);
+  buffer.PrepareWrite(capacity - 2);
+  EXPECT_EQ(buffer.Capacity(), capacity);
+  EXPECT_EQ(string(buffer.Data(), buffer.Size()), "89");
+}
+
+// Tests that the storage grows when the unread bytes do not fit.
+TEST(PipeReceiveBufferTest, Grows) {
+  PipeReceiveBuffer buffer;
+  string message(5000, 'x');
+  buffer.Append("abc", 3);
+  buffer.Append(message.data(), message.size());
+
+  EXPECT_GE(buffer.Capacity(), message.size() + 3);
+  EXPECT_EQ(string(buffer.Data(), buffer.Size()), "abc" + message);
+}
+
+}  // namespace google_cloud_debugger_test
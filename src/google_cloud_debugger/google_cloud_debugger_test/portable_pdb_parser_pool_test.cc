@@ -0,0 +1,103 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "i_portable_pdb_mocks.h"
+#include "portable_pdb_parser_pool.h"
+
+using google_cloud_debugger_portable_pdb::PortablePdbParserPool;
+using std::shared_ptr;
+using std::vector;
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace google_cloud_debugger_test {
+
+// Tests that every queued PDB file is parsed once.
+TEST(PortablePdbParserPoolTest, ParsesQueuedFiles) {
+  vector<shared_ptr<IPortablePdbFileMock>> pdb_files;
+  for (int i = 0; i < 10; ++i) {
+    shared_ptr<IPortablePdbFileMock> pdb_file(new IPortablePdbFileMock());
+    EXPECT_CALL(*pdb_file, ParsePdbFile()).Times(1).WillOnce(Return(true));
+    pdb_files.push_back(pdb_file);
+  }
+
+  PortablePdbParserPool pool;
+  for (auto &pdb_file : pdb_files) {
+    pool.Enqueue(pdb_file);
+  }
+
+  pool.WaitUntilIdle();
+}
+
+// Tests that a failed parse does not stop the pool from parsing
+// the next files.
+TEST(PortablePdbParserPoolTest, ContinuesAfterFailure) {
+  shared_ptr<IPortablePdbFileMock> bad_file(new IPortablePdbFileMock());
+  shared_ptr<IPortablePdbFileMock> good_file(new IPortablePdbFileMock());
+  EXPECT_CALL(*bad_file, ParsePdbFile()).Times(1).WillOnce(Return(false));
+  EXPECT_CALL(*good_file, ParsePdbFile()).Times(1).WillOnce(Return(true));
+
+  PortablePdbParserPool pool(1);
+  pool.Enqueue(bad_file);
+  pool.Enqueue(good_file);
+  pool.WaitUntilIdle();
+}
+
+// Tests that a removed file is not parsed and is not kept alive by
+// the pool.
+TEST(PortablePdbParserPoolTest, RemovesQueuedFiles) {
+  shared_ptr<IPortablePdbFileMock> busy_file(new IPortablePdbFileMock());
+  shared_ptr<IPortablePdbFileMock> removed_file(new IPortablePdbFileMock());
+  std::promise<void> parse_started;
+  std::promise<void> parse_released;
+  std::future<void> parse_released_future = parse_released.get_future();
+  EXPECT_CALL(*busy_file, ParsePdbFile())
+      .Times(1)
+      .WillOnce(Invoke([&parse_started, &parse_released_future]() {
+        parse_started.set_value();
+        parse_released_future.wait();
+        return true;
+      }));
+  EXPECT_CALL(*removed_file, ParsePdbFile()).Times(0);
+
+  // The only worker is busy, so removed_file stays queued until removed.
+  PortablePdbParserPool pool(1);
+  pool.Enqueue(busy_file);
+  parse_started.get_future().wait();
+  pool.Enqueue(removed_file);
+  pool.Remove(removed_file.get());
+
+  std::weak_ptr<IPortablePdbFileMock> removed = removed_file;
+  removed_file.reset();
+  EXPECT_TRUE(removed.expired());
+
+  parse_released.set_value();
+  pool.WaitUntilIdle();
+}
+
+// Tests that null files are ignored and that an idle pool
+// does not block.
+TEST(PortablePdbParserPoolTest, IgnoresNullFiles) {
+  PortablePdbParserPool pool;
+  pool.Enqueue(nullptr);
+  pool.WaitUntilIdle();
+}
+
+}  // namespace google_cloud_debugger_test
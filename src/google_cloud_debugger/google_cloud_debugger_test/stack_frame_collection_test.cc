@@ -299,8 +299,9 @@ class StackFrameCollectionTest : public ::testing::Test {
 
   virtual void SetUpPDBFile() {
     MethodInfo method;
-    // Method def can just be some random number, not important here.
-    method.method_def = 4000;
+    // Makes this method the same as the first frame's method by giving
+    // it the MethodDef row of the first frame's function token.
+    method.method_def = RidFromToken(first_frame_.frame_function_token_);
 
     // Gives the method a sequence point that matches the IP Offset of the
     // first frame.
@@ -325,16 +326,6 @@ class StackFrameCollectionTest : public ::testing::Test {
     pdb_file_fixture_.SetUpIPortablePDBFile(pdb_file.get());
 
     pdb_files_.push_back(std::move(pdb_file));
-
-    // Makes this method the same as the first frame's method by giving
-    // them the same function name and virtual address.
-    EXPECT_CALL(metadata_import_, GetMethodProps(method.method_def, _, nullptr,
-                                                 0, _, _, _, _, _, _))
-        .WillRepeatedly(
-            DoAll(SetArgPointee<1>(method.method_def),
-                  SetArgPointee<4>(first_frame_.wchar_function_name_.size()),
-                  SetArgPointee<8>(first_frame_.frame_func_virtual_addr_),
-                  Return(S_OK)));
   }
 
   // ICorDebugHelper used for StackFrameCollection constructor.
@@ -411,6 +402,26 @@ TEST_F(StackFrameCollectionTest, TestInitializeWithPDBFile) {
   EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
 }
 
+// Tests that only the PDB files of the modules on the stack are parsed.
+TEST_F(StackFrameCollectionTest, TestParseOnlyStackModulePDBFiles) {
+  StackFrameCollection stack_frame_collection(debug_helper_,
+                                              dbg_object_factory_);
+  SetUpStackWalk();
+  SetUpPDBFile();
+
+  // A PDB file of a module that is not on the stack.
+  string other_module_name = "OtherModule";
+  shared_ptr<IPortablePdbFileMock> other_pdb_file(new IPortablePdbFileMock());
+  ON_CALL(*other_pdb_file, GetModuleName())
+      .WillByDefault(ReturnRef(other_module_name));
+  EXPECT_CALL(*other_pdb_file, ParsePdbFile()).Times(0);
+  pdb_files_.insert(pdb_files_.begin(), other_pdb_file);
+
+  HRESULT hr = stack_frame_collection.ProcessBreakpoint(
+      pdb_files_, &dbg_breakpoint_, &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+}
+
 // Tests the Initialize function of stack frame collection
 // when there is an error.
 TEST_F(StackFrameCollectionTest, TestInitializeError) {
@@ -0,0 +1,63 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+
+#include "string_stream_wrapper.h"
+
+using google_cloud_debugger::StringStreamWrapper;
+
+namespace google_cloud_debugger_test {
+
+// Tests that errors written with WriteError and to the error stream
+// are collected.
+TEST(StringStreamWrapperTest, WriteError) {
+  StringStreamWrapper wrapper;
+  EXPECT_EQ(wrapper.GetErrorString(), "");
+
+  wrapper.WriteError("First error.");
+  *wrapper.GetErrorStream() << "Second error " << 2 << ".";
+  EXPECT_EQ(wrapper.GetErrorString(), "First error.\nSecond error 2.");
+}
+
+// Tests that ResetErrorStream removes the errors written so far.
+TEST(StringStreamWrapperTest, ResetErrorStream) {
+  StringStreamWrapper wrapper;
+  wrapper.WriteError("Error.");
+  wrapper.ResetErrorStream();
+  EXPECT_EQ(wrapper.GetErrorString(), "");
+
+  *wrapper.GetErrorStream() << "Another error.";
+  EXPECT_EQ(wrapper.GetErrorString(), "Another error.");
+}
+
+// Tests that a moved wrapper keeps its errors and writes to its own
+// error stream.
+TEST(StringStreamWrapperTest, Move) {
+  StringStreamWrapper wrapper;
+  wrapper.WriteError("Error.");
+
+  StringStreamWrapper moved(std::move(wrapper));
+  *moved.GetErrorStream() << "Another error.";
+  EXPECT_EQ(moved.GetErrorString(), "Error.\nAnother error.");
+
+  StringStreamWrapper assigned;
+  assigned = std::move(moved);
+  EXPECT_EQ(assigned.GetErrorString(), "Error.\nAnother error.");
+  EXPECT_NE(assigned.GetErrorStream(), moved.GetErrorStream());
+}
+
+}  // namespace google_cloud_debugger_test
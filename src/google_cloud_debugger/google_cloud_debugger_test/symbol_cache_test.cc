@@ -0,0 +1,195 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "document_index.h"
+#include "symbol_cache.h"
+
+using google_cloud_debugger_portable_pdb::DocumentIndex;
+using google_cloud_debugger_portable_pdb::IDocumentIndex;
+using google_cloud_debugger_portable_pdb::LocalConstantInfo;
+using google_cloud_debugger_portable_pdb::LocalVariableInfo;
+using google_cloud_debugger_portable_pdb::MethodInfo;
+using google_cloud_debugger_portable_pdb::Scope;
+using google_cloud_debugger_portable_pdb::SequencePoint;
+using google_cloud_debugger_portable_pdb::SymbolCache;
+using std::array;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// Test Fixture for SymbolCache.
+// Caches a document index of a fake PDB file in the current directory.
+class SymbolCacheTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    WritePdbFile("fake pdb content");
+    pdb_id_.fill(0xab);
+
+    MethodInfo method;
+    method.method_def = 7;
+    method.first_line = 10;
+    method.last_line = 20;
+
+    SequencePoint sequence_point;
+    sequence_point.il_offset = 4;
+    sequence_point.start_line = 12;
+    sequence_point.start_col = 3;
+    sequence_point.end_line = 12;
+    sequence_point.end_col = 30;
+    method.sequence_points.push_back(sequence_point);
+    sequence_point.is_hidden = true;
+    method.sequence_points.push_back(sequence_point);
+
+    Scope scope;
+    scope.index = 2;
+    scope.start_offset = 0;
+    scope.length = 40;
+    LocalVariableInfo variable;
+    variable.slot = 1;
+    variable.name = "counter";
+    variable.debugger_hidden = true;
+    scope.local_variables.push_back(variable);
+    LocalConstantInfo constant;
+    constant.name = "Limit";
+    constant.signature_data = {0x08, 0x0a, 0x00};
+    scope.local_constants.push_back(constant);
+    method.local_scope.push_back(scope);
+
+    unique_ptr<DocumentIndex> document_index(new DocumentIndex());
+    document_index->Initialize("C:\\src\\Program.cs", {method});
+    document_indices_.push_back(std::move(document_index));
+  }
+
+  virtual void TearDown() {
+    std::remove(pdb_path_.c_str());
+    std::remove(kCacheFile);
+  }
+
+  // Replaces the content of the fake PDB file.
+  void WritePdbFile(const string &content) {
+    std::ofstream pdb_file(pdb_path_, std::ios::binary | std::ios::trunc);
+    pdb_file << content;
+  }
+
+  // The cache file of pdb_id_ in the current directory.
+  static constexpr const char *kCacheFile =
+      "abababababababababababababababababababab.symidx";
+
+  // Path to the fake PDB file.
+  string pdb_path_ = "symbol_cache_test.pdb";
+
+  // PDB ID of the fake PDB file.
+  array<std::uint8_t, 20> pdb_id_;
+
+  // Document indices to cache.
+  vector<unique_ptr<IDocumentIndex>> document_indices_;
+
+  SymbolCache symbol_cache_{"."};
+};
+
+constexpr const char *SymbolCacheTest::kCacheFile;
+
+// Tests that a saved index is loaded back unchanged.
+TEST_F(SymbolCacheTest, SaveAndLoad) {
+  EXPECT_TRUE(symbol_cache_.Save(pdb_path_, pdb_id_, document_indices_));
+
+  vector<unique_ptr<IDocumentIndex>> loaded;
+  ASSERT_TRUE(symbol_cache_.Load(pdb_path_, pdb_id_, &loaded));
+  ASSERT_EQ(loaded.size(), 1);
+  EXPECT_EQ(loaded[0]->GetFilePath(), "C:\\src\\Program.cs");
+
+  const vector<MethodInfo> &methods = loaded[0]->GetMethods();
+  ASSERT_EQ(methods.size(), 1);
+  EXPECT_EQ(methods[0].method_def, 7);
+  EXPECT_EQ(methods[0].first_line, 10);
+  EXPECT_EQ(methods[0].last_line, 20);
+
+  ASSERT_EQ(methods[0].sequence_points.size(), 2);
+  EXPECT_EQ(methods[0].sequence_points[0].il_offset, 4);
+  EXPECT_EQ(methods[0].sequence_points[0].start_line, 12);
+  EXPECT_EQ(methods[0].sequence_points[0].start_col, 3);
+  EXPECT_EQ(methods[0].sequence_points[0].end_col, 30);
+  EXPECT_FALSE(methods[0].sequence_points[0].is_hidden);
+  EXPECT_TRUE(methods[0].sequence_points[1].is_hidden);
+
+  ASSERT_EQ(methods[0].local_scope.size(), 1);
+  const Scope &scope = methods[0].local_scope[0];
+  EXPECT_EQ(scope.index, 2);
+  EXPECT_EQ(scope.length, 40);
+  ASSERT_EQ(scope.local_variables.size(), 1);
+  EXPECT_EQ(scope.local_variables[0].slot, 1);
+  EXPECT_EQ(scope.local_variables[0].name, "counter");
+  EXPECT_TRUE(scope.local_variables[0].debugger_hidden);
+  ASSERT_EQ(scope.local_constants.size(), 1);
+  EXPECT_EQ(scope.local_constants[0].name, "Limit");
+  EXPECT_EQ(scope.local_constants[0].signature_data,
+            vector<std::uint8_t>({0x08, 0x0a, 0x00}));
+
+  // The line index of the loaded document is built as well.
+  uint32_t method_index;
+  uint32_t sequence_point_index;
+  EXPECT_TRUE(loaded[0]->GetMethodLineIndex().FindLocation(
+      methods, 11, &method_index, &sequence_point_index));
+}
+
+// Tests that nothing is loaded for a PDB that is not cached.
+TEST_F(SymbolCacheTest, LoadMissing) {
+  vector<unique_ptr<IDocumentIndex>> loaded;
+  EXPECT_FALSE(symbol_cache_.Load(pdb_path_, pdb_id_, &loaded));
+  EXPECT_FALSE(symbol_cache_.Load("missing.pdb", pdb_id_, &loaded));
+  EXPECT_FALSE(symbol_cache_.Load(pdb_path_, pdb_id_, nullptr));
+}
+
+// Tests that the cache is not used once the PDB file changes.
+TEST_F(SymbolCacheTest, LoadStale) {
+  EXPECT_TRUE(symbol_cache_.Save(pdb_path_, pdb_id_, document_indices_));
+  WritePdbFile("rebuilt fake pdb content");
+
+  vector<unique_ptr<IDocumentIndex>> loaded;
+  EXPECT_FALSE(symbol_cache_.Load(pdb_path_, pdb_id_, &loaded));
+  EXPECT_TRUE(loaded.empty());
+}
+
+// Tests that a truncated cache file is rejected.
+TEST_F(SymbolCacheTest, LoadCorrupted) {
+  EXPECT_TRUE(symbol_cache_.Save(pdb_path_, pdb_id_, document_indices_));
+
+  string content;
+  {
+    std::ifstream cache_file(kCacheFile, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(cache_file),
+                   std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream cache_file(kCacheFile, std::ios::binary | std::ios::trunc);
+    cache_file << content.substr(0, content.size() - 5);
+  }
+
+  vector<unique_ptr<IDocumentIndex>> loaded;
+  EXPECT_FALSE(symbol_cache_.Load(pdb_path_, pdb_id_, &loaded));
+  EXPECT_TRUE(loaded.empty());
+}
+
+}  // namespace google_cloud_debugger_test
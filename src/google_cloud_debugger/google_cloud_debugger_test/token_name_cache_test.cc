@@ -0,0 +1,135 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "i_metadata_import_mock.h"
+#include "token_name_cache.h"
+
+using google_cloud_debugger::TokenInfo;
+using google_cloud_debugger::TokenNameCache;
+using ::testing::Return;
+
+namespace google_cloud_debugger_test {
+
+// Test Fixture for TokenNameCache.
+class TokenNameCacheTest : public ::testing::Test {
+ protected:
+  // Metadata of the first module. The cache only uses its address and
+  // its reference count.
+  IMetaDataImportMock first_metadata_;
+
+  // Metadata of the second module.
+  IMetaDataImportMock second_metadata_;
+
+  // Tokens in the modules.
+  mdToken first_token_ = 0x02000002;
+  mdToken second_token_ = 0x06000003;
+
+  // The cache under test. This is declared last as it releases the
+  // metadata when it is destroyed.
+  TokenNameCache cache_;
+};
+
+// Tests that cached names are found by metadata and token, and that
+// lookups are counted.
+TEST_F(TokenNameCacheTest, AddAndFind) {
+  cache_.AddMetaDataImport(&first_metadata_);
+  cache_.AddMetaDataImport(&second_metadata_);
+
+  TokenInfo info;
+  EXPECT_FALSE(cache_.Find(&first_metadata_, first_token_, &info));
+
+  TokenInfo method_info;
+  method_info.name = "Method";
+  method_info.parent_token = first_token_;
+  method_info.code_rva = 0x2050;
+  cache_.Add(&first_metadata_, second_token_, method_info);
+
+  EXPECT_TRUE(cache_.Find(&first_metadata_, second_token_, &info));
+  EXPECT_EQ(info.name, "Method");
+  EXPECT_EQ(info.parent_token, first_token_);
+  EXPECT_EQ(info.code_rva, 0x2050);
+  EXPECT_FALSE(cache_.Find(&second_metadata_, second_token_, &info));
+
+  EXPECT_EQ(cache_.GetHits(), 1);
+  EXPECT_EQ(cache_.GetMisses(), 2);
+}
+
+// Tests that RemoveMetaDataImport drops the names of a module and the
+// TypeRefs that resolve to it.
+TEST_F(TokenNameCacheTest, RemoveMetaDataImport) {
+  cache_.AddMetaDataImport(&first_metadata_);
+  cache_.AddMetaDataImport(&second_metadata_);
+
+  TokenInfo info;
+  info.name = "Class";
+  cache_.Add(&first_metadata_, first_token_, info);
+  cache_.Add(&second_metadata_, first_token_, info);
+
+  mdToken type_ref = 0x01000004;
+  cache_.AddResolvedTypeRef(&first_metadata_, type_ref, first_token_,
+                            &second_metadata_);
+
+  mdTypeDef type_def = 0;
+  IMetaDataImport *type_def_metadata = nullptr;
+  EXPECT_CALL(second_metadata_, AddRef()).WillOnce(Return(2));
+  EXPECT_TRUE(cache_.FindResolvedTypeRef(&first_metadata_, type_ref,
+                                         &type_def, &type_def_metadata));
+  EXPECT_EQ(type_def, first_token_);
+  EXPECT_EQ(type_def_metadata, &second_metadata_);
+
+  cache_.RemoveMetaDataImport(&second_metadata_);
+  EXPECT_TRUE(cache_.Find(&first_metadata_, first_token_, &info));
+  EXPECT_FALSE(cache_.Find(&second_metadata_, first_token_, &info));
+  EXPECT_FALSE(cache_.FindResolvedTypeRef(&first_metadata_, type_ref,
+                                          &type_def, &type_def_metadata));
+
+  cache_.Clear();
+  EXPECT_FALSE(cache_.Find(&first_metadata_, first_token_, &info));
+}
+
+// Tests that the cache holds a reference to the metadata of the modules
+// that are added until they are removed, and that the tokens of other
+// modules are not cached.
+TEST_F(TokenNameCacheTest, AddMetaDataImport) {
+  EXPECT_CALL(first_metadata_, AddRef()).WillOnce(Return(2));
+  cache_.AddMetaDataImport(&first_metadata_);
+
+  TokenInfo info;
+  info.name = "Class";
+  cache_.Add(&first_metadata_, first_token_, info);
+  cache_.Add(&second_metadata_, first_token_, info);
+  EXPECT_TRUE(cache_.Find(&first_metadata_, first_token_, &info));
+  EXPECT_FALSE(cache_.Find(&second_metadata_, first_token_, &info));
+
+  // A TypeRef is only cached if both modules were added.
+  mdToken type_ref = 0x01000004;
+  mdTypeDef type_def = 0;
+  IMetaDataImport *type_def_metadata = nullptr;
+  cache_.AddResolvedTypeRef(&first_metadata_, type_ref, first_token_,
+                            &second_metadata_);
+  EXPECT_FALSE(cache_.FindResolvedTypeRef(&first_metadata_, type_ref,
+                                          &type_def, &type_def_metadata));
+
+  EXPECT_CALL(first_metadata_, Release()).WillOnce(Return(1));
+  cache_.RemoveMetaDataImport(&first_metadata_);
+  ::testing::Mock::VerifyAndClearExpectations(&first_metadata_);
+
+  cache_.Add(&first_metadata_, first_token_, info);
+  EXPECT_FALSE(cache_.Find(&first_metadata_, first_token_, &info));
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,81 @@
+// Copyright 2018 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <queue>
+
+#include "breakpoint.pb.h"
+#include "dbg_breakpoint.h"
+#include "fake_dbg_object.h"
+#include "i_eval_coordinator_mock.h"
+#include "variable_wrapper.h"
+
+using google::cloud::diagnostics::debug::StackFrame;
+using google_cloud_debugger::DbgBreakpoint;
+using google_cloud_debugger::VariableWrapper;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using std::queue;
+
+namespace google_cloud_debugger_test {
+
+// Populates a stack frame until it is about as large as a breakpoint can
+// be, once by serializing the frame before each variable and once with
+// the size kept by PerformBFS. Serializing the frame each time is
+// quadratic in the size of the frame while keeping the size is linear.
+TEST(VariableWrapperBenchmark, LargeSnapshot) {
+  const int kNumLocals = 50;
+  const int kNumMembers = 100;
+  const std::int64_t kMaximumSize = DbgBreakpoint::kMaximumBreakpointSize;
+  IEvalCoordinatorMock eval_coordinator;
+
+  StackFrame serialized_frame;
+  queue<VariableWrapper> bfs_queue;
+  FakeDbgObjectProtoMembers::AddLocals(&serialized_frame, kNumLocals,
+                                       kNumMembers, &bfs_queue);
+  steady_clock::time_point start = steady_clock::now();
+  HRESULT hr = VariableWrapper::PerformBFS(
+      &bfs_queue,
+      [&serialized_frame, kMaximumSize]() {
+        return serialized_frame.ByteSizeLong() > kMaximumSize;
+      },
+      &eval_coordinator);
+  milliseconds serialized_time =
+      duration_cast<milliseconds>(steady_clock::now() - start);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  StackFrame sized_frame;
+  bfs_queue = queue<VariableWrapper>();
+  FakeDbgObjectProtoMembers::AddLocals(&sized_frame, kNumLocals, kNumMembers,
+                                       &bfs_queue);
+  start = steady_clock::now();
+  std::int64_t size = sized_frame.ByteSizeLong();
+  hr = VariableWrapper::PerformBFS(
+      &bfs_queue, [&size, kMaximumSize]() { return size > kMaximumSize; },
+      &eval_coordinator, &size);
+  milliseconds sized_time =
+      duration_cast<milliseconds>(steady_clock::now() - start);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  std::cout << "Populating " << sized_frame.ByteSizeLong()
+            << " bytes of variables: serializing each time "
+            << serialized_time.count() << "ms, keeping the size "
+            << sized_time.count() << "ms" << std::endl;
+}
+
+}  // namespace google_cloud_debugger_test
@@ -15,7 +15,6 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <cstdint>
-#include <cstdlib>
 #include <queue>
 #include <vector>
 
@@ -23,14 +22,18 @@
 #include "constants.h"
 #include "cor.h"
 #include "cordebug.h"
+#include "dbg_breakpoint.h"
 #include "dbg_object.h"
+#include "fake_dbg_object.h"
 #include "i_cor_debug_helper.h"
 #include "i_dbg_object_factory.h"
 #include "i_eval_coordinator_mock.h"
 #include "variable_wrapper.h"
 #include "winerror.h"
 
+using google::cloud::diagnostics::debug::StackFrame;
 using google::cloud::diagnostics::debug::Variable;
+using google_cloud_debugger::DbgBreakpoint;
 using google_cloud_debugger::DbgObject;
 using google_cloud_debugger::ICorDebugHelper;
 using google_cloud_debugger::IDbgObjectFactory;
@@ -49,85 +52,39 @@ using ::testing::SetArgPointee;
 namespace google_cloud_debugger_test {
 
 // Helper class that implements DbgObject.
-// This class contains its own variable proto.
-class FakeDbgObjectBase : public DbgObject {
+// Like a class whose property getters are evaluated while its members
+// are populated, this object is moved by the garbage collector to
+// moved_address_ when PopulateMembers is called.
+class FakeDbgObjectMovedMembers : public FakeDbgObjectMembers {
  public:
-  FakeDbgObjectBase(ICorDebugType *debug_type, int depth)
-      : DbgObject(debug_type, depth, std::shared_ptr<ICorDebugHelper>()) {}
-
-  virtual void Initialize(ICorDebugValue *debug_value, BOOL is_null) override {}
-
-  virtual HRESULT GetTypeString(std::string *type_string) override {
-    *type_string = type_;
-    return S_OK;
-  }
-
-  virtual HRESULT GetICorDebugValue(ICorDebugValue **debug_value,
-                                    ICorDebugEval *debug_eval) override {
-    return E_NOTIMPL;
+  FakeDbgObjectMovedMembers(CORDB_ADDRESS address,
+                            CORDB_ADDRESS moved_address)
+      : FakeDbgObjectMembers(nullptr, 0),
+        current_address_(address),
+        moved_address_(moved_address) {
+    SetAddress(address);
+    SetCorElementType(CorElementType::ELEMENT_TYPE_CLASS);
   }
 
-  // Type of the object.
-  std::string type_ = "Type" + std::to_string(rand());
-
-  // Proto of the object.
-  Variable variable_proto_;
-};
-
-// Helper class that implements DbgObject.
-// This class returns no members.
-class FakeDbgObjectValue : public FakeDbgObjectBase {
- public:
-  FakeDbgObjectValue(ICorDebugType *debug_type, int depth)
-      : FakeDbgObjectBase(debug_type, depth) {}
-
-  virtual HRESULT PopulateValue(Variable *variable) override {
-    variable->set_value(value_);
+  virtual HRESULT GetCurrentAddress(CORDB_ADDRESS *address) override {
+    *address = current_address_;
     return S_OK;
   }
 
   virtual HRESULT PopulateMembers(Variable *variable_proto,
                                   std::vector<VariableWrapper> *members,
                                   IEvalCoordinator *eval_coordinator) override {
-    return S_FALSE;
-  }
-
-  // Creates a variable wrapper. The proto of the wrapper
-  // will be variable_proto_ field of the object.
-  static VariableWrapper GetVariableWrapper() {
-    shared_ptr<FakeDbgObjectValue> object(new FakeDbgObjectValue(nullptr, 0));
-    return VariableWrapper(&object->variable_proto_, object);
-  }
-  // Value of the object.
-  std::string value_ = "Value" + std::to_string(rand());
-};
-
-// Helper class that implements DbgObject.
-// This class returns members but no value.
-class FakeDbgObjectMembers : public FakeDbgObjectBase {
- public:
-  FakeDbgObjectMembers(ICorDebugType *debug_type, int depth)
-      : FakeDbgObjectBase(debug_type, depth) {}
-
-  virtual HRESULT PopulateValue(Variable *variable) override { return S_FALSE; }
-
-  virtual HRESULT PopulateMembers(Variable *variable_proto,
-                                  std::vector<VariableWrapper> *members,
-                                  IEvalCoordinator *eval_coordinator) override {
-    members->insert(members->begin(), members_.begin(), members_.end());
-    return S_OK;
+    current_address_ = moved_address_;
+    return FakeDbgObjectMembers::PopulateMembers(variable_proto, members,
+                                                 eval_coordinator);
   }
 
-  // Creates a variable wrapper. The proto of the wrapper
-  // will be variable_proto_ field of the object.
-  static VariableWrapper GetVariableWrapper() {
-    shared_ptr<FakeDbgObjectMembers> object(
-        new FakeDbgObjectMembers(nullptr, 0));
-    return VariableWrapper(&object->variable_proto_, object);
-  }
+ private:
+  // Address of the object now.
+  CORDB_ADDRESS current_address_;
 
-  // Members of the object.
-  vector<VariableWrapper> members_;
+  // Address the object is moved to when its members are populated.
+  CORDB_ADDRESS moved_address_;
 };
 
 // Test Fixture for DbgClass.
@@ -366,4 +323,139 @@ TEST_F(VariableWrapperTest, TestBFSThreeLevels) {
   CheckValue(&value_wrapper_4_);
 }
 
+// Tests PerformBFS method when 2 children are the same object.
+// Only the first child should be expanded.
+TEST_F(VariableWrapperTest, TestBFSSameObject) {
+  members_wrapper_.GetVariableProto()->set_name("request");
+  members_wrapper_2_.GetVariableProto()->set_name("first");
+  members_wrapper_3_.GetVariableProto()->set_name("second");
+  for (VariableWrapper *wrapper : {&members_wrapper_2_, &members_wrapper_3_}) {
+    wrapper->GetVariableValue()->SetAddress(0x1000);
+    wrapper->GetVariableValue()->SetCorElementType(
+        CorElementType::ELEMENT_TYPE_CLASS);
+  }
+  AddMembers(&members_wrapper_, members_wrapper_2_);
+  AddMembers(&members_wrapper_, members_wrapper_3_);
+  AddMembers(&members_wrapper_2_, value_wrapper_2_);
+  AddMembers(&members_wrapper_3_, value_wrapper_3_);
+
+  queue<VariableWrapper> bfs_queue;
+  bfs_queue.push(members_wrapper_);
+  HRESULT hr = VariableWrapper::PerformBFS(&bfs_queue, []() { return false; },
+                                           &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  CheckType(&members_wrapper_2_);
+  CheckType(&value_wrapper_2_);
+  CheckValue(&value_wrapper_2_);
+
+  // The second child should refer to the first one instead of being
+  // expanded again.
+  CheckType(&members_wrapper_3_);
+  EXPECT_FALSE(members_wrapper_3_.GetVariableProto()->status().iserror());
+  EXPECT_EQ(members_wrapper_3_.GetVariableProto()->status().message(),
+            "Same object as request.first.");
+  EXPECT_TRUE(value_wrapper_3_.GetVariableProto()->type().empty());
+  EXPECT_TRUE(value_wrapper_3_.GetVariableProto()->value().empty());
+}
+
+// Tests PerformBFS method when the first child is moved by the garbage
+// collector while it is expanded and the second child is a different
+// object at the address the first child had when it was created.
+// Both children should be expanded.
+TEST_F(VariableWrapperTest, TestBFSObjectMoved) {
+  shared_ptr<FakeDbgObjectMovedMembers> moved_object(
+      new FakeDbgObjectMovedMembers(0x1000, 0x2000));
+  VariableWrapper moved_wrapper(&moved_object->variable_proto_,
+                                moved_object);
+  members_wrapper_.GetVariableProto()->set_name("request");
+  moved_wrapper.GetVariableProto()->set_name("first");
+  members_wrapper_3_.GetVariableProto()->set_name("second");
+  members_wrapper_3_.GetVariableValue()->SetAddress(0x1000);
+  members_wrapper_3_.GetVariableValue()->SetCorElementType(
+      CorElementType::ELEMENT_TYPE_CLASS);
+  AddMembers(&members_wrapper_, moved_wrapper);
+  AddMembers(&members_wrapper_, members_wrapper_3_);
+  AddMembers(&moved_wrapper, value_wrapper_2_);
+  AddMembers(&members_wrapper_3_, value_wrapper_3_);
+
+  queue<VariableWrapper> bfs_queue;
+  bfs_queue.push(members_wrapper_);
+  HRESULT hr = VariableWrapper::PerformBFS(&bfs_queue, []() { return false; },
+                                           &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  CheckType(&moved_wrapper);
+  CheckType(&value_wrapper_2_);
+  CheckValue(&value_wrapper_2_);
+
+  CheckType(&members_wrapper_3_);
+  EXPECT_FALSE(members_wrapper_3_.GetVariableProto()->has_status());
+  CheckType(&value_wrapper_3_);
+  CheckValue(&value_wrapper_3_);
+}
+
+// Tests that PerformBFS keeps track of the size of the message that
+// contains the variables.
+TEST_F(VariableWrapperTest, TestBFSSize) {
+  StackFrame stack_frame;
+  queue<VariableWrapper> bfs_queue;
+  FakeDbgObjectProtoMembers::AddLocals(&stack_frame, 3, 10, &bfs_queue);
+
+  std::int64_t size = stack_frame.ByteSizeLong();
+  HRESULT hr = VariableWrapper::PerformBFS(&bfs_queue, []() { return false; },
+                                           &eval_coordinator_, &size);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  // The length prefixes of the locals grow as their members are
+  // populated, which is not counted.
+  std::int64_t actual_size = stack_frame.ByteSizeLong();
+  EXPECT_LE(size, actual_size);
+  EXPECT_GE(size + 2 * stack_frame.locals_size(), actual_size);
+}
+
+// Tests that the size kept by PerformBFS tracks the size of the message
+// each time terminate_condition checks it, for cutoffs from a few
+// variables up to the maximum size of a breakpoint.
+TEST_F(VariableWrapperTest, TestBFSSizeAtCutoffs) {
+  const int kNumLocals = 20;
+  const int kNumMembers = 50;
+  const std::int64_t kCutoffs[] = {1000, 5000, 20000,
+                                   DbgBreakpoint::kMaximumBreakpointSize};
+
+  for (std::int64_t cutoff : kCutoffs) {
+    StackFrame stack_frame;
+    queue<VariableWrapper> bfs_queue;
+    FakeDbgObjectProtoMembers::AddLocals(&stack_frame, kNumLocals,
+                                         kNumMembers, &bfs_queue);
+
+    // The length prefixes of the locals grow as their members are
+    // populated, which is not counted, so the size can be up to 2 bytes
+    // per local below the real size.
+    std::int64_t size = stack_frame.ByteSizeLong();
+    HRESULT hr = VariableWrapper::PerformBFS(
+        &bfs_queue,
+        [&size, &stack_frame, cutoff]() {
+          std::int64_t actual_size = stack_frame.ByteSizeLong();
+          EXPECT_LE(size, actual_size) << "Cutoff: " << cutoff;
+          EXPECT_GE(size + 2 * kNumLocals, actual_size)
+              << "Cutoff: " << cutoff;
+          return size > cutoff;
+        },
+        &eval_coordinator_, &size);
+    EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+    std::int64_t actual_size = stack_frame.ByteSizeLong();
+    EXPECT_LE(size, actual_size) << "Cutoff: " << cutoff;
+    EXPECT_GE(size + 2 * kNumLocals, actual_size) << "Cutoff: " << cutoff;
+    if (cutoff < DbgBreakpoint::kMaximumBreakpointSize) {
+      EXPECT_GT(size, cutoff);
+    } else {
+      // The whole frame fits under the largest cutoff.
+      EXPECT_LE(size, cutoff);
+      EXPECT_TRUE(bfs_queue.empty());
+    }
+  }
+}
+
 }  // namespace google_cloud_debugger_test
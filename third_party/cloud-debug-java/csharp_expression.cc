@@ -752,7 +752,7 @@ CompiledExpression CSharpExpressionMemberSelector::CreateEvaluator() {
             std::move(source_evaluator.evaluator),
             std::move(identifier_name),
             std::move(possible_class_name),
-            std::move(member_),
+            member_,
             std::move(debug_helper))),
   };
 }
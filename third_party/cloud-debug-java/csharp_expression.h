@@ -48,6 +48,8 @@ class CSharpExpression {
   // Compiles the expression into executable format. The caller owns the
   // returned instance. If a particular language feature is not yet supported,
   // the function returns null and prints description in "error_message".
+  // This does not modify the expression tree, so it can be called multiple
+  // times to create independent evaluators of the same expression.
   virtual CompiledExpression CreateEvaluator() = 0;
 };
 
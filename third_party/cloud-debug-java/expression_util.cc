@@ -28,11 +28,12 @@ using std::cerr;
 
 namespace google_cloud_debugger {
 
-CompiledExpression CompileExpression(const std::string& string_expression) {
+std::unique_ptr<CSharpExpression> ParseExpression(
+    const std::string& string_expression) {
   if (string_expression.size() > kMaxExpressionLength) {
     std::cerr << "Expression can't be compiled because it is too long: "
               << string_expression.size();
-    return {nullptr, string_expression};
+    return nullptr;
   }
 
   // Parse the expression.
@@ -50,7 +51,7 @@ CompiledExpression CompileExpression(const std::string& string_expression) {
     std::cerr << "Expression parsing failed" << std::endl
               << "Input: " << string_expression << std::endl
               << "Parser error: " << parser.errors()[0];
-    return {nullptr, string_expression};
+    return nullptr;
   }
 
   // Transform ANTLR AST into "CSharpExpression" tree.
@@ -62,7 +63,15 @@ CompiledExpression CompileExpression(const std::string& string_expression) {
     cerr << "Tree walking on parsed expression failed" << std::endl
          << "Input: " << string_expression << std::endl
          << "AST: " << parser.getAST()->toStringTree();
+  }
 
+  return expression;
+}
+
+CompiledExpression CompileExpression(const std::string& string_expression) {
+  std::unique_ptr<CSharpExpression> expression =
+      ParseExpression(string_expression);
+  if (expression == nullptr) {
     return {nullptr, string_expression};
   }
 
@@ -72,7 +81,8 @@ CompiledExpression CompileExpression(const std::string& string_expression) {
   if (compiled_expression.evaluator == nullptr) {
     cerr << "Expression not supported by the evaluator" << std::endl
          << "Input: " << string_expression << std::endl
-         << "AST: " << parser.getAST()->toStringTree();
+         << "Expression: ";
+    expression->Print(&cerr, false);
   }
 
   return compiled_expression;
@@ -23,6 +23,7 @@
 
 namespace google_cloud_debugger {
 
+class CSharpExpression;
 class ExpressionEvaluator;
 class DbgStackFrame;
 
@@ -42,6 +43,15 @@ struct CompiledExpression {
   std::string expression;
 };
 
+// Tokenizes, parses and tree-walks the specified expression into a
+// "CSharpExpression" tree. Returns nullptr if the expression is too long
+// or syntactically incorrect. The returned tree can be used to create
+// any number of evaluators through "CSharpExpression::CreateEvaluator", so
+// callers that evaluate the same expression repeatedly should only parse
+// it once.
+std::unique_ptr<CSharpExpression> ParseExpression(
+    const std::string& string_expression);
+
 // Shortcut method to tokenize, parse, and tree-walk the specified
 // expression. Returns nullptr if any error occures (syntactically or
 // semantically incorrect expression). In such cases, "error_message" is